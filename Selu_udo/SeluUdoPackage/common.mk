@@ -21,8 +21,11 @@ else
 $(error SNPE_ROOT: Please set SNPE_ROOT or ZDL_ROOT to obtain Udo headers necessary to compile the package)
 endif
 
+# set optimization level, can be overridden from the command line (e.g. OPT_FLAGS="-O0 -g")
+OPT_FLAGS ?= -O3
+
 # set compiler flags
-CXXFLAGS += -std=c++11 -fPIC $(TARGET_AARCH_VARS) $(INCLUDES)
+CXXFLAGS += -std=c++11 -fPIC -pthread $(OPT_FLAGS) $(TARGET_AARCH_VARS) $(INCLUDES)
 
 # set runtime specific compiler flags
 ifdef CL_INCLUDE_PATH
@@ -35,8 +38,8 @@ SOURCES := $(wildcard $(SRC_DIR)/*.cpp)
 # define utility source directory
 UTIL_SRC_DIR := ../utils
 
-# define utility sources
-UTIL_SOURCES := $(wildcard $(UTIL_SRC_DIR)/*.cpp)
+# define utility sources, leaving out the ones a library lists in UTIL_EXCLUDES
+UTIL_SOURCES := $(filter-out $(addprefix $(UTIL_SRC_DIR)/,$(UTIL_EXCLUDES)),$(wildcard $(UTIL_SRC_DIR)/*.cpp))
 
 # Make runtime specific adjustments to sources
 ifeq ($(RUNTIME), GPU)
@@ -51,8 +54,9 @@ else
 OBJ_DIR :=../../../obj/local/$(TARGET)
 endif
 
-# define utility object directory
-UTIL_OBJ_DIR = $(OBJ_DIR)
+# define utility object directory, a library building them with its own flags sets
+# its own
+UTIL_OBJ_DIR ?= $(OBJ_DIR)
 
 # setup object files in object directory
 OBJECTS := $(patsubst %.cpp,$(OBJ_DIR)/%.o,$(foreach x,$(SOURCES),$(notdir $(x))))
@@ -81,7 +85,7 @@ $(UTIL_OBJ_DIR)/%.o: $(UTIL_SRC_DIR)/$(RUNTIME)/%.cpp
 	$(CXX) $(CXXFLAGS) -c $^ -o $@
 
 # set up resources
-directories := $(LIB_DIR) $(OBJ_DIR)
+directories := $(sort $(LIB_DIR) $(OBJ_DIR) $(UTIL_OBJ_DIR))
 
 # Compile
 $(library): $(OBJECTS) $(UTIL_OBJECTS) | $(directories)
@@ -89,6 +93,7 @@ $(library): $(OBJECTS) $(UTIL_OBJECTS) | $(directories)
 
 # rule for object directory resource
 $(OBJECTS): | $(OBJ_DIR)
+$(UTIL_OBJECTS): | $(UTIL_OBJ_DIR)
 
 # rule to create directories
 $(directories):
@@ -0,0 +1,111 @@
+//==============================================================================
+// Auto Generated Code for SeluUdoPackage
+//==============================================================================
+
+#pragma once
+
+#include <memory>
+
+#include "utils/IUdoOpDefinition.hpp"
+#include "utils/UdoCpuOperation.hpp"
+#include "utils/UdoConv.hpp"
+#include "SeluKernelsCpu.hpp"
+
+/**
+ * @brief Everything execute needs besides the tensors, see ActivationExecutionPlan.
+ * The batch and spatial sizes depend on currDimensions, so a shape change redoes the
+ * tiling.
+ */
+struct Conv2dSeluExecutionPlan
+{
+    UdoUtil::ConvKernelArgs args = {nullptr, nullptr, nullptr, nullptr, {0, 0, 0, 0, 0, 0, 0, 0}, 0, 0, 0, 0,
+                                    {0.0f, 0.0f}};
+    UdoUtil::ConvKernelFn run = nullptr;
+    UdoUtil::ActivationKernelFn exactActivation = nullptr;
+    UdoUtil::DenseTiling tiling = {0, 0, 0, 0, 0, 0, 0};
+};
+
+/**
+ * @brief Selu(conv(in, W) + b) with float32 NHWC tensors. The weights are packed for
+ * the kernel into an aligned blob of the static tensor store, shared by ops with the same
+ * weights.
+ */
+class Conv2dSeluOp : public UdoUtil::UdoCpuOperation
+{
+public:
+    Conv2dSeluOp(SnpeUdo_TensorParam_t* inputs, uint32_t numOfInputs,
+                SnpeUdo_TensorParam_t* outputs, uint32_t numOfOutputs,
+                SnpeUdo_CpuInfrastructure_t* infrastructure, uint32_t numOfStaticParams, SnpeUdo_Param_t* params,
+                const UdoUtil::ConvKernelSet& kernels, UdoUtil::ConvKernelFn run,
+                UdoUtil::ActivationKernelFn exactActivation, const UdoUtil::ConvGeometry& geometry)
+        : UdoCpuOperation(inputs, numOfInputs, outputs, numOfOutputs, infrastructure, numOfStaticParams, params)
+        , m_Kernels(kernels)
+        , m_Run(run)
+        , m_ExactActivation(exactActivation)
+        , m_Geometry(geometry) {}
+
+    /**
+     * \brief Packs kernelHeight x kernelWidth x channels x units weights and the optional
+     * bias for the kernels.
+     * Called once by createOp, before preparePlan.
+     */
+    SnpeUdo_ErrorType_t packWeights(const float* weights, const float* bias);
+
+private:
+    /**
+     * \brief Fills the packed weights, bias, geometry and kernel into the plan.
+     */
+    SnpeUdo_ErrorType_t prepare() override;
+
+    /**
+     * \brief Updates the sizes and tiling of the plan for the current currDimensions.
+     * Does not allocate.
+     */
+    SnpeUdo_ErrorType_t reshape() override;
+
+    void runPlan(const void* in, void* out) override;
+
+    const UdoUtil::ConvKernelSet& m_Kernels;
+    UdoUtil::ConvKernelFn m_Run;
+    UdoUtil::ActivationKernelFn m_ExactActivation;
+    UdoUtil::ConvGeometry m_Geometry;
+    UdoUtil::UdoStaticBlobRef m_Packed;
+    const float* m_Weights = nullptr;
+    const float* m_Bias = nullptr;
+    Conv2dSeluExecutionPlan m_Plan;
+};
+
+/**
+ * @brief Op definition of Conv2dSelu. kernels is the convolution kernel set of the
+ * resolved kernel table and selu the table's Selu kernels, whose exact mode finishes
+ * exact ops.
+ */
+class Conv2dSeluOpDef : public UdoUtil::IUdoOpDefinition
+{
+public:
+    Conv2dSeluOpDef() = delete;
+    Conv2dSeluOpDef(const UdoUtil::ConvKernelSet& kernels, const UdoUtil::ActivationKernelSet& selu,
+                   uint32_t numOfInputs, uint32_t numOfOutputs)
+        : m_Kernels(kernels)
+        , m_Selu(selu)
+        , m_NumOfInputs(numOfInputs)
+        , m_NumOfOutputs(numOfOutputs)
+    {}
+
+    std::unique_ptr<UdoUtil::UdoOperation>
+    createOp(void* perOpInfrastucture,
+             uint32_t numOfInputs,
+             SnpeUdo_TensorParam_t* inputs,
+             uint32_t numOfOutputs,
+             SnpeUdo_TensorParam_t* outputs,
+             uint32_t numOfStaticParams,
+             SnpeUdo_Param_t* params) override;
+
+    const char* getOperationType() const override { return CONV2D_SELU_OP_TYPE; }
+
+private:
+    const UdoUtil::ConvKernelSet& m_Kernels;
+    const UdoUtil::ActivationKernelSet& m_Selu;
+    uint32_t m_NumOfInputs;
+    uint32_t m_NumOfOutputs;
+};
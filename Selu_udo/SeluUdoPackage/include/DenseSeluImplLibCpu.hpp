@@ -0,0 +1,108 @@
+//==============================================================================
+// Auto Generated Code for SeluUdoPackage
+//==============================================================================
+
+#pragma once
+
+#include <memory>
+
+#include "utils/IUdoOpDefinition.hpp"
+#include "utils/UdoCpuOperation.hpp"
+#include "utils/UdoDense.hpp"
+#include "SeluKernelsCpu.hpp"
+
+/**
+ * @brief Everything execute needs besides the tensors, see ActivationExecutionPlan.
+ * Only the row count depends on currDimensions, so a batch change redoes the tiling.
+ */
+struct DenseSeluExecutionPlan
+{
+    UdoUtil::DenseKernelArgs args = {nullptr, nullptr, nullptr, nullptr, 0, 0, 0, {0.0f, 0.0f}};
+    UdoUtil::DenseKernelFn run = nullptr;
+    UdoUtil::ActivationKernelFn exactActivation = nullptr;
+    UdoUtil::DenseTiling tiling = {0, 0, 0, 0, 0, 0, 0};
+};
+
+/**
+ * @brief Selu(in W + b) with float32 tensors. The weights are packed for the kernel
+ * into an aligned blob of the static tensor store, shared by ops with the same weights.
+ */
+class DenseSeluOp : public UdoUtil::UdoCpuOperation
+{
+public:
+    DenseSeluOp(SnpeUdo_TensorParam_t* inputs, uint32_t numOfInputs,
+                SnpeUdo_TensorParam_t* outputs, uint32_t numOfOutputs,
+                SnpeUdo_CpuInfrastructure_t* infrastructure, uint32_t numOfStaticParams, SnpeUdo_Param_t* params,
+                const UdoUtil::DenseKernelSet& kernels, UdoUtil::DenseKernelFn run,
+                UdoUtil::ActivationKernelFn exactActivation, size_t depth, size_t units)
+        : UdoCpuOperation(inputs, numOfInputs, outputs, numOfOutputs, infrastructure, numOfStaticParams, params)
+        , m_Kernels(kernels)
+        , m_Run(run)
+        , m_ExactActivation(exactActivation)
+        , m_Depth(depth)
+        , m_Units(units) {}
+
+    /**
+     * \brief Packs depth x units row major weights and the optional bias for the kernels.
+     * Called once by createOp, before preparePlan.
+     */
+    SnpeUdo_ErrorType_t packWeights(const float* weights, const float* bias);
+
+private:
+    /**
+     * \brief Fills the packed weights, bias and kernel into the plan.
+     */
+    SnpeUdo_ErrorType_t prepare() override;
+
+    /**
+     * \brief Updates the row count and tiling of the plan for the current currDimensions.
+     * Does not allocate.
+     */
+    SnpeUdo_ErrorType_t reshape() override;
+
+    void runPlan(const void* in, void* out) override;
+
+    const UdoUtil::DenseKernelSet& m_Kernels;
+    UdoUtil::DenseKernelFn m_Run;
+    UdoUtil::ActivationKernelFn m_ExactActivation;
+    size_t m_Depth;
+    size_t m_Units;
+    UdoUtil::UdoStaticBlobRef m_Packed;
+    const float* m_Weights = nullptr;
+    const float* m_Bias = nullptr;
+    DenseSeluExecutionPlan m_Plan;
+};
+
+/**
+ * @brief Op definition of DenseSelu. kernels is the dense kernel set of the resolved
+ * kernel table and selu the table's Selu kernels, whose exact mode finishes exact ops.
+ */
+class DenseSeluOpDef : public UdoUtil::IUdoOpDefinition
+{
+public:
+    DenseSeluOpDef() = delete;
+    DenseSeluOpDef(const UdoUtil::DenseKernelSet& kernels, const UdoUtil::ActivationKernelSet& selu,
+                   uint32_t numOfInputs, uint32_t numOfOutputs)
+        : m_Kernels(kernels)
+        , m_Selu(selu)
+        , m_NumOfInputs(numOfInputs)
+        , m_NumOfOutputs(numOfOutputs)
+    {}
+
+    std::unique_ptr<UdoUtil::UdoOperation>
+    createOp(void* perOpInfrastucture,
+             uint32_t numOfInputs,
+             SnpeUdo_TensorParam_t* inputs,
+             uint32_t numOfOutputs,
+             SnpeUdo_TensorParam_t* outputs,
+             uint32_t numOfStaticParams,
+             SnpeUdo_Param_t* params) override;
+
+    const char* getOperationType() const override { return DENSE_SELU_OP_TYPE; }
+
+private:
+    const UdoUtil::DenseKernelSet& m_Kernels;
+    const UdoUtil::ActivationKernelSet& m_Selu;
+    uint32_t m_NumOfInputs;
+    uint32_t m_NumOfOutputs;
+};
@@ -0,0 +1,97 @@
+//==============================================================================
+// Auto Generated Code for SeluUdoPackage
+//==============================================================================
+
+#pragma once
+
+#include <memory>
+
+#include "utils/IUdoOpDefinition.hpp"
+#include "utils/UdoCpuOperation.hpp"
+#include "utils/UdoExpression.hpp"
+#include "SeluKernelsCpu.hpp"
+
+/**
+ * @brief Everything execute needs besides the tensors, see ActivationExecutionPlan.
+ */
+struct FusedElementwiseExecutionPlan
+{
+    UdoUtil::ExprKernelArgs args = {nullptr, nullptr, nullptr, nullptr, UdoUtil::ACTIVATION_ACCURACY_FAST};
+    UdoUtil::ExprKernelFn run = nullptr;
+    UdoUtil::ElementPartition partition = {0, 0, 0};
+};
+
+/**
+ * @brief An elementwise expression of one float32 tensor, compiled by
+ * FusedElementwiseOpDef when the op is created.
+ */
+class FusedElementwiseOp : public UdoUtil::UdoCpuOperation
+{
+public:
+    FusedElementwiseOp(SnpeUdo_TensorParam_t* inputs, uint32_t numOfInputs,
+                       SnpeUdo_TensorParam_t* outputs, uint32_t numOfOutputs,
+                       SnpeUdo_CpuInfrastructure_t* infrastructure, uint32_t numOfStaticParams,
+                       SnpeUdo_Param_t* params, UdoUtil::ExprKernelFn run,
+                       const UdoUtil::ActivationKernelSet* activations, const UdoUtil::ExprProgram& program,
+                       UdoUtil::ActivationAccuracy accuracy)
+        : UdoCpuOperation(inputs, numOfInputs, outputs, numOfOutputs, infrastructure, numOfStaticParams, params)
+        , m_Run(run)
+        , m_Activations(activations)
+        , m_Program(program)
+        , m_Accuracy(accuracy) {}
+
+private:
+    /**
+     * \brief Fills the compiled expression and activations into the plan.
+     */
+    SnpeUdo_ErrorType_t prepare() override;
+
+    /**
+     * \brief Updates the element count and partition of the plan for the current
+     * currDimensions. Does not allocate.
+     */
+    SnpeUdo_ErrorType_t reshape() override;
+
+    void runPlan(const void* in, void* out) override;
+
+    UdoUtil::ExprKernelFn m_Run;
+    const UdoUtil::ActivationKernelSet* m_Activations;
+    UdoUtil::ExprProgram m_Program;
+    UdoUtil::ActivationAccuracy m_Accuracy;
+    FusedElementwiseExecutionPlan m_Plan;
+};
+
+/**
+ * @brief Op definition of FusedElementwise. run is the expression kernel of the
+ * resolved kernel table and activations the table's activations, in
+ * SeluPackageActivations order.
+ */
+class FusedElementwiseOpDef : public UdoUtil::IUdoOpDefinition
+{
+public:
+    FusedElementwiseOpDef() = delete;
+    FusedElementwiseOpDef(UdoUtil::ExprKernelFn run, const UdoUtil::ActivationKernelSet* activations,
+                          uint32_t numOfInputs, uint32_t numOfOutputs)
+        : m_Run(run)
+        , m_Activations(activations)
+        , m_NumOfInputs(numOfInputs)
+        , m_NumOfOutputs(numOfOutputs)
+    {}
+
+    std::unique_ptr<UdoUtil::UdoOperation>
+    createOp(void* perOpInfrastucture,
+             uint32_t numOfInputs,
+             SnpeUdo_TensorParam_t* inputs,
+             uint32_t numOfOutputs,
+             SnpeUdo_TensorParam_t* outputs,
+             uint32_t numOfStaticParams,
+             SnpeUdo_Param_t* params) override;
+
+    const char* getOperationType() const override { return FUSED_ELEMENTWISE_OP_TYPE; }
+
+private:
+    UdoUtil::ExprKernelFn m_Run;
+    const UdoUtil::ActivationKernelSet* m_Activations;
+    uint32_t m_NumOfInputs;
+    uint32_t m_NumOfOutputs;
+};
@@ -0,0 +1,84 @@
+//==============================================================================
+// CPU kernels for SeluUdoPackage
+//==============================================================================
+
+#pragma once
+
+#include <cstddef>
+
+#include "utils/UdoActivation.hpp"
+#include "utils/UdoConv.hpp"
+#include "utils/UdoDense.hpp"
+#include "utils/UdoExpression.hpp"
+#include "SeluParams.hpp"
+
+/**
+ * @brief Kernels of the package for one backend: every activation, in
+ * SeluPackageActivations order, the dense layer of DenseSelu, the convolution of
+ * Conv2dSelu and the expression evaluator of FusedElementwise.
+ *
+ * Selu float32 error against the correctly rounded result, measured over every
+ * negative float32 input, and single thread throughput of 1x56x56x64 fp32 on AVX-512
+ * (selu-bench):
+ *   exact  0 ulp                                ~6.7 ns/element, libm expm1 per element
+ *   fast   2 ulp                                ~0.38 ns/element
+ *   turbo  4.3e-4 relative (6962 ulp near -1)   ~0.32 ns/element
+ * Positive inputs are a single multiply and exact in every mode. See UdoActivation.hpp
+ * for the other activations. Float16 outputs are rounded once more from the float32
+ * result.
+ */
+struct SeluKernelTable
+{
+  const char* name;
+  UdoUtil::ActivationKernelSet activations[SELU_PACKAGE_NUM_ACTIVATIONS];
+  UdoUtil::DenseKernelSet denseSelu;
+  UdoUtil::ConvKernelSet conv2dSelu;
+  UdoUtil::ExprKernelFn fusedElementwise;
+};
+
+/**
+ * \brief The kernel table of backend V, instantiated by the SeluKernel<Isa>.cpp
+ * translation units. The exact mode is filled in by resolveSeluKernelTable().
+ */
+template <typename V, UdoUtil::Lut8Fn Lut8, UdoUtil::Interp16Fn Interp16, typename... Acts>
+SeluKernelTable
+makeSeluKernelTable(const char* name, UdoUtil::ActivationList<Acts...>)
+{
+  SeluKernelTable table = {name,
+                           {UdoUtil::makeActivationKernelSet<Acts, V, Lut8, Interp16>(name)...},
+                           UdoUtil::makeDenseKernelSet<UdoUtil::SeluActivation, V>(),
+                           UdoUtil::makeConvKernelSet<UdoUtil::SeluActivation, V>(),
+                           &UdoUtil::exprKernel<V>};
+  return table;
+}
+
+/**
+ * \brief Portable kernels on the scalar backend, always available.
+ */
+const SeluKernelTable*
+getSeluKernelTableScalar();
+
+/**
+ * \brief Accessors for the ISA specific kernels. Each returns nullptr when its
+ * translation unit was built without the matching instruction set enabled,
+ * so the caller must also check the CPU before using the result.
+ */
+const SeluKernelTable*
+getSeluKernelTableSse42();
+
+const SeluKernelTable*
+getSeluKernelTableAvx2();
+
+const SeluKernelTable*
+getSeluKernelTableAvx512();
+
+const SeluKernelTable*
+getSeluKernelTableNeon();
+
+/**
+ * \brief Returns the fastest kernels supported by both the build and the host CPU,
+ * with the exact mode kernels built for the baseline instruction set. The choice is
+ * made on the first call and reused for the lifetime of the process.
+ */
+const SeluKernelTable&
+resolveSeluKernelTable();
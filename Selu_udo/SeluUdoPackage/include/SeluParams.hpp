@@ -0,0 +1,294 @@
+//==============================================================================
+// Ops of SeluUdoPackage, shared by the registration and CPU libraries
+//==============================================================================
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "SnpeUdo/UdoBase.h"
+#include "utils/UdoActivation.hpp"
+#include "utils/UdoConv.hpp"
+#include "utils/UdoExpression.hpp"
+#include "utils/UdoParamSchema.hpp"
+
+/**
+ * @brief The elementwise activations the package registers, each as an op type of
+ * its own. Every one takes the optional params of UdoUtil::ACTIVATION_PARAM_SCHEMA,
+ * see UdoActivationParams.hpp. Kernel tables and registration follow this order.
+ */
+using SeluPackageActivations = UdoUtil::ActivationList<UdoUtil::SeluActivation,
+                                                       UdoUtil::EluActivation,
+                                                       UdoUtil::CeluActivation,
+                                                       UdoUtil::GeluActivation,
+                                                       UdoUtil::GeluTanhActivation,
+                                                       UdoUtil::SwishActivation,
+                                                       UdoUtil::HardSwishActivation>;
+
+constexpr size_t SELU_PACKAGE_NUM_ACTIVATIONS = SeluPackageActivations::size;
+
+/**
+ * \brief Op type, defaults and reference of every activation of the package, in
+ * SeluPackageActivations order.
+ */
+inline const UdoUtil::ActivationInfo*
+getSeluPackageActivations()
+{
+  return UdoUtil::getActivationInfos(SeluPackageActivations());
+}
+
+/**
+ * @brief DenseSelu, Selu(in W + b) in one op: a Dense layer with the Selu fused into
+ * the store. Static params:
+ *
+ *   weights        FLOAT_32 tensor, depth x units row major like a Keras Dense kernel
+ *   bias           FLOAT_32 tensor of units, optional
+ *   accuracy_mode  UINT_32  as for the activations, see ActivationAccuracy
+ *
+ * The input is rows x depth and the output rows x units, with any leading dimensions
+ * folded into rows. The Selu uses its default alpha and scale.
+ */
+constexpr const char* DENSE_SELU_OP_TYPE = "DenseSelu";
+constexpr const char* DENSE_SELU_WEIGHTS_PARAM = "weights";
+constexpr const char* DENSE_SELU_BIAS_PARAM = "bias";
+
+enum DenseSeluParamSlot : size_t
+{
+  DENSE_SELU_PARAM_WEIGHTS = 0,
+  DENSE_SELU_PARAM_BIAS,
+  DENSE_SELU_PARAM_ACCURACY_MODE,
+  DENSE_SELU_NUM_PARAMS
+};
+
+constexpr UdoUtil::UdoParamSpec DENSE_SELU_PARAM_SCHEMA[DENSE_SELU_NUM_PARAMS] = {
+  UdoUtil::tensorParamSpec(DENSE_SELU_WEIGHTS_PARAM, SNPE_UDO_DATATYPE_FLOAT_32, true),
+  UdoUtil::tensorParamSpec(DENSE_SELU_BIAS_PARAM, SNPE_UDO_DATATYPE_FLOAT_32, false),
+  UdoUtil::scalarParamSpec<uint32_t>(UdoUtil::ACTIVATION_ACCURACY_MODE_PARAM, false),
+};
+
+using DenseSeluParamTable = UdoUtil::UdoParamTable<DENSE_SELU_NUM_PARAMS>;
+
+/**
+ * \brief Resolves the static params of DenseSelu and the layer size they imply.
+ * @return SNPE_UDO_WRONG_NUM_OF_DIMENSIONS for weights that are not a non-empty matrix
+ *         or a bias that is not a vector of units, SNPE_UDO_INVALID_ARGUMENT for an
+ *         unknown accuracy_mode, otherwise the status of UdoParamTable::resolve()
+ */
+inline SnpeUdo_ErrorType_t
+resolveDenseSeluParams(const SnpeUdo_Param_t* params, size_t numOfParams, DenseSeluParamTable& table,
+                       size_t& depth, size_t& units, UdoUtil::ActivationAccuracy& accuracy)
+{
+  const SnpeUdo_ErrorType_t status = table.resolve(DENSE_SELU_PARAM_SCHEMA, params, numOfParams);
+  if (status != SNPE_UDO_NO_ERROR)
+  {
+    return status;
+  }
+  const SnpeUdo_TensorParam_t& weights = *table.getTensor(DENSE_SELU_PARAM_WEIGHTS);
+  if (weights.tensorRank != 2 || weights.currDimensions == nullptr ||
+      weights.currDimensions[0] == 0 || weights.currDimensions[1] == 0)
+  {
+    return SNPE_UDO_WRONG_NUM_OF_DIMENSIONS;
+  }
+  depth = weights.currDimensions[0];
+  units = weights.currDimensions[1];
+
+  const SnpeUdo_TensorParam_t* bias = table.getTensor(DENSE_SELU_PARAM_BIAS);
+  if (bias != nullptr && (bias->tensorRank != 1 || bias->currDimensions == nullptr || bias->currDimensions[0] != units))
+  {
+    return SNPE_UDO_WRONG_NUM_OF_DIMENSIONS;
+  }
+
+  const uint32_t mode = table.getScalar<uint32_t>(DENSE_SELU_PARAM_ACCURACY_MODE, UdoUtil::ACTIVATION_ACCURACY_FAST);
+  if (!UdoUtil::isValidActivationAccuracy(mode))
+  {
+    return SNPE_UDO_INVALID_ARGUMENT;
+  }
+  accuracy = static_cast<UdoUtil::ActivationAccuracy>(mode);
+  return SNPE_UDO_NO_ERROR;
+}
+
+/**
+ * @brief Conv2dSelu, Selu(conv(in, W) + b) in one op: a Conv2D layer of NHWC tensors
+ * with the Selu fused into the store. Static params:
+ *
+ *   weights          FLOAT_32 tensor, kernelHeight x kernelWidth x channels x units like
+ *                    a Keras Conv2D kernel
+ *   bias             FLOAT_32 tensor of units, optional
+ *   stride_h         UINT_32  vertical stride, 1 by default
+ *   stride_w         UINT_32  horizontal stride, 1 by default
+ *   pad_top          UINT_32  zero rows above the input, 0 by default
+ *   pad_left         UINT_32  zero columns left of the input, 0 by default
+ *   accuracy_mode    UINT_32  as for the activations, see ActivationAccuracy
+ *
+ * The input is batch x height x width x channels and the output batch x outHeight x
+ * outWidth x units; the output size sets the bottom and right padding, so both Keras
+ * "valid" and "same" convolutions map onto it. The Selu uses its default alpha and scale.
+ */
+constexpr const char* CONV2D_SELU_OP_TYPE = "Conv2dSelu";
+constexpr const char* CONV2D_SELU_WEIGHTS_PARAM = "weights";
+constexpr const char* CONV2D_SELU_BIAS_PARAM = "bias";
+constexpr const char* CONV2D_SELU_STRIDE_H_PARAM = "stride_h";
+constexpr const char* CONV2D_SELU_STRIDE_W_PARAM = "stride_w";
+constexpr const char* CONV2D_SELU_PAD_TOP_PARAM = "pad_top";
+constexpr const char* CONV2D_SELU_PAD_LEFT_PARAM = "pad_left";
+
+enum Conv2dSeluParamSlot : size_t
+{
+  CONV2D_SELU_PARAM_WEIGHTS = 0,
+  CONV2D_SELU_PARAM_BIAS,
+  CONV2D_SELU_PARAM_STRIDE_H,
+  CONV2D_SELU_PARAM_STRIDE_W,
+  CONV2D_SELU_PARAM_PAD_TOP,
+  CONV2D_SELU_PARAM_PAD_LEFT,
+  CONV2D_SELU_PARAM_ACCURACY_MODE,
+  CONV2D_SELU_NUM_PARAMS
+};
+
+constexpr UdoUtil::UdoParamSpec CONV2D_SELU_PARAM_SCHEMA[CONV2D_SELU_NUM_PARAMS] = {
+  UdoUtil::tensorParamSpec(CONV2D_SELU_WEIGHTS_PARAM, SNPE_UDO_DATATYPE_FLOAT_32, true),
+  UdoUtil::tensorParamSpec(CONV2D_SELU_BIAS_PARAM, SNPE_UDO_DATATYPE_FLOAT_32, false),
+  UdoUtil::scalarParamSpec<uint32_t>(CONV2D_SELU_STRIDE_H_PARAM, false),
+  UdoUtil::scalarParamSpec<uint32_t>(CONV2D_SELU_STRIDE_W_PARAM, false),
+  UdoUtil::scalarParamSpec<uint32_t>(CONV2D_SELU_PAD_TOP_PARAM, false),
+  UdoUtil::scalarParamSpec<uint32_t>(CONV2D_SELU_PAD_LEFT_PARAM, false),
+  UdoUtil::scalarParamSpec<uint32_t>(UdoUtil::ACTIVATION_ACCURACY_MODE_PARAM, false),
+};
+
+using Conv2dSeluParamTable = UdoUtil::UdoParamTable<CONV2D_SELU_NUM_PARAMS>;
+
+/**
+ * \brief Resolves the static params of Conv2dSelu and the geometry they imply.
+ * @return SNPE_UDO_WRONG_NUM_OF_DIMENSIONS for weights that are not a non-empty 4D
+ *         tensor or a bias that is not a vector of units, SNPE_UDO_INVALID_ARGUMENT for
+ *         a zero stride, padding as large as the window or an unknown accuracy_mode,
+ *         otherwise the status of UdoParamTable::resolve()
+ */
+inline SnpeUdo_ErrorType_t
+resolveConv2dSeluParams(const SnpeUdo_Param_t* params, size_t numOfParams, Conv2dSeluParamTable& table,
+                        UdoUtil::ConvGeometry& geometry, UdoUtil::ActivationAccuracy& accuracy)
+{
+  const SnpeUdo_ErrorType_t status = table.resolve(CONV2D_SELU_PARAM_SCHEMA, params, numOfParams);
+  if (status != SNPE_UDO_NO_ERROR)
+  {
+    return status;
+  }
+  const SnpeUdo_TensorParam_t& weights = *table.getTensor(CONV2D_SELU_PARAM_WEIGHTS);
+  if (weights.tensorRank != 4 || weights.currDimensions == nullptr ||
+      std::find(weights.currDimensions, weights.currDimensions + 4, 0u) != weights.currDimensions + 4)
+  {
+    return SNPE_UDO_WRONG_NUM_OF_DIMENSIONS;
+  }
+  geometry.kernelHeight = weights.currDimensions[0];
+  geometry.kernelWidth = weights.currDimensions[1];
+  geometry.channels = weights.currDimensions[2];
+  geometry.units = weights.currDimensions[3];
+
+  const SnpeUdo_TensorParam_t* bias = table.getTensor(CONV2D_SELU_PARAM_BIAS);
+  if (bias != nullptr &&
+      (bias->tensorRank != 1 || bias->currDimensions == nullptr || bias->currDimensions[0] != geometry.units))
+  {
+    return SNPE_UDO_WRONG_NUM_OF_DIMENSIONS;
+  }
+
+  geometry.strideHeight = table.getScalar<uint32_t>(CONV2D_SELU_PARAM_STRIDE_H, 1);
+  geometry.strideWidth = table.getScalar<uint32_t>(CONV2D_SELU_PARAM_STRIDE_W, 1);
+  geometry.padTop = table.getScalar<uint32_t>(CONV2D_SELU_PARAM_PAD_TOP, 0);
+  geometry.padLeft = table.getScalar<uint32_t>(CONV2D_SELU_PARAM_PAD_LEFT, 0);
+  if (geometry.strideHeight == 0 || geometry.strideWidth == 0 ||
+      geometry.padTop >= geometry.kernelHeight || geometry.padLeft >= geometry.kernelWidth)
+  {
+    return SNPE_UDO_INVALID_ARGUMENT;
+  }
+
+  const uint32_t mode = table.getScalar<uint32_t>(CONV2D_SELU_PARAM_ACCURACY_MODE, UdoUtil::ACTIVATION_ACCURACY_FAST);
+  if (!UdoUtil::isValidActivationAccuracy(mode))
+  {
+    return SNPE_UDO_INVALID_ARGUMENT;
+  }
+  accuracy = static_cast<UdoUtil::ActivationAccuracy>(mode);
+  return SNPE_UDO_NO_ERROR;
+}
+
+/**
+ * @brief FusedElementwise, a chain of elementwise ops in one pass: the expression
+ * param is compiled once, see UdoExpression.hpp. Static params:
+ *
+ *   expression     STRING   e.g. "selu(x * a + b)", x being the input element and the
+ *                           activations of SeluPackageActivations callable by name
+ *   a, b, c, d     FLOAT_32 values of the names a to d in the expression, 0 by default
+ *   accuracy_mode  UINT_32  of the activations in the expression, see ActivationAccuracy
+ *
+ * Input and output are float32 tensors of the same shape.
+ */
+constexpr const char* FUSED_ELEMENTWISE_OP_TYPE = "FusedElementwise";
+constexpr const char* FUSED_ELEMENTWISE_EXPRESSION_PARAM = "expression";
+
+enum FusedElementwiseParamSlot : size_t
+{
+  FUSED_ELEMENTWISE_PARAM_EXPRESSION = 0,
+  FUSED_ELEMENTWISE_PARAM_A,
+  FUSED_ELEMENTWISE_PARAM_B,
+  FUSED_ELEMENTWISE_PARAM_C,
+  FUSED_ELEMENTWISE_PARAM_D,
+  FUSED_ELEMENTWISE_PARAM_ACCURACY_MODE,
+  FUSED_ELEMENTWISE_NUM_PARAMS
+};
+
+// the variable params, in slot order from FUSED_ELEMENTWISE_PARAM_A
+constexpr size_t FUSED_ELEMENTWISE_NUM_VARIABLES = 4;
+constexpr const char* FUSED_ELEMENTWISE_VARIABLE_NAMES[FUSED_ELEMENTWISE_NUM_VARIABLES] = {"a", "b", "c", "d"};
+
+constexpr UdoUtil::UdoParamSpec FUSED_ELEMENTWISE_PARAM_SCHEMA[FUSED_ELEMENTWISE_NUM_PARAMS] = {
+  UdoUtil::stringParamSpec(FUSED_ELEMENTWISE_EXPRESSION_PARAM, true),
+  UdoUtil::scalarParamSpec<float>(FUSED_ELEMENTWISE_VARIABLE_NAMES[0], false),
+  UdoUtil::scalarParamSpec<float>(FUSED_ELEMENTWISE_VARIABLE_NAMES[1], false),
+  UdoUtil::scalarParamSpec<float>(FUSED_ELEMENTWISE_VARIABLE_NAMES[2], false),
+  UdoUtil::scalarParamSpec<float>(FUSED_ELEMENTWISE_VARIABLE_NAMES[3], false),
+  UdoUtil::scalarParamSpec<uint32_t>(UdoUtil::ACTIVATION_ACCURACY_MODE_PARAM, false),
+};
+
+using FusedElementwiseParamTable = UdoUtil::UdoParamTable<FUSED_ELEMENTWISE_NUM_PARAMS>;
+
+/**
+ * \brief Resolves the static params of FusedElementwise and compiles its expression
+ * into program, with the activations of the package in SeluPackageActivations order.
+ * @return SNPE_UDO_INVALID_ARGUMENT with error filled in for an expression that does
+ *         not compile, SNPE_UDO_INVALID_ARGUMENT for a variable that is not finite or
+ *         an unknown accuracy_mode, otherwise the status of UdoParamTable::resolve()
+ */
+inline SnpeUdo_ErrorType_t
+resolveFusedElementwiseParams(const SnpeUdo_Param_t* params, size_t numOfParams, FusedElementwiseParamTable& table,
+                              UdoUtil::ExprProgram& program, UdoUtil::ExprError& error,
+                              UdoUtil::ActivationAccuracy& accuracy)
+{
+  error.position = 0;
+  error.message = nullptr;
+  const SnpeUdo_ErrorType_t status = table.resolve(FUSED_ELEMENTWISE_PARAM_SCHEMA, params, numOfParams);
+  if (status != SNPE_UDO_NO_ERROR)
+  {
+    return status;
+  }
+  UdoUtil::ExprVariable variables[FUSED_ELEMENTWISE_NUM_VARIABLES];
+  for (size_t idx = 0; idx < FUSED_ELEMENTWISE_NUM_VARIABLES; idx++)
+  {
+    variables[idx].name = FUSED_ELEMENTWISE_VARIABLE_NAMES[idx];
+    variables[idx].value = table.getScalar<float>(FUSED_ELEMENTWISE_PARAM_A + idx, 0.0f);
+    if (!std::isfinite(variables[idx].value))
+    {
+      return SNPE_UDO_INVALID_ARGUMENT;
+    }
+  }
+
+  const uint32_t mode = table.getScalar<uint32_t>(FUSED_ELEMENTWISE_PARAM_ACCURACY_MODE,
+                                                  UdoUtil::ACTIVATION_ACCURACY_FAST);
+  if (!UdoUtil::isValidActivationAccuracy(mode))
+  {
+    return SNPE_UDO_INVALID_ARGUMENT;
+  }
+  accuracy = static_cast<UdoUtil::ActivationAccuracy>(mode);
+  return UdoUtil::compileExpression(table.getString(FUSED_ELEMENTWISE_PARAM_EXPRESSION),
+                                    variables, FUSED_ELEMENTWISE_NUM_VARIABLES,
+                                    getSeluPackageActivations(), SELU_PACKAGE_NUM_ACTIVATIONS, program, error);
+}
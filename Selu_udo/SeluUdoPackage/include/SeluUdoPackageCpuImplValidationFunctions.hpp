@@ -4,12 +4,62 @@
 
 #pragma once
 
+#include "utils/UdoActivationParams.hpp"
 #include "utils/UdoUtil.hpp"
 
-class SeluCpuValidationFunction : public UdoUtil::ImplValidationFunction {
+/**
+ * @brief Validation of one activation op of the package. Every activation has the
+ * same tensors and param schema, they only differ in their op type and params.
+ */
+class ActivationCpuValidationFunction : public UdoUtil::ImplValidationFunction {
 public:
 
-    SeluCpuValidationFunction()
+    explicit ActivationCpuValidationFunction(const UdoUtil::ActivationInfo& info)
+            : ImplValidationFunction(), m_Info(info) {}
+
+    SnpeUdo_ErrorType_t
+    validateOperation(SnpeUdo_OpDefinition_t* def) override;
+
+private:
+    const UdoUtil::ActivationInfo& m_Info;
+};
+
+/**
+ * @brief Validation of DenseSelu: its weights and bias params and float32 tensors
+ * whose last dimensions match them.
+ */
+class DenseSeluCpuValidationFunction : public UdoUtil::ImplValidationFunction {
+public:
+
+    DenseSeluCpuValidationFunction()
+            : ImplValidationFunction() {}
+
+    SnpeUdo_ErrorType_t
+    validateOperation(SnpeUdo_OpDefinition_t* def) override;
+};
+
+/**
+ * @brief Validation of Conv2dSelu: its weights, bias, stride and padding params and
+ * float32 NHWC tensors whose channels and sizes match them.
+ */
+class Conv2dSeluCpuValidationFunction : public UdoUtil::ImplValidationFunction {
+public:
+
+    Conv2dSeluCpuValidationFunction()
+            : ImplValidationFunction() {}
+
+    SnpeUdo_ErrorType_t
+    validateOperation(SnpeUdo_OpDefinition_t* def) override;
+};
+
+/**
+ * @brief Validation of FusedElementwise: an expression param that compiles and
+ * float32 tensors of the same shape.
+ */
+class FusedElementwiseCpuValidationFunction : public UdoUtil::ImplValidationFunction {
+public:
+
+    FusedElementwiseCpuValidationFunction()
             : ImplValidationFunction() {}
 
     SnpeUdo_ErrorType_t
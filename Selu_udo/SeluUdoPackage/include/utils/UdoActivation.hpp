@@ -0,0 +1,517 @@
+//==============================================================================
+//
+// Copyright (c) 2020 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "utils/UdoActivationParams.hpp"
+#include "utils/UdoQuantize.hpp"
+#include "utils/UdoSimd.hpp"
+
+/**
+ * Elementwise activations written once as functors and run by shared kernels.
+ *
+ * An activation is a traits struct with
+ *   name()               op type it is registered as
+ *   defaults()           alpha and scale of an op created without them
+ *   USES_ALPHA           whether the op takes the alpha param
+ *   acceptsParams(p)     domain restrictions on alpha and scale
+ *   reference(x, p)      scale * f(x) in double, for exact kernels and quantized tables
+ *   Vec<V, Mode>         functor computing scale * f(x) on one register of backend V,
+ *                        constructed from the op's params
+ *
+ * makeActivationKernelSet() instantiates the float kernels of one activation for one
+ * backend, which also gives it the backend's quantized lookups; UdoActivationOp runs
+ * the kernels threaded over the tensor. A new activation only needs its traits.
+ *
+ * Float32 error against the correctly rounded reference(), sampled over all float32
+ * inputs with results of at least 1e-30 in magnitude:
+ *               exact   fast                            turbo
+ *   Selu        0 ulp   2 ulp                           4.4e-4 relative
+ *   Elu, Celu   0 ulp   1 ulp                           4.4e-4 relative
+ *   Gelu        0 ulp   25 ulp above -4, 1.4e-5 below   1.9e-4 relative
+ *   GeluTanh    0 ulp   17 ulp above -4, 9.2e-6 below   1.9e-4 relative
+ *   Swish       0 ulp   3 ulp                           1.8e-4 relative
+ *   HardSwish   0 ulp   2 ulp                           2 ulp
+ * Below -4 both Gelu results are under 2e-4 in magnitude, and their error comes from
+ * rounding the exp argument to float32 rather than from the exp itself.
+ */
+namespace UdoUtil {
+
+using Lut8Fn = void (*)(const uint8_t* table, const uint8_t* in, uint8_t* out, size_t count);
+using Interp16Fn = void (*)(const InterpTable16& table, const uint16_t* in, uint16_t* out, size_t count);
+
+/**
+ * @brief The exp based building blocks of the activations, in the precision of Mode.
+ */
+template <typename V, ActivationAccuracy Mode>
+struct ActivationMath
+{
+  using Reg = typename V::Reg;
+
+  static Reg expm1NonPositive(Reg x)
+  {
+    return Mode == ACTIVATION_ACCURACY_TURBO ? Simd::expm1NonPositiveTurbo<V>(x) : Simd::expm1NonPositive<V>(x);
+  }
+
+  static Reg expNonPositive(Reg x)
+  {
+    return Mode == ACTIVATION_ACCURACY_TURBO ? Simd::expNonPositiveTurbo<V>(x) : Simd::expNonPositive<V>(x);
+  }
+
+  /**
+   * \brief 1 / (1 + exp(-x)), from e = exp(-|x|) so that exp never overflows:
+   * 1 / (1 + e) for x > 0 and e / (1 + e) otherwise.
+   */
+  static Reg sigmoid(Reg x)
+  {
+    const Reg zero = V::zero();
+    const Reg e = expNonPositive(V::min(x, V::sub(zero, x)));
+    const Reg s = V::div(V::set1(1.0f), V::add(V::set1(1.0f), e));
+    return V::select(V::cmpgt(x, zero), s, V::mul(e, s));
+  }
+};
+
+/**
+ * @brief scale * x for x > 0, scale * alpha * expm1(x) otherwise, or expm1(x / alpha)
+ * when ScaleInput is set. Both halves are computed and merged with a mask, so the
+ * kernels have no data dependent branches.
+ */
+template <typename V, ActivationAccuracy Mode, bool ScaleInput>
+struct ExpLinearVec
+{
+  using Reg = typename V::Reg;
+
+  explicit ExpLinearVec(const ActivationParams& params)
+    : m_Scale(V::set1(params.scale))
+    , m_NegScale(V::set1(params.scale * params.alpha))
+    , m_InvAlpha(V::set1(ScaleInput ? 1.0f / params.alpha : 1.0f)) {}
+
+  Reg operator()(Reg x) const
+  {
+    const Reg zero = V::zero();
+    const Reg pos = V::mul(x, m_Scale);
+    Reg neg = V::min(zero, x);
+    if (ScaleInput)
+    {
+      neg = V::mul(neg, m_InvAlpha);
+    }
+    neg = V::mul(ActivationMath<V, Mode>::expm1NonPositive(neg), m_NegScale);
+    return V::select(V::cmpgt(x, zero), pos, neg);
+  }
+
+  Reg m_Scale;
+  Reg m_NegScale;
+  Reg m_InvAlpha;
+};
+
+inline bool
+acceptsAnyActivationParams(const ActivationParams&)
+{
+  return true;
+}
+
+/**
+ * @brief SELU from Klambauer et al., "Self-Normalizing Neural Networks".
+ */
+struct SeluActivation
+{
+  static const char* name() { return "Selu"; }
+  static ActivationParams defaults() { return ActivationParams{1.67326324f, 1.05070098f}; }
+  static constexpr bool USES_ALPHA = true;
+  static bool acceptsParams(const ActivationParams& params) { return acceptsAnyActivationParams(params); }
+
+  static double reference(double x, const ActivationParams& params)
+  {
+    return x > 0.0 ? params.scale * x : double(params.scale) * params.alpha * std::expm1(x);
+  }
+
+  template <typename V, ActivationAccuracy Mode>
+  using Vec = ExpLinearVec<V, Mode, false>;
+};
+
+/**
+ * @brief ELU, SELU with alpha and scale defaulting to 1.
+ */
+struct EluActivation
+{
+  static const char* name() { return "Elu"; }
+  static ActivationParams defaults() { return ActivationParams{1.0f, 1.0f}; }
+  static constexpr bool USES_ALPHA = true;
+  static bool acceptsParams(const ActivationParams& params) { return acceptsAnyActivationParams(params); }
+
+  static double reference(double x, const ActivationParams& params)
+  {
+    return SeluActivation::reference(x, params);
+  }
+
+  template <typename V, ActivationAccuracy Mode>
+  using Vec = ExpLinearVec<V, Mode, false>;
+};
+
+/**
+ * @brief CELU, alpha * expm1(x / alpha) for x <= 0, continuously differentiable for
+ * any alpha > 0.
+ */
+struct CeluActivation
+{
+  static const char* name() { return "Celu"; }
+  static ActivationParams defaults() { return ActivationParams{1.0f, 1.0f}; }
+  static constexpr bool USES_ALPHA = true;
+  static bool acceptsParams(const ActivationParams& params) { return params.alpha > 0.0f; }
+
+  static double reference(double x, const ActivationParams& params)
+  {
+    return x > 0.0 ? params.scale * x : double(params.scale) * params.alpha * std::expm1(x / params.alpha);
+  }
+
+  template <typename V, ActivationAccuracy Mode>
+  using Vec = ExpLinearVec<V, Mode, true>;
+};
+
+/**
+ * @brief GELU, x * Phi(x) = x / 2 * erfc(-x / sqrt(2)).
+ */
+struct GeluActivation
+{
+  static const char* name() { return "Gelu"; }
+  static ActivationParams defaults() { return ActivationParams{0.0f, 1.0f}; }
+  static constexpr bool USES_ALPHA = false;
+  static bool acceptsParams(const ActivationParams& params) { return acceptsAnyActivationParams(params); }
+
+  static double reference(double x, const ActivationParams& params)
+  {
+    return params.scale * 0.5 * x * std::erfc(-x * 0.70710678118654752440);
+  }
+
+  /**
+   * erfc(z) for z = |x| / sqrt(2) is t * exp(-z^2 + P(t)) with t = 1 / (1 + z / 2),
+   * the Chebyshev fit of Numerical Recipes' erfcc, fractional error below 1.2e-7.
+   * GELU is then x - x / 2 * erfc(z) for x > 0 and x / 2 * erfc(z) otherwise.
+   */
+  template <typename V, ActivationAccuracy Mode>
+  struct Vec
+  {
+    using Reg = typename V::Reg;
+
+    explicit Vec(const ActivationParams& params) : m_Scale(V::set1(params.scale)) {}
+
+    Reg operator()(Reg x) const
+    {
+      const Reg zero = V::zero();
+      const Reg one = V::set1(1.0f);
+      const Reg z = V::mul(V::max(x, V::sub(zero, x)), V::set1(0.707106781f));
+      const Reg t = V::div(one, V::fmadd(z, V::set1(0.5f), one));
+      Reg p = V::set1(0.17087277f);
+      p = V::fmadd(p, t, V::set1(-0.82215223f));
+      p = V::fmadd(p, t, V::set1(1.48851587f));
+      p = V::fmadd(p, t, V::set1(-1.13520398f));
+      p = V::fmadd(p, t, V::set1(0.27886807f));
+      p = V::fmadd(p, t, V::set1(-0.18628806f));
+      p = V::fmadd(p, t, V::set1(0.09678418f));
+      p = V::fmadd(p, t, V::set1(0.37409196f));
+      p = V::fmadd(p, t, V::set1(1.00002368f));
+      p = V::fmadd(p, t, V::set1(-1.26551223f));
+      // P(t) - z^2 is at most a few ulp above 0, which exp handles
+      const Reg erfc = V::mul(t, ActivationMath<V, Mode>::expNonPositive(V::fnmadd(z, z, p)));
+      const Reg half = V::mul(V::mul(x, V::set1(0.5f)), erfc);
+      return V::mul(V::select(V::cmpgt(x, zero), V::sub(x, half), half), m_Scale);
+    }
+
+    Reg m_Scale;
+  };
+};
+
+/**
+ * @brief GELU with the tanh approximation of Hendrycks and Gimpel,
+ * x / 2 * (1 + tanh(u)) with u = sqrt(2 / pi) * (x + 0.044715 x^3), evaluated as
+ * x * sigmoid(2u), which does not cancel for negative x.
+ */
+struct GeluTanhActivation
+{
+  static const char* name() { return "GeluTanh"; }
+  static ActivationParams defaults() { return ActivationParams{0.0f, 1.0f}; }
+  static constexpr bool USES_ALPHA = false;
+  static bool acceptsParams(const ActivationParams& params) { return acceptsAnyActivationParams(params); }
+
+  static double reference(double x, const ActivationParams& params)
+  {
+    const double u = 0.79788456080286535588 * (x + 0.044715 * x * x * x);
+    return params.scale * x / (1.0 + std::exp(-2.0 * u));
+  }
+
+  template <typename V, ActivationAccuracy Mode>
+  struct Vec
+  {
+    using Reg = typename V::Reg;
+
+    explicit Vec(const ActivationParams& params) : m_Scale(V::set1(params.scale)) {}
+
+    Reg operator()(Reg x) const
+    {
+      const Reg twoU = V::mul(x, V::fmadd(V::mul(x, x), V::set1(0.0713548163f), V::set1(1.59576912f)));
+      return V::mul(V::mul(x, m_Scale), ActivationMath<V, Mode>::sigmoid(twoU));
+    }
+
+    Reg m_Scale;
+  };
+};
+
+/**
+ * @brief Swish with beta 1, also known as SiLU, x * sigmoid(x).
+ */
+struct SwishActivation
+{
+  static const char* name() { return "Swish"; }
+  static ActivationParams defaults() { return ActivationParams{0.0f, 1.0f}; }
+  static constexpr bool USES_ALPHA = false;
+  static bool acceptsParams(const ActivationParams& params) { return acceptsAnyActivationParams(params); }
+
+  static double reference(double x, const ActivationParams& params)
+  {
+    return params.scale * x / (1.0 + std::exp(-x));
+  }
+
+  template <typename V, ActivationAccuracy Mode>
+  struct Vec
+  {
+    using Reg = typename V::Reg;
+
+    explicit Vec(const ActivationParams& params) : m_Scale(V::set1(params.scale)) {}
+
+    Reg operator()(Reg x) const
+    {
+      return V::mul(V::mul(x, m_Scale), ActivationMath<V, Mode>::sigmoid(x));
+    }
+
+    Reg m_Scale;
+  };
+};
+
+/**
+ * @brief HardSwish from MobileNetV3, x * relu6(x + 3) / 6. It has no exp, so every
+ * accuracy mode computes the same float32 result.
+ */
+struct HardSwishActivation
+{
+  static const char* name() { return "HardSwish"; }
+  static ActivationParams defaults() { return ActivationParams{0.0f, 1.0f}; }
+  static constexpr bool USES_ALPHA = false;
+  static bool acceptsParams(const ActivationParams& params) { return acceptsAnyActivationParams(params); }
+
+  static double reference(double x, const ActivationParams& params)
+  {
+    return params.scale * x * std::min(std::max(x + 3.0, 0.0), 6.0) / 6.0;
+  }
+
+  template <typename V, ActivationAccuracy Mode>
+  struct Vec
+  {
+    using Reg = typename V::Reg;
+
+    explicit Vec(const ActivationParams& params) : m_ScaleSixth(V::set1(params.scale / 6.0f)) {}
+
+    Reg operator()(Reg x) const
+    {
+      // scaling relu6 first keeps x * 6 from overflowing near the float max
+      const Reg relu6 = V::min(V::max(V::add(x, V::set1(3.0f)), V::zero()), V::set1(6.0f));
+      return V::mul(x, V::mul(relu6, m_ScaleSixth));
+    }
+
+    Reg m_ScaleSixth;
+  };
+};
+
+/**
+ * @brief A list of activation traits, e.g. the activations one package registers.
+ */
+template <typename... Acts>
+struct ActivationList
+{
+  static constexpr size_t size = sizeof...(Acts);
+};
+
+/**
+ * @brief Position of activation Act in a list, for tables kept in list order.
+ */
+template <typename Act, typename List>
+struct ActivationIndex;
+
+template <typename Act, typename... Rest>
+struct ActivationIndex<Act, ActivationList<Act, Rest...>>
+{
+  static constexpr size_t value = 0;
+};
+
+template <typename Act, typename First, typename... Rest>
+struct ActivationIndex<Act, ActivationList<First, Rest...>>
+{
+  static constexpr size_t value = 1 + ActivationIndex<Act, ActivationList<Rest...>>::value;
+};
+
+template <typename Act>
+ActivationInfo
+makeActivationInfo()
+{
+  ActivationInfo info = {Act::name(), Act::defaults(), Act::USES_ALPHA, &Act::acceptsParams, &Act::reference};
+  return info;
+}
+
+/**
+ * \brief ActivationInfo of every activation in the list, in list order.
+ */
+template <typename... Acts>
+const ActivationInfo*
+getActivationInfos(ActivationList<Acts...>)
+{
+  static const ActivationInfo infos[] = {makeActivationInfo<Acts>()...};
+  return infos;
+}
+
+/**
+ * @brief Operands of a prepared activation call. table is the lut8 or interp16 table
+ * of an ActivationQuantTable for quantized tensors and unused otherwise.
+ */
+struct ActivationKernelArgs
+{
+  const void* in;
+  void* out;
+  const void* table;
+  ActivationParams params;
+};
+
+/**
+ * @brief Computes out[i] = f(in[i]) for i in [begin, end). Every entry point has
+ * this signature, so a prepared op runs any data type through one indirect call.
+ */
+using ActivationKernelFn = void (*)(const ActivationKernelArgs& args, size_t begin, size_t end);
+
+/**
+ * @brief Float entry points for one accuracy mode. They load and store the named
+ * element types and do the math in float32, or in double for the exact mode.
+ */
+struct ActivationFloatKernels
+{
+  ActivationKernelFn f32;
+  ActivationKernelFn f16;
+  ActivationKernelFn f16ToF32;
+  ActivationKernelFn f32ToF16;
+};
+
+/**
+ * @brief Entry points of one activation for one backend, float ones per accuracy mode.
+ * The quantized entries apply a table built for the tensors' encodings and do not
+ * depend on the activation. in and out may alias when their types match.
+ */
+struct ActivationKernelSet
+{
+  const char* name;
+  ActivationFloatKernels modes[ACTIVATION_NUM_ACCURACY_MODES];
+  ActivationKernelFn lut8;
+  ActivationKernelFn interp16;
+};
+
+/**
+ * \brief The float kernel of every activation, instantiated per backend by the
+ * ISA specific translation units.
+ */
+template <typename Act, typename V, ActivationAccuracy Mode, typename InT, typename OutT>
+void
+activationKernel(const ActivationKernelArgs& args, size_t begin, size_t end)
+{
+  Simd::transform<V>(static_cast<const InT*>(args.in) + begin,
+                     static_cast<OutT*>(args.out) + begin,
+                     end - begin,
+                     typename Act::template Vec<V, Mode>(args.params));
+}
+
+template <typename Act, typename V, ActivationAccuracy Mode>
+ActivationFloatKernels
+makeActivationFloatKernels()
+{
+  ActivationFloatKernels kernels = {&activationKernel<Act, V, Mode, float, float>,
+                                    &activationKernel<Act, V, Mode, Simd::Half, Simd::Half>,
+                                    &activationKernel<Act, V, Mode, Simd::Half, float>,
+                                    &activationKernel<Act, V, Mode, float, Simd::Half>};
+  return kernels;
+}
+
+template <Lut8Fn Lookup>
+void
+activationLut8Kernel(const ActivationKernelArgs& args, size_t begin, size_t end)
+{
+  Lookup(static_cast<const uint8_t*>(args.table),
+         static_cast<const uint8_t*>(args.in) + begin,
+         static_cast<uint8_t*>(args.out) + begin,
+         end - begin);
+}
+
+template <Interp16Fn Lookup>
+void
+activationInterp16Kernel(const ActivationKernelArgs& args, size_t begin, size_t end)
+{
+  Lookup(*static_cast<const InterpTable16*>(args.table),
+         static_cast<const uint16_t*>(args.in) + begin,
+         static_cast<uint16_t*>(args.out) + begin,
+         end - begin);
+}
+
+/**
+ * \brief Kernels of one activation on backend V. The exact mode is left empty, see
+ * makeActivationExactKernels().
+ */
+template <typename Act, typename V, Lut8Fn Lut8, Interp16Fn Interp16>
+ActivationKernelSet
+makeActivationKernelSet(const char* name)
+{
+  ActivationKernelSet kernels = {name,
+                                 {{nullptr, nullptr, nullptr, nullptr},
+                                  makeActivationFloatKernels<Act, V, ACTIVATION_ACCURACY_FAST>(),
+                                  makeActivationFloatKernels<Act, V, ACTIVATION_ACCURACY_TURBO>()},
+                                 &activationLut8Kernel<Lut8>,
+                                 &activationInterp16Kernel<Interp16>};
+  return kernels;
+}
+
+/**
+ * \brief Exact kernel, Act::reference() per element and one rounding to float32.
+ */
+template <typename Act, typename InT, typename OutT>
+void
+activationExactKernel(const ActivationKernelArgs& args, size_t begin, size_t end)
+{
+  typedef Simd::VecF32<Simd::ScalarIsa> Scalar;
+  const InT* in = static_cast<const InT*>(args.in);
+  OutT* out = static_cast<OutT*>(args.out);
+  for (size_t idx = begin; idx < end; idx++)
+  {
+    const float x = Simd::VecIo<Scalar, InT>::load(in + idx);
+    Simd::VecIo<Scalar, OutT>::store(out + idx, static_cast<float>(Act::reference(x, args.params)));
+  }
+}
+
+/**
+ * \brief The exact mode entry points. They do not depend on the instruction set and
+ * must only be instantiated in translation units built with the baseline flags.
+ */
+template <typename Act>
+ActivationFloatKernels
+makeActivationExactKernels()
+{
+  ActivationFloatKernels kernels = {&activationExactKernel<Act, float, float>,
+                                    &activationExactKernel<Act, Simd::Half, Simd::Half>,
+                                    &activationExactKernel<Act, Simd::Half, float>,
+                                    &activationExactKernel<Act, float, Simd::Half>};
+  return kernels;
+}
+
+}
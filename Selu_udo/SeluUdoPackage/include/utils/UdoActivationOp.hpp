@@ -0,0 +1,136 @@
+//==============================================================================
+//
+// Copyright (c) 2020 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "utils/IUdoOpDefinition.hpp"
+#include "utils/UdoActivation.hpp"
+#include "utils/UdoCpuOperation.hpp"
+#include "utils/UdoQuantize.hpp"
+
+namespace UdoUtil {
+
+/**
+ * @brief An activation precomputed for one pair of quantized input/output encodings
+ * and one set of params. 8-bit tensors use lut8, 16-bit tensors use interp16.
+ */
+struct ActivationQuantTable
+{
+    uint32_t bitWidth;
+    QuantEncoding input;
+    QuantEncoding output;
+    ActivationParams params;
+    uint8_t lut8[256];
+    InterpTable16 interp16;
+};
+
+/**
+ * @brief Everything execute needs besides the tensors, resolved ahead of time. The
+ * partition is cheap to redo when currDimensions change, everything else only depends
+ * on data types, ranks and parallelism. Running the plan is one indirect call per chunk.
+ */
+struct ActivationExecutionPlan
+{
+    size_t elementSize = 0;                 // bytes per output element
+    ActivationKernelArgs args = {nullptr, nullptr, nullptr, {0.0f, 0.0f}};
+    ActivationKernelFn run = nullptr;
+    ElementPartition partition = {0, 0, 0};
+};
+
+/**
+ * @brief One input, one output elementwise activation. The kernels, params and
+ * quantized table are resolved by ActivationOpDef, the op only plans and runs them.
+ */
+class ActivationOp : public UdoCpuOperation
+{
+public:
+    ActivationOp(const ActivationInfo& info, const ActivationKernelSet& kernels,
+                 SnpeUdo_TensorParam_t* inputs, uint32_t numOfInputs,
+                 SnpeUdo_TensorParam_t* outputs, uint32_t numOfOutputs,
+                 SnpeUdo_CpuInfrastructure_t* infrastructure, uint32_t numOfStaticParams,
+                 SnpeUdo_Param_t* params, const ActivationParams& activation, ActivationAccuracy accuracy,
+                 std::shared_ptr<const ActivationQuantTable> quantTable = nullptr)
+        : UdoCpuOperation(inputs, numOfInputs, outputs, numOfOutputs, infrastructure, numOfStaticParams, params)
+        , m_Info(info)
+        , m_Kernels(kernels)
+        , m_Activation(activation)
+        , m_Accuracy(accuracy)
+        , m_QuantTable(std::move(quantTable)) {}
+
+private:
+    /**
+     * \brief Resolves the kernel for the tensors' data types and accuracy mode.
+     */
+    SnpeUdo_ErrorType_t prepare() override;
+
+    /**
+     * \brief Updates the partition of the plan for the current currDimensions. Does not
+     * allocate.
+     */
+    SnpeUdo_ErrorType_t reshape() override;
+
+    void runPlan(const void* in, void* out) override;
+
+    const ActivationInfo& m_Info;
+    const ActivationKernelSet& m_Kernels;
+    ActivationParams m_Activation;
+    ActivationAccuracy m_Accuracy;
+    std::shared_ptr<const ActivationQuantTable> m_QuantTable;
+    ActivationExecutionPlan m_Plan;
+};
+
+/**
+ * @brief Op definition shared by every activation. info and kernels describe the
+ * activation and must outlive the definition, typically as statics of the package.
+ */
+class ActivationOpDef : public IUdoOpDefinition
+{
+public:
+    ActivationOpDef() = delete;
+    ActivationOpDef(const ActivationInfo& info, const ActivationKernelSet& kernels,
+                    uint32_t numOfInputs, uint32_t numOfOutputs)
+        : m_Info(info)
+        , m_Kernels(kernels)
+        , m_NumOfInputs(numOfInputs)
+        , m_NumOfOutputs(numOfOutputs)
+    {}
+
+    std::unique_ptr<UdoOperation>
+    createOp(void* perOpInfrastucture,
+             uint32_t numOfInputs,
+             SnpeUdo_TensorParam_t* inputs,
+             uint32_t numOfOutputs,
+             SnpeUdo_TensorParam_t* outputs,
+             uint32_t numOfStaticParams,
+             SnpeUdo_Param_t* params) override;
+
+    const char* getOperationType() const override { return m_Info.operationType; }
+
+private:
+    /**
+     * \brief Returns the table for the given quantized tensors and params, building it
+     * on first use. Ops with the same encodings and params share one table, which lives
+     * as long as any of them.
+     */
+    std::shared_ptr<const ActivationQuantTable>
+    getQuantTable(const SnpeUdo_TensorParam_t& input, const SnpeUdo_TensorParam_t& output, uint32_t bitWidth,
+                  const ActivationParams& params);
+
+    const ActivationInfo& m_Info;
+    const ActivationKernelSet& m_Kernels;
+    uint32_t m_NumOfInputs;
+    uint32_t m_NumOfOutputs;
+    std::mutex m_QuantTablesMutex;
+    std::vector<std::weak_ptr<const ActivationQuantTable>> m_QuantTables;
+};
+
+}
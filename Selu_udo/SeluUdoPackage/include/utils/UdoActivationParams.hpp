@@ -0,0 +1,126 @@
+//==============================================================================
+//
+// Copyright (c) 2020 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "SnpeUdo/UdoBase.h"
+#include "utils/UdoParamSchema.hpp"
+
+/**
+ * Static params shared by the elementwise activations of UdoActivation.hpp. Every
+ * activation takes the same optional params, so that the registration library, the
+ * validation functions and the CPU library agree on one schema:
+ *
+ *   accuracy_mode  UINT_32  how float tensors evaluate exp, see ActivationAccuracy
+ *   alpha          FLOAT_32 the activation's alpha, only for activations that have one
+ *   scale          FLOAT_32 output multiplier, applied as scale * f(x)
+ */
+namespace UdoUtil {
+
+constexpr const char* ACTIVATION_ACCURACY_MODE_PARAM = "accuracy_mode";
+constexpr const char* ACTIVATION_ALPHA_PARAM = "alpha";
+constexpr const char* ACTIVATION_SCALE_PARAM = "scale";
+
+/**
+ * @brief Values of the accuracy_mode param. Quantized tensors always use tables
+ * computed in double precision and ignore it.
+ */
+enum ActivationAccuracy : uint32_t
+{
+  ACTIVATION_ACCURACY_EXACT = 0, // evaluated in double and rounded once to float32
+  ACTIVATION_ACCURACY_FAST = 1,  // float32 polynomials within a few ulp, the default
+  ACTIVATION_ACCURACY_TURBO = 2, // short exp polynomial, around 1e-3 relative error
+  ACTIVATION_NUM_ACCURACY_MODES = 3
+};
+
+inline bool
+isValidActivationAccuracy(uint32_t mode)
+{
+  return mode < ACTIVATION_NUM_ACCURACY_MODES;
+}
+
+/**
+ * @brief Values of the alpha and scale params, after defaults are applied.
+ */
+struct ActivationParams
+{
+  float alpha;
+  float scale;
+};
+
+/**
+ * @brief What the registration and CPU libraries need to know about one activation
+ * op, without its kernels. See makeActivationInfo() in UdoActivation.hpp.
+ */
+struct ActivationInfo
+{
+  const char* operationType;
+  ActivationParams defaults;
+  bool usesAlpha;
+  // domain restrictions of the params beyond being finite, e.g. a nonzero alpha
+  bool (*acceptsParams)(const ActivationParams& params);
+  // scale * f(x) in double, for exact kernels and quantization tables
+  double (*reference)(double x, const ActivationParams& params);
+};
+
+/**
+ * @brief Slots of the activation params in ACTIVATION_PARAM_SCHEMA.
+ */
+enum ActivationParamSlot : size_t
+{
+  ACTIVATION_PARAM_ACCURACY_MODE = 0,
+  ACTIVATION_PARAM_ALPHA,
+  ACTIVATION_PARAM_SCALE,
+  ACTIVATION_NUM_PARAMS
+};
+
+constexpr UdoParamSpec ACTIVATION_PARAM_SCHEMA[ACTIVATION_NUM_PARAMS] = {
+  scalarParamSpec<uint32_t>(ACTIVATION_ACCURACY_MODE_PARAM, false),
+  scalarParamSpec<float>(ACTIVATION_ALPHA_PARAM, false),
+  scalarParamSpec<float>(ACTIVATION_SCALE_PARAM, false),
+};
+
+using ActivationParamTable = UdoParamTable<ACTIVATION_NUM_PARAMS>;
+
+/**
+ * \brief Resolves the static params of an activation op and applies its defaults.
+ * @return SNPE_UDO_WRONG_OPERATION for alpha on an activation without one,
+ *         SNPE_UDO_INVALID_ARGUMENT for an unknown accuracy_mode or param values the
+ *         activation does not accept, otherwise the status of UdoParamTable::resolve()
+ */
+inline SnpeUdo_ErrorType_t
+resolveActivationParams(const ActivationInfo& info, const SnpeUdo_Param_t* params, size_t numOfParams,
+                        ActivationParams& resolved, ActivationAccuracy& accuracy)
+{
+  ActivationParamTable table;
+  const SnpeUdo_ErrorType_t status = table.resolve(ACTIVATION_PARAM_SCHEMA, params, numOfParams);
+  if (status != SNPE_UDO_NO_ERROR)
+  {
+    return status;
+  }
+  if (!info.usesAlpha && table.has(ACTIVATION_PARAM_ALPHA))
+  {
+    return SNPE_UDO_WRONG_OPERATION;
+  }
+  const uint32_t mode = table.getScalar<uint32_t>(ACTIVATION_PARAM_ACCURACY_MODE, ACTIVATION_ACCURACY_FAST);
+  resolved.alpha = table.getScalar<float>(ACTIVATION_PARAM_ALPHA, info.defaults.alpha);
+  resolved.scale = table.getScalar<float>(ACTIVATION_PARAM_SCALE, info.defaults.scale);
+  if (!isValidActivationAccuracy(mode) || !std::isfinite(resolved.alpha) || !std::isfinite(resolved.scale) ||
+      !info.acceptsParams(resolved))
+  {
+    return SNPE_UDO_INVALID_ARGUMENT;
+  }
+  accuracy = static_cast<ActivationAccuracy>(mode);
+  return SNPE_UDO_NO_ERROR;
+}
+
+}
@@ -0,0 +1,49 @@
+//==============================================================================
+//
+// Copyright (c) 2020 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+#pragma once
+
+namespace UdoUtil {
+
+/**
+ * @brief Marks the code a thread runs while the scope is alive as part of an execute,
+ * which must not allocate once the op is created.
+ *
+ * The CPU library built with UDO_ALLOC_CHECK=1 (UDO_CHECK_EXECUTE_ALLOCATIONS) replaces
+ * malloc and operator new and aborts on any allocation inside such a scope, naming its
+ * size. The replacements take effect when the library is linked into the process or
+ * preloaded with LD_PRELOAD, not when it is only opened with dlopen, and need glibc.
+ * In other builds the scope compiles to nothing.
+ */
+class UdoNoAllocScope
+{
+public:
+#ifdef UDO_CHECK_EXECUTE_ALLOCATIONS
+  UdoNoAllocScope();
+  ~UdoNoAllocScope();
+#else
+  UdoNoAllocScope() {}
+#endif
+
+  UdoNoAllocScope(const UdoNoAllocScope&) = delete;
+  UdoNoAllocScope& operator=(const UdoNoAllocScope&) = delete;
+};
+
+/**
+ * \brief Whether the calling thread is inside a UdoNoAllocScope, so that work it hands
+ * to other threads can be checked as well. Always false without the check.
+ */
+#ifdef UDO_CHECK_EXECUTE_ALLOCATIONS
+bool
+isNoAllocScope();
+#else
+inline bool
+isNoAllocScope() { return false; }
+#endif
+
+}
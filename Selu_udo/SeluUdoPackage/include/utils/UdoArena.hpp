@@ -0,0 +1,111 @@
+//==============================================================================
+//
+// Copyright (c) 2020 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+
+namespace UdoUtil {
+
+/**
+ * @brief Bump allocator over a single heap block, for metadata that lives exactly as
+ * long as its owner. Every allocate() is announced by a reserve() of the same type and
+ * count beforehand, then commit() makes the one allocation. Memory is zeroed and only
+ * released with the arena, objects placed in it must be trivially destructible.
+ */
+class UdoArena
+{
+public:
+    UdoArena() = default;
+    UdoArena(const UdoArena&) = delete;
+    UdoArena& operator=(const UdoArena&) = delete;
+
+    void reserve(size_t bytes, size_t alignment)
+    {
+        // worst case padding, so allocations may come in any order
+        m_Capacity += bytes + alignment - 1;
+    }
+
+    template <typename T>
+    void reserve(size_t count)
+    {
+        reserve(sizeof(T) * count, alignof(T));
+    }
+
+    /**
+     * \brief Allocates the reserved capacity.
+     * @return false if the allocation failed
+     */
+    bool commit()
+    {
+        m_Block.reset(new (std::nothrow) uint8_t[m_Capacity > 0 ? m_Capacity : 1]);
+        if (m_Block == nullptr)
+        {
+            return false;
+        }
+        std::memset(m_Block.get(), 0, m_Capacity);
+        m_Used = 0;
+        return true;
+    }
+
+    /**
+     * \brief Takes bytes from the block, nullptr when they were not reserved.
+     */
+    void* allocate(size_t bytes, size_t alignment)
+    {
+        const uintptr_t base = reinterpret_cast<uintptr_t>(m_Block.get());
+        const size_t offset = ((base + m_Used + alignment - 1) & ~(uintptr_t(alignment) - 1)) - base;
+        if (m_Block == nullptr || offset + bytes > m_Capacity)
+        {
+            return nullptr;
+        }
+        m_Used = offset + bytes;
+        return m_Block.get() + offset;
+    }
+
+    template <typename T>
+    T* allocate(size_t count)
+    {
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    size_t getCapacity() const { return m_Capacity; }
+
+private:
+    std::unique_ptr<uint8_t[]> m_Block;
+    size_t m_Capacity = 0;
+    size_t m_Used = 0;
+};
+
+/**
+ * @brief Fixed size array stored in a UdoArena, with the parts of the std::vector
+ * interface that op code uses.
+ */
+template <typename T>
+class ArenaSpan
+{
+public:
+    ArenaSpan() = default;
+    ArenaSpan(T* data, size_t count) : m_Data(data), m_Count(data != nullptr ? count : 0) {}
+
+    T& operator[](size_t idx) const { return m_Data[idx]; }
+    T* begin() const { return m_Data; }
+    T* end() const { return m_Data + m_Count; }
+    size_t size() const { return m_Count; }
+    bool empty() const { return m_Count == 0; }
+
+private:
+    T* m_Data = nullptr;
+    size_t m_Count = 0;
+};
+
+}
@@ -0,0 +1,59 @@
+//==============================================================================
+//
+// Copyright (c) 2019 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace UdoUtil {
+
+/**
+ * @brief Background thread running non-blocking executes in submission order.
+ *
+ * Jobs are intrusive: the submitter owns the Job and keeps it alive until it has
+ * run, so submitting never allocates. A job that needs more threads uses the
+ * library task scheduler like any other caller.
+ */
+class UdoAsyncExecutor
+{
+public:
+  struct Job
+  {
+    void (*run)(Job* job) = nullptr;
+    Job* next = nullptr;
+  };
+
+  UdoAsyncExecutor();
+
+  /**
+   * \brief Runs every job still queued, then stops the thread.
+   */
+  ~UdoAsyncExecutor();
+
+  UdoAsyncExecutor(const UdoAsyncExecutor&) = delete;
+  UdoAsyncExecutor& operator=(const UdoAsyncExecutor&) = delete;
+
+  /**
+   * \brief Queues job->run(job) for the background thread and returns immediately.
+   */
+  void submit(Job* job);
+
+private:
+  void workerLoop();
+
+  std::mutex m_Mutex;
+  std::condition_variable m_Cv;
+  Job* m_Head = nullptr;
+  Job* m_Tail = nullptr;
+  bool m_Stop = false;
+  std::thread m_Thread;
+};
+
+}
@@ -0,0 +1,495 @@
+//==============================================================================
+//
+// Copyright (c) 2020 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+#include "utils/UdoActivation.hpp"
+#include "utils/UdoDense.hpp"
+#include "utils/UdoSimd.hpp"
+
+/**
+ * 2D convolutions of NHWC float tensors with an activation fused into the store,
+ * out = f(conv(in, W) + b).
+ *
+ * The weights come in the Keras layout, kernelHeight x kernelWidth x channels x units,
+ * which is a depth x units matrix with depth = kernelHeight * kernelWidth * channels,
+ * so they are packed into the panels of UdoDense.hpp. The kernels convolve directly:
+ * a tile of CONV_BLOCK_PIXELS neighbouring output pixels by one panel is accumulated
+ * in registers, each input value of the tile broadcast against the panel's weights of
+ * its tap. A task owning whole output rows activates each row in place once all of
+ * its panels are stored, otherwise the activation is applied on the way out. 3x3 stride 1 windows have
+ * their tap loops unrolled, any other window runs the same code with runtime extents.
+ * Pixels whose window reaches into the padding take a per pixel path that skips the
+ * missing taps.
+ */
+namespace UdoUtil {
+
+// output pixels accumulated together
+constexpr size_t CONV_BLOCK_PIXELS = 4;
+
+/**
+ * @brief Window, stride and leading padding of a convolution. The trailing padding
+ * follows from the output size.
+ */
+struct ConvGeometry
+{
+  size_t kernelHeight;
+  size_t kernelWidth;
+  size_t channels;
+  size_t units;
+  size_t strideHeight;
+  size_t strideWidth;
+  size_t padTop;
+  size_t padLeft;
+};
+
+inline size_t
+getConvDepth(const ConvGeometry& geometry)
+{
+  return geometry.kernelHeight * geometry.kernelWidth * geometry.channels;
+}
+
+/**
+ * \brief Whether outSize windows of kernel at stride, starting padBefore elements
+ * before the input, all overlap an input of inSize.
+ */
+inline bool
+isValidConvExtent(size_t inSize, size_t outSize, size_t kernel, size_t stride, size_t padBefore)
+{
+  return inSize > 0 && outSize > 0 && padBefore < kernel && (outSize - 1) * stride < inSize + padBefore;
+}
+
+/**
+ * @brief Operands of a prepared convolution. in is batch x inHeight x inWidth x
+ * channels and out batch x outHeight x outWidth x units; weights and bias are packed
+ * for the kernel's panel width.
+ */
+struct ConvKernelArgs
+{
+  const float* in;
+  float* out;
+  const float* weights;
+  const float* bias;
+  ConvGeometry geometry;
+  size_t inHeight;
+  size_t inWidth;
+  size_t outHeight;
+  size_t outWidth;
+  ActivationParams params;
+};
+
+/**
+ * @brief Computes output rows [rowBegin, rowEnd), counted over the batch, of the
+ * units in panels [panelBegin, panelEnd). Disjoint ranges may run concurrently.
+ */
+using ConvKernelFn = void (*)(const ConvKernelArgs& args, size_t rowBegin, size_t rowEnd,
+                              size_t panelBegin, size_t panelEnd);
+
+/**
+ * @brief Convolution entry points of one activation on one backend, laid out like
+ * DenseKernelSet.
+ */
+struct ConvKernelSet
+{
+  size_t panelWidth;
+  ConvKernelFn linear;
+  ConvKernelFn modes[ACTIVATION_NUM_ACCURACY_MODES];
+};
+
+namespace ConvDetail {
+
+// extents known at compile time are unrolled, 0 reads them from the geometry
+template <size_t Fixed>
+size_t
+getExtent(size_t runtime)
+{
+  return Fixed > 0 ? Fixed : runtime;
+}
+
+template <typename V, size_t Regs>
+void
+getPanelLanes(size_t units, size_t panel, size_t lanes[Regs])
+{
+  constexpr size_t W = V::Width;
+  const size_t col = panel * getDensePanelWidth<V>();
+  const size_t cols = std::min(getDensePanelWidth<V>(), units - col);
+  for (size_t reg = 0; reg < Regs; reg++)
+  {
+    lanes[reg] = cols > reg * W ? std::min(W, cols - reg * W) : 0;
+  }
+}
+
+/**
+ * \brief Pixels output pixels from column ox of one output row, by the first Regs
+ * registers of one panel. Every window of the tile lies inside the input, its top
+ * left corner at input row iy.
+ */
+template <typename V, size_t Pixels, size_t Regs, size_t KH, size_t KW, size_t Stride, typename Epilogue>
+void
+convTile(const ConvKernelArgs& args, const float* image, float* outRow, size_t iy, size_t ox, size_t panel,
+         const Epilogue& epilogue)
+{
+  using Reg = typename V::Reg;
+  constexpr size_t W = V::Width;
+  constexpr size_t PanelWidth = DENSE_PANEL_REGS * W;
+  const ConvGeometry& geometry = args.geometry;
+  const size_t kernelHeight = getExtent<KH>(geometry.kernelHeight);
+  const size_t kernelWidth = getExtent<KW>(geometry.kernelWidth);
+  const size_t pixelStride = getExtent<Stride>(geometry.strideWidth) * geometry.channels;
+  const size_t channels = geometry.channels;
+  const size_t col = panel * PanelWidth;
+
+  Reg acc[Pixels][Regs];
+  for (size_t pixel = 0; pixel < Pixels; pixel++)
+  {
+    for (size_t reg = 0; reg < Regs; reg++)
+    {
+      acc[pixel][reg] = V::load(args.bias + col + reg * W);
+    }
+  }
+
+  // channels outermost, so a window of fixed extent is one unrolled block of taps
+  // even when there are few channels
+  const float* panelWeights = args.weights + panel * getConvDepth(geometry) * PanelWidth;
+  const float* corner = image + (iy * args.inWidth + ox * getExtent<Stride>(geometry.strideWidth) - geometry.padLeft) *
+                                channels;
+  const size_t inRowStride = args.inWidth * channels;
+  const size_t tapStride = channels * PanelWidth;
+  for (size_t channel = 0; channel < channels; channel++)
+  {
+    const float* weights = panelWeights + channel * PanelWidth;
+    for (size_t ky = 0; ky < kernelHeight; ky++)
+    {
+      const float* in = corner + ky * inRowStride + channel;
+      for (size_t kx = 0; kx < kernelWidth; kx++)
+      {
+        Reg w[Regs];
+        for (size_t reg = 0; reg < Regs; reg++)
+        {
+          w[reg] = V::load(weights + reg * W);
+        }
+        for (size_t pixel = 0; pixel < Pixels; pixel++)
+        {
+          const Reg x = V::set1(in[pixel * pixelStride + kx * channels]);
+          for (size_t reg = 0; reg < Regs; reg++)
+          {
+            acc[pixel][reg] = V::fmadd(x, w[reg], acc[pixel][reg]);
+          }
+        }
+        weights += tapStride;
+      }
+    }
+  }
+
+  size_t lanes[Regs];
+  getPanelLanes<V, Regs>(geometry.units, panel, lanes);
+  for (size_t pixel = 0; pixel < Pixels; pixel++)
+  {
+    float* out = outRow + (ox + pixel) * geometry.units + col;
+    for (size_t reg = 0; reg < Regs; reg++)
+    {
+      DenseDetail::storeLanes<V>(out + reg * W, epilogue(acc[pixel][reg]), lanes[reg]);
+    }
+  }
+}
+
+/**
+ * \brief One output pixel whose window may reach into the padding, whose taps are
+ * skipped rather than multiplied by zeros.
+ */
+template <typename V, size_t Regs, typename Epilogue>
+void
+convPaddedPixel(const ConvKernelArgs& args, const float* image, float* outRow, size_t oy, size_t ox, size_t panel,
+                const Epilogue& epilogue)
+{
+  using Reg = typename V::Reg;
+  constexpr size_t W = V::Width;
+  constexpr size_t PanelWidth = DENSE_PANEL_REGS * W;
+  const ConvGeometry& geometry = args.geometry;
+  const size_t col = panel * PanelWidth;
+
+  Reg acc[Regs];
+  for (size_t reg = 0; reg < Regs; reg++)
+  {
+    acc[reg] = V::load(args.bias + col + reg * W);
+  }
+
+  // taps before the input are skipped by comparing against the padding, so the
+  // unsigned input coordinates never go negative
+  const size_t top = oy * geometry.strideHeight;
+  const size_t left = ox * geometry.strideWidth;
+  const float* panelWeights = args.weights + panel * getConvDepth(geometry) * PanelWidth;
+  for (size_t ky = 0; ky < geometry.kernelHeight; ky++)
+  {
+    if (top + ky < geometry.padTop || top + ky - geometry.padTop >= args.inHeight)
+    {
+      continue;
+    }
+    for (size_t kx = 0; kx < geometry.kernelWidth; kx++)
+    {
+      if (left + kx < geometry.padLeft || left + kx - geometry.padLeft >= args.inWidth)
+      {
+        continue;
+      }
+      const float* in = image + ((top + ky - geometry.padTop) * args.inWidth + left + kx - geometry.padLeft) *
+                                geometry.channels;
+      const float* weights = panelWeights + (ky * geometry.kernelWidth + kx) * geometry.channels * PanelWidth;
+      for (size_t channel = 0; channel < geometry.channels; channel++)
+      {
+        const Reg x = V::set1(in[channel]);
+        for (size_t reg = 0; reg < Regs; reg++)
+        {
+          acc[reg] = V::fmadd(x, V::load(weights + reg * W), acc[reg]);
+        }
+        weights += PanelWidth;
+      }
+    }
+  }
+
+  size_t lanes[Regs];
+  getPanelLanes<V, Regs>(geometry.units, panel, lanes);
+  float* out = outRow + ox * geometry.units + col;
+  for (size_t reg = 0; reg < Regs; reg++)
+  {
+    DenseDetail::storeLanes<V>(out + reg * W, epilogue(acc[reg]), lanes[reg]);
+  }
+}
+
+/**
+ * @brief Output columns [begin, end) have no window reaching into the left or right
+ * padding, so they are computed in tiles.
+ */
+struct ConvColumnRange
+{
+  size_t begin;
+  size_t end;
+};
+
+inline ConvColumnRange
+getConvInnerColumns(const ConvKernelArgs& args)
+{
+  const ConvGeometry& geometry = args.geometry;
+  ConvColumnRange columns;
+  columns.begin = std::min(args.outWidth, (geometry.padLeft + geometry.strideWidth - 1) / geometry.strideWidth);
+  columns.end = columns.begin;
+  if (args.inWidth + geometry.padLeft >= geometry.kernelWidth)
+  {
+    columns.end = std::max(columns.begin,
+                           std::min(args.outWidth,
+                                    (args.inWidth + geometry.padLeft - geometry.kernelWidth) / geometry.strideWidth + 1));
+  }
+  return columns;
+}
+
+/**
+ * \brief One output row, counted over the batch, of one panel: whole tiles over the
+ * inner columns, the rest pixel by pixel.
+ */
+template <typename V, size_t Regs, size_t KH, size_t KW, size_t Stride, typename Epilogue>
+void
+convRow(const ConvKernelArgs& args, const ConvColumnRange& columns, size_t row, size_t panel,
+        const Epilogue& epilogue)
+{
+  const ConvGeometry& geometry = args.geometry;
+  const size_t oy = row % args.outHeight;
+  const float* image = args.in + (row / args.outHeight) * args.inHeight * args.inWidth * geometry.channels;
+  float* outRow = args.out + row * args.outWidth * geometry.units;
+  const size_t top = oy * geometry.strideHeight;
+  const bool isInside = top >= geometry.padTop && top - geometry.padTop + geometry.kernelHeight <= args.inHeight;
+  if (!isInside)
+  {
+    for (size_t ox = 0; ox < args.outWidth; ox++)
+    {
+      convPaddedPixel<V, Regs>(args, image, outRow, oy, ox, panel, epilogue);
+    }
+    return;
+  }
+
+  const size_t iy = top - geometry.padTop;
+  for (size_t ox = 0; ox < columns.begin; ox++)
+  {
+    convPaddedPixel<V, Regs>(args, image, outRow, oy, ox, panel, epilogue);
+  }
+  size_t ox = columns.begin;
+  for (; ox + CONV_BLOCK_PIXELS <= columns.end; ox += CONV_BLOCK_PIXELS)
+  {
+    convTile<V, CONV_BLOCK_PIXELS, Regs, KH, KW, Stride>(args, image, outRow, iy, ox, panel, epilogue);
+  }
+  switch (columns.end - ox)
+  {
+    case 3: convTile<V, 3, Regs, KH, KW, Stride>(args, image, outRow, iy, ox, panel, epilogue); break;
+    case 2: convTile<V, 2, Regs, KH, KW, Stride>(args, image, outRow, iy, ox, panel, epilogue); break;
+    case 1: convTile<V, 1, Regs, KH, KW, Stride>(args, image, outRow, iy, ox, panel, epilogue); break;
+    default: break;
+  }
+  for (ox = columns.end; ox < args.outWidth; ox++)
+  {
+    convPaddedPixel<V, Regs>(args, image, outRow, oy, ox, panel, epilogue);
+  }
+}
+
+/**
+ * \brief Every panel of [panelBegin, panelEnd) for one output row. A last panel of at
+ * most one register skips the padding register, see densePanels.
+ */
+template <typename V, size_t KH, size_t KW, size_t Stride, typename Epilogue>
+void
+convRowPanels(const ConvKernelArgs& args, const ConvColumnRange& columns, size_t row, size_t panelBegin,
+              size_t panelEnd, bool isLastNarrow, const Epilogue& epilogue)
+{
+  const size_t wideEnd = isLastNarrow ? panelEnd - 1 : panelEnd;
+  for (size_t panel = panelBegin; panel < wideEnd; panel++)
+  {
+    convRow<V, DENSE_PANEL_REGS, KH, KW, Stride>(args, columns, row, panel, epilogue);
+  }
+  if (isLastNarrow)
+  {
+    convRow<V, 1, KH, KW, Stride>(args, columns, row, panelEnd - 1, epilogue);
+  }
+}
+
+// applies the epilogue to count floats at data, two registers at a time
+template <typename V, typename Epilogue>
+void
+activateInPlace(float* data, size_t count, const Epilogue& epilogue)
+{
+  constexpr size_t W = V::Width;
+  size_t idx = 0;
+  for (; idx + 2 * W <= count; idx += 2 * W)
+  {
+    const typename V::Reg a = epilogue(V::load(data + idx));
+    const typename V::Reg b = epilogue(V::load(data + idx + W));
+    V::store(data + idx, a);
+    V::store(data + idx + W, b);
+  }
+  for (; idx < count; idx += W)
+  {
+    DenseDetail::storeLanes<V>(data + idx, epilogue(DenseDetail::loadLanes<V>(data + idx, count - idx)), count - idx);
+  }
+}
+
+/**
+ * \brief Output rows [rowBegin, rowEnd) of panels [panelBegin, panelEnd). A range that
+ * covers whole rows stores them linear and activates each one while it is still in
+ * L1: with few taps per output the activation costs as much as the convolution, and
+ * run over the contiguous row it wastes no lanes on the padding of the panels. Other
+ * ranges activate in registers on the way out.
+ */
+template <typename V, size_t KH, size_t KW, size_t Stride, typename Epilogue>
+void
+convPanels(const ConvKernelArgs& args, size_t rowBegin, size_t rowEnd, size_t panelBegin, size_t panelEnd,
+           const Epilogue& epilogue)
+{
+  const ConvGeometry& geometry = args.geometry;
+  const ConvColumnRange columns = getConvInnerColumns(args);
+  const bool isLastNarrow = panelEnd > panelBegin &&
+                            geometry.units - (panelEnd - 1) * getDensePanelWidth<V>() <= V::Width;
+  const bool isWholeRows = panelBegin == 0 && panelEnd == getDenseNumPanels(geometry.units, getDensePanelWidth<V>());
+  if (isWholeRows)
+  {
+    const DenseLinearVec<V> linear(args.params);
+    const size_t outRowSize = args.outWidth * geometry.units;
+    for (size_t row = rowBegin; row < rowEnd; row++)
+    {
+      convRowPanels<V, KH, KW, Stride>(args, columns, row, panelBegin, panelEnd, isLastNarrow, linear);
+      activateInPlace<V>(args.out + row * outRowSize, outRowSize, epilogue);
+    }
+    return;
+  }
+  for (size_t row = rowBegin; row < rowEnd; row++)
+  {
+    convRowPanels<V, KH, KW, Stride>(args, columns, row, panelBegin, panelEnd, isLastNarrow, epilogue);
+  }
+}
+
+template <typename V, size_t KH, size_t KW, size_t Stride>
+void
+convPanels(const ConvKernelArgs& args, size_t rowBegin, size_t rowEnd, size_t panelBegin, size_t panelEnd,
+           const DenseLinearVec<V>& linear)
+{
+  const ConvColumnRange columns = getConvInnerColumns(args);
+  const bool isLastNarrow = panelEnd > panelBegin &&
+                            args.geometry.units - (panelEnd - 1) * getDensePanelWidth<V>() <= V::Width;
+  for (size_t row = rowBegin; row < rowEnd; row++)
+  {
+    convRowPanels<V, KH, KW, Stride>(args, columns, row, panelBegin, panelEnd, isLastNarrow, linear);
+  }
+}
+
+}
+
+/**
+ * \brief The convolution kernel of backend V with activation functor Epilogue,
+ * instantiated by the ISA specific translation units.
+ */
+template <typename V, typename Epilogue>
+void
+convKernel(const ConvKernelArgs& args, size_t rowBegin, size_t rowEnd, size_t panelBegin, size_t panelEnd)
+{
+  const Epilogue epilogue(args.params);
+  const ConvGeometry& geometry = args.geometry;
+  if (geometry.kernelHeight == 3 && geometry.kernelWidth == 3 && geometry.strideWidth == 1)
+  {
+    ConvDetail::convPanels<V, 3, 3, 1>(args, rowBegin, rowEnd, panelBegin, panelEnd, epilogue);
+    return;
+  }
+  ConvDetail::convPanels<V, 0, 0, 0>(args, rowBegin, rowEnd, panelBegin, panelEnd, epilogue);
+}
+
+/**
+ * \brief Convolution kernels of activation Act on backend V.
+ */
+template <typename Act, typename V>
+ConvKernelSet
+makeConvKernelSet()
+{
+  ConvKernelSet kernels = {getDensePanelWidth<V>(),
+                           &convKernel<V, DenseLinearVec<V>>,
+                           {nullptr,
+                            &convKernel<V, typename Act::template Vec<V, ACTIVATION_ACCURACY_FAST>>,
+                            &convKernel<V, typename Act::template Vec<V, ACTIVATION_ACCURACY_TURBO>>}};
+  return kernels;
+}
+
+/**
+ * \brief Runs task taskIdx of a tiling over the output rows, see makeDenseTiling(), and
+ * the exact activation over its block when given one.
+ */
+inline void
+runConvTask(ConvKernelFn kernel, ActivationKernelFn exactActivation, const ConvKernelArgs& args,
+            const DenseTiling& tiling, size_t taskIdx)
+{
+  const size_t rowBegin = (taskIdx / tiling.panelTasks) * tiling.rowsPerTask;
+  const size_t rowEnd = std::min(tiling.rows, rowBegin + tiling.rowsPerTask);
+  const size_t panelBegin = (taskIdx % tiling.panelTasks) * tiling.panelsPerTask;
+  const size_t panelEnd = std::min(tiling.numPanels, panelBegin + tiling.panelsPerTask);
+  kernel(args, rowBegin, rowEnd, panelBegin, panelEnd);
+
+  if (exactActivation != nullptr)
+  {
+    const size_t units = args.geometry.units;
+    const size_t colBegin = panelBegin * tiling.panelWidth;
+    const size_t colEnd = std::min(units, panelEnd * tiling.panelWidth);
+    const ActivationKernelArgs activationArgs = {args.out, args.out, nullptr, args.params};
+    if (colBegin == 0 && colEnd == units)
+    {
+      // the task owns whole rows, which are contiguous
+      exactActivation(activationArgs, rowBegin * args.outWidth * units, rowEnd * args.outWidth * units);
+      return;
+    }
+    for (size_t pixel = rowBegin * args.outWidth; pixel < rowEnd * args.outWidth; pixel++)
+    {
+      exactActivation(activationArgs, pixel * units + colBegin, pixel * units + colEnd);
+    }
+  }
+}
+
+}
@@ -0,0 +1,37 @@
+//==============================================================================
+//
+// Copyright (c) 2019 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+#pragma once
+
+namespace UdoUtil {
+
+/**
+ * @brief Instruction set extensions usable by the current process.
+ * x86 flags are only set when both the CPU reports the extension and the OS
+ * has enabled the matching register state (XCR0), so a kernel selected from
+ * this struct is always safe to run.
+ */
+struct CpuFeatures
+{
+  bool sse42   = false;
+  bool avx     = false;
+  bool avx2    = false;
+  bool fma     = false;
+  bool f16c    = false;
+  bool avx512f = false;
+  bool neon    = false;
+};
+
+/**
+ * \brief Returns the features of the host CPU. Detection runs once per process,
+ * later calls return the cached result.
+ */
+const CpuFeatures&
+getCpuFeatures();
+
+}
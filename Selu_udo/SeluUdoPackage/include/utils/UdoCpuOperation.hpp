@@ -8,12 +8,30 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <vector>
+#include "UdoAsyncExecutor.hpp"
 #include "UdoOperation.hpp"
+#include "UdoProfiler.hpp"
+#include "UdoTaskScheduler.hpp"
 #include "SnpeUdo/UdoImplCpu.h"
 
 namespace UdoUtil {
 
+/**
+ * @brief Elements [0, count) split into numChunks chunks of chunkSize elements,
+ * the last one possibly shorter.
+ */
+struct ElementPartition
+{
+  size_t count;
+  size_t chunkSize;
+  size_t numChunks;
+};
+
 class UdoCpuOperation : public UdoOperation
 {
 public:
@@ -25,20 +43,297 @@ public:
                     uint32_t numOfStaticParams = 0,
                     SnpeUdo_Param_t* params =  nullptr);
 
+  /**
+   * \brief Runs the op's plan on its first input and output. The plan is rebuilt with
+   * prepare() when the parallelism settings changed, rebound when setIo swapped the
+   * buffers and reshaped with reshape() when currDimensions changed, so a steady state
+   * execute goes straight to runPlan().
+   */
   SnpeUdo_ErrorType_t
   snpeUdoExecute(bool blocking,
                  uint32_t id,
-                 SnpeUdo_ExternalNotify_t notifyFunc) override = 0;
+                 SnpeUdo_ExternalNotify_t notifyFunc) override;
 
+  /**
+   * \brief Builds the execution plan for the current tensors. Called at creation and
+   * again by execute whenever the parallelism settings no longer match the plan.
+   */
+  SnpeUdo_ErrorType_t preparePlan();
+
+  /**
+   * \brief Rebinds the op to new tensor handles and shapes without reallocating. The
+   * op keeps its own copies of the tensor params, so the caller's arrays may go away
+   * afterwards. Data types and ranks must match the ones the op was created with,
+   * encodings and layouts stay as created.
+   */
   SnpeUdo_ErrorType_t
   snpeUdoSetIo(SnpeUdo_TensorParam_t* inputs, SnpeUdo_TensorParam_t* outputs) override ;
 
   SnpeUdo_ErrorType_t snpeUdoProfile(uint32_t* executionTime) override ;
 
+  SnpeUdo_ErrorType_t snpeUdoProfileStats(UdoProfileStats_t* stats) override;
+
+  SnpeUdo_ErrorType_t snpeUdoResetProfileStats() override;
+
+  const UdoLatencyHistogram* getLatencyHistogram() const override { return &m_LatencyHistogram; }
+
+  void waitForCompletion() override;
+
+  /**
+   * \brief True when the tensors have the counts, data types, layouts, ranks, max
+   * dimensions and quantization the op was created for. Everything an op derives from
+   * its tensors at creation depends only on these and the factory's static params, so
+   * such an op is as good as a new one.
+   */
+  bool isReusableFor(uint32_t numOfInputs, const SnpeUdo_TensorParam_t* inputs,
+                     uint32_t numOfOutputs, const SnpeUdo_TensorParam_t* outputs) const override;
+
+  /**
+   * \brief Rebinds the tensors like snpeUdoSetIo() and resets the profile stats, the
+   * latency histogram and the parallelism settings of snpeUdoSetParallelism(). Does
+   * not allocate.
+   */
+  SnpeUdo_ErrorType_t reuse(SnpeUdo_TensorParam_t* inputs, SnpeUdo_TensorParam_t* outputs) override;
+
   ~UdoCpuOperation() override;
 
+  /**
+   * \brief Configures how the op's work is split across the library task scheduler,
+   * from its next execute on. Waits for a non-blocking execute still in flight.
+   * @param maxThreads Upper bound on threads working on this op at once, 0 lets the
+   *        op use every scheduler thread.
+   * @param grainSize Minimum number of elements per chunk, 0 restores the default.
+   *        Tensors smaller than two grains are processed on the calling thread.
+   */
+  SnpeUdo_ErrorType_t snpeUdoSetParallelism(uint32_t maxThreads, size_t grainSize) override;
+
 protected:
+    /**
+     * \brief Validates the op and fills the parts of its plan that depend on data types,
+     * ranks, static params and the parallelism settings.
+     */
+    virtual SnpeUdo_ErrorType_t prepare() = 0;
+
+    /**
+     * \brief Checks the currDimensions of the tensors, which already fit their
+     * maxDimensions, and updates the shape dependent parts of the plan. Must not allocate.
+     */
+    virtual SnpeUdo_ErrorType_t reshape() = 0;
+
+    /**
+     * \brief Runs the plan from in to out, the data of the first input and output. Runs
+     * on the async executor for non-blocking executes, and must not allocate.
+     */
+    virtual void runPlan(const void* in, void* out) = 0;
+
+    /**
+     * \brief Ends the profiled call started with m_Profiler.beginCall(): updates the
+     * profile stats, the latency histogram and the execution time of snpeUdoProfile.
+     */
+    void endProfiledCall()
+    {
+        const uint64_t callNs = m_Profiler.endCall();
+        m_LatencyHistogram.record(callNs);
+        m_ExecutionTime = static_cast<uint32_t>(callNs / 1000);
+    }
+
+    /**
+     * \brief Number of elements of a shape.
+     */
+    static size_t getElementCount(const uint32_t* dimensions, uint32_t rank)
+    {
+        size_t count = 1;
+        for (uint32_t dim = 0; dim < rank; dim++)
+        {
+            count *= dimensions[dim];
+        }
+        return count;
+    }
+
+    /**
+     * \brief Checks that a tensor's current shape fits in its max shape, which is what
+     * the runtime sized the buffer for. Ops size their state from maxDimensions once
+     * and only need this check when currDimensions changes.
+     */
+    static bool fitsMaxDimensions(const SnpeUdo_TensorParam_t& tensor)
+    {
+        for (uint32_t dim = 0; dim < tensor.tensorRank; dim++)
+        {
+            if (tensor.currDimensions[dim] > tensor.maxDimensions[dim])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * \brief Most tasks one execute should be split into: the op's thread cap, or without
+     * one chunksPerThread tasks for every scheduler thread so that idle threads can steal.
+     * 1 when there is no scheduler to run them on.
+     */
+    size_t getMaxTasks(size_t chunksPerThread = CHUNKS_PER_THREAD)
+    {
+        UdoTaskScheduler* scheduler = getTaskScheduler();
+        if (scheduler == nullptr || scheduler->getNumThreads() <= 1)
+        {
+            return 1;
+        }
+        return m_MaxThreads > 0 ? std::min<size_t>(m_MaxThreads, scheduler->getNumThreads())
+                                : scheduler->getNumThreads() * chunksPerThread;
+    }
+
+    /**
+     * \brief Splits count elements of elementSize bytes into chunks for the task scheduler.
+     * Chunk boundaries fall on cache-line multiples so that no two threads write the same
+     * line. Without a thread cap the range is over-split so that idle threads can steal
+     * the remainder of a slow chunk set. The result only depends on the arguments and the
+     * op's parallelism settings, so ops may compute it once and reuse it.
+     */
+    ElementPartition partitionElements(size_t count, size_t elementSize)
+    {
+        ElementPartition partition = {count, count, count > 0 ? size_t(1) : size_t(0)};
+        const size_t numChunks = std::min(count / m_GrainSize, getMaxTasks());
+        if (numChunks <= 1)
+        {
+            return partition;
+        }
+
+        const size_t lineElements = std::max<size_t>(1, CACHE_LINE_SIZE / elementSize);
+        partition.chunkSize = ((count + numChunks - 1) / numChunks + lineElements - 1) / lineElements * lineElements;
+        partition.numChunks = (count + partition.chunkSize - 1) / partition.chunkSize;
+        return partition;
+    }
+
+    /**
+     * \brief Calls fn(begin, end) for every chunk of a partition, on the calling thread
+     * when there is only one. Chunk completion is reported to m_Profiler.
+     */
+    template <typename Fn>
+    void parallelForPartition(const ElementPartition& partition, const Fn& fn)
+    {
+        if (partition.numChunks <= 1)
+        {
+            fn(size_t(0), partition.count);
+            return;
+        }
+        parallelFor(partition.numChunks, [&](size_t chunkIdx)
+        {
+            const size_t begin = chunkIdx * partition.chunkSize;
+            fn(begin, std::min(partition.count, begin + partition.chunkSize));
+            m_Profiler.markChunkEnd();
+        });
+    }
+
+    /**
+     * \brief Calls fn(begin, end) over [0, count) elements of elementSize bytes, see
+     * partitionElements().
+     */
+    template <typename Fn>
+    void parallelForElements(size_t count, size_t elementSize, const Fn& fn)
+    {
+        parallelForPartition(partitionElements(count, elementSize), fn);
+    }
+
+    /**
+     * \brief Runs fn(taskIdx) for taskIdx in [0, numTasks) on the task scheduler, for ops
+     * whose work does not map onto a flat element range.
+     */
+    template <typename Fn>
+    void parallelFor(size_t numTasks, const Fn& fn)
+    {
+        UdoTaskScheduler* scheduler = getTaskScheduler();
+        if (scheduler == nullptr)
+        {
+            for (size_t taskIdx = 0; taskIdx < numTasks; taskIdx++) { fn(taskIdx); }
+            return;
+        }
+        scheduler->parallelFor(numTasks, fn);
+    }
+
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    static constexpr size_t DEFAULT_GRAIN_SIZE = 16384;
+    static constexpr size_t CHUNKS_PER_THREAD = 4;
+
     SnpeUdo_CpuInfrastructure_t*  m_PerOpFactoryInfrastructure;
+    uint32_t m_MaxThreads = 0;
+    size_t m_GrainSize = DEFAULT_GRAIN_SIZE;
+    UdoProfiler m_Profiler;
+
+private:
+    /**
+     * @brief What the plan of the subclass was built for. The shape vectors keep their
+     * capacity, so only preparePlan() may allocate and only on its first call.
+     */
+    struct PlanState
+    {
+        bool ready = false;
+        uint32_t maxThreads = 0;
+        size_t grainSize = 0;
+        SnpeUdo_TensorData_t inHandle = nullptr;
+        SnpeUdo_TensorData_t outHandle = nullptr;
+        const void* in = nullptr;
+        void* out = nullptr;
+        size_t inCount = 0;
+        size_t outCount = 0;
+        std::vector<uint32_t> inShape;
+        std::vector<uint32_t> outShape;
+    };
+
+    using AsyncFn = SnpeUdo_ErrorType_t (*)(UdoCpuOperation* op);
+
+    /**
+     * \brief Runs fn(this) on the library's async executor and returns immediately.
+     * notifyFunc(id), when given, is called once fn has returned. An op has at most one
+     * async execute in flight, callers must waitForCompletion() before touching state
+     * that fn uses, including before submitting again.
+     */
+    SnpeUdo_ErrorType_t submitAsync(AsyncFn fn, uint32_t id, SnpeUdo_ExternalNotify_t notifyFunc);
+
+    struct AsyncJob : UdoAsyncExecutor::Job
+    {
+        UdoCpuOperation* op;
+        AsyncFn fn;
+        uint32_t id;
+        SnpeUdo_ExternalNotify_t notifyFunc;
+    };
+
+    static void runAsyncJob(UdoAsyncExecutor::Job* job);
+
+    /**
+     * \brief Checks the current shapes against the max shapes, then reshape() and the
+     * element counts. Does not allocate.
+     */
+    SnpeUdo_ErrorType_t reshapePlan();
+
+    /**
+     * \brief Points the plan at the current tensor handles, after setIo swapped buffers.
+     * Does not allocate.
+     */
+    void rebindPlan();
+
+    bool isPlanCurrent() const;
+    bool isBindingCurrent() const;
+    bool isShapeCurrent() const;
+
+    static SnpeUdo_ErrorType_t runPlanned(UdoCpuOperation* op);
+
+    static SnpeUdo_ErrorType_t
+    checkRebind(const SnpeUdo_TensorParam_t& srcParam, const SnpeUdo_TensorParam_t& destParam);
+
+    static void rebindTensorParam(const SnpeUdo_TensorParam_t& srcParam, SnpeUdo_TensorParam_t& destParam);
+
+    static bool isSameTensorType(const SnpeUdo_TensorParam_t& srcParam, const SnpeUdo_TensorParam_t& destParam);
+
+    UdoTaskScheduler* getTaskScheduler();
+
+    PlanState m_PlanState;
+    AsyncJob m_AsyncJob;
+    std::mutex m_AsyncMutex;
+    std::condition_variable m_AsyncCv;
+    // written under m_AsyncMutex, read without it by waitForCompletion's fast path
+    std::atomic<bool> m_AsyncPending{false};
+    UdoLatencyHistogram m_LatencyHistogram;
 };
 }
 
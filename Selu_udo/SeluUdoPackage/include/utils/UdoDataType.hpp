@@ -0,0 +1,61 @@
+//==============================================================================
+//
+// Copyright (c) 2020 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "SnpeUdo/UdoBase.h"
+
+namespace UdoUtil {
+
+/**
+ * \brief Bytes per element of each SnpeUdo_DataType_t, indexed by the position of its
+ * bit. 0 marks bits with no data type.
+ */
+constexpr uint8_t DATA_TYPE_SIZES[] = {
+    2, // FLOAT_16
+    4, // FLOAT_32
+    1, // FIXED_4, stored one per byte
+    1, // FIXED_8
+    2, // FIXED_16
+    4, // FIXED_32
+    0, 0,
+    1, // UINT_8
+    2, // UINT_16
+    4, // UINT_32
+    0,
+    1, // INT_8
+    2, // INT_16
+    4, // INT_32
+};
+
+constexpr uint32_t
+getDataTypeBit(uint32_t dataType, uint32_t bit = 0)
+{
+    return (dataType >> bit) == 1 ? bit : getDataTypeBit(dataType, bit + 1);
+}
+
+/**
+ * \brief Bytes per element of a data type, 0 for values that are not a single known
+ * data type. Usable in constant expressions.
+ */
+constexpr size_t
+getDataTypeSize(SnpeUdo_DataType_t dataType)
+{
+    return (dataType == 0 || (dataType & (dataType - 1)) != 0 ||
+            dataType >= (1u << (sizeof(DATA_TYPE_SIZES) / sizeof(DATA_TYPE_SIZES[0]))))
+           ? 0 : DATA_TYPE_SIZES[getDataTypeBit(dataType)];
+}
+
+static_assert(getDataTypeSize(SNPE_UDO_DATATYPE_FLOAT_32) == 4 && getDataTypeSize(SNPE_UDO_DATATYPE_FIXED_16) == 2 &&
+              getDataTypeSize(SNPE_UDO_DATATYPE_INT_8) == 1 && getDataTypeSize(SNPE_UDO_DATATYPE_LAST) == 0,
+              "data type sizes do not match SnpeUdo_DataType_t");
+
+}
@@ -0,0 +1,455 @@
+//==============================================================================
+//
+// Copyright (c) 2020 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "utils/UdoActivation.hpp"
+#include "utils/UdoSimd.hpp"
+#include "utils/UdoStaticTensorStore.hpp"
+
+/**
+ * Fully connected layers with an activation fused into the store, out = f(in W + b).
+ *
+ * The weights are packed once into panels of DENSE_PANEL_REGS registers worth of
+ * output units, each panel a depth x panelWidth row major block, so the kernel
+ * streams them with full width loads. The kernel walks depth in blocks whose panel
+ * slice fits in L1 and reuses each slice for every row before moving on; partial
+ * sums of earlier blocks live in the output. The activation is applied in registers
+ * once the last depth block is added, so the pre-activation values never reach
+ * memory.
+ */
+namespace UdoUtil {
+
+// registers of output units per panel, and rows accumulated together
+constexpr size_t DENSE_PANEL_REGS = 2;
+constexpr size_t DENSE_BLOCK_ROWS = 4;
+// floats of weights per depth block of one panel, 16 KB
+constexpr size_t DENSE_DEPTH_BLOCK_FLOATS = 4096;
+// packed weights start on a cache line, so no panel load splits one
+constexpr size_t DENSE_PACK_ALIGNMENT = 64;
+
+template <typename V>
+constexpr size_t
+getDensePanelWidth()
+{
+  return DENSE_PANEL_REGS * V::Width;
+}
+
+inline size_t
+getDenseNumPanels(size_t units, size_t panelWidth)
+{
+  return (units + panelWidth - 1) / panelWidth;
+}
+
+/**
+ * \brief Packs row major depth x units weights into panels, zero padding the last
+ * one. packed must hold getDenseNumPanels(units, panelWidth) * depth * panelWidth floats.
+ */
+inline void
+packDenseWeights(const float* weights, size_t depth, size_t units, size_t panelWidth, float* packed)
+{
+  const size_t numPanels = getDenseNumPanels(units, panelWidth);
+  for (size_t panel = 0; panel < numPanels; panel++)
+  {
+    const size_t col = panel * panelWidth;
+    const size_t cols = std::min(panelWidth, units - col);
+    for (size_t k = 0; k < depth; k++)
+    {
+      std::copy(weights + k * units + col, weights + k * units + col + cols, packed);
+      std::fill(packed + cols, packed + panelWidth, 0.0f);
+      packed += panelWidth;
+    }
+  }
+}
+
+/**
+ * \brief Copies the bias, or zeros without one, padded to whole panels.
+ */
+inline void
+packDenseBias(const float* bias, size_t units, size_t panelWidth, float* packed)
+{
+  const size_t paddedUnits = getDenseNumPanels(units, panelWidth) * panelWidth;
+  if (bias != nullptr)
+  {
+    std::copy(bias, bias + units, packed);
+  }
+  std::fill(packed + (bias != nullptr ? units : 0), packed + paddedUnits, 0.0f);
+}
+
+// derived blob kind of packed dense weights in the static tensor store
+constexpr uint64_t DENSE_PACKED_BLOB_KIND = 1;
+static_assert(STATIC_TENSOR_ALIGNMENT % DENSE_PACK_ALIGNMENT == 0, "store blobs must be aligned for packed panels");
+
+/**
+ * @brief Weights and bias packed for one panel width, in a blob of the static tensor
+ * store that the op keeps alive.
+ */
+struct DensePackedWeights
+{
+  UdoStaticBlobRef blob;
+  const float* weights;
+  const float* bias;
+};
+
+/**
+ * \brief Packs depth x units weights and the optional bias into one blob of store,
+ * shared by every op that packs the same tensors for the same panel width.
+ * @return false if the blob could not be allocated
+ */
+inline bool
+acquirePackedDense(UdoStaticTensorStore& store, const float* weights, const float* bias, size_t depth, size_t units,
+                   size_t panelWidth, DensePackedWeights& packed)
+{
+  const size_t paddedUnits = getDenseNumPanels(units, panelWidth) * panelWidth;
+  // the bias starts on the cache line after the weights
+  const size_t biasOffset = (sizeof(float) * paddedUnits * depth + DENSE_PACK_ALIGNMENT - 1) /
+                            DENSE_PACK_ALIGNMENT * DENSE_PACK_ALIGNMENT;
+  const UdoStaticDerivedKey key = {{weights, bias}, {DENSE_PACKED_BLOB_KIND, depth, units, panelWidth}};
+  packed.blob = store.acquireDerived(key, biasOffset + sizeof(float) * paddedUnits,
+                                     [weights, bias, depth, units, panelWidth, biasOffset](void* data)
+  {
+    uint8_t* bytes = static_cast<uint8_t*>(data);
+    packDenseWeights(weights, depth, units, panelWidth, reinterpret_cast<float*>(bytes));
+    packDenseBias(bias, units, panelWidth, reinterpret_cast<float*>(bytes + biasOffset));
+  });
+  if (packed.blob == nullptr)
+  {
+    return false;
+  }
+  const uint8_t* bytes = static_cast<const uint8_t*>(packed.blob->getData());
+  packed.weights = reinterpret_cast<const float*>(bytes);
+  packed.bias = reinterpret_cast<const float*>(bytes + biasOffset);
+  return true;
+}
+
+/**
+ * @brief Operands of a prepared dense call. in is rows x depth and out rows x units,
+ * both row major; weights and bias are packed for the kernel's panel width.
+ */
+struct DenseKernelArgs
+{
+  const float* in;
+  float* out;
+  const float* weights;
+  const float* bias;
+  size_t rows;
+  size_t depth;
+  size_t units;
+  ActivationParams params;
+};
+
+/**
+ * @brief Computes rows [rowBegin, rowEnd) of the output units in panels
+ * [panelBegin, panelEnd). Disjoint ranges may run concurrently.
+ */
+using DenseKernelFn = void (*)(const DenseKernelArgs& args, size_t rowBegin, size_t rowEnd,
+                               size_t panelBegin, size_t panelEnd);
+
+/**
+ * @brief Dense entry points of one activation on one backend. linear stores in W + b.
+ * The exact mode is left empty: exact ops run linear and then the activation's exact
+ * kernel over the block they just wrote, which is still in cache.
+ */
+struct DenseKernelSet
+{
+  size_t panelWidth;
+  DenseKernelFn linear;
+  DenseKernelFn modes[ACTIVATION_NUM_ACCURACY_MODES];
+};
+
+/**
+ * @brief The identity, for dense layers without a fused activation.
+ */
+template <typename V>
+struct DenseLinearVec
+{
+  using Reg = typename V::Reg;
+
+  explicit DenseLinearVec(const ActivationParams&) {}
+
+  Reg operator()(Reg x) const { return x; }
+};
+
+namespace DenseDetail {
+
+template <typename V>
+typename V::Reg
+loadLanes(const float* p, size_t lanes)
+{
+  return lanes >= V::Width ? V::load(p) : (lanes > 0 ? V::loadPartial(p, lanes) : V::zero());
+}
+
+template <typename V>
+void
+storeLanes(float* p, typename V::Reg a, size_t lanes)
+{
+  if (lanes >= V::Width)
+  {
+    V::store(p, a);
+  }
+  else if (lanes > 0)
+  {
+    V::storePartial(p, a, lanes);
+  }
+}
+
+/**
+ * \brief Adds depth [depthBegin, depthEnd) of Rows rows and the first Regs registers
+ * of one panel to the output, applying the epilogue on the way out of the last depth
+ * block. Fewer rows leave FMA latency exposed, so they split depth over independent
+ * chains.
+ */
+template <typename V, size_t Rows, size_t Regs, typename Epilogue>
+void
+denseBlock(const DenseKernelArgs& args, size_t row, size_t panel, size_t depthBegin, size_t depthEnd,
+           const Epilogue& epilogue)
+{
+  using Reg = typename V::Reg;
+  constexpr size_t W = V::Width;
+  constexpr size_t PanelWidth = DENSE_PANEL_REGS * W;
+  constexpr size_t Chains = Rows == 1 ? 4 : (Rows == 2 ? 2 : 1);
+
+  const size_t col = panel * PanelWidth;
+  const size_t cols = std::min(PanelWidth, args.units - col);
+  size_t lanes[Regs];
+  for (size_t reg = 0; reg < Regs; reg++)
+  {
+    lanes[reg] = cols > reg * W ? std::min(W, cols - reg * W) : 0;
+  }
+
+  Reg acc[Chains][Rows][Regs];
+  for (size_t r = 0; r < Rows; r++)
+  {
+    const float* out = args.out + (row + r) * args.units + col;
+    for (size_t reg = 0; reg < Regs; reg++)
+    {
+      // the first block starts from the bias, later ones from the stored partial sums
+      acc[0][r][reg] = depthBegin == 0 ? V::load(args.bias + col + reg * W) : loadLanes<V>(out + reg * W, lanes[reg]);
+      for (size_t chain = 1; chain < Chains; chain++)
+      {
+        acc[chain][r][reg] = V::zero();
+      }
+    }
+  }
+
+  const float* in = args.in + row * args.depth;
+  const float* weights = args.weights + (panel * args.depth + depthBegin) * PanelWidth;
+  size_t k = depthBegin;
+  for (; k + Chains <= depthEnd; k += Chains)
+  {
+    for (size_t chain = 0; chain < Chains; chain++)
+    {
+      Reg w[Regs];
+      for (size_t reg = 0; reg < Regs; reg++)
+      {
+        w[reg] = V::load(weights + reg * W);
+      }
+      for (size_t r = 0; r < Rows; r++)
+      {
+        const Reg x = V::set1(in[r * args.depth + k + chain]);
+        for (size_t reg = 0; reg < Regs; reg++)
+        {
+          acc[chain][r][reg] = V::fmadd(x, w[reg], acc[chain][r][reg]);
+        }
+      }
+      weights += PanelWidth;
+    }
+  }
+  for (; k < depthEnd; k++)
+  {
+    for (size_t r = 0; r < Rows; r++)
+    {
+      const Reg x = V::set1(in[r * args.depth + k]);
+      for (size_t reg = 0; reg < Regs; reg++)
+      {
+        acc[0][r][reg] = V::fmadd(x, V::load(weights + reg * W), acc[0][r][reg]);
+      }
+    }
+    weights += PanelWidth;
+  }
+
+  for (size_t r = 0; r < Rows; r++)
+  {
+    float* out = args.out + (row + r) * args.units + col;
+    for (size_t reg = 0; reg < Regs; reg++)
+    {
+      Reg sum = acc[0][r][reg];
+      for (size_t chain = 1; chain < Chains; chain++)
+      {
+        sum = V::add(sum, acc[chain][r][reg]);
+      }
+      storeLanes<V>(out + reg * W, epilogue(sum), lanes[reg]);
+    }
+  }
+}
+
+template <typename V, size_t Regs, typename Epilogue>
+void
+densePanelRange(const DenseKernelArgs& args, size_t rowBegin, size_t rowEnd, size_t panelBegin, size_t panelEnd,
+                size_t depthBegin, size_t depthEnd, const Epilogue& epilogue)
+{
+  for (size_t panel = panelBegin; panel < panelEnd; panel++)
+  {
+    size_t row = rowBegin;
+    for (; row + DENSE_BLOCK_ROWS <= rowEnd; row += DENSE_BLOCK_ROWS)
+    {
+      denseBlock<V, DENSE_BLOCK_ROWS, Regs>(args, row, panel, depthBegin, depthEnd, epilogue);
+    }
+    switch (rowEnd - row)
+    {
+      case 3: denseBlock<V, 3, Regs>(args, row, panel, depthBegin, depthEnd, epilogue); break;
+      case 2: denseBlock<V, 2, Regs>(args, row, panel, depthBegin, depthEnd, epilogue); break;
+      case 1: denseBlock<V, 1, Regs>(args, row, panel, depthBegin, depthEnd, epilogue); break;
+      default: break;
+    }
+  }
+}
+
+template <typename V, typename Epilogue>
+void
+densePanels(const DenseKernelArgs& args, size_t rowBegin, size_t rowEnd, size_t panelBegin, size_t panelEnd,
+            size_t depthBegin, size_t depthEnd, const Epilogue& epilogue)
+{
+  // a last panel of at most one register, such as the 10 units of a classifier,
+  // skips the padding register instead of multiplying and activating zeros
+  const size_t lastCols = args.units - (panelEnd - 1) * getDensePanelWidth<V>();
+  if (panelEnd > panelBegin && lastCols <= V::Width)
+  {
+    densePanelRange<V, DENSE_PANEL_REGS>(args, rowBegin, rowEnd, panelBegin, panelEnd - 1, depthBegin, depthEnd,
+                                         epilogue);
+    densePanelRange<V, 1>(args, rowBegin, rowEnd, panelEnd - 1, panelEnd, depthBegin, depthEnd, epilogue);
+    return;
+  }
+  densePanelRange<V, DENSE_PANEL_REGS>(args, rowBegin, rowEnd, panelBegin, panelEnd, depthBegin, depthEnd, epilogue);
+}
+
+}
+
+/**
+ * \brief The dense kernel of backend V with activation functor Epilogue, instantiated
+ * by the ISA specific translation units. Only the last depth block is instantiated
+ * with the epilogue, so its code stays out of the loops that do most of the work.
+ */
+template <typename V, typename Epilogue>
+void
+denseKernel(const DenseKernelArgs& args, size_t rowBegin, size_t rowEnd, size_t panelBegin, size_t panelEnd)
+{
+  const DenseLinearVec<V> linear(args.params);
+  const size_t depthBlock = std::max<size_t>(1, DENSE_DEPTH_BLOCK_FLOATS / getDensePanelWidth<V>());
+  size_t depthBegin = 0;
+  for (; depthBegin + depthBlock < args.depth; depthBegin += depthBlock)
+  {
+    DenseDetail::densePanels<V>(args, rowBegin, rowEnd, panelBegin, panelEnd, depthBegin, depthBegin + depthBlock, linear);
+  }
+  DenseDetail::densePanels<V>(args, rowBegin, rowEnd, panelBegin, panelEnd, depthBegin, args.depth,
+                              Epilogue(args.params));
+}
+
+/**
+ * \brief Dense kernels of activation Act on backend V.
+ */
+template <typename Act, typename V>
+DenseKernelSet
+makeDenseKernelSet()
+{
+  DenseKernelSet kernels = {getDensePanelWidth<V>(),
+                            &denseKernel<V, DenseLinearVec<V>>,
+                            {nullptr,
+                             &denseKernel<V, typename Act::template Vec<V, ACTIVATION_ACCURACY_FAST>>,
+                             &denseKernel<V, typename Act::template Vec<V, ACTIVATION_ACCURACY_TURBO>>}};
+  return kernels;
+}
+
+/**
+ * @brief How one dense call is split into tasks: a grid of row ranges, in multiples
+ * of DENSE_BLOCK_ROWS, by panel ranges. Panels are split first, since every task
+ * then streams a disjoint part of the weights.
+ */
+struct DenseTiling
+{
+  size_t rows;
+  size_t panelWidth;
+  size_t numPanels;
+  size_t rowsPerTask;
+  size_t panelsPerTask;
+  size_t rowTasks;
+  size_t panelTasks;
+};
+
+/**
+ * \brief Caps maxTasks so that every task gets at least grainSize *
+ * DENSE_MACS_PER_GRAIN_ELEMENT multiply-adds. Small layers, such as the 128 x 10
+ * output of the MNIST model, then stay on the calling thread.
+ */
+constexpr size_t DENSE_MACS_PER_GRAIN_ELEMENT = 16;
+
+inline size_t
+limitDenseTasks(size_t rows, size_t depth, size_t units, size_t grainSize, size_t maxTasks)
+{
+  const size_t macs = rows * depth * units;
+  return std::max<size_t>(1, std::min(maxTasks, macs / (std::max<size_t>(1, grainSize) * DENSE_MACS_PER_GRAIN_ELEMENT)));
+}
+
+inline DenseTiling
+makeDenseTiling(size_t rows, size_t units, size_t panelWidth, size_t maxTasks)
+{
+  DenseTiling tiling;
+  tiling.rows = rows;
+  tiling.panelWidth = panelWidth;
+  tiling.numPanels = getDenseNumPanels(units, panelWidth);
+  const size_t rowBlocks = (rows + DENSE_BLOCK_ROWS - 1) / DENSE_BLOCK_ROWS;
+  maxTasks = std::max<size_t>(1, maxTasks);
+
+  const size_t panelTasks = std::max<size_t>(1, std::min(tiling.numPanels, maxTasks));
+  tiling.panelsPerTask = std::max<size_t>(1, (tiling.numPanels + panelTasks - 1) / panelTasks);
+  tiling.panelTasks = std::max<size_t>(1, (tiling.numPanels + tiling.panelsPerTask - 1) / tiling.panelsPerTask);
+
+  const size_t rowTasks = std::max<size_t>(1, std::min(rowBlocks, maxTasks / tiling.panelTasks));
+  tiling.rowsPerTask = std::max<size_t>(1, (rowBlocks + rowTasks - 1) / rowTasks) * DENSE_BLOCK_ROWS;
+  tiling.rowTasks = std::max<size_t>(1, (rows + tiling.rowsPerTask - 1) / tiling.rowsPerTask);
+  return tiling;
+}
+
+inline size_t
+getDenseNumTasks(const DenseTiling& tiling)
+{
+  return tiling.rowTasks * tiling.panelTasks;
+}
+
+/**
+ * \brief Runs task taskIdx of a tiling, and the exact activation over its block when
+ * given one.
+ */
+inline void
+runDenseTask(DenseKernelFn kernel, ActivationKernelFn exactActivation, const DenseKernelArgs& args,
+             const DenseTiling& tiling, size_t taskIdx)
+{
+  const size_t rowBegin = (taskIdx / tiling.panelTasks) * tiling.rowsPerTask;
+  const size_t rowEnd = std::min(tiling.rows, rowBegin + tiling.rowsPerTask);
+  const size_t panelBegin = (taskIdx % tiling.panelTasks) * tiling.panelsPerTask;
+  const size_t panelEnd = std::min(tiling.numPanels, panelBegin + tiling.panelsPerTask);
+  kernel(args, rowBegin, rowEnd, panelBegin, panelEnd);
+
+  if (exactActivation != nullptr)
+  {
+    const size_t colBegin = panelBegin * tiling.panelWidth;
+    const size_t colEnd = std::min(args.units, panelEnd * tiling.panelWidth);
+    for (size_t row = rowBegin; row < rowEnd; row++)
+    {
+      float* out = args.out + row * args.units;
+      const ActivationKernelArgs activationArgs = {out, out, nullptr, args.params};
+      exactActivation(activationArgs, colBegin, colEnd);
+    }
+  }
+}
+
+}
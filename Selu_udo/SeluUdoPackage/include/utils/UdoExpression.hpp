@@ -0,0 +1,295 @@
+//==============================================================================
+//
+// Copyright (c) 2020 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "SnpeUdo/UdoBase.h"
+#include "utils/UdoActivation.hpp"
+#include "utils/UdoSimd.hpp"
+
+/**
+ * Elementwise expressions of one float tensor, e.g. "selu(x * a + b)", compiled once
+ * and evaluated in a single pass over the tensor.
+ *
+ * Grammar, with the usual precedence and left associativity:
+ *   expr     := term (('+' | '-') term)*
+ *   term     := unary (('*' | '/') unary)*
+ *   unary    := ('-' | '+') unary | primary
+ *   primary  := number | name | name '(' expr (',' expr)* ')' | '(' expr ')'
+ * x is the input element and other names are the variables given to the compiler.
+ * The functions are min(a, b), max(a, b), clamp(v, lo, hi), relu(v), abs(v) and the
+ * given activations by name in any case, e.g. selu(v) or hardswish(v), with their
+ * default alpha and scale.
+ *
+ * compileExpression() folds constant subexpressions and lowers the tree to an
+ * ExprProgram: a short list of instructions over tiles of EXPR_TILE_FLOATS elements.
+ * Operands are the input tile, the output tile or temporaries that stay in L1, so a
+ * chain of scale, bias, clamp and activation reads and writes the tensor once. Scalar
+ * operands are immediates of the instruction, and v * c1 + c2 and min(max(v, lo), hi)
+ * become one instruction each; the former is a fused multiply-add, rounded once.
+ */
+namespace UdoUtil {
+
+// tree nodes and instructions of one expression
+constexpr size_t EXPR_MAX_NODES = 64;
+// temporary tiles of one evaluation, EXPR_TILE_FLOATS floats each
+constexpr size_t EXPR_MAX_TEMPS = 8;
+// elements per tile, so that all temporaries fit in L1
+constexpr size_t EXPR_TILE_FLOATS = 512;
+
+enum ExprOpcode : uint8_t
+{
+  EXPR_OP_COPY = 0,   // dst = src0
+  EXPR_OP_FILL,       // dst = c0
+  EXPR_OP_ADD,        // dst = src0 + src1
+  EXPR_OP_SUB,        // dst = src0 - src1
+  EXPR_OP_MUL,        // dst = src0 * src1
+  EXPR_OP_DIV,        // dst = src0 / src1
+  EXPR_OP_MIN,        // dst = min(src0, src1)
+  EXPR_OP_MAX,        // dst = max(src0, src1)
+  EXPR_OP_ADD_C,      // dst = src0 + c0
+  EXPR_OP_MUL_C,      // dst = src0 * c0
+  EXPR_OP_FMA_C,      // dst = src0 * c0 + c1
+  EXPR_OP_RSUB_C,     // dst = c0 - src0
+  EXPR_OP_DIV_C,      // dst = src0 / c0
+  EXPR_OP_RDIV_C,     // dst = c0 / src0
+  EXPR_OP_MIN_C,      // dst = min(src0, c0)
+  EXPR_OP_MAX_C,      // dst = max(src0, c0)
+  EXPR_OP_CLAMP_C,    // dst = min(max(src0, c0), c1)
+  EXPR_OP_ABS,        // dst = |src0|
+  EXPR_OP_ACTIVATION  // dst = activations[activation](src0)
+};
+
+/**
+ * @brief Operand slots: the input and output tiles, then the temporaries.
+ */
+enum ExprSlot : uint8_t
+{
+  EXPR_SLOT_INPUT = 0,
+  EXPR_SLOT_OUTPUT,
+  EXPR_SLOT_TEMP,
+  EXPR_NUM_SLOTS = EXPR_SLOT_TEMP + EXPR_MAX_TEMPS
+};
+
+struct ExprInstruction
+{
+  ExprOpcode opcode;
+  uint8_t dst;
+  uint8_t src[2];
+  uint32_t activation;        // EXPR_OP_ACTIVATION only
+  ActivationParams params;    // EXPR_OP_ACTIVATION only
+  float constants[2];
+};
+
+/**
+ * @brief A compiled expression. The last instruction writes the output slot and no
+ * instruction writes the input slot, so the program also runs in place.
+ */
+struct ExprProgram
+{
+  ExprInstruction instructions[EXPR_MAX_NODES];
+  size_t numInstructions;
+  size_t numTemps;
+};
+
+/**
+ * @brief A name the expression may use for a scalar, such as an op param.
+ */
+struct ExprVariable
+{
+  const char* name;
+  float value;
+};
+
+/**
+ * @brief Where and why an expression did not compile.
+ */
+struct ExprError
+{
+  size_t position;
+  const char* message;
+};
+
+/**
+ * \brief Parses text and lowers it to program. activations lists the activations
+ * the expression may call, the instructions refer to them by index.
+ * @return SNPE_UDO_INVALID_ARGUMENT with error filled in for text that does not parse,
+ *         names that are not known or expressions beyond the limits of ExprProgram
+ */
+SnpeUdo_ErrorType_t
+compileExpression(const char* text, const ExprVariable* variables, size_t numVariables,
+                  const ActivationInfo* activations, size_t numActivations,
+                  ExprProgram& program, ExprError& error);
+
+/**
+ * @brief Operands of a prepared expression. activations are the float kernels of the
+ * program's activation indices, run in the given accuracy mode.
+ */
+struct ExprKernelArgs
+{
+  const float* in;
+  float* out;
+  const ExprProgram* program;
+  const ActivationKernelSet* activations;
+  ActivationAccuracy accuracy;
+};
+
+/**
+ * @brief Evaluates the program for elements [begin, end).
+ */
+using ExprKernelFn = void (*)(const ExprKernelArgs& args, size_t begin, size_t end);
+
+namespace ExprDetail {
+
+template <typename V, typename Fn>
+void
+mapBinary(const float* a, const float* b, float* out, size_t count, Fn fn)
+{
+  size_t idx = 0;
+  for (; idx + V::Width <= count; idx += V::Width)
+  {
+    V::store(out + idx, fn(V::load(a + idx), V::load(b + idx)));
+  }
+  if (idx < count)
+  {
+    const size_t rest = count - idx;
+    V::storePartial(out + idx, fn(V::loadPartial(a + idx, rest), V::loadPartial(b + idx, rest)), rest);
+  }
+}
+
+template <typename V>
+void
+fill(float* out, size_t count, typename V::Reg value)
+{
+  size_t idx = 0;
+  for (; idx + V::Width <= count; idx += V::Width)
+  {
+    V::store(out + idx, value);
+  }
+  if (idx < count)
+  {
+    V::storePartial(out + idx, value, count - idx);
+  }
+}
+
+template <typename V>
+void
+runInstruction(const ExprKernelArgs& args, const ExprInstruction& ins, const float* const* reads,
+               float* const* writes, size_t count)
+{
+  typedef typename V::Reg Reg;
+  const float* a = reads[ins.src[0]];
+  const float* b = reads[ins.src[1]];
+  float* dst = writes[ins.dst];
+  const Reg c0 = V::set1(ins.constants[0]);
+  const Reg c1 = V::set1(ins.constants[1]);
+  switch (ins.opcode)
+  {
+    case EXPR_OP_COPY:
+      Simd::transform<V>(a, dst, count, [](Reg x) { return x; });
+      break;
+    case EXPR_OP_FILL:
+      fill<V>(dst, count, c0);
+      break;
+    case EXPR_OP_ADD:
+      mapBinary<V>(a, b, dst, count, [](Reg x, Reg y) { return V::add(x, y); });
+      break;
+    case EXPR_OP_SUB:
+      mapBinary<V>(a, b, dst, count, [](Reg x, Reg y) { return V::sub(x, y); });
+      break;
+    case EXPR_OP_MUL:
+      mapBinary<V>(a, b, dst, count, [](Reg x, Reg y) { return V::mul(x, y); });
+      break;
+    case EXPR_OP_DIV:
+      mapBinary<V>(a, b, dst, count, [](Reg x, Reg y) { return V::div(x, y); });
+      break;
+    case EXPR_OP_MIN:
+      mapBinary<V>(a, b, dst, count, [](Reg x, Reg y) { return V::min(x, y); });
+      break;
+    case EXPR_OP_MAX:
+      mapBinary<V>(a, b, dst, count, [](Reg x, Reg y) { return V::max(x, y); });
+      break;
+    case EXPR_OP_ADD_C:
+      Simd::transform<V>(a, dst, count, [c0](Reg x) { return V::add(x, c0); });
+      break;
+    case EXPR_OP_MUL_C:
+      Simd::transform<V>(a, dst, count, [c0](Reg x) { return V::mul(x, c0); });
+      break;
+    case EXPR_OP_FMA_C:
+      Simd::transform<V>(a, dst, count, [c0, c1](Reg x) { return V::fmadd(x, c0, c1); });
+      break;
+    case EXPR_OP_RSUB_C:
+      Simd::transform<V>(a, dst, count, [c0](Reg x) { return V::sub(c0, x); });
+      break;
+    case EXPR_OP_DIV_C:
+      Simd::transform<V>(a, dst, count, [c0](Reg x) { return V::div(x, c0); });
+      break;
+    case EXPR_OP_RDIV_C:
+      Simd::transform<V>(a, dst, count, [c0](Reg x) { return V::div(c0, x); });
+      break;
+    case EXPR_OP_MIN_C:
+      Simd::transform<V>(a, dst, count, [c0](Reg x) { return V::min(x, c0); });
+      break;
+    case EXPR_OP_MAX_C:
+      Simd::transform<V>(a, dst, count, [c0](Reg x) { return V::max(x, c0); });
+      break;
+    case EXPR_OP_CLAMP_C:
+      Simd::transform<V>(a, dst, count, [c0, c1](Reg x) { return V::min(V::max(x, c0), c1); });
+      break;
+    case EXPR_OP_ABS:
+      Simd::transform<V>(a, dst, count, [](Reg x) { return V::max(x, V::sub(V::zero(), x)); });
+      break;
+    case EXPR_OP_ACTIVATION:
+    {
+      // the table's kernels already loop over a tile, and accept in == out
+      const ActivationKernelArgs activationArgs = {a, dst, nullptr, ins.params};
+      args.activations[ins.activation].modes[args.accuracy].f32(activationArgs, 0, count);
+      break;
+    }
+  }
+}
+
+}
+
+/**
+ * \brief The expression kernel of backend V, instantiated by the ISA specific
+ * translation units. Runs every instruction over one tile before moving to the next.
+ */
+template <typename V>
+void
+exprKernel(const ExprKernelArgs& args, size_t begin, size_t end)
+{
+  alignas(64) float temps[EXPR_MAX_TEMPS][EXPR_TILE_FLOATS];
+  const ExprProgram& program = *args.program;
+  const float* reads[EXPR_NUM_SLOTS];
+  float* writes[EXPR_NUM_SLOTS];
+  for (size_t temp = 0; temp < EXPR_MAX_TEMPS; temp++)
+  {
+    reads[EXPR_SLOT_TEMP + temp] = temps[temp];
+    writes[EXPR_SLOT_TEMP + temp] = temps[temp];
+  }
+  writes[EXPR_SLOT_INPUT] = nullptr;
+
+  for (size_t tile = begin; tile < end; tile += EXPR_TILE_FLOATS)
+  {
+    const size_t count = std::min(EXPR_TILE_FLOATS, end - tile);
+    reads[EXPR_SLOT_INPUT] = args.in + tile;
+    reads[EXPR_SLOT_OUTPUT] = args.out + tile;
+    writes[EXPR_SLOT_OUTPUT] = args.out + tile;
+    for (size_t idx = 0; idx < program.numInstructions; idx++)
+    {
+      ExprDetail::runInstruction<V>(args, program.instructions[idx], reads, writes, count);
+    }
+  }
+}
+
+}
@@ -0,0 +1,120 @@
+//==============================================================================
+//
+// Copyright (c) 2020 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "UdoProfileStats.h"
+
+namespace UdoUtil {
+
+/**
+ * @brief Log-linear latency histogram in nanoseconds, in the spirit of HdrHistogram.
+ *
+ * Every power of two is split into SUB_BUCKETS linear buckets, so a recorded value is
+ * known to within 1/SUB_BUCKETS of itself; values below 2 * SUB_BUCKETS are exact and
+ * values above MAX_VALUE_NS are clamped. record() is a handful of relaxed loads and
+ * stores with no read-modify-write, which relies on one writer at a time: an op's
+ * executes never overlap. merge() and the readers may run on any thread at any time,
+ * readers then see a snapshot that may miss the call being recorded.
+ */
+class UdoLatencyHistogram
+{
+public:
+    static constexpr uint32_t SUB_BUCKET_BITS = 4;
+    static constexpr uint32_t SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+    static constexpr uint32_t MAX_VALUE_BITS = 40; // ~18 minutes
+    static constexpr uint64_t MAX_VALUE_NS = (uint64_t(1) << MAX_VALUE_BITS) - 1;
+    static constexpr uint32_t NUM_BUCKETS = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    UdoLatencyHistogram() { reset(); }
+
+    UdoLatencyHistogram(const UdoLatencyHistogram&) = delete;
+    UdoLatencyHistogram& operator=(const UdoLatencyHistogram&) = delete;
+
+    static uint32_t getBucketIndex(uint64_t valueNs)
+    {
+        valueNs = valueNs < MAX_VALUE_NS ? valueNs : MAX_VALUE_NS;
+        const uint32_t msb = valueNs != 0 ? 63 - static_cast<uint32_t>(__builtin_clzll(valueNs)) : 0;
+        const uint32_t shift = msb > SUB_BUCKET_BITS ? msb - SUB_BUCKET_BITS : 0;
+        return shift * SUB_BUCKETS + static_cast<uint32_t>(valueNs >> shift);
+    }
+
+    /**
+     * \brief Largest value that falls in a bucket.
+     */
+    static uint64_t getBucketUpperBound(uint32_t index)
+    {
+        if (index < 2 * SUB_BUCKETS)
+        {
+            return index;
+        }
+        const uint32_t shift = index / SUB_BUCKETS - 1;
+        const uint64_t mantissa = index - shift * SUB_BUCKETS;
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+    /**
+     * \brief Records one value. Single writer only, see the class comment.
+     */
+    void record(uint64_t valueNs)
+    {
+        std::atomic<uint64_t>& bucket = m_Buckets[getBucketIndex(valueNs)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        m_TotalNs.store(m_TotalNs.load(std::memory_order_relaxed) + valueNs, std::memory_order_relaxed);
+        if (valueNs < m_MinNs.load(std::memory_order_relaxed))
+        {
+            m_MinNs.store(valueNs, std::memory_order_relaxed);
+        }
+        if (valueNs > m_MaxNs.load(std::memory_order_relaxed))
+        {
+            m_MaxNs.store(valueNs, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * \brief Adds the values of another histogram. Safe with concurrent merges and
+     * readers, but not with a concurrent record() on this histogram.
+     */
+    void merge(const UdoLatencyHistogram& other);
+
+    /**
+     * \brief Count, extremes, mean and percentiles. Percentiles are the upper bound of
+     * the bucket holding the requested rank, capped at the maximum.
+     */
+    void getStats(UdoLatencyStats_t& stats) const;
+
+    /**
+     * \brief Value at or below which percentile % of the values fall.
+     */
+    uint64_t getValueAtPercentile(double percentile) const;
+
+    uint64_t getCount() const;
+
+    /**
+     * \brief Whether nothing was recorded or merged since the last reset, without
+     * summing the buckets like getCount().
+     */
+    bool isEmpty() const { return m_MinNs.load(std::memory_order_relaxed) == UINT64_MAX; }
+
+    /**
+     * \brief Not safe with a concurrent record().
+     */
+    void reset();
+
+private:
+    std::atomic<uint64_t> m_Buckets[NUM_BUCKETS];
+    std::atomic<uint64_t> m_TotalNs;
+    std::atomic<uint64_t> m_MinNs;
+    std::atomic<uint64_t> m_MaxNs;
+};
+
+}
@@ -8,29 +8,89 @@
 
 #pragma once
 
-#include <string>
-#include <sstream>
+#include <cstddef>
+#include <cstdio>
 #include <iostream>
+#include <streambuf>
 
+#if defined(__GNUC__)
+#define UDO_UNLIKELY(condition) __builtin_expect(!!(condition), 0)
+#define UDO_COLD __attribute__((cold, noinline))
+#else
+#define UDO_UNLIKELY(condition) (condition)
+#define UDO_COLD
+#endif
 
-#define UDO_ERROR_MSG(status, msg)                              \
-   {                                                            \
-      std::ostringstream oss ## __LINE__;                       \
-      oss ## __LINE__ << msg;                                   \
-      std::cerr<<"ERROR: "<<oss ##__LINE__.str()                \
-      <<"; UDO error code = "<<(int)status<< "; File: "<<__FILE__<<       \
-      "; Function: "<<__FUNCTION__<<" Line : "<<__LINE__<<std::endl; \
+namespace UdoUtil {
+
+/**
+ * @brief Stack buffer that error messages are streamed into, so that reporting an
+ * error does not allocate. Longer messages are truncated.
+ */
+class UdoErrorMessageBuffer : public std::streambuf
+{
+public:
+  UdoErrorMessageBuffer() { setp(m_Data, m_Data + sizeof(m_Data)); }
+
+  const char* getData() const { return m_Data; }
+  int getSize() const { return static_cast<int>(pptr() - pbase()); }
+
+private:
+  char m_Data[384];
+};
+
+/**
+ * \brief Prints a formatted error as one line with one write, so that errors of
+ * concurrent threads do not interleave.
+ */
+inline UDO_COLD void
+printError(int status, const char* file, const char* function, int line, const char* message, int messageSize)
+{
+  char text[768];
+  const int size = std::snprintf(text, sizeof(text), "ERROR: %.*s; UDO error code = %d; File: %s; Function: %s Line : %d\n",
+                                 messageSize, message, status, file, function, line);
+  if (size > 0)
+  {
+    std::cerr.write(text, size < static_cast<int>(sizeof(text)) ? size : static_cast<int>(sizeof(text)) - 1);
+    std::cerr.flush();
+  }
+}
+
+/**
+ * \brief Out of line, cold part of the macros below: streams the message with format
+ * and prints it. The checks thus cost their callers a compare and a branch, and an
+ * error in a hot loop neither allocates nor takes locks.
+ */
+template <typename Fn>
+UDO_COLD void
+reportError(int status, const char* file, const char* function, int line, const Fn& format)
+{
+  UdoErrorMessageBuffer buffer;
+  std::ostream stream(&buffer);
+  format(stream);
+  printError(status, file, function, line, buffer.getData(), buffer.getSize());
+}
+
+}
+
+#define UDO_ERROR_MSG(status, msg)                                                 \
+   {                                                                              \
+      UdoUtil::reportError(static_cast<int>(status), __FILE__, __FUNCTION__, __LINE__, \
+                           [&](std::ostream& udoErrorStream) { udoErrorStream << msg; }); \
    }
 #define UDO_ASSERT_MSG(condition, status, msg)                  \
-   if((condition)) {                                              \
+   if(UDO_UNLIKELY(condition)) {                                \
       UDO_ERROR_MSG(status, msg)                                \
    }
 #define UDO_VALIDATE_MSG(condition, status, msg)                \
-   if((condition)) {                                           \
+   if(UDO_UNLIKELY(condition)) {                                \
       UDO_ERROR_MSG(status, msg)                                \
       return status;                                            \
    }
 #define UDO_VALIDATE_RETURN_STATUS(status)                       \
-   if(status != SNPE_UDO_NO_ERROR) {                             \
-      return status;                                             \
+   {                                                             \
+      const auto udoStatus = (status);                           \
+      if(UDO_UNLIKELY(udoStatus != SNPE_UDO_NO_ERROR)) {         \
+         return udoStatus;                                       \
+      }                                                          \
    }
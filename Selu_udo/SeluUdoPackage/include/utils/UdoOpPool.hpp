@@ -0,0 +1,90 @@
+//==============================================================================
+//
+// Copyright (c) 2020 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "SnpeUdo/UdoImpl.h"
+
+namespace UdoUtil {
+
+// released operations a factory keeps for reuse, unless UDO_CPU_OP_POOL_SIZE is set
+constexpr uint32_t DEFAULT_OP_POOL_SIZE = 16;
+
+struct UdoOpPoolStats
+{
+  size_t numLive;     // ops of the factory created and not yet released
+  size_t highWater;   // most ops of the factory that were live at once
+  size_t numPooled;   // released ops kept for reuse
+  uint64_t numReused; // creates answered with a pooled op
+};
+
+/**
+ * @brief Free list of the released operations of one factory, which later creates with
+ * tensors of the same types reuse instead of constructing, see
+ * UdoOperation::isReusableFor(). Shared by the factory and its live operation handles,
+ * so that a handle released after its factory is simply deleted. Holds at most
+ * capacity ops, and never more than were live at once. Thread safe.
+ */
+class UdoOpPool
+{
+public:
+  explicit UdoOpPool(uint32_t capacity);
+
+  ~UdoOpPool();
+
+  UdoOpPool(const UdoOpPool&) = delete;
+  UdoOpPool& operator=(const UdoOpPool&) = delete;
+
+  /**
+   * \brief Takes a pooled handle whose op accepts these tensors and counts it live. The
+   * caller still has to bind it with UdoOperation::reuse().
+   * @return nullptr when no pooled op fits
+   */
+  SnpeUdo_Operation_t take(uint32_t numOfInputs, const SnpeUdo_TensorParam_t* inputs,
+                           uint32_t numOfOutputs, const SnpeUdo_TensorParam_t* outputs);
+
+  /**
+   * \brief Counts a newly constructed op of the factory live.
+   */
+  void addLive();
+
+  /**
+   * \brief Counts a live op of the factory deleted without being put back.
+   */
+  void dropLive();
+
+  /**
+   * \brief Counts a handle released and keeps it for reuse. Its op must be idle and the
+   * handle must no longer reference the pool.
+   * @return false when the pool is full or closed, the caller then deletes the handle
+   */
+  bool put(SnpeUdo_Operation_t operation);
+
+  /**
+   * \brief Deletes the pooled handles and stops pooling, when the factory is released.
+   */
+  void close();
+
+  void getStats(UdoOpPoolStats& stats);
+
+private:
+  std::mutex m_Mutex;
+  std::vector<SnpeUdo_Operation_t> m_Free; // reserved to m_Capacity, put() does not allocate
+  size_t m_Capacity;
+  bool m_Closed = false;
+  size_t m_NumLive = 0;
+  size_t m_HighWater = 0;
+  uint64_t m_NumReused = 0;
+};
+
+}
@@ -10,6 +10,10 @@
 
 #include "SnpeUdo/UdoBase.h"
 #include "SnpeUdo/UdoImpl.h"
+#include "UdoArena.hpp"
+#include "UdoLatencyHistogram.hpp"
+#include "UdoProfileStats.h"
+#include "UdoStaticTensorStore.hpp"
 #include <string>
 #include <map>
 #include <vector>
@@ -19,6 +23,11 @@ namespace UdoUtil {
 class UdoOperation
 {
 public:
+  /**
+   * \brief Runs the op. Everything it needs is prepared by its creation and by
+   * snpeUdoSetIo(), so execute neither allocates nor waits on a lock other ops hold;
+   * builds with UDO_ALLOC_CHECK=1 abort on any allocation made inside it.
+   */
   virtual SnpeUdo_ErrorType_t
   snpeUdoExecute(bool blocking, uint32_t id, SnpeUdo_ExternalNotify_t notifyFunc) = 0;
 
@@ -27,14 +36,66 @@ public:
 
   virtual SnpeUdo_ErrorType_t snpeUdoProfile(uint32_t* executionTime) = 0;
 
+  /**
+   * \brief Extended profile with nanosecond totals, per phase times and hardware
+   * counters, see UdoProfileStats.h. Ops without a profiler report unsupported.
+   */
+  virtual SnpeUdo_ErrorType_t snpeUdoProfileStats(UdoProfileStats_t*) { return SNPE_UDO_UNSUPPORTED_FEATURE; }
+
+  virtual SnpeUdo_ErrorType_t snpeUdoResetProfileStats() { return SNPE_UDO_UNSUPPORTED_FEATURE; }
+
+  /**
+   * \brief Limits how the op's work is split across threads, see
+   * SnpeUdoExt_setOpParallelism(). Ops that always run on the calling thread report
+   * unsupported.
+   */
+  virtual SnpeUdo_ErrorType_t snpeUdoSetParallelism(uint32_t, size_t) { return SNPE_UDO_UNSUPPORTED_FEATURE; }
+
+  /**
+   * \brief Histogram of execute latencies, nullptr for ops that do not keep one. It can
+   * be read while executes are running.
+   */
+  virtual const UdoLatencyHistogram* getLatencyHistogram() const { return nullptr; }
+
+  /**
+   * \brief Blocks until work started by a non-blocking execute has finished. The
+   * library calls this before releasing the operation.
+   */
+  virtual void waitForCompletion() {}
+
+  /**
+   * \brief Whether a released operation can serve a new create of its factory with
+   * these tensors, see reuse(). Ops that cannot be reused return false.
+   */
+  virtual bool isReusableFor(uint32_t, const SnpeUdo_TensorParam_t*, uint32_t, const SnpeUdo_TensorParam_t*) const
+  {
+    return false;
+  }
+
+  /**
+   * \brief Binds a released operation to the tensors of a new create that
+   * isReusableFor() accepted, and clears what it recorded for its previous user.
+   */
+  virtual SnpeUdo_ErrorType_t reuse(SnpeUdo_TensorParam_t*, SnpeUdo_TensorParam_t*)
+  {
+    return SNPE_UDO_UNSUPPORTED_FEATURE;
+  }
+
   virtual ~UdoOperation() = default;
 
 protected:
-    std::vector<SnpeUdo_TensorParam_t*> m_Inputs;
-    std::vector<SnpeUdo_TensorParam_t*> m_Outputs;
+    // the tensor params, their dimensions and the static params with their names are
+    // all copied into m_Arena, which owns them. Static tensor data is shared through
+    // the library's UdoStaticTensorStore and m_StaticTensors keeps it alive, unless it
+    // is borrowed from the runtime. Ops resolve m_Params to the slots of their
+    // UdoParamSchema when they are created.
+    UdoArena m_Arena;
+    ArenaSpan<SnpeUdo_TensorParam_t*> m_Inputs;
+    ArenaSpan<SnpeUdo_TensorParam_t*> m_Outputs;
     uint32_t m_ExecutionTime;
     uint32_t m_NumOfStaticParams;
-    std::map<std::string, SnpeUdo_Param_t*> m_Params;
+    ArenaSpan<SnpeUdo_Param_t> m_Params;
+    std::vector<UdoStaticBlobRef> m_StaticTensors;
 };
 
 }
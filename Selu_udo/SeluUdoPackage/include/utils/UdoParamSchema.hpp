@@ -0,0 +1,213 @@
+//==============================================================================
+//
+// Copyright (c) 2020 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "SnpeUdo/UdoBase.h"
+
+/**
+ * Typed static param schemas. An op declares its params once, as an array of
+ * UdoParamSpec indexed by an enum of slots:
+ *
+ *   enum MyParamSlot : size_t { MY_PARAM_ALPHA, MY_NUM_PARAMS };
+ *   constexpr UdoUtil::UdoParamSpec MY_PARAM_SCHEMA[MY_NUM_PARAMS] = {
+ *       UdoUtil::scalarParamSpec<float>("alpha", false)};
+ *
+ * UdoParamTable::resolve() matches the params an op was created with against the
+ * schema once, and rejects unknown names, wrong types and missing required params.
+ * Kernels then read params by slot, without string compares.
+ */
+namespace UdoUtil {
+
+/**
+ * \brief Data type a scalar param of C++ type T is registered with.
+ */
+template <typename T> struct UdoScalarType;
+template <> struct UdoScalarType<float>    { static constexpr SnpeUdo_DataType_t value = SNPE_UDO_DATATYPE_FLOAT_32; };
+template <> struct UdoScalarType<uint32_t> { static constexpr SnpeUdo_DataType_t value = SNPE_UDO_DATATYPE_UINT_32; };
+template <> struct UdoScalarType<int32_t>  { static constexpr SnpeUdo_DataType_t value = SNPE_UDO_DATATYPE_INT_32; };
+template <> struct UdoScalarType<bool>     { static constexpr SnpeUdo_DataType_t value = SNPE_UDO_DATATYPE_UINT_8; };
+
+struct UdoParamSpec
+{
+  const char* name;
+  SnpeUdo_ParamType_t paramType;
+  SnpeUdo_DataType_t dataType; // scalar and tensor params only
+  bool required;
+};
+
+template <typename T>
+constexpr UdoParamSpec
+scalarParamSpec(const char* name, bool required)
+{
+  return UdoParamSpec{name, SNPE_UDO_PARAMTYPE_SCALAR, UdoScalarType<T>::value, required};
+}
+
+constexpr UdoParamSpec
+tensorParamSpec(const char* name, SnpeUdo_DataType_t dataType, bool required)
+{
+  return UdoParamSpec{name, SNPE_UDO_PARAMTYPE_TENSOR, dataType, required};
+}
+
+constexpr UdoParamSpec
+stringParamSpec(const char* name, bool required)
+{
+  return UdoParamSpec{name, SNPE_UDO_PARAMTYPE_STRING, SNPE_UDO_DATATYPE_LAST, required};
+}
+
+inline bool
+isIntegerScalarType(SnpeUdo_DataType_t dataType)
+{
+  switch (dataType)
+  {
+    case SNPE_UDO_DATATYPE_UINT_8:
+    case SNPE_UDO_DATATYPE_UINT_16:
+    case SNPE_UDO_DATATYPE_UINT_32:
+    case SNPE_UDO_DATATYPE_INT_8:
+    case SNPE_UDO_DATATYPE_INT_16:
+    case SNPE_UDO_DATATYPE_INT_32:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/**
+ * \brief Whether a scalar of the given type can be read as the schema's type. The
+ * converters write integer params with whatever width the model used, so integer
+ * params accept any integer type, and float params also accept integers.
+ */
+inline bool
+isScalarConvertible(SnpeUdo_DataType_t from, SnpeUdo_DataType_t to)
+{
+  if (to == SNPE_UDO_DATATYPE_FLOAT_32)
+  {
+    return from == SNPE_UDO_DATATYPE_FLOAT_32 || isIntegerScalarType(from);
+  }
+  return isIntegerScalarType(to) && isIntegerScalarType(from);
+}
+
+/**
+ * \brief Value of a scalar param as T, see isScalarConvertible().
+ */
+template <typename T>
+T
+getScalarValue(const SnpeUdo_ScalarParam_t& scalar)
+{
+  const SnpeUdo_Value_t& data = scalar.dataValue;
+  switch (scalar.dataType)
+  {
+    case SNPE_UDO_DATATYPE_FLOAT_32: return static_cast<T>(data.floatValue);
+    case SNPE_UDO_DATATYPE_UINT_32:  return static_cast<T>(data.uint32Value);
+    case SNPE_UDO_DATATYPE_INT_32:   return static_cast<T>(data.int32Value);
+    case SNPE_UDO_DATATYPE_UINT_16:  return static_cast<T>(data.uint16Value);
+    case SNPE_UDO_DATATYPE_INT_16:   return static_cast<T>(data.int16Value);
+    case SNPE_UDO_DATATYPE_UINT_8:   return static_cast<T>(data.uint8Value);
+    case SNPE_UDO_DATATYPE_INT_8:    return static_cast<T>(data.int8Value);
+    default:                         return T();
+  }
+}
+
+/**
+ * @brief Params of one op resolved to the slots of its schema. The table points at
+ * the params it was resolved from, which must outlive it.
+ */
+template <size_t NumSlots>
+class UdoParamTable
+{
+public:
+  UdoParamTable()
+  {
+    for (size_t slot = 0; slot < NumSlots; slot++) { m_Slots[slot] = nullptr; }
+  }
+
+  /**
+   * \brief Assigns every param to the slot of its name.
+   * @return SNPE_UDO_WRONG_OPERATION for names not in the schema or params given twice,
+   *         SNPE_UDO_WRONG_DATATYPE for a param type or data type that does not match,
+   *         SNPE_UDO_WRONG_NUM_OF_PARAMS when a required param is missing
+   */
+  SnpeUdo_ErrorType_t
+  resolve(const UdoParamSpec (&schema)[NumSlots], const SnpeUdo_Param_t* params, size_t numOfParams)
+  {
+    for (size_t slot = 0; slot < NumSlots; slot++) { m_Slots[slot] = nullptr; }
+    for (size_t idx = 0; idx < numOfParams; idx++)
+    {
+      const SnpeUdo_Param_t& param = params[idx];
+      size_t slot = 0;
+      while (slot < NumSlots && (param.paramName == nullptr || std::strcmp(schema[slot].name, param.paramName) != 0))
+      {
+        slot++;
+      }
+      if (slot == NumSlots || m_Slots[slot] != nullptr)
+      {
+        return SNPE_UDO_WRONG_OPERATION;
+      }
+      if (!matches(schema[slot], param))
+      {
+        return SNPE_UDO_WRONG_DATATYPE;
+      }
+      m_Slots[slot] = &param;
+    }
+    for (size_t slot = 0; slot < NumSlots; slot++)
+    {
+      if (schema[slot].required && m_Slots[slot] == nullptr)
+      {
+        return SNPE_UDO_WRONG_NUM_OF_PARAMS;
+      }
+    }
+    return SNPE_UDO_NO_ERROR;
+  }
+
+  bool has(size_t slot) const { return m_Slots[slot] != nullptr; }
+
+  /**
+   * \brief The scalar in a slot as T, defaultValue when the op was created without it.
+   */
+  template <typename T>
+  T getScalar(size_t slot, T defaultValue) const
+  {
+    return has(slot) ? getScalarValue<T>(m_Slots[slot]->scalarParam) : defaultValue;
+  }
+
+  const SnpeUdo_TensorParam_t* getTensor(size_t slot) const
+  {
+    return has(slot) ? &m_Slots[slot]->tensorParam : nullptr;
+  }
+
+  const char* getString(size_t slot) const
+  {
+    return has(slot) ? m_Slots[slot]->stringParam : nullptr;
+  }
+
+private:
+  static bool matches(const UdoParamSpec& spec, const SnpeUdo_Param_t& param)
+  {
+    if (param.paramType != spec.paramType)
+    {
+      return false;
+    }
+    switch (param.paramType)
+    {
+      case SNPE_UDO_PARAMTYPE_SCALAR:
+        return isScalarConvertible(param.scalarParam.dataType, spec.dataType);
+      case SNPE_UDO_PARAMTYPE_TENSOR:
+        return param.tensorParam.dataType == spec.dataType;
+      default:
+        return true;
+    }
+  }
+
+  const SnpeUdo_Param_t* m_Slots[NumSlots];
+};
+
+}
@@ -0,0 +1,83 @@
+//==============================================================================
+//
+// Copyright (c) 2020 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+#pragma once
+#include "SnpeUdo/UdoImpl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// phases of one execute, see UdoProfileStats_t
+typedef enum {
+    UDO_PROFILE_PHASE_SETUP  = 0, // validating and updating the op's plan on the calling thread
+    UDO_PROFILE_PHASE_QUEUE  = 1, // non-blocking executes only: waiting for the background thread
+    UDO_PROFILE_PHASE_KERNEL = 2, // start of the kernel until its last chunk finished
+    UDO_PROFILE_PHASE_JOIN   = 3, // last chunk finished until the driving thread saw it
+    UDO_PROFILE_NUM_PHASES   = 4
+} UdoProfilePhase_t;
+
+// extended profile of an operation, cumulative since creation or the last reset
+typedef struct {
+    uint64_t numCalls;
+    uint64_t lastNs;
+    uint64_t totalNs;
+    uint64_t minNs;
+    uint64_t maxNs;
+    uint64_t lastPhaseNs[UDO_PROFILE_NUM_PHASES];
+    uint64_t totalPhaseNs[UDO_PROFILE_NUM_PHASES];
+    // hardware counters of the thread driving the kernel phase, collected when the
+    // UDO_CPU_PERF_COUNTERS environment variable is set and perf_event_open is allowed
+    uint32_t hwCountersValid;
+    uint64_t cycles;
+    uint64_t instructions;
+    uint64_t cacheMisses;
+} UdoProfileStats_t;
+
+// latency distribution of executes, percentiles are accurate to within 1/16 of the value
+typedef struct {
+    uint64_t count;
+    uint64_t minNs;
+    uint64_t maxNs;
+    uint64_t meanNs;
+    uint64_t p50Ns;
+    uint64_t p90Ns;
+    uint64_t p99Ns;
+    uint64_t p999Ns;
+} UdoLatencyStats_t;
+
+// extension entry points of the CPU implementation library, resolve them with dlsym
+SnpeUdo_ErrorType_t
+SnpeUdoExt_getOpProfileStats(SnpeUdo_Operation_t operation, UdoProfileStats_t* stats);
+
+SnpeUdo_ErrorType_t
+SnpeUdoExt_resetOpProfileStats(SnpeUdo_Operation_t operation);
+
+// latency of one operation since creation or the last SnpeUdoExt_resetOpProfileStats
+SnpeUdo_ErrorType_t
+SnpeUdoExt_getOpLatencyStats(SnpeUdo_Operation_t operation, UdoLatencyStats_t* stats);
+
+// latency of all released operations of a type, merged when each was released
+SnpeUdo_ErrorType_t
+SnpeUdoExt_getOpTypeLatencyStats(SnpeUdo_String_t operationType, UdoLatencyStats_t* stats);
+
+// caps the threads an operation's executes use, 0 for every scheduler thread, and sets
+// the minimum elements per chunk, 0 for the default of 16384. Applies from the next
+// execute until the operation is released.
+SnpeUdo_ErrorType_t
+SnpeUdoExt_setOpParallelism(SnpeUdo_Operation_t operation, uint32_t maxThreads, uint32_t grainSize);
+
+typedef SnpeUdo_ErrorType_t (*fptrGetOpProfileStats)(SnpeUdo_Operation_t, UdoProfileStats_t*);
+typedef SnpeUdo_ErrorType_t (*fptrResetOpProfileStats)(SnpeUdo_Operation_t);
+typedef SnpeUdo_ErrorType_t (*fptrGetOpLatencyStats)(SnpeUdo_Operation_t, UdoLatencyStats_t*);
+typedef SnpeUdo_ErrorType_t (*fptrGetOpTypeLatencyStats)(SnpeUdo_String_t, UdoLatencyStats_t*);
+typedef SnpeUdo_ErrorType_t (*fptrSetOpParallelism)(SnpeUdo_Operation_t, uint32_t, uint32_t);
+
+#ifdef __cplusplus
+}
+#endif
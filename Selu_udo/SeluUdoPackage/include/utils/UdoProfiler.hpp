@@ -0,0 +1,84 @@
+//==============================================================================
+//
+// Copyright (c) 2019 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "UdoProfileStats.h"
+
+namespace UdoUtil {
+
+/**
+ * @brief Per operation profiler with nanosecond timestamps.
+ *
+ * An execute calls beginCall(), endSetup(), beginKernel() and endCall() in that
+ * order; kernel chunks call markChunkEnd() so the time spent waiting for the slowest
+ * chunk is reported as the join phase. beginKernel() and endCall() must run on the
+ * same thread, which is where hardware counters are read. The timeline belongs to the
+ * one execute in flight. Its stats are published under a sequence count, so that
+ * endCall() never waits for a reader; getStats() retries while a call is ending.
+ */
+class UdoProfiler
+{
+public:
+  static uint64_t nowNs()
+  {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+  }
+
+  UdoProfiler();
+
+  void beginCall() { m_CallStartNs = nowNs(); }
+
+  void endSetup() { m_SetupEndNs = nowNs(); }
+
+  void beginKernel();
+
+  void markChunkEnd()
+  {
+    const uint64_t now = nowNs();
+    uint64_t last = m_LastChunkEndNs.load(std::memory_order_relaxed);
+    while (now > last && !m_LastChunkEndNs.compare_exchange_weak(last, now, std::memory_order_relaxed)) {}
+  }
+
+  /**
+   * @return wall time of the call in nanoseconds
+   */
+  uint64_t endCall();
+
+  void getStats(UdoProfileStats_t& stats) const;
+
+  /**
+   * \brief Not safe with a concurrent endCall(), like the op's other setup calls.
+   */
+  void reset();
+
+private:
+  uint64_t m_CallStartNs = 0;
+  uint64_t m_SetupEndNs = 0;
+  uint64_t m_KernelStartNs = 0;
+  std::atomic<uint64_t> m_LastChunkEndNs;
+  bool m_CountersStarted = false;
+  uint64_t m_CountersStart[3];
+
+  static constexpr size_t NUM_STATS_WORDS = sizeof(UdoProfileStats_t) / sizeof(uint64_t);
+  static_assert(sizeof(UdoProfileStats_t) % sizeof(uint64_t) == 0, "stats are published as whole words");
+
+  void publishStats();
+
+  UdoProfileStats_t m_Stats; // written by endCall() and reset() only
+  std::atomic<uint32_t> m_StatsSeq; // odd while m_StatsWords is being written
+  std::atomic<uint64_t> m_StatsWords[NUM_STATS_WORDS];
+};
+
+}
@@ -0,0 +1,330 @@
+//==============================================================================
+//
+// Copyright (c) 2019 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "SnpeUdo/UdoBase.h"
+
+#if defined(__SSSE3__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+/**
+ * Helpers for activations on unsigned TF-quantized tensors.
+ *
+ * An elementwise function of an 8-bit tensor is a 256 entry table from input to
+ * output codes, looked up with byte shuffles. 16-bit tensors use a piecewise
+ * linear table that is interpolated in float and rounded once.
+ *
+ * The lookup functions are static so that each ISA specific translation unit
+ * keeps its own copy, built with its own flags.
+ */
+namespace UdoUtil {
+
+/**
+ * \brief Affine encoding of an unsigned quantized tensor, real = (q - zeroPoint) * scale.
+ */
+struct QuantEncoding
+{
+  float scale;
+  int32_t zeroPoint;
+  int32_t maxValue;
+};
+
+/**
+ * \brief Bit width of the quantized types handled here, 0 for any other type.
+ */
+inline uint32_t
+getQuantizedBitWidth(SnpeUdo_DataType_t dataType)
+{
+  switch (dataType)
+  {
+    case SNPE_UDO_DATATYPE_FIXED_8:
+    case SNPE_UDO_DATATYPE_UINT_8:
+      return 8;
+    case SNPE_UDO_DATATYPE_FIXED_16:
+      return 16;
+    default:
+      return 0;
+  }
+}
+
+/**
+ * \brief Reads the TF encoding of a quantized tensor.
+ * @return false when the tensor has no TF encoding or its range is empty.
+ */
+inline bool
+getQuantEncoding(const SnpeUdo_TensorParam_t& tensor, uint32_t bitWidth, QuantEncoding& encoding)
+{
+  if (tensor.quantizeParams.quantizeType != SNPE_UDO_QUANTIZATION_TF)
+  {
+    return false;
+  }
+  const float minValue = tensor.quantizeParams.TFParams.minValue;
+  const float maxValue = tensor.quantizeParams.TFParams.maxValue;
+  if (!(maxValue > minValue))
+  {
+    return false;
+  }
+  encoding.maxValue = static_cast<int32_t>((1u << bitWidth) - 1);
+  encoding.scale = (maxValue - minValue) / encoding.maxValue;
+  encoding.zeroPoint = std::min(encoding.maxValue,
+                                std::max(0, static_cast<int32_t>(std::lround(-minValue / encoding.scale))));
+  return true;
+}
+
+inline bool
+operator==(const QuantEncoding& a, const QuantEncoding& b)
+{
+  return a.scale == b.scale && a.zeroPoint == b.zeroPoint && a.maxValue == b.maxValue;
+}
+
+inline double
+dequantize(const QuantEncoding& encoding, int32_t q)
+{
+  return static_cast<double>(q - encoding.zeroPoint) * encoding.scale;
+}
+
+/**
+ * \brief Real value to output code units, unrounded and unclamped.
+ */
+inline double
+toQuantizedUnits(const QuantEncoding& encoding, double x)
+{
+  return x / encoding.scale + encoding.zeroPoint;
+}
+
+inline int32_t
+quantize(const QuantEncoding& encoding, double x)
+{
+  const double q = std::floor(toQuantizedUnits(encoding, x) + 0.5);
+  return static_cast<int32_t>(std::min<double>(encoding.maxValue, std::max(0.0, q)));
+}
+
+/**
+ * \brief Builds table[q] = quantize(out, fn(dequantize(in, q))) for every 8-bit code.
+ */
+template <typename Fn>
+void
+buildTable8(const QuantEncoding& in, const QuantEncoding& out, Fn fn, uint8_t* table)
+{
+  for (int32_t q = 0; q < 256; q++)
+  {
+    table[q] = static_cast<uint8_t>(quantize(out, fn(dequantize(in, q))));
+  }
+}
+
+/**
+ * @brief Piecewise linear approximation of a function over 16-bit codes.
+ * Code q belongs to segment (q + bias) >> SEGMENT_BITS, which holds the output at its
+ * first code, in output code units, followed by the slope per input code. bias places
+ * one chosen breakpoint, e.g. the kink of an activation, on a segment boundary so the
+ * kink is reproduced exactly.
+ */
+struct InterpTable16
+{
+  static constexpr uint32_t SEGMENT_BITS = 4;
+  static constexpr uint32_t SEGMENT_MASK = (1u << SEGMENT_BITS) - 1;
+
+  uint32_t bias = 0;
+  float maxValue = 0.0f;
+  std::vector<float> segments;
+};
+
+template <typename Fn>
+void
+buildInterpTable16(const QuantEncoding& in, const QuantEncoding& out, int32_t breakpoint, Fn fn,
+                   InterpTable16& table)
+{
+  const uint32_t segmentSize = 1u << InterpTable16::SEGMENT_BITS;
+  table.bias = (segmentSize - static_cast<uint32_t>(breakpoint) % segmentSize) % segmentSize;
+  table.maxValue = static_cast<float>(out.maxValue);
+
+  const uint32_t numSegments = ((65535u + table.bias) >> InterpTable16::SEGMENT_BITS) + 1;
+  table.segments.resize(2 * numSegments);
+  for (uint32_t segment = 0; segment < numSegments; segment++)
+  {
+    const int32_t first = static_cast<int32_t>(segment * segmentSize) - static_cast<int32_t>(table.bias);
+    const double start = toQuantizedUnits(out, fn(dequantize(in, first)));
+    const double end = toQuantizedUnits(out, fn(dequantize(in, first + static_cast<int32_t>(segmentSize))));
+    table.segments[2 * segment] = static_cast<float>(start);
+    table.segments[2 * segment + 1] = static_cast<float>((end - start) / segmentSize);
+  }
+}
+
+//==============================================================================
+// 8-bit table lookup
+//==============================================================================
+static inline void
+lookupTable8Scalar(const uint8_t* table, const uint8_t* in, uint8_t* out, size_t count)
+{
+  for (size_t i = 0; i < count; i++)
+  {
+    out[i] = table[in[i]];
+  }
+}
+
+#if defined(__SSSE3__)
+/**
+ * \brief One shuffle per 16 entry slice of the table. The index is rebased onto the
+ * slice and offset with unsigned saturation so that every lane outside the slice has
+ * bit 7 set, which the shuffle turns into 0; the slices are then OR'd together.
+ */
+static inline __m128i
+lookupTable8Sse(const __m128i* slices, __m128i idx)
+{
+  const __m128i sliceStep = _mm_set1_epi8(0x10);
+  const __m128i outOfSlice = _mm_set1_epi8(0x70);
+  __m128i result = _mm_setzero_si128();
+  for (int slice = 0; slice < 16; slice++)
+  {
+    result = _mm_or_si128(result, _mm_shuffle_epi8(slices[slice], _mm_adds_epu8(idx, outOfSlice)));
+    idx = _mm_sub_epi8(idx, sliceStep);
+  }
+  return result;
+}
+
+static inline void
+lookupTable8Ssse3(const uint8_t* table, const uint8_t* in, uint8_t* out, size_t count)
+{
+  __m128i slices[16];
+  for (int slice = 0; slice < 16; slice++)
+  {
+    slices[slice] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(table + 16 * slice));
+  }
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16)
+  {
+    const __m128i idx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), lookupTable8Sse(slices, idx));
+  }
+  lookupTable8Scalar(table, in + i, out + i, count - i);
+}
+#endif
+
+#if defined(__AVX2__)
+static inline void
+lookupTable8Avx2(const uint8_t* table, const uint8_t* in, uint8_t* out, size_t count)
+{
+  // vpshufb shuffles within 128-bit lanes, so each slice is broadcast to both
+  __m256i slices[16];
+  for (int slice = 0; slice < 16; slice++)
+  {
+    slices[slice] = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(table + 16 * slice)));
+  }
+  const __m256i sliceStep = _mm256_set1_epi8(0x10);
+  const __m256i outOfSlice = _mm256_set1_epi8(0x70);
+  size_t i = 0;
+  for (; i + 32 <= count; i += 32)
+  {
+    __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+    __m256i result = _mm256_setzero_si256();
+    for (int slice = 0; slice < 16; slice++)
+    {
+      result = _mm256_or_si256(result, _mm256_shuffle_epi8(slices[slice], _mm256_adds_epu8(idx, outOfSlice)));
+      idx = _mm256_sub_epi8(idx, sliceStep);
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), result);
+  }
+  lookupTable8Scalar(table, in + i, out + i, count - i);
+}
+#endif
+
+#if defined(__aarch64__)
+static inline uint8x16x4_t
+loadTable8Quarter(const uint8_t* table)
+{
+  uint8x16x4_t quarter;
+  quarter.val[0] = vld1q_u8(table);
+  quarter.val[1] = vld1q_u8(table + 16);
+  quarter.val[2] = vld1q_u8(table + 32);
+  quarter.val[3] = vld1q_u8(table + 48);
+  return quarter;
+}
+
+static inline void
+lookupTable8Neon(const uint8_t* table, const uint8_t* in, uint8_t* out, size_t count)
+{
+  // tbx leaves lanes whose index is out of its 64 byte range untouched
+  const uint8x16x4_t q0 = loadTable8Quarter(table);
+  const uint8x16x4_t q1 = loadTable8Quarter(table + 64);
+  const uint8x16x4_t q2 = loadTable8Quarter(table + 128);
+  const uint8x16x4_t q3 = loadTable8Quarter(table + 192);
+  const uint8x16_t quarterStep = vdupq_n_u8(64);
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16)
+  {
+    uint8x16_t idx = vld1q_u8(in + i);
+    uint8x16_t result = vqtbl4q_u8(q0, idx);
+    idx = vsubq_u8(idx, quarterStep);
+    result = vqtbx4q_u8(result, q1, idx);
+    idx = vsubq_u8(idx, quarterStep);
+    result = vqtbx4q_u8(result, q2, idx);
+    idx = vsubq_u8(idx, quarterStep);
+    result = vqtbx4q_u8(result, q3, idx);
+    vst1q_u8(out + i, result);
+  }
+  lookupTable8Scalar(table, in + i, out + i, count - i);
+}
+#endif
+
+//==============================================================================
+// 16-bit interpolated table lookup
+//==============================================================================
+static inline void
+lookupInterp16Scalar(const InterpTable16& table, const uint16_t* in, uint16_t* out, size_t count)
+{
+  const float* segments = table.segments.data();
+  const float roundMagic = 12582912.0f; // 1.5 * 2^23, rounds to nearest even like the vector paths
+  for (size_t i = 0; i < count; i++)
+  {
+    const uint32_t u = in[i] + table.bias;
+    const float* segment = segments + 2 * (u >> InterpTable16::SEGMENT_BITS);
+    float y = segment[0] + segment[1] * static_cast<float>(u & InterpTable16::SEGMENT_MASK);
+    y = std::min(table.maxValue, std::max(0.0f, y));
+    out[i] = static_cast<uint16_t>((y + roundMagic) - roundMagic);
+  }
+}
+
+#if defined(__AVX2__) && defined(__FMA__)
+static inline void
+lookupInterp16Avx2(const InterpTable16& table, const uint16_t* in, uint16_t* out, size_t count)
+{
+  const float* segments = table.segments.data();
+  const __m256i bias = _mm256_set1_epi32(static_cast<int32_t>(table.bias));
+  const __m256i segmentMask = _mm256_set1_epi32(InterpTable16::SEGMENT_MASK);
+  const __m256 maxValue = _mm256_set1_ps(table.maxValue);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m256i u = _mm256_add_epi32(
+        _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i))), bias);
+    const __m256i idx = _mm256_slli_epi32(_mm256_srli_epi32(u, InterpTable16::SEGMENT_BITS), 1);
+    const __m256 start = _mm256_i32gather_ps(segments, idx, 4);
+    const __m256 slope = _mm256_i32gather_ps(segments + 1, idx, 4);
+    __m256 y = _mm256_fmadd_ps(slope, _mm256_cvtepi32_ps(_mm256_and_si256(u, segmentMask)), start);
+    y = _mm256_min_ps(maxValue, _mm256_max_ps(_mm256_setzero_ps(), y));
+    const __m256i q = _mm256_cvtps_epi32(y);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+                     _mm_packus_epi32(_mm256_castsi256_si128(q), _mm256_extracti128_si256(q, 1)));
+  }
+  lookupInterp16Scalar(table, in + i, out + i, count - i);
+}
+#endif
+
+}
@@ -0,0 +1,637 @@
+//==============================================================================
+//
+// Copyright (c) 2019 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE4_1__) || defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+/**
+ * @brief Portable float32 vector types for UDO CPU kernels.
+ *
+ * A kernel is written once as a template over VecF32<Isa> and instantiated in
+ * one translation unit per instruction set. A backend is only defined when the
+ * including translation unit is compiled with that instruction set enabled, so
+ * each ISA specific instantiation must live in a file built with the matching
+ * flags (see jni/src/CPU/Makefile) and be selected at runtime through
+ * UdoUtil::getCpuFeatures().
+ *
+ * Every backend provides:
+ *   Width                        number of float lanes
+ *   Reg, Mask                    register and comparison mask types
+ *   load/store                   unaligned full-width access
+ *   loadPartial/storePartial     access to the first n < Width lanes
+ *   loadHalf/storeHalf           IEEE half precision memory, float32 registers
+ *   loadHalfPartial/storeHalfPartial
+ *   set1, zero, add, sub, mul, div
+ *   fmadd(a, b, c) = a * b + c,  fnmadd(a, b, c) = c - a * b
+ *   min(a, b), max(a, b)         return b when either operand is NaN
+ *                                (NEON returns NaN)
+ *   cmpgt(a, b), select(m, a, b) lane-wise m ? a : b
+ *   round(a)                     round to nearest integer, |a| < 2^22
+ *   pow2(n)                      2^n for integer valued n in [-126, 127]
+ */
+namespace UdoUtil {
+namespace Simd {
+
+using Half = uint16_t;
+
+struct ScalarIsa {};
+struct Sse4Isa {};
+struct Avx2Isa {};
+struct Avx512Isa {};
+struct NeonIsa {};
+
+template <typename Isa>
+struct VecF32;
+
+/**
+ * \brief Portable half <-> float conversions, used where the ISA has no conversion
+ * instructions. Declared static so that every translation unit keeps its own copy
+ * built with its own flags.
+ */
+static inline float
+halfToFloat(Half h)
+{
+  const uint32_t sign = static_cast<uint32_t>(h & 0x8000u) << 16;
+  uint32_t exponent = (h >> 10) & 0x1fu;
+  uint32_t mantissa = h & 0x3ffu;
+  uint32_t bits;
+  if (exponent == 0x1fu)
+  {
+    bits = sign | 0x7f800000u | (mantissa << 13);
+  }
+  else if (exponent != 0)
+  {
+    bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+  }
+  else if (mantissa == 0)
+  {
+    bits = sign;
+  }
+  else
+  {
+    // subnormal half, renormalize into a float
+    exponent = 113;
+    while ((mantissa & 0x400u) == 0)
+    {
+      mantissa <<= 1;
+      exponent--;
+    }
+    bits = sign | (exponent << 23) | ((mantissa & 0x3ffu) << 13);
+  }
+  float result;
+  std::memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+static inline Half
+floatToHalf(float f)
+{
+  // round to nearest even, after F. Giesen's float_to_half_fast3_rtne
+  uint32_t bits;
+  std::memcpy(&bits, &f, sizeof(bits));
+  const uint32_t sign = (bits >> 16) & 0x8000u;
+  bits &= 0x7fffffffu;
+
+  if (bits >= 0x7f800000u)
+  {
+    return static_cast<Half>(sign | 0x7c00u | (bits > 0x7f800000u ? 0x200u : 0u));
+  }
+  if (bits >= 0x477ff000u)
+  {
+    return static_cast<Half>(sign | 0x7c00u);
+  }
+  if (bits < 0x38800000u)
+  {
+    // below the smallest normal half, let the FPU round the subnormal by adding 0.5f
+    float magnitude;
+    std::memcpy(&magnitude, &bits, sizeof(magnitude));
+    magnitude += 0.5f;
+    std::memcpy(&bits, &magnitude, sizeof(bits));
+    return static_cast<Half>(sign | (bits - 0x3f000000u));
+  }
+  bits += 0xc8000fffu + ((bits >> 13) & 1u);
+  return static_cast<Half>(sign | (bits >> 13));
+}
+
+//==============================================================================
+// Scalar backend, always available
+//==============================================================================
+template <>
+struct VecF32<ScalarIsa>
+{
+  using Reg = float;
+  using Mask = bool;
+  static constexpr size_t Width = 1;
+
+  static Reg load(const float* p) { return *p; }
+  static void store(float* p, Reg a) { *p = a; }
+  static Reg loadPartial(const float* p, size_t) { return *p; }
+  static void storePartial(float* p, Reg a, size_t) { *p = a; }
+  static Reg loadHalf(const Half* p) { return halfToFloat(*p); }
+  static void storeHalf(Half* p, Reg a) { *p = floatToHalf(a); }
+  static Reg loadHalfPartial(const Half* p, size_t) { return halfToFloat(*p); }
+  static void storeHalfPartial(Half* p, Reg a, size_t) { *p = floatToHalf(a); }
+  static Reg set1(float a) { return a; }
+  static Reg zero() { return 0.0f; }
+  static Reg add(Reg a, Reg b) { return a + b; }
+  static Reg sub(Reg a, Reg b) { return a - b; }
+  static Reg mul(Reg a, Reg b) { return a * b; }
+  static Reg div(Reg a, Reg b) { return a / b; }
+  static Reg fmadd(Reg a, Reg b, Reg c) { return a * b + c; }
+  static Reg fnmadd(Reg a, Reg b, Reg c) { return c - a * b; }
+  static Reg min(Reg a, Reg b) { return a < b ? a : b; }
+  static Reg max(Reg a, Reg b) { return a > b ? a : b; }
+  static Mask cmpgt(Reg a, Reg b) { return a > b; }
+  static Reg select(Mask m, Reg a, Reg b) { return m ? a : b; }
+
+  static Reg round(Reg a)
+  {
+    // adding 1.5 * 2^23 pushes the fraction out of the mantissa with round-to-nearest-even
+    const float magic = 12582912.0f;
+    return (a + magic) - magic;
+  }
+
+  static Reg pow2(Reg n)
+  {
+    const uint32_t bits = static_cast<uint32_t>(static_cast<int32_t>(n) + 127) << 23;
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+  }
+};
+
+//==============================================================================
+// SSE4.1 backend
+//==============================================================================
+#if defined(__SSE4_1__)
+template <>
+struct VecF32<Sse4Isa>
+{
+  using Reg = __m128;
+  using Mask = __m128;
+  static constexpr size_t Width = 4;
+
+  static Reg load(const float* p) { return _mm_loadu_ps(p); }
+  static void store(float* p, Reg a) { _mm_storeu_ps(p, a); }
+
+  static Reg loadPartial(const float* p, size_t n)
+  {
+    float buf[Width] = {0.0f, 0.0f, 0.0f, 0.0f};
+    for (size_t i = 0; i < n; ++i) { buf[i] = p[i]; }
+    return _mm_loadu_ps(buf);
+  }
+
+  static void storePartial(float* p, Reg a, size_t n)
+  {
+    float buf[Width];
+    _mm_storeu_ps(buf, a);
+    for (size_t i = 0; i < n; ++i) { p[i] = buf[i]; }
+  }
+
+  // SSE has no half conversions, F16C hosts take the AVX2 path instead
+  static Reg loadHalfPartial(const Half* p, size_t n)
+  {
+    float buf[Width] = {0.0f, 0.0f, 0.0f, 0.0f};
+    for (size_t i = 0; i < n; ++i) { buf[i] = halfToFloat(p[i]); }
+    return _mm_loadu_ps(buf);
+  }
+
+  static void storeHalfPartial(Half* p, Reg a, size_t n)
+  {
+    float buf[Width];
+    _mm_storeu_ps(buf, a);
+    for (size_t i = 0; i < n; ++i) { p[i] = floatToHalf(buf[i]); }
+  }
+
+  static Reg loadHalf(const Half* p) { return loadHalfPartial(p, Width); }
+  static void storeHalf(Half* p, Reg a) { storeHalfPartial(p, a, Width); }
+
+  static Reg set1(float a) { return _mm_set1_ps(a); }
+  static Reg zero() { return _mm_setzero_ps(); }
+  static Reg add(Reg a, Reg b) { return _mm_add_ps(a, b); }
+  static Reg sub(Reg a, Reg b) { return _mm_sub_ps(a, b); }
+  static Reg mul(Reg a, Reg b) { return _mm_mul_ps(a, b); }
+  static Reg div(Reg a, Reg b) { return _mm_div_ps(a, b); }
+  static Reg fmadd(Reg a, Reg b, Reg c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+  static Reg fnmadd(Reg a, Reg b, Reg c) { return _mm_sub_ps(c, _mm_mul_ps(a, b)); }
+  static Reg min(Reg a, Reg b) { return _mm_min_ps(a, b); }
+  static Reg max(Reg a, Reg b) { return _mm_max_ps(a, b); }
+  static Mask cmpgt(Reg a, Reg b) { return _mm_cmpgt_ps(a, b); }
+  static Reg select(Mask m, Reg a, Reg b) { return _mm_blendv_ps(b, a, m); }
+  static Reg round(Reg a) { return _mm_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+  static Reg pow2(Reg n)
+  {
+    const __m128i bits = _mm_slli_epi32(_mm_add_epi32(_mm_cvtps_epi32(n), _mm_set1_epi32(127)), 23);
+    return _mm_castsi128_ps(bits);
+  }
+};
+#endif
+
+//==============================================================================
+// AVX2 + FMA + F16C backend
+//==============================================================================
+#if defined(__AVX2__) && defined(__FMA__) && defined(__F16C__)
+template <>
+struct VecF32<Avx2Isa>
+{
+  using Reg = __m256;
+  using Mask = __m256;
+  static constexpr size_t Width = 8;
+
+  static Reg load(const float* p) { return _mm256_loadu_ps(p); }
+  static void store(float* p, Reg a) { _mm256_storeu_ps(p, a); }
+
+  static __m256i partialMask(size_t n)
+  {
+    const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    return _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int32_t>(n)), lane);
+  }
+
+  static Reg loadPartial(const float* p, size_t n) { return _mm256_maskload_ps(p, partialMask(n)); }
+  static void storePartial(float* p, Reg a, size_t n) { _mm256_maskstore_ps(p, partialMask(n), a); }
+
+  static Reg loadHalf(const Half* p)
+  {
+    return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+  }
+
+  static void storeHalf(Half* p, Reg a)
+  {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm256_cvtps_ph(a, _MM_FROUND_TO_NEAREST_INT));
+  }
+
+  static Reg loadHalfPartial(const Half* p, size_t n)
+  {
+    Half buf[Width] = {0, 0, 0, 0, 0, 0, 0, 0};
+    for (size_t i = 0; i < n; ++i) { buf[i] = p[i]; }
+    return loadHalf(buf);
+  }
+
+  static void storeHalfPartial(Half* p, Reg a, size_t n)
+  {
+    Half buf[Width];
+    storeHalf(buf, a);
+    for (size_t i = 0; i < n; ++i) { p[i] = buf[i]; }
+  }
+
+  static Reg set1(float a) { return _mm256_set1_ps(a); }
+  static Reg zero() { return _mm256_setzero_ps(); }
+  static Reg add(Reg a, Reg b) { return _mm256_add_ps(a, b); }
+  static Reg sub(Reg a, Reg b) { return _mm256_sub_ps(a, b); }
+  static Reg mul(Reg a, Reg b) { return _mm256_mul_ps(a, b); }
+  static Reg div(Reg a, Reg b) { return _mm256_div_ps(a, b); }
+  static Reg fmadd(Reg a, Reg b, Reg c) { return _mm256_fmadd_ps(a, b, c); }
+  static Reg fnmadd(Reg a, Reg b, Reg c) { return _mm256_fnmadd_ps(a, b, c); }
+  static Reg min(Reg a, Reg b) { return _mm256_min_ps(a, b); }
+  static Reg max(Reg a, Reg b) { return _mm256_max_ps(a, b); }
+  static Mask cmpgt(Reg a, Reg b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+  static Reg select(Mask m, Reg a, Reg b) { return _mm256_blendv_ps(b, a, m); }
+  static Reg round(Reg a) { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+  static Reg pow2(Reg n)
+  {
+    const __m256i bits = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23);
+    return _mm256_castsi256_ps(bits);
+  }
+};
+#endif
+
+//==============================================================================
+// AVX-512F backend
+//==============================================================================
+#if defined(__AVX512F__)
+template <>
+struct VecF32<Avx512Isa>
+{
+  using Reg = __m512;
+  using Mask = __mmask16;
+  static constexpr size_t Width = 16;
+
+  static __mmask16 partialMask(size_t n) { return static_cast<__mmask16>((1u << n) - 1u); }
+
+  static Reg load(const float* p) { return _mm512_loadu_ps(p); }
+  static void store(float* p, Reg a) { _mm512_storeu_ps(p, a); }
+  static Reg loadPartial(const float* p, size_t n) { return _mm512_maskz_loadu_ps(partialMask(n), p); }
+  static void storePartial(float* p, Reg a, size_t n) { _mm512_mask_storeu_ps(p, partialMask(n), a); }
+
+  static Reg loadHalf(const Half* p)
+  {
+    return _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+  }
+
+  static void storeHalf(Half* p, Reg a)
+  {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), _mm512_cvtps_ph(a, _MM_FROUND_TO_NEAREST_INT));
+  }
+
+  // 16-bit masked moves need AVX-512BW, stage partial vectors through the stack
+  static Reg loadHalfPartial(const Half* p, size_t n)
+  {
+    Half buf[Width] = {0};
+    for (size_t i = 0; i < n; ++i) { buf[i] = p[i]; }
+    return loadHalf(buf);
+  }
+
+  static void storeHalfPartial(Half* p, Reg a, size_t n)
+  {
+    Half buf[Width];
+    storeHalf(buf, a);
+    for (size_t i = 0; i < n; ++i) { p[i] = buf[i]; }
+  }
+
+  static Reg set1(float a) { return _mm512_set1_ps(a); }
+  static Reg zero() { return _mm512_setzero_ps(); }
+  static Reg add(Reg a, Reg b) { return _mm512_add_ps(a, b); }
+  static Reg sub(Reg a, Reg b) { return _mm512_sub_ps(a, b); }
+  static Reg mul(Reg a, Reg b) { return _mm512_mul_ps(a, b); }
+  static Reg div(Reg a, Reg b) { return _mm512_div_ps(a, b); }
+  static Reg fmadd(Reg a, Reg b, Reg c) { return _mm512_fmadd_ps(a, b, c); }
+  static Reg fnmadd(Reg a, Reg b, Reg c) { return _mm512_fnmadd_ps(a, b, c); }
+  static Reg min(Reg a, Reg b) { return _mm512_min_ps(a, b); }
+  static Reg max(Reg a, Reg b) { return _mm512_max_ps(a, b); }
+  static Mask cmpgt(Reg a, Reg b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+  static Reg select(Mask m, Reg a, Reg b) { return _mm512_mask_blend_ps(m, b, a); }
+  static Reg round(Reg a) { return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+  static Reg pow2(Reg n) { return _mm512_scalef_ps(_mm512_set1_ps(1.0f), n); }
+};
+#endif
+
+//==============================================================================
+// NEON backend (aarch64 and armv7 with NEON)
+//==============================================================================
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+template <>
+struct VecF32<NeonIsa>
+{
+  using Reg = float32x4_t;
+  using Mask = uint32x4_t;
+  static constexpr size_t Width = 4;
+
+  static Reg load(const float* p) { return vld1q_f32(p); }
+  static void store(float* p, Reg a) { vst1q_f32(p, a); }
+
+  static Reg loadPartial(const float* p, size_t n)
+  {
+    float buf[Width] = {0.0f, 0.0f, 0.0f, 0.0f};
+    for (size_t i = 0; i < n; ++i) { buf[i] = p[i]; }
+    return vld1q_f32(buf);
+  }
+
+  static void storePartial(float* p, Reg a, size_t n)
+  {
+    float buf[Width];
+    vst1q_f32(buf, a);
+    for (size_t i = 0; i < n; ++i) { p[i] = buf[i]; }
+  }
+
+#if defined(__aarch64__)
+  static Reg loadHalf(const Half* p) { return vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(p))); }
+  static void storeHalf(Half* p, Reg a) { vst1_u16(p, vreinterpret_u16_f16(vcvt_f16_f32(a))); }
+#else
+  // half conversions are optional on armv7, convert in software
+  static Reg loadHalf(const Half* p)
+  {
+    float buf[Width];
+    for (size_t i = 0; i < Width; ++i) { buf[i] = halfToFloat(p[i]); }
+    return vld1q_f32(buf);
+  }
+
+  static void storeHalf(Half* p, Reg a)
+  {
+    float buf[Width];
+    vst1q_f32(buf, a);
+    for (size_t i = 0; i < Width; ++i) { p[i] = floatToHalf(buf[i]); }
+  }
+#endif
+
+  static Reg loadHalfPartial(const Half* p, size_t n)
+  {
+    Half buf[Width] = {0, 0, 0, 0};
+    for (size_t i = 0; i < n; ++i) { buf[i] = p[i]; }
+    return loadHalf(buf);
+  }
+
+  static void storeHalfPartial(Half* p, Reg a, size_t n)
+  {
+    Half buf[Width];
+    storeHalf(buf, a);
+    for (size_t i = 0; i < n; ++i) { p[i] = buf[i]; }
+  }
+
+  static Reg set1(float a) { return vdupq_n_f32(a); }
+  static Reg zero() { return vdupq_n_f32(0.0f); }
+  static Reg add(Reg a, Reg b) { return vaddq_f32(a, b); }
+  static Reg sub(Reg a, Reg b) { return vsubq_f32(a, b); }
+  static Reg mul(Reg a, Reg b) { return vmulq_f32(a, b); }
+#if defined(__aarch64__)
+  static Reg fmadd(Reg a, Reg b, Reg c) { return vfmaq_f32(c, a, b); }
+  static Reg fnmadd(Reg a, Reg b, Reg c) { return vfmsq_f32(c, a, b); }
+  static Reg round(Reg a) { return vrndnq_f32(a); }
+  static Reg div(Reg a, Reg b) { return vdivq_f32(a, b); }
+#else
+  static Reg fmadd(Reg a, Reg b, Reg c) { return vmlaq_f32(c, a, b); }
+  static Reg fnmadd(Reg a, Reg b, Reg c) { return vmlsq_f32(c, a, b); }
+  static Reg round(Reg a)
+  {
+    // armv7 has no vector round, use the 1.5 * 2^23 trick as in the scalar backend
+    const Reg magic = vdupq_n_f32(12582912.0f);
+    return vsubq_f32(vaddq_f32(a, magic), magic);
+  }
+  static Reg div(Reg a, Reg b)
+  {
+    // armv7 has no vector divide, refine the reciprocal estimate to float precision
+    Reg r = vrecpeq_f32(b);
+    r = vmulq_f32(vrecpsq_f32(b, r), r);
+    r = vmulq_f32(vrecpsq_f32(b, r), r);
+    return vmulq_f32(a, r);
+  }
+#endif
+  static Reg min(Reg a, Reg b) { return vminq_f32(a, b); }
+  static Reg max(Reg a, Reg b) { return vmaxq_f32(a, b); }
+  static Mask cmpgt(Reg a, Reg b) { return vcgtq_f32(a, b); }
+  static Reg select(Mask m, Reg a, Reg b) { return vbslq_f32(m, a, b); }
+
+  static Reg pow2(Reg n)
+  {
+    const int32x4_t bits = vshlq_n_s32(vaddq_s32(vcvtq_s32_f32(n), vdupq_n_s32(127)), 23);
+    return vreinterpretq_f32_s32(bits);
+  }
+};
+#endif
+
+//==============================================================================
+// Math built on the backend primitives
+//==============================================================================
+
+/**
+ * \brief expm1(x) for x in [-87, 0], max relative error around 1.5e-7.
+ * x is split as n*ln2 + r with |r| <= ln2/2, then
+ * expm1(x) = (2^n - 1) + 2^n * expm1(r), which keeps full relative precision near 0.
+ */
+template <typename V>
+inline typename V::Reg
+expm1NonPositive(typename V::Reg x)
+{
+  x = V::max(V::set1(-87.0f), x);
+  const typename V::Reg n = V::round(V::mul(x, V::set1(1.44269504088896341f)));
+  typename V::Reg r = V::fnmadd(n, V::set1(0.693359375f), x);
+  r = V::fnmadd(n, V::set1(-2.12194440e-4f), r);
+
+  // Taylor series of expm1(r), truncation error below 1 ulp on |r| <= ln2/2
+  typename V::Reg p = V::set1(1.0f / 5040.0f);
+  p = V::fmadd(p, r, V::set1(1.0f / 720.0f));
+  p = V::fmadd(p, r, V::set1(1.0f / 120.0f));
+  p = V::fmadd(p, r, V::set1(1.0f / 24.0f));
+  p = V::fmadd(p, r, V::set1(1.0f / 6.0f));
+  p = V::fmadd(p, r, V::set1(0.5f));
+  p = V::fmadd(V::mul(p, r), r, r);
+
+  const typename V::Reg pow2n = V::pow2(n);
+  return V::fmadd(pow2n, p, V::sub(pow2n, V::set1(1.0f)));
+}
+
+/**
+ * \brief expm1(x) for x in [-87, 0] with max relative error 4.4e-4, for callers that
+ * trade accuracy for speed. Same reduction as expm1NonPositive() with a one-constant
+ * ln2 and a degree 3 minimax polynomial instead of degree 7.
+ */
+template <typename V>
+inline typename V::Reg
+expm1NonPositiveTurbo(typename V::Reg x)
+{
+  x = V::max(V::set1(-87.0f), x);
+  const typename V::Reg n = V::round(V::mul(x, V::set1(1.44269504088896341f)));
+  const typename V::Reg r = V::fnmadd(n, V::set1(0.693147180559945309f), x);
+
+  // r * (c0 + c1 r + c2 r^2), minimax for relative error on |r| <= ln2/2
+  typename V::Reg p = V::set1(0.166666230f);
+  p = V::fmadd(p, r, V::set1(0.503751357f));
+  p = V::fmadd(p, r, V::set1(1.00004490f));
+  p = V::mul(p, r);
+
+  const typename V::Reg pow2n = V::pow2(n);
+  return V::fmadd(pow2n, p, V::sub(pow2n, V::set1(1.0f)));
+}
+
+/**
+ * \brief exp(x) for x <= 0, max relative error around 1.5e-7. x below -87, where the
+ * result nears the smallest normal float, gives 0. The reduction and polynomial are
+ * those of expm1NonPositive(), recombined as 2^n + 2^n * expm1(r). Inputs up to a few
+ * ulp above 0 are also fine, as left by rounding in callers.
+ */
+template <typename V>
+inline typename V::Reg
+expNonPositive(typename V::Reg x)
+{
+  const typename V::Reg clamped = V::max(V::set1(-87.0f), x);
+  const typename V::Reg n = V::round(V::mul(clamped, V::set1(1.44269504088896341f)));
+  typename V::Reg r = V::fnmadd(n, V::set1(0.693359375f), clamped);
+  r = V::fnmadd(n, V::set1(-2.12194440e-4f), r);
+
+  typename V::Reg p = V::set1(1.0f / 5040.0f);
+  p = V::fmadd(p, r, V::set1(1.0f / 720.0f));
+  p = V::fmadd(p, r, V::set1(1.0f / 120.0f));
+  p = V::fmadd(p, r, V::set1(1.0f / 24.0f));
+  p = V::fmadd(p, r, V::set1(1.0f / 6.0f));
+  p = V::fmadd(p, r, V::set1(0.5f));
+  p = V::fmadd(V::mul(p, r), r, r);
+
+  const typename V::Reg pow2n = V::pow2(n);
+  return V::select(V::cmpgt(V::set1(-87.0f), x), V::zero(), V::fmadd(pow2n, p, pow2n));
+}
+
+/**
+ * \brief exp(x) for x <= 0 with max relative error 4.4e-4, the counterpart of
+ * expm1NonPositiveTurbo().
+ */
+template <typename V>
+inline typename V::Reg
+expNonPositiveTurbo(typename V::Reg x)
+{
+  const typename V::Reg clamped = V::max(V::set1(-87.0f), x);
+  const typename V::Reg n = V::round(V::mul(clamped, V::set1(1.44269504088896341f)));
+  const typename V::Reg r = V::fnmadd(n, V::set1(0.693147180559945309f), clamped);
+
+  typename V::Reg p = V::set1(0.166666230f);
+  p = V::fmadd(p, r, V::set1(0.503751357f));
+  p = V::fmadd(p, r, V::set1(1.00004490f));
+  p = V::mul(p, r);
+
+  const typename V::Reg pow2n = V::pow2(n);
+  return V::select(V::cmpgt(V::set1(-87.0f), x), V::zero(), V::fmadd(pow2n, p, pow2n));
+}
+
+/**
+ * \brief Loads and stores a register from float or half memory.
+ */
+template <typename V, typename T>
+struct VecIo;
+
+template <typename V>
+struct VecIo<V, float>
+{
+  static typename V::Reg load(const float* p) { return V::load(p); }
+  static typename V::Reg loadPartial(const float* p, size_t n) { return V::loadPartial(p, n); }
+  static void store(float* p, typename V::Reg a) { V::store(p, a); }
+  static void storePartial(float* p, typename V::Reg a, size_t n) { V::storePartial(p, a, n); }
+};
+
+template <typename V>
+struct VecIo<V, Half>
+{
+  static typename V::Reg load(const Half* p) { return V::loadHalf(p); }
+  static typename V::Reg loadPartial(const Half* p, size_t n) { return V::loadHalfPartial(p, n); }
+  static void store(Half* p, typename V::Reg a) { V::storeHalf(p, a); }
+  static void storePartial(Half* p, typename V::Reg a, size_t n) { V::storeHalfPartial(p, a, n); }
+};
+
+/**
+ * \brief Applies a unary vector function over count elements. InT and OutT are
+ * float or Half; the math always runs in float32 registers. in and out may
+ * alias when they have the same type.
+ * The tail shorter than one vector goes through the same function so results
+ * never depend on the element's position in the buffer.
+ */
+template <typename V, typename InT, typename OutT, typename Fn>
+inline void
+transform(const InT* in, OutT* out, size_t count, Fn fn)
+{
+  typedef VecIo<V, InT> In;
+  typedef VecIo<V, OutT> Out;
+  size_t i = 0;
+  for (; i + 2 * V::Width <= count; i += 2 * V::Width)
+  {
+    const typename V::Reg a = In::load(in + i);
+    const typename V::Reg b = In::load(in + i + V::Width);
+    Out::store(out + i, fn(a));
+    Out::store(out + i + V::Width, fn(b));
+  }
+  for (; i + V::Width <= count; i += V::Width)
+  {
+    Out::store(out + i, fn(In::load(in + i)));
+  }
+  if (i < count)
+  {
+    Out::storePartial(out + i, fn(In::loadPartial(in + i, count - i)), count - i);
+  }
+}
+
+} // namespace Simd
+} // namespace UdoUtil
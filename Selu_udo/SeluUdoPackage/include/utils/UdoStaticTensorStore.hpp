@@ -0,0 +1,185 @@
+//==============================================================================
+//
+// Copyright (c) 2020 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "SnpeUdo/UdoBase.h"
+#include "utils/UdoArena.hpp"
+
+namespace UdoUtil {
+
+// static tensor data is aligned for any vector load
+constexpr size_t STATIC_TENSOR_ALIGNMENT = 64;
+
+/**
+ * @brief How static tensor params are kept by op factories and ops.
+ */
+enum UdoStaticTensorMode
+{
+  // copied once into the store, deduplicated by content and shared by every op
+  UDO_STATIC_TENSORS_COPY = 0,
+  // the runtime's memory is used in place, which requires it to outlive every
+  // factory and op created from it
+  UDO_STATIC_TENSORS_BORROW
+};
+
+/**
+ * @brief Immutable aligned bytes shared through UdoStaticBlobRef.
+ */
+class UdoStaticBlob
+{
+public:
+  const void* getData() const { return m_Data; }
+  size_t getSize() const { return m_Size; }
+
+private:
+  friend class UdoStaticTensorStore;
+
+  std::unique_ptr<uint8_t[]> m_Block;
+  void* m_Data = nullptr;
+  size_t m_Size = 0;
+  uint64_t m_Hash = 0;
+  // a derived blob keeps the blobs it was built from, so that their addresses,
+  // which key it, are not reused while it is alive
+  std::shared_ptr<const UdoStaticBlob> m_Sources[2];
+};
+
+using UdoStaticBlobRef = std::shared_ptr<const UdoStaticBlob>;
+
+/**
+ * @brief What a derived blob, such as packed weights, is built from: up to two source
+ * buffers and the parameters of the transform.
+ */
+struct UdoStaticDerivedKey
+{
+  const void* sources[2];
+  uint64_t params[4];
+};
+
+struct UdoStaticTensorStats
+{
+  size_t numBlobs;      // live blobs
+  size_t numBytes;      // bytes of live blobs
+  uint64_t numShared;   // acquires answered with a blob that was already stored
+  uint64_t bytesShared; // bytes those acquires did not copy or build
+};
+
+/**
+ * @brief Content addressed, reference counted store of static tensor data, owned by
+ * the implementation library. Equal tensors are stored once however many factories
+ * and ops use them, and blobs are released with their last reference. References may
+ * outlive the store. Thread safe, blobs are built outside the lock.
+ */
+class UdoStaticTensorStore
+{
+public:
+  UdoStaticTensorStore();
+
+  /**
+   * \brief Sets how static tensors are kept, before the first factory is created.
+   */
+  void setMode(UdoStaticTensorMode mode) { m_Mode = mode; }
+  UdoStaticTensorMode getMode() const { return m_Mode; }
+
+  /**
+   * \brief A blob with the given bytes. data may be a blob of the store, which is then
+   * shared without reading it.
+   * @return nullptr if the blob could not be allocated
+   */
+  UdoStaticBlobRef acquire(const void* data, size_t size);
+
+  /**
+   * \brief A blob of size bytes that build fills from key's sources, shared by every
+   * acquire with the same key. Sources are told apart by address, so results are only
+   * shared when every source is a blob of the store or when the store borrows, in
+   * which case the sources must outlive the blob. Otherwise the blob is private.
+   * @return nullptr if the blob could not be allocated
+   */
+  UdoStaticBlobRef acquireDerived(const UdoStaticDerivedKey& key, size_t size,
+                                  const std::function<void(void* data)>& build);
+
+  void getStats(UdoStaticTensorStats& stats);
+
+private:
+  struct DerivedKeyHash
+  {
+    size_t operator()(const UdoStaticDerivedKey& key) const;
+  };
+  struct DerivedKeyEqual
+  {
+    bool operator()(const UdoStaticDerivedKey& lhs, const UdoStaticDerivedKey& rhs) const;
+  };
+
+  using BlobWeakRef = std::weak_ptr<const UdoStaticBlob>;
+
+  static std::shared_ptr<UdoStaticBlob> allocateBlob(size_t size);
+
+  // callers hold m_Mutex
+  UdoStaticBlobRef findByAddress(const void* data);
+  UdoStaticBlobRef findByContent(uint64_t hash, const void* data, size_t size);
+  void insert(const UdoStaticBlobRef& blob);
+  void pruneExpired();
+  void countShared(size_t size);
+
+  UdoStaticTensorMode m_Mode;
+  std::mutex m_Mutex;
+  std::unordered_multimap<uint64_t, BlobWeakRef> m_Contents;
+  std::unordered_map<const void*, BlobWeakRef> m_Addresses;
+  std::unordered_map<UdoStaticDerivedKey, BlobWeakRef, DerivedKeyHash, DerivedKeyEqual> m_Derived;
+  size_t m_PruneThreshold;
+  uint64_t m_NumShared = 0;
+  uint64_t m_BytesShared = 0;
+};
+
+/**
+ * \brief Bytes of a tensor's data at its current dimensions.
+ */
+size_t
+getTensorDataSize(const SnpeUdo_TensorParam_t& param);
+
+/**
+ * \brief Reserves what copyStaticParams() takes from arena, which includes the tensor
+ * data when there is no store.
+ */
+void
+reserveStaticParams(const SnpeUdo_Param_t* params, uint32_t numOfParams, UdoArena& arena,
+                    const UdoStaticTensorStore* store);
+
+/**
+ * \brief Copies params with their names, strings and dimensions into arena. Tensor data
+ * is acquired from store, with the references appended to tensors, or borrowed when the
+ * store borrows. Without a store the data is copied into arena.
+ * @return The copies, nullptr when arena was too small
+ */
+SnpeUdo_Param_t*
+copyStaticParams(const SnpeUdo_Param_t* params, uint32_t numOfParams, UdoArena& arena, UdoStaticTensorStore* store,
+                 std::vector<UdoStaticBlobRef>& tensors);
+
+/**
+ * \brief Reserves a tensor's dimensions in arena, and its data when copyData is set.
+ */
+void
+reserveTensorParam(const SnpeUdo_TensorParam_t& srcParam, UdoArena& arena, bool copyData);
+
+/**
+ * \brief Copies a tensor param's metadata into arena. The data is copied into arena
+ * with copyData and referenced otherwise.
+ */
+SnpeUdo_ErrorType_t
+copyTensorParam(const SnpeUdo_TensorParam_t& srcParam, SnpeUdo_TensorParam_t& destParam, UdoArena& arena,
+                bool copyData = false);
+
+}
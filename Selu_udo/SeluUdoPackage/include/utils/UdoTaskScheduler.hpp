@@ -0,0 +1,133 @@
+//==============================================================================
+//
+// Copyright (c) 2019 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace UdoUtil {
+
+/**
+ * @brief Work-stealing task scheduler shared by every operation of a library.
+ *
+ * Each worker thread owns a Chase-Lev deque: the owner pushes and pops at the
+ * bottom without locks, other threads steal from the top with a single CAS.
+ * Runtime threads calling parallelFor() borrow one of a fixed set of external
+ * deques for the duration of the call, push their tasks there and then work
+ * on them, stealing from other ops while their own tasks are in flight.
+ * Idle workers steal from any deque, so chunks of a busy op instance are
+ * picked up by cores that another op instance left idle.
+ */
+class UdoTaskScheduler
+{
+public:
+  using TaskFn = void (*)(void* context, size_t taskIdx);
+
+  explicit UdoTaskScheduler(uint32_t numThreads);
+
+  ~UdoTaskScheduler();
+
+  UdoTaskScheduler(const UdoTaskScheduler&) = delete;
+  UdoTaskScheduler& operator=(const UdoTaskScheduler&) = delete;
+
+  /**
+   * \brief Number of threads that can run tasks, including one calling thread.
+   */
+  uint32_t getNumThreads() const { return static_cast<uint32_t>(m_Workers.size()) + 1; }
+
+  /**
+   * \brief Runs fn(context, i) for every i in [0, numTasks) and returns once all
+   * tasks have finished. Safe to call from any number of threads at once and
+   * from inside a task.
+   */
+  void run(size_t numTasks, TaskFn fn, void* context);
+
+  /**
+   * \brief Convenience wrapper around run() for any callable taking the task index.
+   * The callable is passed by reference, nothing is allocated.
+   */
+  template <typename Fn>
+  void parallelFor(size_t numTasks, const Fn& fn)
+  {
+    run(numTasks, &invokeTask<Fn>, const_cast<void*>(static_cast<const void*>(&fn)));
+  }
+
+private:
+  struct TaskGroup
+  {
+    TaskFn fn;
+    void* context;
+    std::atomic<size_t> pending;
+    bool checkAllocations; // started inside a UdoNoAllocScope, so are its tasks
+  };
+
+  struct Task
+  {
+    TaskGroup* group;
+    size_t taskIdx;
+  };
+
+  /**
+   * Bounded Chase-Lev deque of task pointers (Le et al., "Correct and
+   * Efficient Work-Stealing for Weak Memory Models", PPoPP 2013).
+   */
+  class TaskDeque
+  {
+  public:
+    static constexpr int64_t CAPACITY = 1024;
+
+    TaskDeque();
+    bool push(Task* task);  // owner only, false when full
+    Task* pop();            // owner only
+    Task* steal();          // any thread, nullptr when empty or on a lost race
+
+    std::atomic<bool> m_Claimed; // external deques only: owned by a runtime thread
+
+  private:
+    // top is written by thieves and bottom by the owner, keep them on separate cache lines
+    char m_PadTop[64];
+    std::atomic<int64_t> m_Top;
+    char m_PadBottom[64];
+    std::atomic<int64_t> m_Bottom;
+    std::atomic<Task*> m_Buffer[CAPACITY];
+  };
+
+  template <typename Fn>
+  static void invokeTask(void* context, size_t taskIdx)
+  {
+    (*static_cast<const Fn*>(context))(taskIdx);
+  }
+
+  // tasks pushed per batch, bounded so they fit on the caller's stack
+  static constexpr size_t MAX_BATCH = 256;
+  static constexpr uint32_t NUM_EXTERNAL_DEQUES = 16;
+  static constexpr uint32_t SPINS_BEFORE_SLEEP = 64;
+
+  void workerLoop(uint32_t dequeIdx);
+  void execute(Task* task);
+  Task* findTask(uint32_t dequeIdx);
+  int32_t acquireDeque();
+  void wakeWorkers();
+
+  std::vector<std::unique_ptr<TaskDeque>> m_Deques; // workers first, then external deques
+  std::vector<std::thread> m_Workers;
+  std::atomic<int64_t> m_QueuedTasks;
+  std::atomic<uint32_t> m_Sleepers;
+  std::mutex m_SleepMutex;
+  std::condition_variable m_SleepCv;
+  std::atomic<bool> m_Stop;
+};
+
+}
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -22,6 +23,10 @@
 #include "SnpeUdo/UdoBase.h"
 #include "UdoOperation.hpp"
 #include "IUdoOpDefinition.hpp"
+#include "UdoAsyncExecutor.hpp"
+#include "UdoOpPool.hpp"
+#include "UdoStaticTensorStore.hpp"
+#include "UdoTaskScheduler.hpp"
 #include "utils/UdoMacros.hpp"
 
 extern "C"
@@ -30,14 +35,19 @@ extern "C"
 struct _SnpeUdo_Operation_t
 {
   std::unique_ptr<UdoUtil::UdoOperation> operation;
+  const char* operationType; // owned by the op definition
+  std::shared_ptr<UdoUtil::UdoOpPool> pool; // of the factory, while the op is live
 };
 
 struct _SnpeUdo_OpFactory_t
 {
   UdoUtil::IUdoOpDefinition* definition;
   void* infrastructure;
-  SnpeUdo_Param_t* staticParams;
+  SnpeUdo_Param_t* staticParams; // in arena, tensor data in staticTensors or borrowed
   uint32_t numOfStaticParams;
+  UdoUtil::UdoArena arena;
+  std::vector<UdoUtil::UdoStaticBlobRef> staticTensors;
+  std::shared_ptr<UdoUtil::UdoOpPool> opPool; // nullptr when pooling is off
 };
 
 } // extern "C"
@@ -126,6 +136,10 @@ public:
   void
   addScalarParam(const char* name, SnpeUdo_DataType_t type);
 
+  // signature for adding string param for registration info, no value
+  void
+  addStringParam(const char* name);
+
   // signature for adding tensor param
   void
   addTensorParam(const char* name,
@@ -289,6 +303,11 @@ private:
  *  The class utilizes an internal map to store all the operations and opDefinitions in
  *  in an implementation library, and provides a simple entry point to SnpeUdo methods that
  *  are called when an implementation library is opened.
+ *
+ *  A library is built and its definitions registered on one thread, then sealed and
+ *  published by setImplementation(). From then on its definitions, info and strings are
+ *  immutable and read without locking by any thread; the scheduler, executor, store and
+ *  latency histograms synchronize themselves.
  */
 class UdoImplementationLib
 {
@@ -301,7 +320,7 @@ public:
 
   /**
    *\brief Sets the core type and package name for this library
-   * when the default constructor is used.
+   * when the default constructor is used. Must be called before the library is sealed.
    */
   void
   configure(SnpeUdo_CoreType_t coreType, const std::string &packageName);
@@ -315,11 +334,23 @@ public:
    * @param definition An object of IUdoOpDefinition which is registered in a std::map member of an
    *        ImplLib instance.
    *
-   *@return SNPE_UDO_WRONG_OPERATION if the definition was already registered
+   *@return SNPE_UDO_WRONG_OPERATION if the definition was already registered,
+   *        SNPE_UDO_UNSUPPORTED_FEATURE if the library is sealed
    */
   SnpeUdo_ErrorType_t
   registerOpDefinition(const std::string &name, std::unique_ptr<IUdoOpDefinition>&& definition);
 
+  /**
+   * \brief Builds the implementation info, its operations string and a latency
+   * histogram per registered operation type, once all definitions are registered.
+   * Called by setImplementation() before the library is published.
+   */
+  void
+  seal();
+
+  bool
+  isSealed() const { return m_Sealed; }
+
   /**
    * @brief A function to create an operation factory.
    *        The function receives the operation type, and an array of static parameters,
@@ -343,6 +374,39 @@ public:
                                       SnpeUdo_Param_t* staticParams,
                                       SnpeUdo_OpFactory_t* opFactory);
 
+  /**
+   * @brief Creates an operation of a factory. A released operation of the factory that
+   *        accepts the tensors is rebound and returned instead of a new one when the
+   *        factory pools operations.
+   *
+   * @param[in] opFactory Factory of the operation
+   *
+   * @param[in] numOfInputs, inputs, numOfOutputs, outputs The tensors of the operation
+   *
+   * @param[in,out] operation Handle to the operation
+   *
+   * @return Error Code
+   */
+  static SnpeUdo_ErrorType_t createOperation(SnpeUdo_OpFactory_t opFactory,
+                                             uint32_t numOfInputs,
+                                             SnpeUdo_TensorParam_t* inputs,
+                                             uint32_t numOfOutputs,
+                                             SnpeUdo_TensorParam_t* outputs,
+                                             SnpeUdo_Operation_t* operation);
+
+  /**
+   * \brief Waits for the operation, merges its latencies into the library and returns it
+   * to its factory's pool, or deletes it when the factory is released, does not pool or
+   * has enough pooled. Safe after the library was terminated.
+   */
+  static SnpeUdo_ErrorType_t releaseOperation(SnpeUdo_Operation_t operation);
+
+  /**
+   * \brief Deletes the factory and its pooled operations. Live operations of the factory
+   * stay valid.
+   */
+  static SnpeUdo_ErrorType_t releaseOpFactory(SnpeUdo_OpFactory_t opFactory);
+
   SnpeUdo_ErrorType_t
   getVersion(SnpeUdo_LibVersion_t** version);
 
@@ -359,26 +423,152 @@ public:
    *
    * @return error code
    *
+   * The info is built once by seal(), so concurrent callers share it.
    */
   SnpeUdo_ErrorType_t
   getImplementationInfo(SnpeUdo_ImpInfo_t** info);
 
+  /**
+   * \brief Sets the number of threads, including one calling thread, used for intra-op
+   * parallelism. Defaults to the UDO_CPU_NUM_THREADS environment variable, or to the
+   * number of hardware threads. Must be called before the scheduler is first used.
+   *
+   * @return SNPE_UDO_INVALID_ARGUMENT, leaving the count as it is, once the scheduler
+   *         has been created
+   */
+  SnpeUdo_ErrorType_t
+  setNumThreads(uint32_t numThreads);
+
+  /**
+   * \brief Returns the work-stealing scheduler shared by all operations of this library.
+   * The scheduler is created on first use and lives until the library is terminated.
+   */
+  UdoTaskScheduler&
+  getTaskScheduler();
+
+  /**
+   * \brief Returns the background executor for non-blocking executes, created on first
+   * use. It is stopped before the task scheduler when the library is terminated.
+   */
+  UdoAsyncExecutor&
+  getAsyncExecutor();
+
+  /**
+   * \brief Returns the store that keeps the static tensor params of this library's
+   * factories and operations. Its mode defaults to borrowing when the
+   * UDO_CPU_STATIC_TENSORS environment variable is "borrow" and to copying otherwise.
+   */
+  UdoStaticTensorStore&
+  getStaticTensorStore() { return m_StaticTensorStore; }
+
+  /**
+   * \brief Sets how many released operations each factory created afterwards keeps for
+   * reuse, 0 turns pooling off. Defaults to the UDO_CPU_OP_POOL_SIZE environment
+   * variable, or to DEFAULT_OP_POOL_SIZE.
+   */
+  void
+  setOpPoolSize(uint32_t poolSize) { m_OpPoolSize.store(poolSize, std::memory_order_relaxed); }
+
+  /**
+   * \brief Adds the latencies of a released operation to the histogram of its type,
+   * without locking. Types that are not registered are dropped.
+   */
+  void
+  mergeLatencyHistogram(const char* operationType, const UdoLatencyHistogram& histogram);
+
+  /**
+   * \brief Latency of all released operations of a type.
+   * @return SNPE_UDO_WRONG_OPERATION if no operation of the type was released yet
+   */
+  SnpeUdo_ErrorType_t
+  getLatencyStats(const std::string &operationType, UdoLatencyStats_t* stats);
+
+  /**
+   * \brief Prints count, mean and percentiles of every operation type that recorded
+   * executes. Called when the library is terminated.
+   */
+  void
+  dumpLatencyStats(std::ostream& stream);
+
 private:
+  struct OperationLatency
+  {
+    const char* operationType; // owned by the op definition
+    std::unique_ptr<UdoLatencyHistogram> histogram;
+  };
+
   IUdoOpDefinition* resolveOperation(const char* operationType);
+  UdoLatencyHistogram* findLatencyHistogram(const char* operationType);
   std::map<std::string, std::unique_ptr<IUdoOpDefinition>> m_Definitions;
   SnpeUdo_ImpInfo_t m_ImplInfo;
   std::string m_PackageName;
   SnpeUdo_LibVersion_t m_Version;
   SnpeUdo_CoreType_t m_CoreType;
   std::string m_OperationsString;
+  bool m_Sealed;
+  std::atomic<uint32_t> m_NumThreads;
+  std::once_flag m_TaskSchedulerOnce;
+  std::atomic<bool> m_TaskSchedulerCreated; // set by getTaskScheduler's call_once
+  std::unique_ptr<UdoTaskScheduler> m_TaskScheduler;
+  std::once_flag m_AsyncExecutorOnce;
+  std::unique_ptr<UdoAsyncExecutor> m_AsyncExecutor;
+  UdoStaticTensorStore m_StaticTensorStore;
+  std::atomic<uint32_t> m_OpPoolSize;
+  std::vector<OperationLatency> m_Latencies; // one per definition, fixed once sealed
 };
  UdoImplementationLib&
  getImplementation();
 
+  /**
+   * \brief Seals a fully registered library and publishes it as the current
+   * implementation library, with one atomic store. Threads that find it see it complete.
+   *
+   * @return SNPE_UDO_INVALID_ARGUMENT if a library is already set
+   */
   SnpeUdo_ErrorType_t
-  setImplementation(SnpeUdo_CoreType_t coreType, const std::string &packageName);
+  setImplementation(std::unique_ptr<UdoImplementationLib>&& implLib);
 
+  /**
+   * \brief Unpublishes and deletes the current implementation library. Like its
+   * publication this happens when the runtime initializes or terminates the library,
+   * which no other call of the library overlaps.
+   */
   SnpeUdo_ErrorType_t
   deleteImplementationInstance();
+
+  /**
+   * \brief Returns the task scheduler of the current implementation library,
+   * or nullptr when no implementation library has been set.
+   */
+  UdoTaskScheduler*
+  getImplementationTaskScheduler();
+
+  /**
+   * \brief Returns the async executor of the current implementation library,
+   * or nullptr when no implementation library has been set.
+   */
+  UdoAsyncExecutor*
+  getImplementationAsyncExecutor();
+
+  /**
+   * \brief Returns the static tensor store of the current implementation library,
+   * or nullptr when no implementation library has been set.
+   */
+  UdoStaticTensorStore*
+  getImplementationStaticTensorStore();
+
+  /**
+   * \brief Merges a released operation's latencies into the current implementation
+   * library, dropped when no implementation library has been set.
+   */
+  void
+  mergeImplementationLatency(const char* operationType, const UdoLatencyHistogram& histogram);
+
+  /**
+   * \brief Writes the latency stats of the current implementation library to stream,
+   * nothing when no implementation library has been set.
+   */
+  void
+  dumpImplementationLatencyStats(std::ostream& stream);
 }
 
@@ -26,7 +26,7 @@ endif
 #========================== Define Registration Library Build Variables =============================================
 include $(CLEAR_VARS)
 LOCAL_C_INCLUDES               := $(PACKAGE_C_INCLUDES)
-MY_SRC_FILES                    = $(wildcard $(LOCAL_PATH)/src/reg/*.cpp) $(wildcard $(LOCAL_PATH)/src/utils/*.cpp)
+MY_SRC_FILES                    = $(wildcard $(LOCAL_PATH)/src/reg/*.cpp) $(filter-out %/UdoAllocCheck.cpp,$(wildcard $(LOCAL_PATH)/src/utils/*.cpp))
 LOCAL_MODULE                   := UdoSeluUdoPackageReg
 LOCAL_SRC_FILES                := $(subst jni/,,$(MY_SRC_FILES))
 #LOCAL_CPP_FEATURES            := rtti exceptions
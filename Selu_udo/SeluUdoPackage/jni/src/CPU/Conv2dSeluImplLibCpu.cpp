@@ -0,0 +1,174 @@
+//==============================================================================
+// Auto Generated Code for SeluUdoPackage
+//==============================================================================
+
+#include "Conv2dSeluImplLibCpu.hpp"
+#include "utils/UdoMacros.hpp"
+#include "utils/UdoUtil.hpp"
+
+using namespace UdoUtil;
+
+namespace {
+
+// NHWC tensors, the only layout the kernels address
+constexpr uint32_t CONV2D_SELU_TENSOR_RANK = 4;
+
+}
+
+std::unique_ptr<UdoOperation>
+Conv2dSeluOpDef::createOp(void* perOpInfrastructure,
+                          uint32_t numOfInputs,
+                          SnpeUdo_TensorParam_t* inputs,
+                          uint32_t numOfOutputs,
+                          SnpeUdo_TensorParam_t* outputs,
+                          uint32_t numOfStaticParams,
+                          SnpeUdo_Param_t* params)
+{
+    Conv2dSeluParamTable table;
+    ConvGeometry geometry;
+    ActivationAccuracy accuracy;
+    const SnpeUdo_ErrorType_t status = resolveConv2dSeluParams(params, numOfStaticParams, table, geometry, accuracy);
+    if (status != SNPE_UDO_NO_ERROR)
+    {
+        UDO_ERROR_MSG(status, CONV2D_SELU_OP_TYPE << " needs a 4D float32 " << CONV2D_SELU_WEIGHTS_PARAM
+                      << " tensor, optionally a float32 " << CONV2D_SELU_BIAS_PARAM << " of its units, non-zero strides,"
+                      << " padding smaller than the window and an integer " << ACTIVATION_ACCURACY_MODE_PARAM
+                      << " below " << ACTIVATION_NUM_ACCURACY_MODES)
+        return nullptr;
+    }
+    if (numOfInputs != m_NumOfInputs || numOfOutputs != m_NumOfOutputs || inputs == nullptr || outputs == nullptr ||
+        inputs[0].dataType != SNPE_UDO_DATATYPE_FLOAT_32 || outputs[0].dataType != SNPE_UDO_DATATYPE_FLOAT_32)
+    {
+        UDO_ERROR_MSG(SNPE_UDO_UNSUPPORTED_FEATURE, CONV2D_SELU_OP_TYPE << " needs one float32 input and output")
+        return nullptr;
+    }
+
+    // static tensor params carry a host pointer to their data rather than a runtime handle
+    const SnpeUdo_TensorParam_t& weights = *table.getTensor(CONV2D_SELU_PARAM_WEIGHTS);
+    const SnpeUdo_TensorParam_t* bias = table.getTensor(CONV2D_SELU_PARAM_BIAS);
+    if (weights.tensorData == nullptr || (bias != nullptr && bias->tensorData == nullptr))
+    {
+        UDO_ERROR_MSG(SNPE_UDO_INVALID_ARGUMENT, CONV2D_SELU_OP_TYPE << " weights and bias must have data")
+        return nullptr;
+    }
+
+    // the exact mode stores conv(in, W) + b and rounds Selu's double reference over
+    // each finished block
+    const bool isExact = accuracy == ACTIVATION_ACCURACY_EXACT;
+    const ConvKernelFn run = isExact ? m_Kernels.linear : m_Kernels.modes[accuracy];
+    const ActivationKernelFn exactActivation = isExact ? m_Selu.modes[ACTIVATION_ACCURACY_EXACT].f32 : nullptr;
+
+    std::unique_ptr<Conv2dSeluOp> op(new Conv2dSeluOp(inputs, numOfInputs, outputs, numOfOutputs,
+                                                      static_cast<SnpeUdo_CpuInfrastructure_t*>(perOpInfrastructure),
+                                                      numOfStaticParams, params, m_Kernels, run, exactActivation,
+                                                      geometry));
+    if (op->packWeights(static_cast<const float*>(weights.tensorData),
+                        bias != nullptr ? static_cast<const float*>(bias->tensorData) : nullptr) != SNPE_UDO_NO_ERROR ||
+        op->preparePlan() != SNPE_UDO_NO_ERROR)
+    {
+        return nullptr;
+    }
+    return op;
+}
+
+SnpeUdo_ErrorType_t
+Conv2dSeluOp::packWeights(const float* weights, const float* bias)
+{
+    // ops with the same weights share one packed copy
+    UdoStaticTensorStore* store = getImplementationStaticTensorStore();
+    UDO_VALIDATE_MSG(store == nullptr,
+                     SNPE_UDO_INVALID_ARGUMENT,
+                     CONV2D_SELU_OP_TYPE << " needs the implementation library to store its packed weights")
+
+    // a Keras kernel is a depth x units matrix, so it packs into the dense panels
+    DensePackedWeights packed;
+    UDO_VALIDATE_MSG(!acquirePackedDense(*store, weights, bias, getConvDepth(m_Geometry), m_Geometry.units, m_Kernels.panelWidth, packed),
+                     SNPE_UDO_MEM_ALLOC_ERROR,
+                     CONV2D_SELU_OP_TYPE << " could not allocate its packed weights")
+
+    m_Packed = std::move(packed.blob);
+    m_Weights = packed.weights;
+    m_Bias = packed.bias;
+    return SNPE_UDO_NO_ERROR;
+}
+
+SnpeUdo_ErrorType_t
+Conv2dSeluOp::prepare()
+{
+    UDO_VALIDATE_MSG(m_Weights == nullptr || m_Bias == nullptr,
+                     SNPE_UDO_INVALID_ARGUMENT,
+                     CONV2D_SELU_OP_TYPE << " weights must be packed before the op is prepared")
+    UDO_VALIDATE_MSG(m_Run == nullptr,
+                     SNPE_UDO_UNSUPPORTED_FEATURE,
+                     CONV2D_SELU_OP_TYPE << " has no kernel for its accuracy mode")
+
+    const SnpeUdo_TensorParam_t& input = *m_Inputs[0];
+    const SnpeUdo_TensorParam_t& output = *m_Outputs[0];
+    UDO_VALIDATE_MSG(input.tensorRank != CONV2D_SELU_TENSOR_RANK || output.tensorRank != CONV2D_SELU_TENSOR_RANK,
+                     SNPE_UDO_WRONG_NUM_OF_DIMENSIONS,
+                     CONV2D_SELU_OP_TYPE << " input and output must be NHWC tensors of rank "
+                     << CONV2D_SELU_TENSOR_RANK)
+
+    m_Plan.args.weights = m_Weights;
+    m_Plan.args.bias = m_Bias;
+    m_Plan.args.geometry = m_Geometry;
+    m_Plan.args.params = SeluActivation::defaults();
+    m_Plan.exactActivation = m_ExactActivation;
+    m_Plan.run = m_Run;
+    return SNPE_UDO_NO_ERROR;
+}
+
+SnpeUdo_ErrorType_t
+Conv2dSeluOp::reshape()
+{
+    const SnpeUdo_TensorParam_t& input = *m_Inputs[0];
+    const SnpeUdo_TensorParam_t& output = *m_Outputs[0];
+    const uint32_t* inDims = input.currDimensions;
+    const uint32_t* outDims = output.currDimensions;
+    UDO_VALIDATE_MSG(inDims[0] != outDims[0] || inDims[3] != m_Geometry.channels || outDims[3] != m_Geometry.units ||
+                     !isValidConvExtent(inDims[1], outDims[1], m_Geometry.kernelHeight, m_Geometry.strideHeight,
+                                        m_Geometry.padTop) ||
+                     !isValidConvExtent(inDims[2], outDims[2], m_Geometry.kernelWidth, m_Geometry.strideWidth,
+                                        m_Geometry.padLeft),
+                     SNPE_UDO_INVALID_ARGUMENT,
+                     CONV2D_SELU_OP_TYPE << " needs an input of batch x height x width x " << m_Geometry.channels
+                     << " and an output of batch x outHeight x outWidth x " << m_Geometry.units
+                     << " whose windows all overlap the input")
+
+    m_Plan.args.inHeight = inDims[1];
+    m_Plan.args.inWidth = inDims[2];
+    m_Plan.args.outHeight = outDims[1];
+    m_Plan.args.outWidth = outDims[2];
+    // tasks are whole output rows over the batch, by panels
+    const size_t rows = static_cast<size_t>(outDims[0]) * outDims[1];
+    const size_t maxTasks = limitDenseTasks(rows * outDims[2], getConvDepth(m_Geometry), m_Geometry.units,
+                                            m_GrainSize, getMaxTasks());
+    m_Plan.tiling = makeDenseTiling(rows, m_Geometry.units, m_Kernels.panelWidth, maxTasks);
+    return SNPE_UDO_NO_ERROR;
+}
+
+void
+Conv2dSeluOp::runPlan(const void* in, void* out)
+{
+    const Conv2dSeluExecutionPlan& plan = m_Plan;
+    if (plan.tiling.rows == 0)
+    {
+        return;
+    }
+    ConvKernelArgs args = plan.args;
+    args.in = static_cast<const float*>(in);
+    args.out = static_cast<float*>(out);
+    const size_t numTasks = getDenseNumTasks(plan.tiling);
+    if (numTasks <= 1)
+    {
+        runConvTask(plan.run, plan.exactActivation, args, plan.tiling, 0);
+    }
+    else
+    {
+        parallelFor(numTasks, [this, &plan, &args](size_t taskIdx)
+        {
+            runConvTask(plan.run, plan.exactActivation, args, plan.tiling, taskIdx);
+            m_Profiler.markChunkEnd();
+        });
+    }
+}
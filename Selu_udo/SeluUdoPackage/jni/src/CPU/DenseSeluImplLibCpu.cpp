@@ -0,0 +1,158 @@
+//==============================================================================
+// Auto Generated Code for SeluUdoPackage
+//==============================================================================
+
+#include "DenseSeluImplLibCpu.hpp"
+#include "utils/UdoMacros.hpp"
+#include "utils/UdoUtil.hpp"
+
+using namespace UdoUtil;
+
+std::unique_ptr<UdoOperation>
+DenseSeluOpDef::createOp(void* perOpInfrastructure,
+                         uint32_t numOfInputs,
+                         SnpeUdo_TensorParam_t* inputs,
+                         uint32_t numOfOutputs,
+                         SnpeUdo_TensorParam_t* outputs,
+                         uint32_t numOfStaticParams,
+                         SnpeUdo_Param_t* params)
+{
+    DenseSeluParamTable table;
+    size_t depth = 0;
+    size_t units = 0;
+    ActivationAccuracy accuracy;
+    const SnpeUdo_ErrorType_t status = resolveDenseSeluParams(params, numOfStaticParams, table, depth, units, accuracy);
+    if (status != SNPE_UDO_NO_ERROR)
+    {
+        UDO_ERROR_MSG(status, DENSE_SELU_OP_TYPE << " needs a float32 " << DENSE_SELU_WEIGHTS_PARAM
+                      << " matrix, optionally a float32 " << DENSE_SELU_BIAS_PARAM << " of its columns and an integer "
+                      << ACTIVATION_ACCURACY_MODE_PARAM << " below " << ACTIVATION_NUM_ACCURACY_MODES)
+        return nullptr;
+    }
+    if (numOfInputs != m_NumOfInputs || numOfOutputs != m_NumOfOutputs || inputs == nullptr || outputs == nullptr ||
+        inputs[0].dataType != SNPE_UDO_DATATYPE_FLOAT_32 || outputs[0].dataType != SNPE_UDO_DATATYPE_FLOAT_32)
+    {
+        UDO_ERROR_MSG(SNPE_UDO_UNSUPPORTED_FEATURE, DENSE_SELU_OP_TYPE << " needs one float32 input and output")
+        return nullptr;
+    }
+
+    // static tensor params carry a host pointer to their data rather than a runtime handle
+    const SnpeUdo_TensorParam_t& weights = *table.getTensor(DENSE_SELU_PARAM_WEIGHTS);
+    const SnpeUdo_TensorParam_t* bias = table.getTensor(DENSE_SELU_PARAM_BIAS);
+    if (weights.tensorData == nullptr || (bias != nullptr && bias->tensorData == nullptr))
+    {
+        UDO_ERROR_MSG(SNPE_UDO_INVALID_ARGUMENT, DENSE_SELU_OP_TYPE << " weights and bias must have data")
+        return nullptr;
+    }
+    // the exact mode stores in W + b and rounds Selu's double reference over each
+    // finished block
+    const bool isExact = accuracy == ACTIVATION_ACCURACY_EXACT;
+    const DenseKernelFn run = isExact ? m_Kernels.linear : m_Kernels.modes[accuracy];
+    const ActivationKernelFn exactActivation = isExact ? m_Selu.modes[ACTIVATION_ACCURACY_EXACT].f32 : nullptr;
+
+    std::unique_ptr<DenseSeluOp> op(new DenseSeluOp(inputs, numOfInputs, outputs, numOfOutputs,
+                                                    static_cast<SnpeUdo_CpuInfrastructure_t*>(perOpInfrastructure),
+                                                    numOfStaticParams, params, m_Kernels, run, exactActivation,
+                                                    depth, units));
+    if (op->packWeights(static_cast<const float*>(weights.tensorData),
+                        bias != nullptr ? static_cast<const float*>(bias->tensorData) : nullptr) != SNPE_UDO_NO_ERROR ||
+        op->preparePlan() != SNPE_UDO_NO_ERROR)
+    {
+        return nullptr;
+    }
+    return op;
+}
+
+SnpeUdo_ErrorType_t
+DenseSeluOp::packWeights(const float* weights, const float* bias)
+{
+    // ops with the same weights share one packed copy
+    UdoStaticTensorStore* store = getImplementationStaticTensorStore();
+    UDO_VALIDATE_MSG(store == nullptr,
+                     SNPE_UDO_INVALID_ARGUMENT,
+                     DENSE_SELU_OP_TYPE << " needs the implementation library to store its packed weights")
+
+    DensePackedWeights packed;
+    UDO_VALIDATE_MSG(!acquirePackedDense(*store, weights, bias, m_Depth, m_Units, m_Kernels.panelWidth, packed),
+                     SNPE_UDO_MEM_ALLOC_ERROR,
+                     DENSE_SELU_OP_TYPE << " could not allocate its packed weights")
+
+    m_Packed = std::move(packed.blob);
+    m_Weights = packed.weights;
+    m_Bias = packed.bias;
+    return SNPE_UDO_NO_ERROR;
+}
+
+SnpeUdo_ErrorType_t
+DenseSeluOp::prepare()
+{
+    UDO_VALIDATE_MSG(m_Weights == nullptr || m_Bias == nullptr,
+                     SNPE_UDO_INVALID_ARGUMENT,
+                     DENSE_SELU_OP_TYPE << " weights must be packed before the op is prepared")
+    UDO_VALIDATE_MSG(m_Run == nullptr,
+                     SNPE_UDO_UNSUPPORTED_FEATURE,
+                     DENSE_SELU_OP_TYPE << " has no kernel for its accuracy mode")
+
+    const SnpeUdo_TensorParam_t& input = *m_Inputs[0];
+    const SnpeUdo_TensorParam_t& output = *m_Outputs[0];
+    UDO_VALIDATE_MSG(input.tensorRank == 0 || output.tensorRank == 0,
+                     SNPE_UDO_WRONG_NUM_OF_DIMENSIONS,
+                     DENSE_SELU_OP_TYPE << " input and output must have at least one dimension")
+
+    m_Plan.args.weights = m_Weights;
+    m_Plan.args.bias = m_Bias;
+    m_Plan.args.depth = m_Depth;
+    m_Plan.args.units = m_Units;
+    m_Plan.args.params = SeluActivation::defaults();
+    m_Plan.exactActivation = m_ExactActivation;
+    m_Plan.run = m_Run;
+    return SNPE_UDO_NO_ERROR;
+}
+
+SnpeUdo_ErrorType_t
+DenseSeluOp::reshape()
+{
+    const SnpeUdo_TensorParam_t& input = *m_Inputs[0];
+    const SnpeUdo_TensorParam_t& output = *m_Outputs[0];
+    // leading dimensions fold into rows, so [batch, depth] and [batch, 1, 1, depth] both work
+    const size_t inputCount = getElementCount(input.currDimensions, input.tensorRank);
+    const size_t rows = inputCount / m_Depth;
+    UDO_VALIDATE_MSG(input.currDimensions[input.tensorRank - 1] != m_Depth ||
+                     output.currDimensions[output.tensorRank - 1] != m_Units ||
+                     getElementCount(output.currDimensions, output.tensorRank) != rows * m_Units,
+                     SNPE_UDO_INVALID_ARGUMENT,
+                     DENSE_SELU_OP_TYPE << " needs an input of rows x " << m_Depth
+                     << " and an output of rows x " << m_Units)
+
+    m_Plan.args.rows = rows;
+    // every extra row range streams the weights again, so dense calls are not over-split
+    const size_t maxTasks = limitDenseTasks(rows, m_Depth, m_Units, m_GrainSize, getMaxTasks(1));
+    m_Plan.tiling = makeDenseTiling(rows, m_Units, m_Kernels.panelWidth, maxTasks);
+    return SNPE_UDO_NO_ERROR;
+}
+
+void
+DenseSeluOp::runPlan(const void* in, void* out)
+{
+    const DenseSeluExecutionPlan& plan = m_Plan;
+    if (plan.args.rows == 0)
+    {
+        return;
+    }
+    DenseKernelArgs args = plan.args;
+    args.in = static_cast<const float*>(in);
+    args.out = static_cast<float*>(out);
+    const size_t numTasks = getDenseNumTasks(plan.tiling);
+    if (numTasks <= 1)
+    {
+        runDenseTask(plan.run, plan.exactActivation, args, plan.tiling, 0);
+    }
+    else
+    {
+        parallelFor(numTasks, [this, &plan, &args](size_t taskIdx)
+        {
+            runDenseTask(plan.run, plan.exactActivation, args, plan.tiling, taskIdx);
+            m_Profiler.markChunkEnd();
+        });
+    }
+}
@@ -0,0 +1,105 @@
+//==============================================================================
+// Auto Generated Code for SeluUdoPackage
+//==============================================================================
+
+#include "FusedElementwiseImplLibCpu.hpp"
+#include "utils/UdoMacros.hpp"
+
+using namespace UdoUtil;
+
+std::unique_ptr<UdoOperation>
+FusedElementwiseOpDef::createOp(void* perOpInfrastructure,
+                                uint32_t numOfInputs,
+                                SnpeUdo_TensorParam_t* inputs,
+                                uint32_t numOfOutputs,
+                                SnpeUdo_TensorParam_t* outputs,
+                                uint32_t numOfStaticParams,
+                                SnpeUdo_Param_t* params)
+{
+    FusedElementwiseParamTable table;
+    ExprProgram program;
+    ExprError error;
+    ActivationAccuracy accuracy;
+    const SnpeUdo_ErrorType_t status = resolveFusedElementwiseParams(params, numOfStaticParams, table, program,
+                                                                     error, accuracy);
+    if (status != SNPE_UDO_NO_ERROR)
+    {
+        if (error.message != nullptr)
+        {
+            UDO_ERROR_MSG(status, FUSED_ELEMENTWISE_OP_TYPE << " " << FUSED_ELEMENTWISE_EXPRESSION_PARAM << " \""
+                          << table.getString(FUSED_ELEMENTWISE_PARAM_EXPRESSION) << "\" at " << error.position
+                          << ": " << error.message)
+        }
+        else
+        {
+            UDO_ERROR_MSG(status, FUSED_ELEMENTWISE_OP_TYPE << " needs a string " << FUSED_ELEMENTWISE_EXPRESSION_PARAM
+                          << ", optionally finite float32 a, b, c and d and an integer "
+                          << ACTIVATION_ACCURACY_MODE_PARAM << " below " << ACTIVATION_NUM_ACCURACY_MODES)
+        }
+        return nullptr;
+    }
+    if (numOfInputs != m_NumOfInputs || numOfOutputs != m_NumOfOutputs || inputs == nullptr || outputs == nullptr ||
+        inputs[0].dataType != SNPE_UDO_DATATYPE_FLOAT_32 || outputs[0].dataType != SNPE_UDO_DATATYPE_FLOAT_32)
+    {
+        UDO_ERROR_MSG(SNPE_UDO_UNSUPPORTED_FEATURE, FUSED_ELEMENTWISE_OP_TYPE << " needs one float32 input and output")
+        return nullptr;
+    }
+
+    std::unique_ptr<FusedElementwiseOp> op(new FusedElementwiseOp(inputs, numOfInputs, outputs, numOfOutputs,
+                                                                  static_cast<SnpeUdo_CpuInfrastructure_t*>(
+                                                                      perOpInfrastructure),
+                                                                  numOfStaticParams, params, m_Run, m_Activations,
+                                                                  program, accuracy));
+    if (op->preparePlan() != SNPE_UDO_NO_ERROR)
+    {
+        return nullptr;
+    }
+    return op;
+}
+
+SnpeUdo_ErrorType_t
+FusedElementwiseOp::prepare()
+{
+    UDO_VALIDATE_MSG(m_Run == nullptr || m_Program.numInstructions == 0,
+                     SNPE_UDO_UNSUPPORTED_FEATURE,
+                     FUSED_ELEMENTWISE_OP_TYPE << " has no compiled expression")
+
+    const SnpeUdo_TensorParam_t& input = *m_Inputs[0];
+    const SnpeUdo_TensorParam_t& output = *m_Outputs[0];
+    UDO_VALIDATE_MSG(input.tensorRank != output.tensorRank,
+                     SNPE_UDO_WRONG_NUM_OF_DIMENSIONS,
+                     FUSED_ELEMENTWISE_OP_TYPE << " input and output ranks differ")
+
+    m_Plan.args.program = &m_Program;
+    m_Plan.args.activations = m_Activations;
+    m_Plan.args.accuracy = m_Accuracy;
+    m_Plan.run = m_Run;
+    return SNPE_UDO_NO_ERROR;
+}
+
+SnpeUdo_ErrorType_t
+FusedElementwiseOp::reshape()
+{
+    const SnpeUdo_TensorParam_t& input = *m_Inputs[0];
+    const SnpeUdo_TensorParam_t& output = *m_Outputs[0];
+    const size_t elementCount = getElementCount(output.currDimensions, output.tensorRank);
+    UDO_VALIDATE_MSG(getElementCount(input.currDimensions, input.tensorRank) != elementCount,
+                     SNPE_UDO_INVALID_ARGUMENT,
+                     FUSED_ELEMENTWISE_OP_TYPE << " input and output shapes differ")
+
+    m_Plan.partition = partitionElements(elementCount, sizeof(float));
+    return SNPE_UDO_NO_ERROR;
+}
+
+void
+FusedElementwiseOp::runPlan(const void* in, void* out)
+{
+    const ExprKernelFn run = m_Plan.run;
+    ExprKernelArgs args = m_Plan.args;
+    args.in = static_cast<const float*>(in);
+    args.out = static_cast<float*>(out);
+    parallelForPartition(m_Plan.partition, [run, &args](size_t begin, size_t end)
+    {
+        run(args, begin, end);
+    });
+}
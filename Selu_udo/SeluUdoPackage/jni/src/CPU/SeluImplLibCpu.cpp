@@ -3,100 +3,64 @@
 //==============================================================================
 
 #include "SeluImplLibCpu.hpp"
-#include <algorithm>
-#include <cmath>
-#include <chrono>
-#include <string>
+#include "SeluKernelsCpu.hpp"
+#include "utils/UdoCpuFeatures.hpp"
 
-std::unique_ptr<UdoUtil::UdoOperation>
-SeluOpDef::createOp(void *perOpInfrastructure,
-                    uint32_t numOfInputs,
-                    SnpeUdo_TensorParam_t *inputs,
-                    uint32_t numOfOutputs,
-                    SnpeUdo_TensorParam_t *outputs,
-                    uint32_t numOfStaticParams,
-                    SnpeUdo_Param_t* params)
-{
-    /**
-      * add code here
-      * This method should
-      * 1.) Validate Static Params
-      * 2.) Create Op
-      * 3.) Convert arguments and use appropriate constructor in Selu.hpp
-      */
+namespace {
 
-    return std::unique_ptr<UdoUtil::UdoCpuOperation>
-          (new SeluOp(inputs, numOfInputs, outputs, numOfOutputs,
-                         static_cast<SnpeUdo_CpuInfrastructure_t*>(perOpInfrastructure),
-                         numOfStaticParams, params));
-   // return nullptr;
+// the exact kernels evaluate each activation's double reference and are only
+// instantiated here, with the baseline flags
+template <typename... Acts>
+SeluKernelTable
+addExactKernels(SeluKernelTable table, UdoUtil::ActivationList<Acts...>)
+{
+    const UdoUtil::ActivationFloatKernels exactKernels[] = {UdoUtil::makeActivationExactKernels<Acts>()...};
+    for (size_t idx = 0; idx < SELU_PACKAGE_NUM_ACTIVATIONS; idx++)
+    {
+        table.activations[idx].modes[UdoUtil::ACTIVATION_ACCURACY_EXACT] = exactKernels[idx];
+    }
+    return table;
 }
 
-SnpeUdo_ErrorType_t
-SeluOp::snpeUdoExecute(bool blocking, const uint32_t ID, SnpeUdo_ExternalNotify_t notifyFunc)
+const SeluKernelTable*
+selectSeluKernelTable()
 {
-    /**
-      * add code here
-      */
-
-    auto startTime = std::chrono::high_resolution_clock::now();
-    if(!blocking) { return SNPE_UDO_UNSUPPORTED_FEATURE; }
-    if(m_Inputs.empty() || m_Outputs.empty() || !m_PerOpFactoryInfrastructure) { return SNPE_UDO_INVALID_ARGUMENT; }
-
-    const uint32_t rank = m_Outputs[0]->tensorRank;
-    const size_t depth = m_Outputs[0]->currDimensions[rank - 1];
-
-    uint32_t tensorLength = 1;
-
-    for(uint32_t j = 0; j < rank; ++j)
+    const UdoUtil::CpuFeatures& cpu = UdoUtil::getCpuFeatures();
+    // the AVX2 and AVX-512 builds convert half precision with F16C
+    if (cpu.avx512f && cpu.avx2 && cpu.fma && cpu.f16c && getSeluKernelTableAvx512())
     {
-       tensorLength *= (uint32_t)(m_Outputs[0]->currDimensions[j]);
-
+        return getSeluKernelTableAvx512();
     }
-    const size_t numPixels = tensorLength/depth;
-
-    for( size_t pix = 0; pix < numPixels; ++pix )
-   {
-      const float* in = (float*)m_PerOpFactoryInfrastructure->getData(m_Inputs[0]->tensorData)+pix*depth;
-      float* out = (float*)m_PerOpFactoryInfrastructure->getData(m_Outputs[0]->tensorData)+pix*depth;
-
-      
-      // find the max element for max subtraction
-      float maxElt = std::numeric_limits<float>::lowest();
-      for( size_t i = 0; i < depth; ++i )
-      {
-         maxElt = std::max( maxElt, in[i] );
-      }
-      
-      // compute exponentiations
-      float expSum = 0.0;
-      const float scale = 1.05070098;
-      const float alpha = 1.67326324;
-      for( size_t i = 0; i < depth; ++i )
-      {
-       // const float ei = expf( in[i] - maxElt );
-        const float x = in[i] - maxElt;
-        
-        if (x>0) {
-          out[i] = scale * x;
-        }
+    if (cpu.avx2 && cpu.fma && cpu.f16c && getSeluKernelTableAvx2())
+    {
+        return getSeluKernelTableAvx2();
+    }
+    if (cpu.sse42 && getSeluKernelTableSse42())
+    {
+        return getSeluKernelTableSse42();
+    }
+    if (cpu.neon && getSeluKernelTableNeon())
+    {
+        return getSeluKernelTableNeon();
+    }
+    return getSeluKernelTableScalar();
+}
 
-        if (x<0) {
-          out[i] = scale * alpha * (exp(x) - 1);
-        }
+}
 
-      }
-      /*
-      // normalize
-      for( size_t i = 0; i < depth; ++i )
-      {
-         out[i] = out[i] / expSum;
-      }
-      */
-   }
+const SeluKernelTable*
+getSeluKernelTableScalar()
+{
+    static const SeluKernelTable kernels =
+        makeSeluKernelTable<UdoUtil::Simd::VecF32<UdoUtil::Simd::ScalarIsa>,
+                            &UdoUtil::lookupTable8Scalar,
+                            &UdoUtil::lookupInterp16Scalar>("scalar", SeluPackageActivations());
+    return &kernels;
+}
 
-    auto elapsedTime = std::chrono::high_resolution_clock::now() - startTime;
-    uint32_t elapsedTimeUs = std::chrono::duration_cast<std::chrono::microseconds>(elapsedTime).count();
-    m_ExecutionTime = elapsedTimeUs;
-    return SNPE_UDO_NO_ERROR;
+const SeluKernelTable&
+resolveSeluKernelTable()
+{
+    static const SeluKernelTable kernels = addExactKernels(*selectSeluKernelTable(), SeluPackageActivations());
+    return kernels;
 }
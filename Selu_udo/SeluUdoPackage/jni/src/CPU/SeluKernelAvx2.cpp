@@ -0,0 +1,22 @@
+//==============================================================================
+// AVX2/FMA activation kernels for SeluUdoPackage
+//
+// This file is compiled with -mavx2 -mfma -mf16c (see Makefile). It must only
+// instantiate the AVX2/FMA/F16C backend, otherwise the linker may pick a copy of
+// shared inline code built for AVX2/FMA/F16C for use on hosts without it.
+//==============================================================================
+
+#include "SeluKernelsCpu.hpp"
+
+const SeluKernelTable*
+getSeluKernelTableAvx2()
+{
+#if defined(__AVX2__) && defined(__FMA__) && defined(__F16C__)
+    using V = UdoUtil::Simd::VecF32<UdoUtil::Simd::Avx2Isa>;
+    static const SeluKernelTable kernels =
+        makeSeluKernelTable<V, &UdoUtil::lookupTable8Avx2, &UdoUtil::lookupInterp16Avx2>("avx2", SeluPackageActivations());
+    return &kernels;
+#else
+    return nullptr;
+#endif
+}
@@ -0,0 +1,22 @@
+//==============================================================================
+// AVX-512 activation kernels for SeluUdoPackage
+//
+// This file is compiled with -mavx512f -mavx2 -mfma -mf16c (see Makefile). It must only
+// instantiate the AVX-512 backend, otherwise the linker may pick a copy of
+// shared inline code built for AVX-512 for use on hosts without it.
+//==============================================================================
+
+#include "SeluKernelsCpu.hpp"
+
+const SeluKernelTable*
+getSeluKernelTableAvx512()
+{
+#if defined(__AVX512F__)
+    using V = UdoUtil::Simd::VecF32<UdoUtil::Simd::Avx512Isa>;
+    static const SeluKernelTable kernels =
+        makeSeluKernelTable<V, &UdoUtil::lookupTable8Avx2, &UdoUtil::lookupInterp16Avx2>("avx512", SeluPackageActivations());
+    return &kernels;
+#else
+    return nullptr;
+#endif
+}
@@ -0,0 +1,26 @@
+//==============================================================================
+// NEON activation kernels for SeluUdoPackage
+//
+// NEON is part of the aarch64 baseline and of the armeabi-v7a ABI used by
+// ndk-build, so this file needs no extra flags; on x86 it reports no kernel.
+//==============================================================================
+
+#include "SeluKernelsCpu.hpp"
+
+const SeluKernelTable*
+getSeluKernelTableNeon()
+{
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    using V = UdoUtil::Simd::VecF32<UdoUtil::Simd::NeonIsa>;
+#if defined(__aarch64__)
+    static const SeluKernelTable kernels =
+        makeSeluKernelTable<V, &UdoUtil::lookupTable8Neon, &UdoUtil::lookupInterp16Scalar>("neon", SeluPackageActivations());
+#else
+    static const SeluKernelTable kernels =
+        makeSeluKernelTable<V, &UdoUtil::lookupTable8Scalar, &UdoUtil::lookupInterp16Scalar>("neon", SeluPackageActivations());
+#endif
+    return &kernels;
+#else
+    return nullptr;
+#endif
+}
@@ -0,0 +1,22 @@
+//==============================================================================
+// SSE4.2 activation kernels for SeluUdoPackage
+//
+// This file is compiled with -msse4.2 (see Makefile). It must only
+// instantiate the SSE4.2 backend, otherwise the linker may pick a copy of
+// shared inline code built for SSE4.2 for use on hosts without it.
+//==============================================================================
+
+#include "SeluKernelsCpu.hpp"
+
+const SeluKernelTable*
+getSeluKernelTableSse42()
+{
+#if defined(__SSE4_1__)
+    using V = UdoUtil::Simd::VecF32<UdoUtil::Simd::Sse4Isa>;
+    static const SeluKernelTable kernels =
+        makeSeluKernelTable<V, &UdoUtil::lookupTable8Ssse3, &UdoUtil::lookupInterp16Scalar>("sse4.2", SeluPackageActivations());
+    return &kernels;
+#else
+    return nullptr;
+#endif
+}
@@ -2,7 +2,9 @@
 // Auto Generated Code for SeluUdoPackage
 //==============================================================================
 #include "utils/UdoUtil.hpp"
+#include "utils/UdoAllocCheck.hpp"
 #include "SnpeUdo/UdoImpl.h"
+#include "utils/UdoProfileStats.h"
 #include "SeluImplLibCpu.hpp"
 
 
@@ -12,21 +14,50 @@ using namespace UdoUtil;
 SnpeUdo_ErrorType_t SnpeUdo_initImplLibrary(void* globalInfrastructure)
 {
 
-    UDO_VALIDATE_RETURN_STATUS(setImplementation( SNPE_UDO_CORETYPE_CPU, "SeluUdoPackage"));
-
-    UdoImplementationLib& ImplLib = getImplementation();
+    // built and registered here, then published complete, so that no other thread sees
+    // the library half registered
+    std::unique_ptr<UdoImplementationLib> implLib(new UdoImplementationLib(SNPE_UDO_CORETYPE_CPU, "SeluUdoPackage"));
+    UdoImplementationLib& ImplLib = *implLib;
 
     ImplLib.setVersion(1,0,0);
 
+    // every activation shares ActivationOp, with the kernels of the fastest instruction
+    // set the host supports
+    const SeluKernelTable& kernels = resolveSeluKernelTable();
+    const ActivationInfo* activations = getSeluPackageActivations();
+    for (size_t idx = 0; idx < SELU_PACKAGE_NUM_ACTIVATIONS; idx++)
+    {
+        UDO_VALIDATE_RETURN_STATUS(ImplLib.registerOpDefinition
+                                   (activations[idx].operationType,
+                                   std::unique_ptr<ActivationOpDef>(new ActivationOpDef(activations[idx],
+                                                                                        kernels.activations[idx],
+                                                                                        1, 1))))
+    }
+
+    const size_t seluIdx = ActivationIndex<SeluActivation, SeluPackageActivations>::value;
     UDO_VALIDATE_RETURN_STATUS(ImplLib.registerOpDefinition
-                               ("Selu",
-                               std::unique_ptr<SeluOpDef>(new SeluOpDef("Selu",1, 1))))
-    return SNPE_UDO_NO_ERROR;
+                               (DENSE_SELU_OP_TYPE,
+                               std::unique_ptr<DenseSeluOpDef>(new DenseSeluOpDef(kernels.denseSelu,
+                                                                                  kernels.activations[seluIdx],
+                                                                                  1, 1))))
+    UDO_VALIDATE_RETURN_STATUS(ImplLib.registerOpDefinition
+                               (CONV2D_SELU_OP_TYPE,
+                               std::unique_ptr<Conv2dSeluOpDef>(new Conv2dSeluOpDef(kernels.conv2dSelu,
+                                                                                    kernels.activations[seluIdx],
+                                                                                    1, 1))))
+    UDO_VALIDATE_RETURN_STATUS(ImplLib.registerOpDefinition
+                               (FUSED_ELEMENTWISE_OP_TYPE,
+                               std::unique_ptr<FusedElementwiseOpDef>(new FusedElementwiseOpDef(
+                                                                      kernels.fusedElementwise,
+                                                                      kernels.activations, 1, 1))))
+    return setImplementation(std::move(implLib));
 }
 
 SnpeUdo_ErrorType_t SnpeUdo_terminateImplLibrary(void)
 {
     SnpeUdo_ErrorType_t status = SNPE_UDO_NO_ERROR;
+    // terminate may come without a successful init, or twice
+    dumpImplementationLatencyStats(std::cerr);
     deleteImplementationInstance();
     return status;
 }
@@ -69,23 +100,12 @@ SnpeUdo_createOperation(SnpeUdo_OpFactory_t opFactory,
                         SnpeUdo_TensorParam_t *outputs,
                         SnpeUdo_Operation_t* operation)
 {
-    auto result = (opFactory)->definition->createOp(opFactory->infrastructure,
-                                                    numOfInputs,
-                                                    inputs,
-                                                    numOfOutputs,
-                                                    outputs,
-                                                    opFactory->numOfStaticParams,
-                                                    opFactory->staticParams);
-
-    UDO_VALIDATE_MSG(result == nullptr,
-                    SNPE_UDO_WRONG_OPERATION,
-                    "Could not create operation of type: "<<opFactory->definition->getOperationType())
-
-    std::unique_ptr<_SnpeUdo_Operation_t> handle(new _SnpeUdo_Operation_t());
-    handle->operation = std::move(result);
-    *operation = handle.release();
-
-    return SNPE_UDO_NO_ERROR;
+    return UdoImplementationLib::createOperation(opFactory,
+                                                 numOfInputs,
+                                                 inputs,
+                                                 numOfOutputs,
+                                                 outputs,
+                                                 operation);
 }
 
 SnpeUdo_ErrorType_t
@@ -94,6 +114,14 @@ SnpeUdo_executeOp(SnpeUdo_Operation_t operation,
                   const uint32_t ID,
                   SnpeUdo_ExternalNotify_t notifyFunc)
 {
+#ifdef UDO_CHECK_EXECUTE_ALLOCATIONS
+    // the library's async executor is created with its first non-blocking execute
+    if (!blocking)
+    {
+        UdoUtil::getImplementationAsyncExecutor();
+    }
+#endif
+    UdoUtil::UdoNoAllocScope noAlloc;
     return operation->operation->snpeUdoExecute(blocking, ID, notifyFunc);
 }
 
@@ -102,6 +130,9 @@ SnpeUdo_setOpIO(SnpeUdo_Operation_t operation,
                 SnpeUdo_TensorParam_t *inputs,
                 SnpeUdo_TensorParam_t *outputs)
 {
+    UDO_VALIDATE_MSG(operation == nullptr || !operation->operation,
+                     SNPE_UDO_INVALID_ARGUMENT,
+                     "Operation provided is not valid")
     return operation->operation->snpeUdoSetIo(inputs, outputs);
 }
 
@@ -111,22 +142,68 @@ SnpeUdo_profileOp(SnpeUdo_Operation_t operation, uint32_t *executionTime)
     return  operation->operation->snpeUdoProfile(executionTime);
 }
 
+SnpeUdo_ErrorType_t
+SnpeUdoExt_getOpProfileStats(SnpeUdo_Operation_t operation, UdoProfileStats_t* stats)
+{
+    UDO_VALIDATE_MSG(operation == nullptr || !operation->operation,
+                     SNPE_UDO_INVALID_ARGUMENT,
+                     "Operation provided is not valid")
+    return operation->operation->snpeUdoProfileStats(stats);
+}
 
 SnpeUdo_ErrorType_t
-SnpeUdo_releaseOp(SnpeUdo_Operation_t operation)
+SnpeUdoExt_resetOpProfileStats(SnpeUdo_Operation_t operation)
 {
-    auto status = SNPE_UDO_NO_ERROR;
-    operation->operation.reset();
+    UDO_VALIDATE_MSG(operation == nullptr || !operation->operation,
+                     SNPE_UDO_INVALID_ARGUMENT,
+                     "Operation provided is not valid")
+    return operation->operation->snpeUdoResetProfileStats();
+}
 
-    return status;
+SnpeUdo_ErrorType_t
+SnpeUdoExt_getOpLatencyStats(SnpeUdo_Operation_t operation, UdoLatencyStats_t* stats)
+{
+    UDO_VALIDATE_MSG(operation == nullptr || !operation->operation || stats == nullptr,
+                     SNPE_UDO_INVALID_ARGUMENT,
+                     "Operation or latency stats provided are not valid")
+    const UdoLatencyHistogram* histogram = operation->operation->getLatencyHistogram();
+    if (histogram == nullptr)
+    {
+        return SNPE_UDO_UNSUPPORTED_FEATURE;
+    }
+    histogram->getStats(*stats);
+    return SNPE_UDO_NO_ERROR;
+}
+
+SnpeUdo_ErrorType_t
+SnpeUdoExt_getOpTypeLatencyStats(SnpeUdo_String_t operationType, UdoLatencyStats_t* stats)
+{
+    UDO_VALIDATE_MSG(operationType == nullptr,
+                     SNPE_UDO_INVALID_ARGUMENT,
+                     "Operation type provided is not valid")
+    return getImplementation().getLatencyStats(operationType, stats);
+}
+
+SnpeUdo_ErrorType_t
+SnpeUdoExt_setOpParallelism(SnpeUdo_Operation_t operation, uint32_t maxThreads, uint32_t grainSize)
+{
+    UDO_VALIDATE_MSG(operation == nullptr || !operation->operation,
+                     SNPE_UDO_INVALID_ARGUMENT,
+                     "Operation provided is not valid")
+    return operation->operation->snpeUdoSetParallelism(maxThreads, grainSize);
+}
+
+
+SnpeUdo_ErrorType_t
+SnpeUdo_releaseOp(SnpeUdo_Operation_t operation)
+{
+    return UdoImplementationLib::releaseOperation(operation);
 }
 
 SnpeUdo_ErrorType_t
 SnpeUdo_releaseOpFactory(SnpeUdo_OpFactory_t opFactory)
 {
-    auto status = SNPE_UDO_NO_ERROR;
-    delete opFactory; // manually allocated object in createOpFactory
-    return status;
+    return UdoImplementationLib::releaseOpFactory(opFactory);
 }
 
 }; //extern C
@@ -0,0 +1,192 @@
+//==============================================================================
+//
+// Copyright (c) 2020 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+// Scaffolding shared by the host tools of this directory: the stand-in for the SNPE
+// runtime's CPU infrastructure, tensor params over host buffers, option parsing, timing
+// and result output. Each tool keeps its own layers, options and result columns.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SnpeUdo/UdoBase.h"
+
+namespace BenchCommon {
+
+// timed rounds per pass, each of a BENCH_ROUNDS-th of --min-time-ms
+constexpr uint32_t BENCH_ROUNDS = 5;
+
+/**
+ * \brief The options every benchmark takes, --min-time-ms, --format and --output.
+ */
+struct BenchOptions
+{
+    uint32_t minTimeMs = 200;
+    std::string format = "csv";
+    std::string output;
+};
+
+// tensor handles are plain host pointers, which is all the stand-in runtime needs
+inline float*
+getData(SnpeUdo_TensorData_t tensorData)
+{
+    return static_cast<float*>(tensorData);
+}
+
+/**
+ * \brief A float NHWC tensor over data, dims must outlive the param.
+ */
+inline SnpeUdo_TensorParam_t
+makeTensorParam(std::vector<uint32_t>& dims, float* data)
+{
+    SnpeUdo_TensorParam_t param;
+    std::memset(&param, 0, sizeof(param));
+    param.dataType = SNPE_UDO_DATATYPE_FLOAT_32;
+    param.layout = SNPE_UDO_LAYOUT_NHWC;
+    param.tensorRank = static_cast<uint32_t>(dims.size());
+    param.maxDimensions = dims.data();
+    param.currDimensions = dims.data();
+    param.tensorData = data;
+    return param;
+}
+
+/**
+ * \brief Appends the positive integers of a separated list to list, false on any other item.
+ */
+inline bool
+parseList(const std::string& value, std::vector<uint32_t>& list, char separator = ',')
+{
+    std::istringstream items(value);
+    std::string item;
+    while (std::getline(items, item, separator))
+    {
+        if (std::atoi(item.c_str()) <= 0)
+        {
+            return false;
+        }
+        list.push_back(static_cast<uint32_t>(std::atoi(item.c_str())));
+    }
+    return true;
+}
+
+/**
+ * \brief Splits --key=value, value is empty without the '='.
+ */
+inline void
+splitOption(const std::string& arg, std::string& key, std::string& value)
+{
+    const size_t eq = arg.find('=');
+    key = arg.substr(0, eq);
+    value = eq == std::string::npos ? std::string() : arg.substr(eq + 1);
+}
+
+/**
+ * \brief Parses one of the options of BenchOptions, false for a bad value or any other key.
+ */
+inline bool
+parseBenchOption(const std::string& key, const std::string& value, BenchOptions& options)
+{
+    if (key == "--min-time-ms")
+    {
+        options.minTimeMs = static_cast<uint32_t>(std::atoi(value.c_str()));
+    }
+    else if (key == "--format" && (value == "csv" || value == "json"))
+    {
+        options.format = value;
+    }
+    else if (key == "--output" && !value.empty())
+    {
+        options.output = value;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * \brief One thread and, on a multi-core host, one per hardware thread.
+ */
+inline void
+setDefaultThreads(std::vector<uint32_t>& threads)
+{
+    threads.push_back(1);
+    const uint32_t hwThreads = std::thread::hardware_concurrency();
+    if (hwThreads > 1)
+    {
+        threads.push_back(hwThreads);
+    }
+}
+
+/**
+ * \brief Mean time of fn over at least minTimeMs and 10 calls, after a warm up.
+ */
+template <typename Fn>
+double
+timeCalls(uint32_t minTimeMs, uint64_t& iterations, const Fn& fn)
+{
+    for (uint32_t iter = 0; iter < 3; iter++)
+    {
+        fn();
+    }
+    const auto minTime = std::chrono::milliseconds(minTimeMs);
+    const auto start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::duration elapsed;
+    iterations = 0;
+    do
+    {
+        fn();
+        iterations++;
+        elapsed = std::chrono::steady_clock::now() - start;
+    } while (elapsed < minTime || iterations < 10);
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iterations);
+}
+
+/**
+ * \brief Writes results in the format of options to --output or stdout, false when the
+ * file cannot be opened.
+ */
+template <typename Result>
+bool
+writeResults(const BenchOptions& options, const std::vector<Result>& results,
+             void (*writeCsv)(std::ostream&, const std::vector<Result>&),
+             void (*writeJson)(std::ostream&, const std::vector<Result>&))
+{
+    std::ofstream file;
+    if (!options.output.empty())
+    {
+        file.open(options.output);
+        if (!file)
+        {
+            std::cerr << "ERROR: could not open " << options.output << std::endl;
+            return false;
+        }
+    }
+    std::ostream& stream = options.output.empty() ? std::cout : file;
+    if (options.format == "json")
+    {
+        writeJson(stream, results);
+    }
+    else
+    {
+        writeCsv(stream, results);
+    }
+    return true;
+}
+
+} // namespace BenchCommon
@@ -0,0 +1,320 @@
+//==============================================================================
+//
+// Copyright (c) 2020 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+// Stress benchmark of the implementation library entry points called from many runtime
+// threads at once. Every thread runs cycles of a Selu op on its own 1x128 tensors:
+//  own_factory     SnpeUdo_getImpInfo, then create a factory and an op, execute the op
+//                  and release both, like runtimes loading networks in parallel
+//  shared_factory  create an op of one factory all threads share, execute and release it
+// Threads run at once for --min-time-ms, the fastest of a few rounds is reported with
+// its throughput relative to one thread. Intra-op parallelism is off, so that the
+// threads only meet in the library's shared state.
+//
+// usage: concurrent-op-bench [--threads=1,2,4,8] [--min-time-ms=200] [--format=csv|json] [--output=file]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BenchCommon.hpp"
+#include "SnpeUdo/UdoImpl.h"
+#include "SnpeUdo/UdoImplCpu.h"
+#include "utils/UdoUtil.hpp"
+
+namespace {
+
+constexpr uint32_t NUM_ELEMENTS = 128;
+
+enum Workload
+{
+    OWN_FACTORY,
+    SHARED_FACTORY
+};
+
+const char*
+getWorkloadName(Workload workload)
+{
+    return workload == OWN_FACTORY ? "own_factory" : "shared_factory";
+}
+
+struct BenchResult
+{
+    std::string workload;
+    uint32_t threads;
+    uint64_t cycles;
+    double cycleNs; // per thread
+    double cyclesPerUs; // all threads
+    double scaling;
+};
+
+struct BenchOptions : BenchCommon::BenchOptions
+{
+    std::vector<uint32_t> threads;
+};
+
+/**
+ * \brief The tensors of one thread's ops.
+ */
+class ThreadTensors
+{
+public:
+    ThreadTensors()
+        : m_Dims{1, NUM_ELEMENTS}
+        , m_Input(NUM_ELEMENTS)
+        , m_Output(NUM_ELEMENTS)
+    {
+        for (size_t idx = 0; idx < m_Input.size(); idx++)
+        {
+            m_Input[idx] = static_cast<float>(static_cast<int>(idx * 2654435761u % 2001) - 1000) / 250.0f;
+        }
+        m_InputParam = BenchCommon::makeTensorParam(m_Dims, m_Input.data());
+        m_OutputParam = BenchCommon::makeTensorParam(m_Dims, m_Output.data());
+    }
+
+    ThreadTensors(const ThreadTensors&) = delete;
+    ThreadTensors& operator=(const ThreadTensors&) = delete;
+
+    SnpeUdo_TensorParam_t* getInput() { return &m_InputParam; }
+    SnpeUdo_TensorParam_t* getOutput() { return &m_OutputParam; }
+
+private:
+    std::vector<uint32_t> m_Dims;
+    std::vector<float> m_Input;
+    std::vector<float> m_Output;
+    SnpeUdo_TensorParam_t m_InputParam;
+    SnpeUdo_TensorParam_t m_OutputParam;
+};
+
+bool
+createFactory(SnpeUdo_CpuInfrastructure_t* infrastructure, SnpeUdo_OpFactory_t* factory)
+{
+    return SnpeUdo_createOpFactory(SNPE_UDO_CORETYPE_CPU, infrastructure, const_cast<char*>("Selu"), 0, nullptr,
+                                   factory) == SNPE_UDO_NO_ERROR;
+}
+
+bool
+runOp(SnpeUdo_OpFactory_t factory, ThreadTensors& tensors)
+{
+    SnpeUdo_Operation_t op = nullptr;
+    if (SnpeUdo_createOperation(factory, nullptr, 1, tensors.getInput(), 1, tensors.getOutput(), &op) !=
+        SNPE_UDO_NO_ERROR)
+    {
+        return false;
+    }
+    const bool ok = SnpeUdo_executeOp(op, true, 0, nullptr) == SNPE_UDO_NO_ERROR;
+    return SnpeUdo_releaseOp(op) == SNPE_UDO_NO_ERROR && ok;
+}
+
+/**
+ * \brief One cycle of the workload, see the file comment.
+ */
+bool
+runCycle(Workload workload, SnpeUdo_CpuInfrastructure_t* infrastructure, SnpeUdo_OpFactory_t sharedFactory,
+         ThreadTensors& tensors)
+{
+    if (workload == SHARED_FACTORY)
+    {
+        return runOp(sharedFactory, tensors);
+    }
+    SnpeUdo_ImpInfo_t* info = nullptr;
+    if (SnpeUdo_getImpInfo(&info) != SNPE_UDO_NO_ERROR || info->numOfOperations == 0)
+    {
+        return false;
+    }
+    SnpeUdo_OpFactory_t factory = nullptr;
+    if (!createFactory(infrastructure, &factory))
+    {
+        return false;
+    }
+    const bool ok = runOp(factory, tensors);
+    return SnpeUdo_releaseOpFactory(factory) == SNPE_UDO_NO_ERROR && ok;
+}
+
+/**
+ * \brief Runs numThreads threads for about minTimeMs once all of them are up, and
+ * returns the cycles they completed and the time they ran.
+ */
+bool
+runRound(Workload workload, uint32_t numThreads, uint32_t minTimeMs, SnpeUdo_CpuInfrastructure_t* infrastructure,
+         SnpeUdo_OpFactory_t sharedFactory, uint64_t& cycles, double& elapsedNs)
+{
+    std::atomic<uint32_t> numReady(0);
+    std::atomic<bool> start(false);
+    std::atomic<bool> stop(false);
+    std::atomic<uint64_t> totalCycles(0);
+    std::atomic<bool> ok(true);
+
+    std::vector<std::thread> threads;
+    for (uint32_t threadIdx = 0; threadIdx < numThreads; threadIdx++)
+    {
+        threads.emplace_back([&]() {
+            ThreadTensors tensors;
+            // warm up outside the timed window, then wait for the others
+            bool threadOk = runCycle(workload, infrastructure, sharedFactory, tensors);
+            numReady.fetch_add(1);
+            while (!start.load(std::memory_order_acquire)) { std::this_thread::yield(); }
+            uint64_t threadCycles = 0;
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                threadOk = runCycle(workload, infrastructure, sharedFactory, tensors) && threadOk;
+                threadCycles++;
+            }
+            totalCycles.fetch_add(threadCycles);
+            if (!threadOk) { ok.store(false); }
+        });
+    }
+    while (numReady.load() < numThreads) { std::this_thread::yield(); }
+    const auto startTime = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(std::chrono::milliseconds(minTimeMs));
+    stop.store(true);
+    const auto endTime = std::chrono::steady_clock::now();
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    cycles = totalCycles.load();
+    elapsedNs = std::chrono::duration<double, std::nano>(endTime - startTime).count();
+    return ok.load() && cycles > 0;
+}
+
+bool
+runWorkload(const BenchOptions& options, Workload workload, SnpeUdo_CpuInfrastructure_t* infrastructure,
+            std::vector<BenchResult>& results)
+{
+    SnpeUdo_OpFactory_t sharedFactory = nullptr;
+    if (workload == SHARED_FACTORY && !createFactory(infrastructure, &sharedFactory))
+    {
+        std::cerr << "ERROR: could not create the shared Selu factory" << std::endl;
+        return false;
+    }
+    const uint32_t roundTimeMs = std::max<uint32_t>(1, options.minTimeMs / BenchCommon::BENCH_ROUNDS);
+    double singleThreadRate = 0;
+    bool ok = true;
+    for (uint32_t numThreads : options.threads)
+    {
+        BenchResult result;
+        result.workload = getWorkloadName(workload);
+        result.threads = numThreads;
+        result.cycles = 0;
+        result.cyclesPerUs = 0;
+        for (uint32_t round = 0; round < BenchCommon::BENCH_ROUNDS && ok; round++)
+        {
+            uint64_t cycles = 0;
+            double elapsedNs = 0;
+            ok = runRound(workload, numThreads, roundTimeMs, infrastructure, sharedFactory, cycles, elapsedNs) && ok;
+            result.cycles += cycles;
+            result.cyclesPerUs = std::max(result.cyclesPerUs, static_cast<double>(cycles) * 1000.0 / elapsedNs);
+        }
+        if (!ok)
+        {
+            std::cerr << "ERROR: " << result.workload << " cycle failed with " << numThreads << " threads"
+                      << std::endl;
+            break;
+        }
+        result.cycleNs = numThreads * 1000.0 / result.cyclesPerUs;
+        if (numThreads == 1)
+        {
+            singleThreadRate = result.cyclesPerUs;
+        }
+        result.scaling = singleThreadRate > 0 ? result.cyclesPerUs / singleThreadRate : 0;
+        results.push_back(result);
+    }
+    if (sharedFactory != nullptr)
+    {
+        SnpeUdo_releaseOpFactory(sharedFactory);
+    }
+    return ok;
+}
+
+void
+writeCsv(std::ostream& stream, const std::vector<BenchResult>& results)
+{
+    stream << "workload,threads,cycles,cycle_ns,cycles_per_us,scaling\n";
+    for (const BenchResult& result : results)
+    {
+        stream << result.workload << ',' << result.threads << ',' << result.cycles << ',' << result.cycleNs << ','
+               << result.cyclesPerUs << ',' << result.scaling << '\n';
+    }
+}
+
+void
+writeJson(std::ostream& stream, const std::vector<BenchResult>& results)
+{
+    stream << "[\n";
+    for (size_t idx = 0; idx < results.size(); idx++)
+    {
+        const BenchResult& result = results[idx];
+        stream << "  {\"workload\": \"" << result.workload << "\", \"threads\": " << result.threads
+               << ", \"cycles\": " << result.cycles << ", \"cycle_ns\": " << result.cycleNs
+               << ", \"cycles_per_us\": " << result.cyclesPerUs << ", \"scaling\": " << result.scaling << "}"
+               << (idx + 1 < results.size() ? ",\n" : "\n");
+    }
+    stream << "]\n";
+}
+
+bool
+parseOptions(int argc, char** argv, BenchOptions& options)
+{
+    for (int idx = 1; idx < argc; idx++)
+    {
+        std::string key, value;
+        BenchCommon::splitOption(argv[idx], key, value);
+        if (key == "--threads")
+        {
+            if (!BenchCommon::parseList(value, options.threads)) { return false; }
+        }
+        else if (!BenchCommon::parseBenchOption(key, value, options))
+        {
+            return false;
+        }
+    }
+    if (options.threads.empty())
+    {
+        options.threads = {1, 2, 4, 8};
+    }
+    return true;
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options))
+    {
+        std::cerr << "usage: " << argv[0]
+                  << " [--threads=1,2,4,8] [--min-time-ms=200] [--format=csv|json] [--output=file]" << std::endl;
+        return 1;
+    }
+
+    SnpeUdo_CpuInfrastructure_t infrastructure;
+    infrastructure.getData = BenchCommon::getData;
+
+    if (SnpeUdo_initImplLibrary(nullptr) != SNPE_UDO_NO_ERROR ||
+        UdoUtil::getImplementation().setNumThreads(1) != SNPE_UDO_NO_ERROR)
+    {
+        return 1;
+    }
+    std::vector<BenchResult> results;
+    bool ok = runWorkload(options, OWN_FACTORY, &infrastructure, results);
+    ok = runWorkload(options, SHARED_FACTORY, &infrastructure, results) && ok;
+    SnpeUdo_terminateImplLibrary();
+
+    if (!BenchCommon::writeResults(options, results, writeCsv, writeJson))
+    {
+        return 1;
+    }
+    return ok && !results.empty() ? 0 : 1;
+}
@@ -0,0 +1,398 @@
+//==============================================================================
+//
+// Copyright (c) 2020 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+// Benchmark of the fused Conv2dSelu op against a convolution followed by a Selu op, on
+// the first layer of model_script/selu_UDO_withconv2d/mnist.py and on common 3x3 stride
+// 1 layers, plus 5x5 and stride 2 layers that take the generic path. The unfused
+// convolution runs the same packed kernels without the fused Selu, split over the same
+// task scheduler, so the difference is what fusion saves: storing the pre-activation
+// values and running the Selu over them again. gmac_per_s is the fused throughput.
+//
+// usage: conv2d-selu-bench [--batches=1,8] [--threads=1,4] [--min-time-ms=200]
+//                          [--format=csv|json] [--output=file]
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchCommon.hpp"
+#include "SnpeUdo/UdoImpl.h"
+#include "SnpeUdo/UdoImplCpu.h"
+#include "utils/UdoArena.hpp"
+#include "utils/UdoConv.hpp"
+#include "utils/UdoUtil.hpp"
+#include "SeluKernelsCpu.hpp"
+#include "SeluParams.hpp"
+
+namespace {
+
+struct BenchLayerShape
+{
+    const char* name;
+    uint32_t height;
+    uint32_t width;
+    uint32_t channels;
+    uint32_t kernel;
+    uint32_t units;
+    uint32_t stride;
+    uint32_t pad;
+};
+
+struct BenchResult
+{
+    std::string layer;
+    std::string kernel;
+    uint32_t threads;
+    uint32_t batch;
+    uint64_t iterations;
+    double fusedNs;
+    double unfusedNs;
+    double gmacPerS;
+};
+
+struct BenchOptions : BenchCommon::BenchOptions
+{
+    std::vector<uint32_t> batches;
+    std::vector<uint32_t> threads;
+};
+
+const std::vector<BenchLayerShape>&
+getLayerShapes()
+{
+    static const std::vector<BenchLayerShape> shapes = {
+        // Conv2D(28, (3, 3)) of the MNIST model, "valid"
+        {"mnist_28x28x1_3x3x28",   28, 28, 1,   3, 28,  1, 0},
+        // "same" 3x3 layers of ResNet-like backbones
+        {"same_56x56x64_3x3x64",   56, 56, 64,  3, 64,  1, 1},
+        {"same_28x28x128_3x3x128", 28, 28, 128, 3, 128, 1, 1},
+        // generic path
+        {"same_28x28x32_5x5x32",   28, 28, 32,  5, 32,  1, 2},
+        {"s2_56x56x64_3x3x128",    56, 56, 64,  3, 128, 2, 1},
+    };
+    return shapes;
+}
+
+SnpeUdo_Param_t
+makeScalarParam(const char* name, uint32_t value)
+{
+    SnpeUdo_Param_t param;
+    std::memset(&param, 0, sizeof(param));
+    param.paramType = SNPE_UDO_PARAMTYPE_SCALAR;
+    param.paramName = const_cast<char*>(name);
+    param.scalarParam.dataType = SNPE_UDO_DATATYPE_UINT_32;
+    param.scalarParam.dataValue.uint32Value = value;
+    return param;
+}
+
+/**
+ * \brief One convolution with Selu on batch images, set up both as a Conv2dSelu op and
+ * as an unfused convolution followed by a Selu op on its output.
+ */
+class BenchLayer
+{
+public:
+    BenchLayer(const BenchLayerShape& shape, uint32_t batch, uint32_t threads,
+               SnpeUdo_CpuInfrastructure_t* infrastructure)
+        : m_Weights(shape.kernel * shape.kernel * shape.channels * shape.units)
+        , m_Bias(shape.units)
+        , m_WeightDims{shape.kernel, shape.kernel, shape.channels, shape.units}
+        , m_BiasDims{shape.units}
+        , m_InputDims{batch, shape.height, shape.width, shape.channels}
+        , m_OutputDims{batch, (shape.height + 2 * shape.pad - shape.kernel) / shape.stride + 1,
+                       (shape.width + 2 * shape.pad - shape.kernel) / shape.stride + 1, shape.units}
+    {
+        m_Input.resize(static_cast<size_t>(batch) * shape.height * shape.width * shape.channels);
+        m_Output.resize(static_cast<size_t>(batch) * m_OutputDims[1] * m_OutputDims[2] * shape.units);
+        m_Macs = static_cast<double>(m_Output.size()) * shape.kernel * shape.kernel * shape.channels;
+        for (size_t idx = 0; idx < m_Input.size(); idx++)
+        {
+            m_Input[idx] = static_cast<float>(idx * 2654435761u % 1001) / 1000.0f;
+        }
+        // small weights keep the activations in Selu's interesting range
+        const float weightScale = 1.0f / (1000.0f * static_cast<float>(shape.kernel * shape.kernel * shape.channels));
+        for (size_t idx = 0; idx < m_Weights.size(); idx++)
+        {
+            m_Weights[idx] = static_cast<float>(static_cast<int>(idx * 2654435761u % 2001) - 1000) * weightScale;
+        }
+        for (size_t idx = 0; idx < m_Bias.size(); idx++)
+        {
+            m_Bias[idx] = static_cast<float>(static_cast<int>(idx % 21) - 10) / 100.0f;
+        }
+
+        SnpeUdo_Param_t params[6];
+        std::memset(params, 0, sizeof(params));
+        params[0].paramType = SNPE_UDO_PARAMTYPE_TENSOR;
+        params[0].paramName = const_cast<char*>(CONV2D_SELU_WEIGHTS_PARAM);
+        params[0].tensorParam = BenchCommon::makeTensorParam(m_WeightDims, m_Weights.data());
+        params[1].paramType = SNPE_UDO_PARAMTYPE_TENSOR;
+        params[1].paramName = const_cast<char*>(CONV2D_SELU_BIAS_PARAM);
+        params[1].tensorParam = BenchCommon::makeTensorParam(m_BiasDims, m_Bias.data());
+        params[2] = makeScalarParam(CONV2D_SELU_STRIDE_H_PARAM, shape.stride);
+        params[3] = makeScalarParam(CONV2D_SELU_STRIDE_W_PARAM, shape.stride);
+        params[4] = makeScalarParam(CONV2D_SELU_PAD_TOP_PARAM, shape.pad);
+        params[5] = makeScalarParam(CONV2D_SELU_PAD_LEFT_PARAM, shape.pad);
+        m_InputParam = BenchCommon::makeTensorParam(m_InputDims, m_Input.data());
+        m_OutputParam = BenchCommon::makeTensorParam(m_OutputDims, m_Output.data());
+
+        if (SnpeUdo_createOpFactory(SNPE_UDO_CORETYPE_CPU, infrastructure, const_cast<char*>(CONV2D_SELU_OP_TYPE), 6,
+                                    params, &m_ConvFactory) != SNPE_UDO_NO_ERROR ||
+            SnpeUdo_createOperation(m_ConvFactory, nullptr, 1, &m_InputParam, 1, &m_OutputParam, &m_ConvOp) != SNPE_UDO_NO_ERROR)
+        {
+            return;
+        }
+        // the unfused Selu runs in place on the convolution output
+        if (SnpeUdo_createOpFactory(SNPE_UDO_CORETYPE_CPU, infrastructure, const_cast<char*>("Selu"), 0, nullptr,
+                                    &m_SeluFactory) != SNPE_UDO_NO_ERROR ||
+            SnpeUdo_createOperation(m_SeluFactory, nullptr, 1, &m_OutputParam, 1, &m_OutputParam, &m_SeluOp) != SNPE_UDO_NO_ERROR)
+        {
+            return;
+        }
+
+        const UdoUtil::ConvKernelSet& kernels = resolveSeluKernelTable().conv2dSelu;
+        const UdoUtil::ConvGeometry geometry = {shape.kernel, shape.kernel, shape.channels, shape.units,
+                                                shape.stride, shape.stride, shape.pad, shape.pad};
+        const size_t depth = UdoUtil::getConvDepth(geometry);
+        m_Linear = kernels.linear;
+        // aligned like the op's packed weights, so both passes load the same way
+        const size_t paddedUnits = UdoUtil::getDenseNumPanels(shape.units, kernels.panelWidth) * kernels.panelWidth;
+        m_PackedArena.reserve(sizeof(float) * paddedUnits * depth, UdoUtil::DENSE_PACK_ALIGNMENT);
+        m_PackedArena.reserve(sizeof(float) * paddedUnits, UdoUtil::DENSE_PACK_ALIGNMENT);
+        if (!m_PackedArena.commit())
+        {
+            return;
+        }
+        float* packedWeights = static_cast<float*>(m_PackedArena.allocate(sizeof(float) * paddedUnits * depth,
+                                                                          UdoUtil::DENSE_PACK_ALIGNMENT));
+        float* packedBias = static_cast<float*>(m_PackedArena.allocate(sizeof(float) * paddedUnits,
+                                                                       UdoUtil::DENSE_PACK_ALIGNMENT));
+        UdoUtil::packDenseWeights(m_Weights.data(), depth, shape.units, kernels.panelWidth, packedWeights);
+        UdoUtil::packDenseBias(m_Bias.data(), shape.units, kernels.panelWidth, packedBias);
+        m_Args = {m_Input.data(), m_Output.data(), packedWeights, packedBias, geometry,
+                  shape.height, shape.width, m_OutputDims[1], m_OutputDims[2], UdoUtil::SeluActivation::defaults()};
+        // the same tiling as the op with its default grain size, over-split 4 times per
+        // thread like UdoCpuOperation::getMaxTasks()
+        const size_t rows = static_cast<size_t>(batch) * m_OutputDims[1];
+        const size_t maxTasks = UdoUtil::limitDenseTasks(rows * m_OutputDims[2], depth, shape.units, 16384,
+                                                         threads > 1 ? threads * 4 : 1);
+        m_Tiling = UdoUtil::makeDenseTiling(rows, shape.units, kernels.panelWidth, maxTasks);
+        m_IsValid = true;
+    }
+
+    ~BenchLayer()
+    {
+        if (m_SeluOp != nullptr) { SnpeUdo_releaseOp(m_SeluOp); }
+        if (m_SeluFactory != nullptr) { SnpeUdo_releaseOpFactory(m_SeluFactory); }
+        if (m_ConvOp != nullptr) { SnpeUdo_releaseOp(m_ConvOp); }
+        if (m_ConvFactory != nullptr) { SnpeUdo_releaseOpFactory(m_ConvFactory); }
+    }
+
+    bool isValid() const { return m_IsValid; }
+
+    double getMacs() const { return m_Macs; }
+
+    bool runFused()
+    {
+        return SnpeUdo_executeOp(m_ConvOp, true, 0, nullptr) == SNPE_UDO_NO_ERROR;
+    }
+
+    bool runUnfused()
+    {
+        const UdoUtil::ConvKernelFn linear = m_Linear;
+        const UdoUtil::ConvKernelArgs& args = m_Args;
+        const UdoUtil::DenseTiling& tiling = m_Tiling;
+        UdoUtil::UdoTaskScheduler* scheduler = UdoUtil::getImplementationTaskScheduler();
+        const size_t numTasks = UdoUtil::getDenseNumTasks(tiling);
+        if (scheduler == nullptr || numTasks <= 1)
+        {
+            UdoUtil::runConvTask(linear, nullptr, args, tiling, 0);
+        }
+        else
+        {
+            scheduler->parallelFor(numTasks, [linear, &args, &tiling](size_t taskIdx)
+            {
+                UdoUtil::runConvTask(linear, nullptr, args, tiling, taskIdx);
+            });
+        }
+        return SnpeUdo_executeOp(m_SeluOp, true, 0, nullptr) == SNPE_UDO_NO_ERROR;
+    }
+
+private:
+    std::vector<float> m_Weights;
+    std::vector<float> m_Bias;
+    std::vector<float> m_Input;
+    std::vector<float> m_Output;
+    std::vector<uint32_t> m_WeightDims;
+    std::vector<uint32_t> m_BiasDims;
+    std::vector<uint32_t> m_InputDims;
+    std::vector<uint32_t> m_OutputDims;
+    SnpeUdo_TensorParam_t m_InputParam;
+    SnpeUdo_TensorParam_t m_OutputParam;
+    SnpeUdo_OpFactory_t m_ConvFactory = nullptr;
+    SnpeUdo_Operation_t m_ConvOp = nullptr;
+    SnpeUdo_OpFactory_t m_SeluFactory = nullptr;
+    SnpeUdo_Operation_t m_SeluOp = nullptr;
+    UdoUtil::ConvKernelFn m_Linear = nullptr;
+    UdoUtil::UdoArena m_PackedArena;
+    UdoUtil::ConvKernelArgs m_Args;
+    UdoUtil::DenseTiling m_Tiling;
+    double m_Macs = 0.0;
+    bool m_IsValid = false;
+};
+
+bool
+runBatch(const BenchOptions& options, uint32_t threads, uint32_t batch, SnpeUdo_CpuInfrastructure_t* infrastructure,
+         std::vector<BenchResult>& results)
+{
+    bool ok = true;
+    for (const BenchLayerShape& shape : getLayerShapes())
+    {
+        BenchLayer layer(shape, batch, threads, infrastructure);
+        if (!layer.isValid())
+        {
+            std::cerr << "ERROR: could not create " << shape.name << " for batch " << batch << std::endl;
+            return false;
+        }
+
+        BenchResult result;
+        result.layer = shape.name;
+        result.kernel = resolveSeluKernelTable().name;
+        result.threads = threads;
+        result.batch = batch;
+        result.iterations = 0;
+        result.fusedNs = std::numeric_limits<double>::max();
+        result.unfusedNs = std::numeric_limits<double>::max();
+        // alternating rounds see the same frequency and neighbour noise, the fastest
+        // round of each pass is reported
+        const uint32_t roundTimeMs = std::max<uint32_t>(1, options.minTimeMs / BenchCommon::BENCH_ROUNDS);
+        for (uint32_t round = 0; round < BenchCommon::BENCH_ROUNDS; round++)
+        {
+            uint64_t iterations = 0;
+            result.fusedNs = std::min(result.fusedNs, BenchCommon::timeCalls(roundTimeMs, iterations, [&]()
+            {
+                ok = layer.runFused() && ok;
+            }));
+            result.iterations += iterations;
+            result.unfusedNs = std::min(result.unfusedNs, BenchCommon::timeCalls(roundTimeMs, iterations, [&]()
+            {
+                ok = layer.runUnfused() && ok;
+            }));
+        }
+        result.gmacPerS = layer.getMacs() / result.fusedNs;
+        results.push_back(result);
+    }
+    if (!ok)
+    {
+        std::cerr << "ERROR: execute failed for batch " << batch << std::endl;
+    }
+    return ok;
+}
+
+void
+writeCsv(std::ostream& stream, const std::vector<BenchResult>& results)
+{
+    stream << "layer,kernel,threads,batch,iterations,fused_ns,unfused_ns,speedup,gmac_per_s\n";
+    for (const BenchResult& result : results)
+    {
+        stream << result.layer << ',' << result.kernel << ',' << result.threads << ',' << result.batch << ','
+               << result.iterations << ',' << result.fusedNs << ',' << result.unfusedNs << ','
+               << result.unfusedNs / result.fusedNs << ',' << result.gmacPerS << '\n';
+    }
+}
+
+void
+writeJson(std::ostream& stream, const std::vector<BenchResult>& results)
+{
+    stream << "[\n";
+    for (size_t idx = 0; idx < results.size(); idx++)
+    {
+        const BenchResult& result = results[idx];
+        stream << "  {\"layer\": \"" << result.layer << "\", \"kernel\": \"" << result.kernel
+               << "\", \"threads\": " << result.threads << ", \"batch\": " << result.batch
+               << ", \"iterations\": " << result.iterations << ", \"fused_ns\": " << result.fusedNs
+               << ", \"unfused_ns\": " << result.unfusedNs << ", \"speedup\": " << result.unfusedNs / result.fusedNs
+               << ", \"gmac_per_s\": " << result.gmacPerS << "}"
+               << (idx + 1 < results.size() ? ",\n" : "\n");
+    }
+    stream << "]\n";
+}
+
+bool
+parseOptions(int argc, char** argv, BenchOptions& options)
+{
+    for (int idx = 1; idx < argc; idx++)
+    {
+        std::string key, value;
+        BenchCommon::splitOption(argv[idx], key, value);
+        if (key == "--batches")
+        {
+            if (!BenchCommon::parseList(value, options.batches)) { return false; }
+        }
+        else if (key == "--threads")
+        {
+            if (!BenchCommon::parseList(value, options.threads)) { return false; }
+        }
+        else if (!BenchCommon::parseBenchOption(key, value, options))
+        {
+            return false;
+        }
+    }
+    if (options.batches.empty())
+    {
+        options.batches = {1, 8};
+    }
+    if (options.threads.empty())
+    {
+        BenchCommon::setDefaultThreads(options.threads);
+    }
+    return true;
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options))
+    {
+        std::cerr << "usage: " << argv[0]
+                  << " [--batches=1,8] [--threads=1,4] [--min-time-ms=200] [--format=csv|json] [--output=file]"
+                  << std::endl;
+        return 1;
+    }
+
+    SnpeUdo_CpuInfrastructure_t infrastructure;
+    infrastructure.getData = BenchCommon::getData;
+
+    std::vector<BenchResult> results;
+    for (uint32_t threads : options.threads)
+    {
+        // the thread count is fixed when the library creates its scheduler
+        if (SnpeUdo_initImplLibrary(nullptr) != SNPE_UDO_NO_ERROR ||
+            UdoUtil::getImplementation().setNumThreads(threads) != SNPE_UDO_NO_ERROR)
+        {
+            return 1;
+        }
+        for (uint32_t batch : options.batches)
+        {
+            runBatch(options, threads, batch, &infrastructure, results);
+        }
+        SnpeUdo_terminateImplLibrary();
+    }
+
+    if (!BenchCommon::writeResults(options, results, writeCsv, writeJson))
+    {
+        return 1;
+    }
+    return results.empty() ? 1 : 0;
+}
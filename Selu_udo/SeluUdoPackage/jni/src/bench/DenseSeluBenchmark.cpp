@@ -0,0 +1,423 @@
+//==============================================================================
+//
+// Copyright (c) 2020 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+// Benchmark of the fused DenseSelu op against a Dense layer followed by a Selu op, on
+// the two dense layers of model_script/selu_UDO_withconv2d/mnist.py and on both of them
+// chained. The unfused Dense runs the same packed kernels without the fused Selu, split
+// over the same task scheduler, so the difference is what fusion saves: storing the
+// pre-activation values and running the Selu over them again. The reference pass is a
+// plain FullyConnected, a loop over the row major weights as given split over batch
+// rows, that stores its output for the Selu op, like a graph of two ops without a
+// packed kernel.
+//
+// usage: dense-selu-bench [--batches=1,32] [--threads=1,4] [--min-time-ms=200]
+//                         [--format=csv|json] [--output=file]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchCommon.hpp"
+#include "SnpeUdo/UdoImpl.h"
+#include "SnpeUdo/UdoImplCpu.h"
+#include "utils/UdoArena.hpp"
+#include "utils/UdoDense.hpp"
+#include "utils/UdoUtil.hpp"
+#include "SeluKernelsCpu.hpp"
+#include "SeluParams.hpp"
+
+namespace {
+
+struct BenchLayerShape
+{
+    const char* name;
+    size_t depth;
+    size_t units;
+};
+
+struct BenchResult
+{
+    std::string layer;
+    std::string kernel;
+    uint32_t threads;
+    uint32_t batch;
+    uint64_t iterations;
+    double fusedNs;
+    double unfusedNs;
+    double referenceNs;
+};
+
+struct BenchOptions : BenchCommon::BenchOptions
+{
+    std::vector<uint32_t> batches;
+    std::vector<uint32_t> threads;
+};
+
+const std::vector<BenchLayerShape>&
+getLayerShapes()
+{
+    // Flatten of the 13x13x28 pooled conv output into Dense(128), then Dense(10)
+    static const std::vector<BenchLayerShape> shapes = {
+        {"dense_4732x128", 4732, 128},
+        {"output_128x10",  128,  10},
+    };
+    return shapes;
+}
+
+/**
+ * \brief One dense layer with Selu on batch rows, set up both as a DenseSelu op and
+ * as an unfused Dense pass followed by a Selu op on its output.
+ */
+class BenchLayer
+{
+public:
+    BenchLayer(const BenchLayerShape& shape, uint32_t batch, uint32_t threads, const float* input,
+               SnpeUdo_CpuInfrastructure_t* infrastructure)
+        : m_Batch(batch)
+        , m_Depth(shape.depth)
+        , m_Units(shape.units)
+        , m_InputData(input)
+        , m_Weights(shape.depth * shape.units)
+        , m_Bias(shape.units)
+        , m_Output(batch * shape.units)
+        , m_WeightDims{static_cast<uint32_t>(shape.depth), static_cast<uint32_t>(shape.units)}
+        , m_BiasDims{static_cast<uint32_t>(shape.units)}
+        , m_InputDims{batch, static_cast<uint32_t>(shape.depth)}
+        , m_OutputDims{batch, static_cast<uint32_t>(shape.units)}
+    {
+        // small weights keep the activations in Selu's interesting range
+        for (size_t idx = 0; idx < m_Weights.size(); idx++)
+        {
+            m_Weights[idx] = static_cast<float>(static_cast<int>(idx * 2654435761u % 2001) - 1000) / (1000.0f * std::sqrt(float(m_Depth)));
+        }
+        for (size_t idx = 0; idx < m_Bias.size(); idx++)
+        {
+            m_Bias[idx] = static_cast<float>(static_cast<int>(idx % 21) - 10) / 100.0f;
+        }
+
+        SnpeUdo_Param_t params[2];
+        std::memset(params, 0, sizeof(params));
+        params[0].paramType = SNPE_UDO_PARAMTYPE_TENSOR;
+        params[0].paramName = const_cast<char*>(DENSE_SELU_WEIGHTS_PARAM);
+        params[0].tensorParam = BenchCommon::makeTensorParam(m_WeightDims, m_Weights.data());
+        params[1].paramType = SNPE_UDO_PARAMTYPE_TENSOR;
+        params[1].paramName = const_cast<char*>(DENSE_SELU_BIAS_PARAM);
+        params[1].tensorParam = BenchCommon::makeTensorParam(m_BiasDims, m_Bias.data());
+        m_Input = BenchCommon::makeTensorParam(m_InputDims, const_cast<float*>(input));
+        m_OutputParam = BenchCommon::makeTensorParam(m_OutputDims, m_Output.data());
+
+        if (SnpeUdo_createOpFactory(SNPE_UDO_CORETYPE_CPU, infrastructure, const_cast<char*>(DENSE_SELU_OP_TYPE), 2,
+                                    params, &m_DenseFactory) != SNPE_UDO_NO_ERROR ||
+            SnpeUdo_createOperation(m_DenseFactory, nullptr, 1, &m_Input, 1, &m_OutputParam, &m_DenseOp) != SNPE_UDO_NO_ERROR)
+        {
+            return;
+        }
+        // the unfused Selu runs in place on the Dense output
+        if (SnpeUdo_createOpFactory(SNPE_UDO_CORETYPE_CPU, infrastructure, const_cast<char*>("Selu"), 0, nullptr,
+                                    &m_SeluFactory) != SNPE_UDO_NO_ERROR ||
+            SnpeUdo_createOperation(m_SeluFactory, nullptr, 1, &m_OutputParam, 1, &m_OutputParam, &m_SeluOp) != SNPE_UDO_NO_ERROR)
+        {
+            return;
+        }
+
+        const UdoUtil::DenseKernelSet& kernels = resolveSeluKernelTable().denseSelu;
+        m_Linear = kernels.linear;
+        // aligned like the op's packed weights, so both passes load the same way
+        const size_t paddedUnits = UdoUtil::getDenseNumPanels(m_Units, kernels.panelWidth) * kernels.panelWidth;
+        m_PackedArena.reserve(sizeof(float) * paddedUnits * m_Depth, UdoUtil::DENSE_PACK_ALIGNMENT);
+        m_PackedArena.reserve(sizeof(float) * paddedUnits, UdoUtil::DENSE_PACK_ALIGNMENT);
+        if (!m_PackedArena.commit())
+        {
+            return;
+        }
+        float* packedWeights = static_cast<float*>(m_PackedArena.allocate(sizeof(float) * paddedUnits * m_Depth,
+                                                                          UdoUtil::DENSE_PACK_ALIGNMENT));
+        float* packedBias = static_cast<float*>(m_PackedArena.allocate(sizeof(float) * paddedUnits,
+                                                                       UdoUtil::DENSE_PACK_ALIGNMENT));
+        UdoUtil::packDenseWeights(m_Weights.data(), m_Depth, m_Units, kernels.panelWidth, packedWeights);
+        UdoUtil::packDenseBias(m_Bias.data(), m_Units, kernels.panelWidth, packedBias);
+        m_Args = {input, m_Output.data(), packedWeights, packedBias, batch, m_Depth, m_Units,
+                  UdoUtil::SeluActivation::defaults()};
+        // the same tiling as the op with its default grain size
+        const size_t maxTasks = UdoUtil::limitDenseTasks(batch, m_Depth, m_Units, 16384, threads);
+        m_Tiling = UdoUtil::makeDenseTiling(batch, m_Units, kernels.panelWidth, maxTasks);
+        m_IsValid = true;
+    }
+
+    ~BenchLayer()
+    {
+        if (m_SeluOp != nullptr) { SnpeUdo_releaseOp(m_SeluOp); }
+        if (m_SeluFactory != nullptr) { SnpeUdo_releaseOpFactory(m_SeluFactory); }
+        if (m_DenseOp != nullptr) { SnpeUdo_releaseOp(m_DenseOp); }
+        if (m_DenseFactory != nullptr) { SnpeUdo_releaseOpFactory(m_DenseFactory); }
+    }
+
+    bool isValid() const { return m_IsValid; }
+
+    const float* getOutput() const { return m_Output.data(); }
+
+    bool runFused()
+    {
+        return SnpeUdo_executeOp(m_DenseOp, true, 0, nullptr) == SNPE_UDO_NO_ERROR;
+    }
+
+    bool runUnfused()
+    {
+        const UdoUtil::DenseKernelFn linear = m_Linear;
+        const UdoUtil::DenseKernelArgs& args = m_Args;
+        const UdoUtil::DenseTiling& tiling = m_Tiling;
+        UdoUtil::UdoTaskScheduler* scheduler = UdoUtil::getImplementationTaskScheduler();
+        const size_t numTasks = UdoUtil::getDenseNumTasks(tiling);
+        if (scheduler == nullptr || numTasks <= 1)
+        {
+            UdoUtil::runDenseTask(linear, nullptr, args, tiling, 0);
+        }
+        else
+        {
+            scheduler->parallelFor(numTasks, [linear, &args, &tiling](size_t taskIdx)
+            {
+                UdoUtil::runDenseTask(linear, nullptr, args, tiling, taskIdx);
+            });
+        }
+        return SnpeUdo_executeOp(m_SeluOp, true, 0, nullptr) == SNPE_UDO_NO_ERROR;
+    }
+
+    bool runReference()
+    {
+        UdoUtil::UdoTaskScheduler* scheduler = UdoUtil::getImplementationTaskScheduler();
+        if (scheduler == nullptr || m_Batch <= 1)
+        {
+            for (size_t row = 0; row < m_Batch; row++)
+            {
+                runReferenceRow(row);
+            }
+        }
+        else
+        {
+            scheduler->parallelFor(m_Batch, [this](size_t row) { runReferenceRow(row); });
+        }
+        return SnpeUdo_executeOp(m_SeluOp, true, 0, nullptr) == SNPE_UDO_NO_ERROR;
+    }
+
+private:
+    void runReferenceRow(size_t row)
+    {
+        const float* in = m_InputData + row * m_Depth;
+        float* out = m_Output.data() + row * m_Units;
+        std::memcpy(out, m_Bias.data(), sizeof(float) * m_Units);
+        for (size_t depth = 0; depth < m_Depth; depth++)
+        {
+            const float value = in[depth];
+            const float* weights = m_Weights.data() + depth * m_Units;
+            for (size_t unit = 0; unit < m_Units; unit++)
+            {
+                out[unit] += value * weights[unit];
+            }
+        }
+    }
+
+    size_t m_Batch;
+    size_t m_Depth;
+    size_t m_Units;
+    const float* m_InputData;
+    std::vector<float> m_Weights;
+    std::vector<float> m_Bias;
+    std::vector<float> m_Output;
+    std::vector<uint32_t> m_WeightDims;
+    std::vector<uint32_t> m_BiasDims;
+    std::vector<uint32_t> m_InputDims;
+    std::vector<uint32_t> m_OutputDims;
+    SnpeUdo_TensorParam_t m_Input;
+    SnpeUdo_TensorParam_t m_OutputParam;
+    SnpeUdo_OpFactory_t m_DenseFactory = nullptr;
+    SnpeUdo_Operation_t m_DenseOp = nullptr;
+    SnpeUdo_OpFactory_t m_SeluFactory = nullptr;
+    SnpeUdo_Operation_t m_SeluOp = nullptr;
+    UdoUtil::DenseKernelFn m_Linear = nullptr;
+    UdoUtil::UdoArena m_PackedArena;
+    UdoUtil::DenseKernelArgs m_Args;
+    UdoUtil::DenseTiling m_Tiling;
+    bool m_IsValid = false;
+};
+
+bool
+runBatch(const BenchOptions& options, uint32_t threads, uint32_t batch, SnpeUdo_CpuInfrastructure_t* infrastructure,
+         std::vector<BenchResult>& results)
+{
+    const std::vector<BenchLayerShape>& shapes = getLayerShapes();
+    std::vector<float> input(batch * shapes.front().depth);
+    for (size_t idx = 0; idx < input.size(); idx++)
+    {
+        input[idx] = static_cast<float>(idx * 2654435761u % 1001) / 1000.0f;
+    }
+
+    // each layer reads the output of the one before, like the model's head
+    std::vector<std::unique_ptr<BenchLayer>> layers;
+    const float* layerInput = input.data();
+    for (const BenchLayerShape& shape : shapes)
+    {
+        layers.emplace_back(new BenchLayer(shape, batch, threads, layerInput, infrastructure));
+        if (!layers.back()->isValid())
+        {
+            std::cerr << "ERROR: could not create " << shape.name << " for batch " << batch << std::endl;
+            return false;
+        }
+        layerInput = layers.back()->getOutput();
+    }
+
+    bool ok = true;
+    for (size_t idx = 0; idx <= layers.size(); idx++)
+    {
+        // the last row times every layer in turn
+        const size_t first = idx < layers.size() ? idx : 0;
+        const size_t last = idx < layers.size() ? idx + 1 : layers.size();
+        BenchResult result;
+        result.layer = idx < layers.size() ? shapes[idx].name : "head";
+        result.kernel = resolveSeluKernelTable().name;
+        result.threads = threads;
+        result.batch = batch;
+        result.iterations = 0;
+        result.fusedNs = std::numeric_limits<double>::max();
+        result.unfusedNs = std::numeric_limits<double>::max();
+        result.referenceNs = std::numeric_limits<double>::max();
+        // alternating rounds see the same frequency and neighbour noise, the fastest
+        // round of each pass is reported
+        const uint32_t roundTimeMs = std::max<uint32_t>(1, options.minTimeMs / BenchCommon::BENCH_ROUNDS);
+        for (uint32_t round = 0; round < BenchCommon::BENCH_ROUNDS; round++)
+        {
+            uint64_t iterations = 0;
+            result.fusedNs = std::min(result.fusedNs, BenchCommon::timeCalls(roundTimeMs, iterations, [&]()
+            {
+                for (size_t layer = first; layer < last; layer++) { ok = layers[layer]->runFused() && ok; }
+            }));
+            result.iterations += iterations;
+            result.unfusedNs = std::min(result.unfusedNs, BenchCommon::timeCalls(roundTimeMs, iterations, [&]()
+            {
+                for (size_t layer = first; layer < last; layer++) { ok = layers[layer]->runUnfused() && ok; }
+            }));
+            result.referenceNs = std::min(result.referenceNs, BenchCommon::timeCalls(roundTimeMs, iterations, [&]()
+            {
+                for (size_t layer = first; layer < last; layer++) { ok = layers[layer]->runReference() && ok; }
+            }));
+        }
+        results.push_back(result);
+    }
+    if (!ok)
+    {
+        std::cerr << "ERROR: execute failed for batch " << batch << std::endl;
+    }
+    return ok;
+}
+
+void
+writeCsv(std::ostream& stream, const std::vector<BenchResult>& results)
+{
+    stream << "layer,kernel,threads,batch,iterations,fused_ns,unfused_ns,speedup,reference_ns,reference_speedup\n";
+    for (const BenchResult& result : results)
+    {
+        stream << result.layer << ',' << result.kernel << ',' << result.threads << ',' << result.batch << ','
+               << result.iterations << ',' << result.fusedNs << ',' << result.unfusedNs << ','
+               << result.unfusedNs / result.fusedNs << ',' << result.referenceNs << ','
+               << result.referenceNs / result.fusedNs << '\n';
+    }
+}
+
+void
+writeJson(std::ostream& stream, const std::vector<BenchResult>& results)
+{
+    stream << "[\n";
+    for (size_t idx = 0; idx < results.size(); idx++)
+    {
+        const BenchResult& result = results[idx];
+        stream << "  {\"layer\": \"" << result.layer << "\", \"kernel\": \"" << result.kernel
+               << "\", \"threads\": " << result.threads << ", \"batch\": " << result.batch
+               << ", \"iterations\": " << result.iterations << ", \"fused_ns\": " << result.fusedNs
+               << ", \"unfused_ns\": " << result.unfusedNs << ", \"speedup\": " << result.unfusedNs / result.fusedNs
+               << ", \"reference_ns\": " << result.referenceNs
+               << ", \"reference_speedup\": " << result.referenceNs / result.fusedNs << "}"
+               << (idx + 1 < results.size() ? ",\n" : "\n");
+    }
+    stream << "]\n";
+}
+
+bool
+parseOptions(int argc, char** argv, BenchOptions& options)
+{
+    for (int idx = 1; idx < argc; idx++)
+    {
+        std::string key, value;
+        BenchCommon::splitOption(argv[idx], key, value);
+        if (key == "--batches")
+        {
+            if (!BenchCommon::parseList(value, options.batches)) { return false; }
+        }
+        else if (key == "--threads")
+        {
+            if (!BenchCommon::parseList(value, options.threads)) { return false; }
+        }
+        else if (!BenchCommon::parseBenchOption(key, value, options))
+        {
+            return false;
+        }
+    }
+    if (options.batches.empty())
+    {
+        options.batches = {1, 32};
+    }
+    if (options.threads.empty())
+    {
+        BenchCommon::setDefaultThreads(options.threads);
+    }
+    return true;
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options))
+    {
+        std::cerr << "usage: " << argv[0]
+                  << " [--batches=1,32] [--threads=1,4] [--min-time-ms=200] [--format=csv|json] [--output=file]"
+                  << std::endl;
+        return 1;
+    }
+
+    SnpeUdo_CpuInfrastructure_t infrastructure;
+    infrastructure.getData = BenchCommon::getData;
+
+    std::vector<BenchResult> results;
+    for (uint32_t threads : options.threads)
+    {
+        // the thread count is fixed when the library creates its scheduler
+        if (SnpeUdo_initImplLibrary(nullptr) != SNPE_UDO_NO_ERROR ||
+            UdoUtil::getImplementation().setNumThreads(threads) != SNPE_UDO_NO_ERROR)
+        {
+            return 1;
+        }
+        for (uint32_t batch : options.batches)
+        {
+            runBatch(options, threads, batch, &infrastructure, results);
+        }
+        SnpeUdo_terminateImplLibrary();
+    }
+
+    if (!BenchCommon::writeResults(options, results, writeCsv, writeJson))
+    {
+        return 1;
+    }
+    return results.empty() ? 1 : 0;
+}
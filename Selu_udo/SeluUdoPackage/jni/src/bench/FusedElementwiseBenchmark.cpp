@@ -0,0 +1,321 @@
+//==============================================================================
+//
+// Copyright (c) 2020 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+// Benchmark of FusedElementwise ops against the same chains of scale, bias, activation
+// and clamp run as one op per step. The first step of a chain reads the input and the
+// others run in place on the output, as a graph of separate elementwise ops does, so
+// the difference is what fusion saves: a pass over the tensor for every step but one.
+//
+// usage: fused-elementwise-bench [--sizes=4096,262144,4194304] [--threads=1,4]
+//                                [--min-time-ms=200] [--format=csv|json] [--output=file]
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchCommon.hpp"
+#include "SnpeUdo/UdoImpl.h"
+#include "SnpeUdo/UdoImplCpu.h"
+#include "utils/UdoUtil.hpp"
+#include "SeluKernelsCpu.hpp"
+#include "SeluParams.hpp"
+
+namespace {
+
+constexpr size_t BENCH_MAX_STEPS = 3;
+
+struct BenchChain
+{
+    const char* name;
+    const char* fused;
+    const char* steps[BENCH_MAX_STEPS];
+};
+
+struct BenchResult
+{
+    std::string chain;
+    std::string kernel;
+    uint32_t threads;
+    uint32_t size;
+    uint64_t iterations;
+    double fusedNs;
+    double unfusedNs;
+};
+
+struct BenchOptions : BenchCommon::BenchOptions
+{
+    std::vector<uint32_t> sizes;
+    std::vector<uint32_t> threads;
+};
+
+const std::vector<BenchChain>&
+getChains()
+{
+    // a = 1.5 and b = -0.25 for every op
+    static const std::vector<BenchChain> chains = {
+        {"scale_bias_selu",       "selu(x * a + b)",                 {"x * a + b", "selu(x)", nullptr}},
+        {"scale_bias_selu_clamp", "clamp(selu(x * a + b), -1, 1)",   {"x * a + b", "selu(x)", "clamp(x, -1, 1)"}},
+        {"hardswish_scale_bias",  "hardswish(x) * a + b",            {"hardswish(x)", "x * a + b", nullptr}},
+    };
+    return chains;
+}
+
+/**
+ * \brief Creates a FusedElementwise factory and op of expression from input to output.
+ */
+bool
+createExpressionOp(const char* expression, SnpeUdo_TensorParam_t* input, SnpeUdo_TensorParam_t* output,
+                   SnpeUdo_CpuInfrastructure_t* infrastructure, SnpeUdo_OpFactory_t& factory,
+                   SnpeUdo_Operation_t& op)
+{
+    SnpeUdo_Param_t params[3];
+    std::memset(params, 0, sizeof(params));
+    params[0].paramType = SNPE_UDO_PARAMTYPE_STRING;
+    params[0].paramName = const_cast<char*>(FUSED_ELEMENTWISE_EXPRESSION_PARAM);
+    params[0].stringParam = const_cast<char*>(expression);
+    params[1].paramType = SNPE_UDO_PARAMTYPE_SCALAR;
+    params[1].paramName = const_cast<char*>("a");
+    params[1].scalarParam.dataType = SNPE_UDO_DATATYPE_FLOAT_32;
+    params[1].scalarParam.dataValue.floatValue = 1.5f;
+    params[2].paramType = SNPE_UDO_PARAMTYPE_SCALAR;
+    params[2].paramName = const_cast<char*>("b");
+    params[2].scalarParam.dataType = SNPE_UDO_DATATYPE_FLOAT_32;
+    params[2].scalarParam.dataValue.floatValue = -0.25f;
+    return SnpeUdo_createOpFactory(SNPE_UDO_CORETYPE_CPU, infrastructure, const_cast<char*>(FUSED_ELEMENTWISE_OP_TYPE),
+                                   3, params, &factory) == SNPE_UDO_NO_ERROR &&
+           SnpeUdo_createOperation(factory, nullptr, 1, input, 1, output, &op) == SNPE_UDO_NO_ERROR;
+}
+
+/**
+ * \brief One chain on a tensor of size elements, set up both as a single fused op and
+ * as one op per step.
+ */
+class BenchChainOps
+{
+public:
+    BenchChainOps(const BenchChain& chain, uint32_t size, const float* input,
+                  SnpeUdo_CpuInfrastructure_t* infrastructure)
+        : m_Output(size)
+        , m_Dims{size}
+    {
+        m_Input = BenchCommon::makeTensorParam(m_Dims, const_cast<float*>(input));
+        m_OutputParam = BenchCommon::makeTensorParam(m_Dims, m_Output.data());
+        if (!createExpressionOp(chain.fused, &m_Input, &m_OutputParam, infrastructure, m_FusedFactory, m_FusedOp))
+        {
+            return;
+        }
+        for (size_t step = 0; step < BENCH_MAX_STEPS && chain.steps[step] != nullptr; step++)
+        {
+            SnpeUdo_TensorParam_t* stepInput = step == 0 ? &m_Input : &m_OutputParam;
+            if (!createExpressionOp(chain.steps[step], stepInput, &m_OutputParam, infrastructure,
+                                    m_StepFactories[step], m_StepOps[step]))
+            {
+                return;
+            }
+            m_NumSteps++;
+        }
+        m_IsValid = true;
+    }
+
+    ~BenchChainOps()
+    {
+        for (size_t step = 0; step < BENCH_MAX_STEPS; step++)
+        {
+            if (m_StepOps[step] != nullptr) { SnpeUdo_releaseOp(m_StepOps[step]); }
+            if (m_StepFactories[step] != nullptr) { SnpeUdo_releaseOpFactory(m_StepFactories[step]); }
+        }
+        if (m_FusedOp != nullptr) { SnpeUdo_releaseOp(m_FusedOp); }
+        if (m_FusedFactory != nullptr) { SnpeUdo_releaseOpFactory(m_FusedFactory); }
+    }
+
+    bool isValid() const { return m_IsValid; }
+
+    bool runFused()
+    {
+        return SnpeUdo_executeOp(m_FusedOp, true, 0, nullptr) == SNPE_UDO_NO_ERROR;
+    }
+
+    bool runUnfused()
+    {
+        bool ok = true;
+        for (size_t step = 0; step < m_NumSteps; step++)
+        {
+            ok = SnpeUdo_executeOp(m_StepOps[step], true, 0, nullptr) == SNPE_UDO_NO_ERROR && ok;
+        }
+        return ok;
+    }
+
+private:
+    std::vector<float> m_Output;
+    std::vector<uint32_t> m_Dims;
+    SnpeUdo_TensorParam_t m_Input;
+    SnpeUdo_TensorParam_t m_OutputParam;
+    SnpeUdo_OpFactory_t m_FusedFactory = nullptr;
+    SnpeUdo_Operation_t m_FusedOp = nullptr;
+    SnpeUdo_OpFactory_t m_StepFactories[BENCH_MAX_STEPS] = {};
+    SnpeUdo_Operation_t m_StepOps[BENCH_MAX_STEPS] = {};
+    size_t m_NumSteps = 0;
+    bool m_IsValid = false;
+};
+
+bool
+runSize(const BenchOptions& options, uint32_t threads, uint32_t size, SnpeUdo_CpuInfrastructure_t* infrastructure,
+        std::vector<BenchResult>& results)
+{
+    std::vector<float> input(size);
+    for (size_t idx = 0; idx < input.size(); idx++)
+    {
+        input[idx] = static_cast<float>(static_cast<int>(idx * 2654435761u % 2001) - 1000) / 250.0f;
+    }
+
+    bool ok = true;
+    for (const BenchChain& chain : getChains())
+    {
+        BenchChainOps ops(chain, size, input.data(), infrastructure);
+        if (!ops.isValid())
+        {
+            std::cerr << "ERROR: could not create " << chain.name << " for size " << size << std::endl;
+            return false;
+        }
+        BenchResult result;
+        result.chain = chain.name;
+        result.kernel = resolveSeluKernelTable().name;
+        result.threads = threads;
+        result.size = size;
+        result.iterations = 0;
+        result.fusedNs = std::numeric_limits<double>::max();
+        result.unfusedNs = std::numeric_limits<double>::max();
+        // alternating rounds see the same frequency and neighbour noise, the fastest
+        // round of each pass is reported
+        const uint32_t roundTimeMs = std::max<uint32_t>(1, options.minTimeMs / BenchCommon::BENCH_ROUNDS);
+        for (uint32_t round = 0; round < BenchCommon::BENCH_ROUNDS; round++)
+        {
+            uint64_t iterations = 0;
+            result.fusedNs = std::min(result.fusedNs, BenchCommon::timeCalls(roundTimeMs, iterations, [&]()
+            {
+                ok = ops.runFused() && ok;
+            }));
+            result.iterations += iterations;
+            result.unfusedNs = std::min(result.unfusedNs, BenchCommon::timeCalls(roundTimeMs, iterations, [&]()
+            {
+                ok = ops.runUnfused() && ok;
+            }));
+        }
+        results.push_back(result);
+    }
+    if (!ok)
+    {
+        std::cerr << "ERROR: execute failed for size " << size << std::endl;
+    }
+    return ok;
+}
+
+void
+writeCsv(std::ostream& stream, const std::vector<BenchResult>& results)
+{
+    stream << "chain,kernel,threads,size,iterations,fused_ns,unfused_ns,speedup\n";
+    for (const BenchResult& result : results)
+    {
+        stream << result.chain << ',' << result.kernel << ',' << result.threads << ',' << result.size << ','
+               << result.iterations << ',' << result.fusedNs << ',' << result.unfusedNs << ','
+               << result.unfusedNs / result.fusedNs << '\n';
+    }
+}
+
+void
+writeJson(std::ostream& stream, const std::vector<BenchResult>& results)
+{
+    stream << "[\n";
+    for (size_t idx = 0; idx < results.size(); idx++)
+    {
+        const BenchResult& result = results[idx];
+        stream << "  {\"chain\": \"" << result.chain << "\", \"kernel\": \"" << result.kernel
+               << "\", \"threads\": " << result.threads << ", \"size\": " << result.size
+               << ", \"iterations\": " << result.iterations << ", \"fused_ns\": " << result.fusedNs
+               << ", \"unfused_ns\": " << result.unfusedNs << ", \"speedup\": " << result.unfusedNs / result.fusedNs << "}"
+               << (idx + 1 < results.size() ? ",\n" : "\n");
+    }
+    stream << "]\n";
+}
+
+bool
+parseOptions(int argc, char** argv, BenchOptions& options)
+{
+    for (int idx = 1; idx < argc; idx++)
+    {
+        std::string key, value;
+        BenchCommon::splitOption(argv[idx], key, value);
+        if (key == "--sizes")
+        {
+            if (!BenchCommon::parseList(value, options.sizes)) { return false; }
+        }
+        else if (key == "--threads")
+        {
+            if (!BenchCommon::parseList(value, options.threads)) { return false; }
+        }
+        else if (!BenchCommon::parseBenchOption(key, value, options))
+        {
+            return false;
+        }
+    }
+    if (options.sizes.empty())
+    {
+        // L1, L2 and DRAM sized tensors
+        options.sizes = {4096, 262144, 4194304};
+    }
+    if (options.threads.empty())
+    {
+        BenchCommon::setDefaultThreads(options.threads);
+    }
+    return true;
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options))
+    {
+        std::cerr << "usage: " << argv[0]
+                  << " [--sizes=4096,262144,4194304] [--threads=1,4] [--min-time-ms=200] [--format=csv|json]"
+                  << " [--output=file]" << std::endl;
+        return 1;
+    }
+
+    SnpeUdo_CpuInfrastructure_t infrastructure;
+    infrastructure.getData = BenchCommon::getData;
+
+    std::vector<BenchResult> results;
+    for (uint32_t threads : options.threads)
+    {
+        // the thread count is fixed when the library creates its scheduler
+        if (SnpeUdo_initImplLibrary(nullptr) != SNPE_UDO_NO_ERROR ||
+            UdoUtil::getImplementation().setNumThreads(threads) != SNPE_UDO_NO_ERROR)
+        {
+            return 1;
+        }
+        for (uint32_t size : options.sizes)
+        {
+            runSize(options, threads, size, &infrastructure, results);
+        }
+        SnpeUdo_terminateImplLibrary();
+    }
+
+    if (!BenchCommon::writeResults(options, results, writeCsv, writeJson))
+    {
+        return 1;
+    }
+    return results.empty() ? 1 : 0;
+}
@@ -0,0 +1,344 @@
+//==============================================================================
+//
+// Copyright (c) 2020 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+// Benchmark of SnpeUdo_createOperation / SnpeUdo_releaseOp churn, with and without the
+// per-factory pool of released operations. Each cycle creates --live ops of one factory
+// and releases them again, like a runtime rebuilding a network between inputs. The
+// layers are those of model_script/selu_UDO_withconv2d/mnist.py plus a Selu and a
+// FusedElementwise op on the same tensors.
+//
+// usage: op-churn-bench [--live=1,8] [--min-time-ms=200] [--format=csv|json] [--output=file]
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "BenchCommon.hpp"
+#include "SnpeUdo/UdoImpl.h"
+#include "SnpeUdo/UdoImplCpu.h"
+#include "utils/UdoUtil.hpp"
+#include "SeluParams.hpp"
+
+namespace {
+
+struct BenchResult
+{
+    std::string op;
+    uint32_t live;
+    uint64_t iterations;
+    double unpooledNs;
+    double pooledNs;
+    uint64_t reused;
+};
+
+struct BenchOptions : BenchCommon::BenchOptions
+{
+    std::vector<uint32_t> live;
+};
+
+SnpeUdo_Param_t
+makeTensorStaticParam(const char* name, std::vector<uint32_t>& dims, float* data)
+{
+    SnpeUdo_Param_t param;
+    std::memset(&param, 0, sizeof(param));
+    param.paramType = SNPE_UDO_PARAMTYPE_TENSOR;
+    param.paramName = const_cast<char*>(name);
+    param.tensorParam = BenchCommon::makeTensorParam(dims, data);
+    return param;
+}
+
+/**
+ * \brief The static params and tensors of one op, and its factory.
+ */
+class BenchOp
+{
+public:
+    BenchOp(const std::string& name, const char* operationType, std::vector<uint32_t>&& inputDims,
+            std::vector<uint32_t>&& outputDims)
+        : m_Name(name)
+        , m_OperationType(operationType)
+        , m_InputDims(std::move(inputDims))
+        , m_OutputDims(std::move(outputDims))
+    {
+        m_Input.resize(getNumElements(m_InputDims));
+        m_Output.resize(getNumElements(m_OutputDims));
+        for (size_t idx = 0; idx < m_Input.size(); idx++)
+        {
+            m_Input[idx] = static_cast<float>(idx * 2654435761u % 1001) / 1000.0f;
+        }
+        m_InputParam = BenchCommon::makeTensorParam(m_InputDims, m_Input.data());
+        m_OutputParam = BenchCommon::makeTensorParam(m_OutputDims, m_Output.data());
+    }
+
+    ~BenchOp()
+    {
+        if (m_Factory != nullptr) { SnpeUdo_releaseOpFactory(m_Factory); }
+    }
+
+    BenchOp(const BenchOp&) = delete;
+    BenchOp& operator=(const BenchOp&) = delete;
+
+    const std::string& getName() const { return m_Name; }
+
+    /**
+     * \brief Adds a tensor param, whose dims and data the op keeps.
+     */
+    void addTensorParam(const char* name, std::vector<uint32_t>&& dims)
+    {
+        m_ParamDims.emplace_back(new std::vector<uint32_t>(std::move(dims)));
+        m_ParamData.emplace_back(new std::vector<float>(getNumElements(*m_ParamDims.back())));
+        std::vector<float>& data = *m_ParamData.back();
+        for (size_t idx = 0; idx < data.size(); idx++)
+        {
+            data[idx] = static_cast<float>(static_cast<int>(idx * 2654435761u % 2001) - 1000) / 100000.0f;
+        }
+        m_Params.push_back(makeTensorStaticParam(name, *m_ParamDims.back(), data.data()));
+    }
+
+    void addParam(const SnpeUdo_Param_t& param) { m_Params.push_back(param); }
+
+    bool createFactory(SnpeUdo_CpuInfrastructure_t* infrastructure)
+    {
+        return SnpeUdo_createOpFactory(SNPE_UDO_CORETYPE_CPU, infrastructure, const_cast<char*>(m_OperationType),
+                                       static_cast<uint32_t>(m_Params.size()),
+                                       m_Params.empty() ? nullptr : m_Params.data(), &m_Factory) == SNPE_UDO_NO_ERROR;
+    }
+
+    void releaseFactory()
+    {
+        SnpeUdo_releaseOpFactory(m_Factory);
+        m_Factory = nullptr;
+    }
+
+    uint64_t getNumReused() const
+    {
+        UdoUtil::UdoOpPoolStats stats = {};
+        if (m_Factory != nullptr && m_Factory->opPool != nullptr)
+        {
+            m_Factory->opPool->getStats(stats);
+        }
+        return stats.numReused;
+    }
+
+    /**
+     * \brief Creates ops.size() ops of the factory and releases them again.
+     */
+    bool cycle(std::vector<SnpeUdo_Operation_t>& ops)
+    {
+        bool ok = true;
+        for (SnpeUdo_Operation_t& op : ops)
+        {
+            ok = SnpeUdo_createOperation(m_Factory, nullptr, 1, &m_InputParam, 1, &m_OutputParam, &op) ==
+                 SNPE_UDO_NO_ERROR && ok;
+        }
+        for (SnpeUdo_Operation_t& op : ops)
+        {
+            ok = op != nullptr && SnpeUdo_releaseOp(op) == SNPE_UDO_NO_ERROR && ok;
+            op = nullptr;
+        }
+        return ok;
+    }
+
+private:
+    static size_t getNumElements(const std::vector<uint32_t>& dims)
+    {
+        size_t numElements = 1;
+        for (uint32_t dim : dims) { numElements *= dim; }
+        return numElements;
+    }
+
+    std::string m_Name;
+    const char* m_OperationType;
+    std::vector<uint32_t> m_InputDims;
+    std::vector<uint32_t> m_OutputDims;
+    std::vector<float> m_Input;
+    std::vector<float> m_Output;
+    SnpeUdo_TensorParam_t m_InputParam;
+    SnpeUdo_TensorParam_t m_OutputParam;
+    std::vector<std::unique_ptr<std::vector<uint32_t>>> m_ParamDims;
+    std::vector<std::unique_ptr<std::vector<float>>> m_ParamData;
+    std::vector<SnpeUdo_Param_t> m_Params;
+    SnpeUdo_OpFactory_t m_Factory = nullptr;
+};
+
+std::vector<std::unique_ptr<BenchOp>>
+makeBenchOps()
+{
+    std::vector<std::unique_ptr<BenchOp>> ops;
+    // the 28x28x1 input through Conv2D(28, 3x3), then the Dense(128) of the flattened
+    // pooled output
+    ops.emplace_back(new BenchOp("selu_26x26x28", "Selu", {1, 26, 26, 28}, {1, 26, 26, 28}));
+    ops.emplace_back(new BenchOp("conv2d_selu_3x3x1x28", CONV2D_SELU_OP_TYPE, {1, 28, 28, 1}, {1, 26, 26, 28}));
+    ops.back()->addTensorParam(CONV2D_SELU_WEIGHTS_PARAM, {3, 3, 1, 28});
+    ops.back()->addTensorParam(CONV2D_SELU_BIAS_PARAM, {28});
+    ops.emplace_back(new BenchOp("dense_selu_4732x128", DENSE_SELU_OP_TYPE, {1, 4732}, {1, 128}));
+    ops.back()->addTensorParam(DENSE_SELU_WEIGHTS_PARAM, {4732, 128});
+    ops.back()->addTensorParam(DENSE_SELU_BIAS_PARAM, {128});
+    ops.emplace_back(new BenchOp("fused_elementwise_26x26x28", FUSED_ELEMENTWISE_OP_TYPE, {1, 26, 26, 28},
+                                 {1, 26, 26, 28}));
+    SnpeUdo_Param_t expression;
+    std::memset(&expression, 0, sizeof(expression));
+    expression.paramType = SNPE_UDO_PARAMTYPE_STRING;
+    expression.paramName = const_cast<char*>(FUSED_ELEMENTWISE_EXPRESSION_PARAM);
+    expression.stringParam = const_cast<char*>("clamp(selu(x * a + b), -1, 1)");
+    ops.back()->addParam(expression);
+    return ops;
+}
+
+/**
+ * \brief Times one create/release cycle of live ops of op's factory, created with the
+ * given pool size.
+ */
+bool
+timeCycle(BenchOp& op, uint32_t poolSize, uint32_t live, uint32_t minTimeMs, SnpeUdo_CpuInfrastructure_t* infrastructure,
+          double& cycleNs, uint64_t& iterations, uint64_t& reused)
+{
+    // the pool size is taken when the factory is created
+    UdoUtil::getImplementation().setOpPoolSize(poolSize);
+    if (!op.createFactory(infrastructure))
+    {
+        return false;
+    }
+    std::vector<SnpeUdo_Operation_t> ops(live, nullptr);
+    bool ok = true;
+    cycleNs = BenchCommon::timeCalls(minTimeMs, iterations, [&]() { ok = op.cycle(ops) && ok; });
+    reused = op.getNumReused();
+    op.releaseFactory();
+    return ok;
+}
+
+bool
+runOp(const BenchOptions& options, BenchOp& op, uint32_t live, SnpeUdo_CpuInfrastructure_t* infrastructure,
+      std::vector<BenchResult>& results)
+{
+    BenchResult result;
+    result.op = op.getName();
+    result.live = live;
+    result.iterations = 0;
+    result.unpooledNs = std::numeric_limits<double>::max();
+    result.pooledNs = std::numeric_limits<double>::max();
+    result.reused = 0;
+    // alternating rounds see the same frequency and neighbour noise, the fastest round
+    // of each pass is reported
+    const uint32_t roundTimeMs = std::max<uint32_t>(1, options.minTimeMs / BenchCommon::BENCH_ROUNDS);
+    bool ok = true;
+    for (uint32_t round = 0; round < BenchCommon::BENCH_ROUNDS && ok; round++)
+    {
+        uint64_t iterations = 0;
+        uint64_t reused = 0;
+        double cycleNs = 0;
+        ok = timeCycle(op, 0, live, roundTimeMs, infrastructure, cycleNs, iterations, reused) && ok;
+        result.unpooledNs = std::min(result.unpooledNs, cycleNs);
+        result.iterations += iterations;
+        ok = timeCycle(op, std::max(live, UdoUtil::DEFAULT_OP_POOL_SIZE), live, roundTimeMs, infrastructure, cycleNs,
+                       iterations, reused) && ok;
+        result.pooledNs = std::min(result.pooledNs, cycleNs);
+        result.reused += reused;
+    }
+    if (!ok)
+    {
+        std::cerr << "ERROR: create or release failed for " << op.getName() << std::endl;
+        return false;
+    }
+    results.push_back(result);
+    return true;
+}
+
+void
+writeCsv(std::ostream& stream, const std::vector<BenchResult>& results)
+{
+    stream << "op,live,iterations,unpooled_ns,pooled_ns,speedup,reused\n";
+    for (const BenchResult& result : results)
+    {
+        stream << result.op << ',' << result.live << ',' << result.iterations << ',' << result.unpooledNs << ','
+               << result.pooledNs << ',' << result.unpooledNs / result.pooledNs << ',' << result.reused << '\n';
+    }
+}
+
+void
+writeJson(std::ostream& stream, const std::vector<BenchResult>& results)
+{
+    stream << "[\n";
+    for (size_t idx = 0; idx < results.size(); idx++)
+    {
+        const BenchResult& result = results[idx];
+        stream << "  {\"op\": \"" << result.op << "\", \"live\": " << result.live
+               << ", \"iterations\": " << result.iterations << ", \"unpooled_ns\": " << result.unpooledNs
+               << ", \"pooled_ns\": " << result.pooledNs << ", \"speedup\": " << result.unpooledNs / result.pooledNs
+               << ", \"reused\": " << result.reused << "}" << (idx + 1 < results.size() ? ",\n" : "\n");
+    }
+    stream << "]\n";
+}
+
+bool
+parseOptions(int argc, char** argv, BenchOptions& options)
+{
+    for (int idx = 1; idx < argc; idx++)
+    {
+        std::string key, value;
+        BenchCommon::splitOption(argv[idx], key, value);
+        if (key == "--live")
+        {
+            if (!BenchCommon::parseList(value, options.live)) { return false; }
+        }
+        else if (!BenchCommon::parseBenchOption(key, value, options))
+        {
+            return false;
+        }
+    }
+    if (options.live.empty())
+    {
+        options.live = {1, 8};
+    }
+    return true;
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options))
+    {
+        std::cerr << "usage: " << argv[0]
+                  << " [--live=1,8] [--min-time-ms=200] [--format=csv|json] [--output=file]" << std::endl;
+        return 1;
+    }
+
+    SnpeUdo_CpuInfrastructure_t infrastructure;
+    infrastructure.getData = BenchCommon::getData;
+
+    if (SnpeUdo_initImplLibrary(nullptr) != SNPE_UDO_NO_ERROR)
+    {
+        return 1;
+    }
+    std::vector<BenchResult> results;
+    bool ok = true;
+    {
+        std::vector<std::unique_ptr<BenchOp>> ops = makeBenchOps();
+        for (const std::unique_ptr<BenchOp>& op : ops)
+        {
+            for (uint32_t live : options.live)
+            {
+                ok = runOp(options, *op, live, &infrastructure, results) && ok;
+            }
+        }
+    }
+    SnpeUdo_terminateImplLibrary();
+
+    if (!BenchCommon::writeResults(options, results, writeCsv, writeJson))
+    {
+        return 1;
+    }
+    return ok && !results.empty() ? 0 : 1;
+}
@@ -0,0 +1,438 @@
+//==============================================================================
+//
+// Copyright (c) 2020 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+// Standalone benchmark of the SeluUdoPackage CPU implementation library. It drives the
+// library through the SnpeUdo entry points, with a local getData standing in for the
+// SNPE runtime, and sweeps activations, tensor shapes, data types and thread counts.
+//
+// usage: selu-bench [--ops=Selu,Gelu] [--threads=1,2,4] [--accuracy=exact,fast,turbo]
+//                   [--min-time-ms=200] [--format=csv|json] [--output=file]
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "BenchCommon.hpp"
+#include "SnpeUdo/UdoImpl.h"
+#include "SnpeUdo/UdoImplCpu.h"
+#include "utils/UdoDataType.hpp"
+#include "utils/UdoProfileStats.h"
+#include "utils/UdoSimd.hpp"
+#include "utils/UdoUtil.hpp"
+#include "SeluKernelsCpu.hpp"
+#include "SeluParams.hpp"
+
+namespace {
+
+struct BenchShape
+{
+    const char* name;
+    std::vector<uint32_t> dims;
+};
+
+struct BenchType
+{
+    const char* name;
+    SnpeUdo_DataType_t input;
+    SnpeUdo_DataType_t output;
+};
+
+struct BenchMode
+{
+    const char* name;
+    UdoUtil::ActivationAccuracy mode;
+};
+
+struct BenchResult
+{
+    std::string op;
+    std::string kernel;
+    std::string accuracy;
+    uint32_t threads;
+    std::string shape;
+    std::string dataType;
+    size_t elements;
+    size_t bytes;
+    uint64_t iterations;
+    double meanNs;
+    uint64_t p50Ns;
+    uint64_t p99Ns;
+    double elementsPerNs;
+    double gbPerS;
+};
+
+struct BenchOptions : BenchCommon::BenchOptions
+{
+    std::vector<std::string> ops;
+    std::vector<uint32_t> threads;
+    std::vector<BenchMode> modes;
+};
+
+const std::vector<BenchShape>&
+getShapes()
+{
+    // the dense layers of model_script/selu_UDO_withconv2d/mnist.py, its conv output,
+    // and NHWC feature maps of common vision backbones
+    static const std::vector<BenchShape> shapes = {
+        {"1x10",          {1, 10}},
+        {"1x128",         {1, 128}},
+        {"1x26x26x28",    {1, 26, 26, 28}},
+        {"1x56x56x64",    {1, 56, 56, 64}},
+        {"1x112x112x64",  {1, 112, 112, 64}},
+        {"1x28x28x512",   {1, 28, 28, 512}},
+    };
+    return shapes;
+}
+
+const std::vector<BenchType>&
+getTypes()
+{
+    static const std::vector<BenchType> types = {
+        {"fp32",       SNPE_UDO_DATATYPE_FLOAT_32, SNPE_UDO_DATATYPE_FLOAT_32},
+        {"fp16",       SNPE_UDO_DATATYPE_FLOAT_16, SNPE_UDO_DATATYPE_FLOAT_16},
+        {"fp16->fp32", SNPE_UDO_DATATYPE_FLOAT_16, SNPE_UDO_DATATYPE_FLOAT_32},
+        {"fp32->fp16", SNPE_UDO_DATATYPE_FLOAT_32, SNPE_UDO_DATATYPE_FLOAT_16},
+        {"uint8",      SNPE_UDO_DATATYPE_UINT_8,   SNPE_UDO_DATATYPE_UINT_8},
+        {"fixed16",    SNPE_UDO_DATATYPE_FIXED_16, SNPE_UDO_DATATYPE_FIXED_16},
+    };
+    return types;
+}
+
+const std::vector<BenchMode>&
+getModes()
+{
+    static const std::vector<BenchMode> modes = {
+        {"exact", UdoUtil::ACTIVATION_ACCURACY_EXACT},
+        {"fast",  UdoUtil::ACTIVATION_ACCURACY_FAST},
+        {"turbo", UdoUtil::ACTIVATION_ACCURACY_TURBO},
+    };
+    return modes;
+}
+
+bool
+isPackageActivation(const std::string& op)
+{
+    for (size_t idx = 0; idx < SELU_PACKAGE_NUM_ACTIVATIONS; idx++)
+    {
+        if (op == getSeluPackageActivations()[idx].operationType)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool
+isFloatType(const BenchType& type)
+{
+    return (type.input == SNPE_UDO_DATATYPE_FLOAT_32 || type.input == SNPE_UDO_DATATYPE_FLOAT_16)
+        && (type.output == SNPE_UDO_DATATYPE_FLOAT_32 || type.output == SNPE_UDO_DATATYPE_FLOAT_16);
+}
+
+size_t
+getElementCount(const std::vector<uint32_t>& dims)
+{
+    size_t count = 1;
+    for (uint32_t dim : dims)
+    {
+        count *= dim;
+    }
+    return count;
+}
+
+/**
+ * \brief A host tensor with Selu's typical range, [-4, 4] in, [-1.76, 4.21] out. The
+ * other activations reuse it, only the quantized outputs of some of them saturate.
+ */
+class BenchTensor
+{
+public:
+    BenchTensor(SnpeUdo_DataType_t dataType, const std::vector<uint32_t>& dims, bool isInput)
+        : m_Dims(dims), m_Data(getElementCount(dims) * UdoUtil::getDataTypeSize(dataType))
+    {
+        std::memset(&m_Param, 0, sizeof(m_Param));
+        m_Param.dataType = dataType;
+        m_Param.layout = SNPE_UDO_LAYOUT_NHWC;
+        m_Param.tensorRank = static_cast<uint32_t>(m_Dims.size());
+        m_Param.maxDimensions = m_Dims.data();
+        m_Param.currDimensions = m_Dims.data();
+        m_Param.tensorData = m_Data.data();
+        if (dataType != SNPE_UDO_DATATYPE_FLOAT_32 && dataType != SNPE_UDO_DATATYPE_FLOAT_16)
+        {
+            m_Param.quantizeParams.quantizeType = SNPE_UDO_QUANTIZATION_TF;
+            m_Param.quantizeParams.TFParams.minValue = isInput ? -4.0f : -1.76f;
+            m_Param.quantizeParams.TFParams.maxValue = isInput ? 4.0f : 4.21f;
+        }
+        if (isInput)
+        {
+            fill();
+        }
+    }
+
+    SnpeUdo_TensorParam_t* getParam() { return &m_Param; }
+
+    size_t getSizeInBytes() const { return m_Data.size(); }
+
+private:
+    void fill()
+    {
+        const size_t elementSize = UdoUtil::getDataTypeSize(m_Param.dataType);
+        const size_t count = m_Data.size() / elementSize;
+        for (size_t idx = 0; idx < count; idx++)
+        {
+            const float value = static_cast<float>(static_cast<int>(idx * 2654435761u % 8001) - 4000) / 1000.0f;
+            switch (m_Param.dataType)
+            {
+                case SNPE_UDO_DATATYPE_FLOAT_32:
+                    reinterpret_cast<float*>(m_Data.data())[idx] = value;
+                    break;
+                case SNPE_UDO_DATATYPE_FLOAT_16:
+                    reinterpret_cast<uint16_t*>(m_Data.data())[idx] = UdoUtil::Simd::floatToHalf(value);
+                    break;
+                case SNPE_UDO_DATATYPE_FIXED_16:
+                    reinterpret_cast<uint16_t*>(m_Data.data())[idx] = static_cast<uint16_t>((value + 4.0f) / 8.0f * 65535.0f);
+                    break;
+                default:
+                    m_Data[idx] = static_cast<uint8_t>((value + 4.0f) / 8.0f * 255.0f);
+                    break;
+            }
+        }
+    }
+
+    std::vector<uint32_t> m_Dims;
+    std::vector<uint8_t> m_Data;
+    SnpeUdo_TensorParam_t m_Param;
+};
+
+bool
+runCase(SnpeUdo_OpFactory_t factory, const BenchOptions& options, const std::string& op, uint32_t threads,
+        const BenchMode& mode, const BenchShape& shape, const BenchType& type, BenchResult& result)
+{
+    BenchTensor input(type.input, shape.dims, true);
+    BenchTensor output(type.output, shape.dims, false);
+
+    SnpeUdo_Operation_t operation = nullptr;
+    if (SnpeUdo_createOperation(factory, nullptr, 1, input.getParam(), 1, output.getParam(), &operation) != SNPE_UDO_NO_ERROR)
+    {
+        std::cerr << "ERROR: could not create " << op << " for " << shape.name << " " << type.name << std::endl;
+        return false;
+    }
+
+    // warm up caches, the plan and the scheduler threads
+    for (uint32_t iter = 0; iter < 3; iter++)
+    {
+        SnpeUdo_executeOp(operation, true, iter, nullptr);
+    }
+    SnpeUdoExt_resetOpProfileStats(operation);
+
+    const auto minTime = std::chrono::milliseconds(options.minTimeMs);
+    const auto start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::duration elapsed;
+    uint64_t iterations = 0;
+    do
+    {
+        if (SnpeUdo_executeOp(operation, true, static_cast<uint32_t>(iterations), nullptr) != SNPE_UDO_NO_ERROR)
+        {
+            std::cerr << "ERROR: " << op << " execute failed for " << shape.name << " " << type.name << std::endl;
+            SnpeUdo_releaseOp(operation);
+            return false;
+        }
+        iterations++;
+        elapsed = std::chrono::steady_clock::now() - start;
+    } while (elapsed < minTime || iterations < 10);
+
+    UdoLatencyStats_t latency;
+    SnpeUdoExt_getOpLatencyStats(operation, &latency);
+    SnpeUdo_releaseOp(operation);
+
+    const double meanNs = std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iterations);
+    result.op = op;
+    result.kernel = resolveSeluKernelTable().name;
+    result.accuracy = mode.name;
+    result.threads = threads;
+    result.shape = shape.name;
+    result.dataType = type.name;
+    result.elements = getElementCount(shape.dims);
+    result.bytes = input.getSizeInBytes() + output.getSizeInBytes();
+    result.iterations = iterations;
+    result.meanNs = meanNs;
+    result.p50Ns = latency.p50Ns;
+    result.p99Ns = latency.p99Ns;
+    result.elementsPerNs = static_cast<double>(result.elements) / meanNs;
+    result.gbPerS = static_cast<double>(result.bytes) / meanNs; // bytes per ns == GB/s
+    return true;
+}
+
+void
+writeCsv(std::ostream& stream, const std::vector<BenchResult>& results)
+{
+    stream << "op,kernel,accuracy,threads,shape,dtype,elements,bytes,iterations,mean_ns,p50_ns,p99_ns,elements_per_ns,gb_per_s\n";
+    for (const BenchResult& result : results)
+    {
+        stream << result.op << ',' << result.kernel << ',' << result.accuracy << ',' << result.threads << ',' << result.shape << ',' << result.dataType << ','
+               << result.elements << ',' << result.bytes << ',' << result.iterations << ',' << result.meanNs << ','
+               << result.p50Ns << ',' << result.p99Ns << ',' << result.elementsPerNs << ',' << result.gbPerS << '\n';
+    }
+}
+
+void
+writeJson(std::ostream& stream, const std::vector<BenchResult>& results)
+{
+    stream << "[\n";
+    for (size_t idx = 0; idx < results.size(); idx++)
+    {
+        const BenchResult& result = results[idx];
+        stream << "  {\"op\": \"" << result.op << "\", \"kernel\": \"" << result.kernel << "\", \"accuracy\": \"" << result.accuracy
+               << "\", \"threads\": " << result.threads
+               << ", \"shape\": \"" << result.shape << "\", \"dtype\": \"" << result.dataType
+               << "\", \"elements\": " << result.elements << ", \"bytes\": " << result.bytes
+               << ", \"iterations\": " << result.iterations << ", \"mean_ns\": " << result.meanNs
+               << ", \"p50_ns\": " << result.p50Ns << ", \"p99_ns\": " << result.p99Ns
+               << ", \"elements_per_ns\": " << result.elementsPerNs << ", \"gb_per_s\": " << result.gbPerS << "}"
+               << (idx + 1 < results.size() ? ",\n" : "\n");
+    }
+    stream << "]\n";
+}
+
+bool
+parseOptions(int argc, char** argv, BenchOptions& options)
+{
+    for (int idx = 1; idx < argc; idx++)
+    {
+        std::string key, value;
+        BenchCommon::splitOption(argv[idx], key, value);
+        if (key == "--ops")
+        {
+            std::istringstream list(value);
+            std::string item;
+            while (std::getline(list, item, ','))
+            {
+                if (!isPackageActivation(item))
+                {
+                    return false;
+                }
+                options.ops.push_back(item);
+            }
+        }
+        else if (key == "--threads")
+        {
+            if (!BenchCommon::parseList(value, options.threads)) { return false; }
+        }
+        else if (key == "--accuracy")
+        {
+            std::istringstream list(value);
+            std::string item;
+            while (std::getline(list, item, ','))
+            {
+                size_t mode = 0;
+                while (mode < getModes().size() && item != getModes()[mode].name)
+                {
+                    mode++;
+                }
+                if (mode == getModes().size())
+                {
+                    return false;
+                }
+                options.modes.push_back(getModes()[mode]);
+            }
+        }
+        else if (!BenchCommon::parseBenchOption(key, value, options))
+        {
+            return false;
+        }
+    }
+    if (options.modes.empty())
+    {
+        options.modes.push_back(getModes()[UdoUtil::ACTIVATION_ACCURACY_FAST]);
+    }
+    if (options.ops.empty())
+    {
+        options.ops.push_back(getSeluPackageActivations()[0].operationType);
+    }
+    if (options.threads.empty())
+    {
+        BenchCommon::setDefaultThreads(options.threads);
+    }
+    return true;
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options))
+    {
+        std::cerr << "usage: " << argv[0]
+                  << " [--ops=Selu,Gelu] [--threads=1,2,4] [--accuracy=exact,fast,turbo] [--min-time-ms=200]"
+                  << " [--format=csv|json] [--output=file]" << std::endl;
+        return 1;
+    }
+
+    SnpeUdo_CpuInfrastructure_t infrastructure;
+    infrastructure.getData = BenchCommon::getData;
+
+    std::vector<BenchResult> results;
+    for (uint32_t threads : options.threads)
+    {
+        // the thread count is fixed when the library creates its scheduler
+        if (SnpeUdo_initImplLibrary(nullptr) != SNPE_UDO_NO_ERROR ||
+            UdoUtil::getImplementation().setNumThreads(threads) != SNPE_UDO_NO_ERROR)
+        {
+            return 1;
+        }
+
+        for (const std::string& op : options.ops)
+        {
+            for (const BenchMode& mode : options.modes)
+            {
+                // the mode is a static param, so each one gets its own factory
+                SnpeUdo_Param_t accuracyParam;
+                std::memset(&accuracyParam, 0, sizeof(accuracyParam));
+                accuracyParam.paramType = SNPE_UDO_PARAMTYPE_SCALAR;
+                accuracyParam.paramName = const_cast<char*>(UdoUtil::ACTIVATION_ACCURACY_MODE_PARAM);
+                accuracyParam.scalarParam.dataType = SNPE_UDO_DATATYPE_UINT_32;
+                accuracyParam.scalarParam.dataValue.uint32Value = mode.mode;
+
+                SnpeUdo_OpFactory_t factory = nullptr;
+                if (SnpeUdo_createOpFactory(SNPE_UDO_CORETYPE_CPU, &infrastructure, const_cast<char*>(op.c_str()), 1,
+                                            &accuracyParam, &factory) != SNPE_UDO_NO_ERROR)
+                {
+                    SnpeUdo_terminateImplLibrary();
+                    return 1;
+                }
+                for (const BenchShape& shape : getShapes())
+                {
+                    for (const BenchType& type : getTypes())
+                    {
+                        // quantized tensors use tables and ignore the mode, time them once
+                        BenchResult result;
+                        if ((isFloatType(type) || mode.mode == options.modes.front().mode)
+                            && runCase(factory, options, op, threads, mode, shape, type, result))
+                        {
+                            results.push_back(result);
+                        }
+                    }
+                }
+                SnpeUdo_releaseOpFactory(factory);
+            }
+        }
+        SnpeUdo_terminateImplLibrary();
+    }
+
+    if (!BenchCommon::writeResults(options, results, writeCsv, writeJson))
+    {
+        return 1;
+    }
+    return results.empty() ? 1 : 0;
+}
@@ -0,0 +1,430 @@
+//==============================================================================
+//
+// Copyright (c) 2020 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+// Replays the SnpeUdo lifecycle the way the SNPE runtime drives a UDO package: the
+// registration library is loaded and queried, the operation is validated, then the
+// implementation library it names is loaded and an operation is created, executed and
+// released. Every stage is timed on its own so that library load and op creation
+// costs are visible next to the kernel. Only the C ABI is used, through dlsym, with a
+// local stand-in for the CPU infrastructure.
+//
+// usage: selu-lifecycle [--lib-dir=dir] [--shape=1x128] [--iterations=1000] [--cycles=1] [--format=text|csv]
+
+#include <dlfcn.h>
+#include <limits.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BenchCommon.hpp"
+#include "SnpeUdo/UdoBase.h"
+#include "SnpeUdo/UdoImpl.h"
+#include "SnpeUdo/UdoImplCpu.h"
+#include "SnpeUdo/UdoReg.h"
+
+namespace {
+
+// entry points as resolved by the runtime, declared here so that the harness does not
+// depend on the function pointer typedefs of a particular SDK release
+using InitRegLibraryFn = SnpeUdo_ErrorType_t (*)(void);
+using GetRegInfoFn = SnpeUdo_ErrorType_t (*)(SnpeUdo_RegInfo_t**);
+using ValidateOperationFn = SnpeUdo_ErrorType_t (*)(SnpeUdo_OpDefinition_t*);
+using TerminateRegLibraryFn = SnpeUdo_ErrorType_t (*)(void);
+using InitImplLibraryFn = SnpeUdo_ErrorType_t (*)(void*);
+using GetImpInfoFn = SnpeUdo_ErrorType_t (*)(SnpeUdo_ImpInfo_t**);
+using CreateOpFactoryFn = SnpeUdo_ErrorType_t (*)(SnpeUdo_CoreType_t, void*, SnpeUdo_String_t, uint32_t,
+                                                  SnpeUdo_Param_t*, SnpeUdo_OpFactory_t*);
+using CreateOperationFn = SnpeUdo_ErrorType_t (*)(SnpeUdo_OpFactory_t, void*, uint32_t, SnpeUdo_TensorParam_t*,
+                                                  uint32_t, SnpeUdo_TensorParam_t*, SnpeUdo_Operation_t*);
+using ExecuteOpFn = SnpeUdo_ErrorType_t (*)(SnpeUdo_Operation_t, bool, const uint32_t, SnpeUdo_ExternalNotify_t);
+using SetOpIOFn = SnpeUdo_ErrorType_t (*)(SnpeUdo_Operation_t, SnpeUdo_TensorParam_t*, SnpeUdo_TensorParam_t*);
+using ProfileOpFn = SnpeUdo_ErrorType_t (*)(SnpeUdo_Operation_t, uint32_t*);
+using ReleaseOpFn = SnpeUdo_ErrorType_t (*)(SnpeUdo_Operation_t);
+using ReleaseOpFactoryFn = SnpeUdo_ErrorType_t (*)(SnpeUdo_OpFactory_t);
+using TerminateImplLibraryFn = SnpeUdo_ErrorType_t (*)(void);
+
+const char* REG_LIB_NAME = "libUdoSeluUdoPackageReg.so";
+const char* OPERATION_TYPE = "Selu";
+
+struct HarnessOptions
+{
+    std::string libDir;
+    std::vector<uint32_t> shape = {1, 128};
+    uint32_t iterations = 1000;
+    uint32_t cycles = 1;
+    std::string format = "text";
+};
+
+struct StageTime
+{
+    uint32_t cycle;
+    std::string stage;
+    double ns;
+};
+
+std::atomic<uint32_t> notifiedId(UINT32_MAX);
+
+void
+notify(const uint32_t id)
+{
+    notifiedId.store(id, std::memory_order_release);
+}
+
+/**
+ * \brief Times the stages of one lifecycle, failed stages are reported and not recorded.
+ */
+class LifecycleRun
+{
+public:
+    LifecycleRun(uint32_t cycle, std::vector<StageTime>& times) : m_Cycle(cycle), m_Times(times) {}
+
+    template <typename Fn>
+    bool stage(const char* name, const Fn& fn)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const bool ok = fn();
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        if (!ok)
+        {
+            std::cerr << "ERROR: stage " << name << " failed" << std::endl;
+            return false;
+        }
+        m_Times.push_back({m_Cycle, name, ns});
+        return true;
+    }
+
+    /**
+     * \brief Records a stage measured by the caller, e.g. an average over iterations.
+     */
+    void record(const char* name, double ns) { m_Times.push_back({m_Cycle, name, ns}); }
+
+private:
+    uint32_t m_Cycle;
+    std::vector<StageTime>& m_Times;
+};
+
+template <typename Fn>
+bool
+resolve(void* library, const char* name, Fn& fn)
+{
+    fn = reinterpret_cast<Fn>(dlsym(library, name));
+    if (fn == nullptr)
+    {
+        std::cerr << "ERROR: " << name << " not found: " << dlerror() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool
+runLifecycle(const HarnessOptions& options, uint32_t cycle, std::vector<StageTime>& times)
+{
+    LifecycleRun run(cycle, times);
+
+    size_t elementCount = 1;
+    for (uint32_t dim : options.shape)
+    {
+        elementCount *= dim;
+    }
+    std::vector<uint32_t> dims(options.shape);
+    std::vector<float> input(elementCount), output(elementCount);
+    std::vector<float> backInput(elementCount), backOutput(elementCount);
+    for (size_t idx = 0; idx < elementCount; idx++)
+    {
+        input[idx] = static_cast<float>(static_cast<int>(idx % 801) - 400) / 100.0f;
+        backInput[idx] = -input[idx];
+    }
+    // tensors[2] and tensors[3] are the second buffer pair of double buffered inference
+    SnpeUdo_TensorParam_t tensors[4] = {};
+    for (uint32_t idx = 0; idx < 4; idx++)
+    {
+        tensors[idx].dataType = SNPE_UDO_DATATYPE_FLOAT_32;
+        tensors[idx].layout = SNPE_UDO_LAYOUT_NHWC;
+        tensors[idx].quantizeParams.quantizeType = SNPE_UDO_QUANTIZATION_NONE;
+        tensors[idx].tensorRank = static_cast<uint32_t>(dims.size());
+        tensors[idx].maxDimensions = dims.data();
+        tensors[idx].currDimensions = dims.data();
+    }
+    tensors[0].tensorData = input.data();
+    tensors[1].tensorData = output.data();
+    tensors[2].tensorData = backInput.data();
+    tensors[3].tensorData = backOutput.data();
+
+    // registration library
+    void* regLib = nullptr;
+    InitRegLibraryFn initRegLibrary;
+    GetRegInfoFn getRegInfo;
+    ValidateOperationFn validateOperation;
+    TerminateRegLibraryFn terminateRegLibrary;
+    SnpeUdo_RegInfo_t* regInfo = nullptr;
+    bool regInitialized = false;
+    const std::string regLibPath = options.libDir + "/" + REG_LIB_NAME;
+    if (!run.stage("reg_dlopen", [&]() { return (regLib = dlopen(regLibPath.c_str(), RTLD_NOW | RTLD_LOCAL)) != nullptr; }))
+    {
+        std::cerr << dlerror() << std::endl;
+        return false;
+    }
+    bool ok = resolve(regLib, "SnpeUdo_initRegLibrary", initRegLibrary) &&
+              resolve(regLib, "SnpeUdo_getRegInfo", getRegInfo) &&
+              resolve(regLib, "SnpeUdo_validateOperation", validateOperation) &&
+              resolve(regLib, "SnpeUdo_terminateRegLibrary", terminateRegLibrary) &&
+              (regInitialized = run.stage("reg_init", [&]() { return initRegLibrary() == SNPE_UDO_NO_ERROR; })) &&
+              run.stage("reg_get_info", [&]()
+              {
+                  return getRegInfo(&regInfo) == SNPE_UDO_NO_ERROR && regInfo != nullptr &&
+                         regInfo->numOfImplementationLib > 0;
+              });
+
+    SnpeUdo_OpDefinition_t definition = {};
+    if (ok)
+    {
+        definition.packageName = regInfo->packageName;
+        definition.operationType = const_cast<SnpeUdo_String_t>(OPERATION_TYPE);
+        definition.udoCoreType = SNPE_UDO_CORETYPE_CPU;
+        definition.numOfInputs = 1;
+        definition.inputs = &tensors[0];
+        definition.numOfOutputs = 1;
+        definition.outputs = &tensors[1];
+        ok = run.stage("reg_validate_op", [&]() { return validateOperation(&definition) == SNPE_UDO_NO_ERROR; });
+    }
+
+    // implementation library named by the registration library, loaded from the same directory
+    void* implLib = nullptr;
+    InitImplLibraryFn initImplLibrary;
+    GetImpInfoFn getImpInfo;
+    CreateOpFactoryFn createOpFactory;
+    CreateOperationFn createOperation;
+    ExecuteOpFn executeOp;
+    SetOpIOFn setOpIO;
+    ProfileOpFn profileOp;
+    ReleaseOpFn releaseOp;
+    ReleaseOpFactoryFn releaseOpFactory;
+    TerminateImplLibraryFn terminateImplLibrary;
+    if (ok)
+    {
+        const std::string implLibPath = options.libDir + "/" + regInfo->implementationLib[0].libraryName;
+        ok = run.stage("impl_dlopen", [&]() { return (implLib = dlopen(implLibPath.c_str(), RTLD_NOW | RTLD_LOCAL)) != nullptr; });
+        if (!ok)
+        {
+            std::cerr << dlerror() << std::endl;
+        }
+    }
+    ok = ok && resolve(implLib, "SnpeUdo_initImplLibrary", initImplLibrary) &&
+         resolve(implLib, "SnpeUdo_getImpInfo", getImpInfo) &&
+         resolve(implLib, "SnpeUdo_createOpFactory", createOpFactory) &&
+         resolve(implLib, "SnpeUdo_createOperation", createOperation) &&
+         resolve(implLib, "SnpeUdo_executeOp", executeOp) &&
+         resolve(implLib, "SnpeUdo_setOpIO", setOpIO) &&
+         resolve(implLib, "SnpeUdo_profileOp", profileOp) &&
+         resolve(implLib, "SnpeUdo_releaseOp", releaseOp) &&
+         resolve(implLib, "SnpeUdo_releaseOpFactory", releaseOpFactory) &&
+         resolve(implLib, "SnpeUdo_terminateImplLibrary", terminateImplLibrary);
+
+    bool implInitialized = false;
+    SnpeUdo_OpFactory_t factory = nullptr;
+    SnpeUdo_Operation_t operation = nullptr;
+    SnpeUdo_CpuInfrastructure_t infrastructure;
+    infrastructure.getData = BenchCommon::getData;
+    if (ok)
+    {
+        // a runtime may terminate a library it never initialized, e.g. after a failed init
+        ok = run.stage("impl_terminate_uninit", [&]() { return terminateImplLibrary() == SNPE_UDO_NO_ERROR; });
+    }
+    if (ok)
+    {
+        SnpeUdo_ImpInfo_t* impInfo = nullptr;
+        ok = (implInitialized = run.stage("impl_init", [&]() { return initImplLibrary(nullptr) == SNPE_UDO_NO_ERROR; })) &&
+             run.stage("impl_get_info", [&]() { return getImpInfo(&impInfo) == SNPE_UDO_NO_ERROR; }) &&
+             run.stage("create_op_factory", [&]()
+             {
+                 return createOpFactory(SNPE_UDO_CORETYPE_CPU, &infrastructure, const_cast<SnpeUdo_String_t>(OPERATION_TYPE),
+                                        0, nullptr, &factory) == SNPE_UDO_NO_ERROR;
+             }) &&
+             run.stage("create_operation", [&]()
+             {
+                 return createOperation(factory, nullptr, 1, &tensors[0], 1, &tensors[1], &operation) == SNPE_UDO_NO_ERROR;
+             }) &&
+             run.stage("execute_first", [&]() { return executeOp(operation, true, 0, nullptr) == SNPE_UDO_NO_ERROR; });
+    }
+
+    if (ok)
+    {
+        // steady state blocking executes, reported per call
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t iter = 0; iter < options.iterations && ok; iter++)
+        {
+            ok = executeOp(operation, true, iter, nullptr) == SNPE_UDO_NO_ERROR;
+        }
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        if (ok && options.iterations > 0)
+        {
+            run.record("execute_steady", ns / options.iterations);
+        }
+
+        // double buffering: one op, rebound to the other buffer pair before every execute
+        const auto swapStart = std::chrono::steady_clock::now();
+        for (uint32_t iter = 0; iter < options.iterations && ok; iter++)
+        {
+            SnpeUdo_TensorParam_t* pair = &tensors[(iter & 1) * 2];
+            ok = setOpIO(operation, &pair[0], &pair[1]) == SNPE_UDO_NO_ERROR &&
+                 executeOp(operation, true, iter, nullptr) == SNPE_UDO_NO_ERROR;
+        }
+        const double swapNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - swapStart).count();
+        if (ok && options.iterations > 0)
+        {
+            run.record("execute_swap_io", swapNs / options.iterations);
+        }
+        ok = ok && setOpIO(operation, &tensors[0], &tensors[1]) == SNPE_UDO_NO_ERROR;
+
+        uint32_t executionTimeUs = 0;
+        ok = ok && run.stage("execute_async_notify", [&]()
+             {
+                 notifiedId.store(UINT32_MAX, std::memory_order_relaxed);
+                 if (executeOp(operation, false, 7, notify) != SNPE_UDO_NO_ERROR)
+                 {
+                     return false;
+                 }
+                 while (notifiedId.load(std::memory_order_acquire) != 7)
+                 {
+                     std::this_thread::yield();
+                 }
+                 return true;
+             }) &&
+             run.stage("profile_op", [&]() { return profileOp(operation, &executionTimeUs) == SNPE_UDO_NO_ERROR; });
+    }
+
+    // tear down whatever was brought up, in the runtime's order
+    if (operation != nullptr)
+    {
+        ok = run.stage("release_op", [&]() { return releaseOp(operation) == SNPE_UDO_NO_ERROR; }) && ok;
+    }
+    if (factory != nullptr)
+    {
+        ok = run.stage("release_op_factory", [&]() { return releaseOpFactory(factory) == SNPE_UDO_NO_ERROR; }) && ok;
+    }
+    if (implInitialized)
+    {
+        ok = run.stage("impl_terminate", [&]() { return terminateImplLibrary() == SNPE_UDO_NO_ERROR; }) && ok;
+        ok = run.stage("impl_terminate_again", [&]() { return terminateImplLibrary() == SNPE_UDO_NO_ERROR; }) && ok;
+    }
+    if (implLib != nullptr)
+    {
+        ok = run.stage("impl_dlclose", [&]() { return dlclose(implLib) == 0; }) && ok;
+    }
+    if (regInitialized)
+    {
+        ok = run.stage("reg_terminate", [&]() { return terminateRegLibrary() == SNPE_UDO_NO_ERROR; }) && ok;
+    }
+    ok = run.stage("reg_dlclose", [&]() { return dlclose(regLib) == 0; }) && ok;
+    return ok;
+}
+
+/**
+ * \brief The libraries of the benchmark's target, bin/<target>/.. /../libs/<target>.
+ */
+std::string
+getDefaultLibDir()
+{
+    char path[PATH_MAX];
+    const ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+    if (length <= 0)
+    {
+        return ".";
+    }
+    const std::string exe(path, static_cast<size_t>(length));
+    const std::string binDir = exe.substr(0, exe.find_last_of('/'));
+    const std::string target = binDir.substr(binDir.find_last_of('/') + 1);
+    return binDir + "/../../libs/" + target;
+}
+
+bool
+parseOptions(int argc, char** argv, HarnessOptions& options)
+{
+    options.libDir = getDefaultLibDir();
+    for (int idx = 1; idx < argc; idx++)
+    {
+        std::string key, value;
+        BenchCommon::splitOption(argv[idx], key, value);
+        if (key == "--lib-dir" && !value.empty())
+        {
+            options.libDir = value;
+        }
+        else if (key == "--shape")
+        {
+            options.shape.clear();
+            if (!BenchCommon::parseList(value, options.shape, 'x'))
+            {
+                return false;
+            }
+        }
+        else if (key == "--iterations")
+        {
+            options.iterations = static_cast<uint32_t>(std::atoi(value.c_str()));
+        }
+        else if (key == "--cycles" && std::atoi(value.c_str()) > 0)
+        {
+            options.cycles = static_cast<uint32_t>(std::atoi(value.c_str()));
+        }
+        else if (key == "--format" && (value == "text" || value == "csv"))
+        {
+            options.format = value;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return !options.shape.empty();
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+    HarnessOptions options;
+    if (!parseOptions(argc, argv, options))
+    {
+        std::cerr << "usage: " << argv[0]
+                  << " [--lib-dir=dir] [--shape=1x128] [--iterations=1000] [--cycles=1] [--format=text|csv]" << std::endl;
+        return 1;
+    }
+
+    std::vector<StageTime> times;
+    bool ok = true;
+    for (uint32_t cycle = 0; cycle < options.cycles && ok; cycle++)
+    {
+        ok = runLifecycle(options, cycle, times);
+    }
+
+    if (options.format == "csv")
+    {
+        std::cout << "cycle,stage,ns\n";
+        for (const StageTime& time : times)
+        {
+            std::cout << time.cycle << ',' << time.stage << ',' << time.ns << '\n';
+        }
+    }
+    else
+    {
+        for (const StageTime& time : times)
+        {
+            std::cout << "cycle " << time.cycle << "  " << time.stage
+                      << std::string(time.stage.size() < 24 ? 24 - time.stage.size() : 1, ' ')
+                      << static_cast<uint64_t>(time.ns) << " ns\n";
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -4,12 +4,26 @@
 
 #include "SnpeUdo/UdoBase.h"
 #include "SeluUdoPackageCpuImplValidationFunctions.hpp"
+#include "SeluParams.hpp"
+#include "utils/UdoQuantize.hpp"
+#include <algorithm>
 #include <string.h>
 
 using namespace UdoUtil;
 
+namespace {
+
+// the CPU kernels load and store float32 and float16 and compute in float32
+bool
+isSupportedFloatType(SnpeUdo_DataType_t dataType)
+{
+    return dataType == SNPE_UDO_DATATYPE_FLOAT_32 || dataType == SNPE_UDO_DATATYPE_FLOAT_16;
+}
+
+}
+
 SnpeUdo_ErrorType_t
-SeluCpuValidationFunction::validateOperation(SnpeUdo_OpDefinition_t* def) {
+ActivationCpuValidationFunction::validateOperation(SnpeUdo_OpDefinition_t* def) {
     /**
      * add code here
      */
@@ -21,16 +35,165 @@ SeluCpuValidationFunction::validateOperation(SnpeUdo_OpDefinition_t* def) {
         return SNPE_UDO_INVALID_ARGUMENT;
     }
 
-    if (strcmp(def->operationType, "Selu"))
+    if (def->operationType == nullptr || strcmp(def->operationType, m_Info.operationType))
+        return SNPE_UDO_WRONG_OPERATION;
+
+    if (def->numOfStaticParams > 0 && def->staticParams == nullptr)
+        return SNPE_UDO_WRONG_NUM_OF_PARAMS;
+    // the same schema check the CPU library makes when it creates the op
+    ActivationParams params;
+    ActivationAccuracy accuracy;
+    status = resolveActivationParams(m_Info, def->staticParams, def->numOfStaticParams, params, accuracy);
+    if (status != SNPE_UDO_NO_ERROR)
+        return status;
+
+
+    if (def->numOfInputs != 1 || def->numOfOutputs != 1)
+        return SNPE_UDO_WRONG_OPERATION;
+
+    if (def->inputs != nullptr && def->outputs != nullptr)
+    {
+        const SnpeUdo_DataType_t inType = def->inputs[0].dataType;
+        const SnpeUdo_DataType_t outType = def->outputs[0].dataType;
+        const bool isFloat = isSupportedFloatType(inType) && isSupportedFloatType(outType);
+        // quantized tensors go through a table from input to output codes, so both
+        // sides must have the same width
+        const bool isQuantized = getQuantizedBitWidth(inType) != 0 &&
+                                 getQuantizedBitWidth(inType) == getQuantizedBitWidth(outType);
+        if (!isFloat && !isQuantized)
+            return SNPE_UDO_UNSUPPORTED_FEATURE;
+    }
+
+    return SNPE_UDO_NO_ERROR;
+}
+
+SnpeUdo_ErrorType_t
+DenseSeluCpuValidationFunction::validateOperation(SnpeUdo_OpDefinition_t* def) {
+    if (def == nullptr)
+    {
+        return SNPE_UDO_INVALID_ARGUMENT;
+    }
+
+    if (def->operationType == nullptr || strcmp(def->operationType, DENSE_SELU_OP_TYPE))
         return SNPE_UDO_WRONG_OPERATION;
 
-    if (def->numOfStaticParams != 0)
+    if (def->numOfStaticParams > 0 && def->staticParams == nullptr)
+        return SNPE_UDO_WRONG_NUM_OF_PARAMS;
+    // the same checks the CPU library makes when it creates the op
+    DenseSeluParamTable table;
+    size_t depth = 0;
+    size_t units = 0;
+    ActivationAccuracy accuracy;
+    const SnpeUdo_ErrorType_t status = resolveDenseSeluParams(def->staticParams, def->numOfStaticParams, table,
+                                                              depth, units, accuracy);
+    if (status != SNPE_UDO_NO_ERROR)
+        return status;
+
+    if (def->numOfInputs != 1 || def->numOfOutputs != 1)
+        return SNPE_UDO_WRONG_OPERATION;
+
+    if (def->inputs != nullptr && def->outputs != nullptr)
+    {
+        const SnpeUdo_TensorParam_t& input = def->inputs[0];
+        const SnpeUdo_TensorParam_t& output = def->outputs[0];
+        // the dense kernels load and store float32 only
+        if (input.dataType != SNPE_UDO_DATATYPE_FLOAT_32 || output.dataType != SNPE_UDO_DATATYPE_FLOAT_32)
+            return SNPE_UDO_UNSUPPORTED_FEATURE;
+        if (input.tensorRank == 0 || output.tensorRank == 0 ||
+            input.maxDimensions == nullptr || output.maxDimensions == nullptr)
+            return SNPE_UDO_WRONG_NUM_OF_DIMENSIONS;
+        if (input.maxDimensions[input.tensorRank - 1] != depth || output.maxDimensions[output.tensorRank - 1] != units)
+            return SNPE_UDO_WRONG_NUM_OF_DIMENSIONS;
+    }
+
+    return SNPE_UDO_NO_ERROR;
+}
+
+SnpeUdo_ErrorType_t
+Conv2dSeluCpuValidationFunction::validateOperation(SnpeUdo_OpDefinition_t* def) {
+    if (def == nullptr)
+    {
+        return SNPE_UDO_INVALID_ARGUMENT;
+    }
+
+    if (def->operationType == nullptr || strcmp(def->operationType, CONV2D_SELU_OP_TYPE))
         return SNPE_UDO_WRONG_OPERATION;
 
+    if (def->numOfStaticParams > 0 && def->staticParams == nullptr)
+        return SNPE_UDO_WRONG_NUM_OF_PARAMS;
+    // the same checks the CPU library makes when it creates the op
+    Conv2dSeluParamTable table;
+    ConvGeometry geometry;
+    ActivationAccuracy accuracy;
+    const SnpeUdo_ErrorType_t status = resolveConv2dSeluParams(def->staticParams, def->numOfStaticParams, table,
+                                                               geometry, accuracy);
+    if (status != SNPE_UDO_NO_ERROR)
+        return status;
 
     if (def->numOfInputs != 1 || def->numOfOutputs != 1)
         return SNPE_UDO_WRONG_OPERATION;
 
+    if (def->inputs != nullptr && def->outputs != nullptr)
+    {
+        const SnpeUdo_TensorParam_t& input = def->inputs[0];
+        const SnpeUdo_TensorParam_t& output = def->outputs[0];
+        // the convolution kernels load and store float32 only
+        if (input.dataType != SNPE_UDO_DATATYPE_FLOAT_32 || output.dataType != SNPE_UDO_DATATYPE_FLOAT_32)
+            return SNPE_UDO_UNSUPPORTED_FEATURE;
+        if (input.tensorRank != 4 || output.tensorRank != 4 ||
+            input.maxDimensions == nullptr || output.maxDimensions == nullptr)
+            return SNPE_UDO_WRONG_NUM_OF_DIMENSIONS;
+        const uint32_t* inDims = input.maxDimensions;
+        const uint32_t* outDims = output.maxDimensions;
+        if (inDims[0] != outDims[0] || inDims[3] != geometry.channels || outDims[3] != geometry.units)
+            return SNPE_UDO_WRONG_NUM_OF_DIMENSIONS;
+        if (!isValidConvExtent(inDims[1], outDims[1], geometry.kernelHeight, geometry.strideHeight, geometry.padTop) ||
+            !isValidConvExtent(inDims[2], outDims[2], geometry.kernelWidth, geometry.strideWidth, geometry.padLeft))
+            return SNPE_UDO_WRONG_NUM_OF_DIMENSIONS;
+    }
+
     return SNPE_UDO_NO_ERROR;
 }
 
+SnpeUdo_ErrorType_t
+FusedElementwiseCpuValidationFunction::validateOperation(SnpeUdo_OpDefinition_t* def) {
+    if (def == nullptr)
+    {
+        return SNPE_UDO_INVALID_ARGUMENT;
+    }
+
+    if (def->operationType == nullptr || strcmp(def->operationType, FUSED_ELEMENTWISE_OP_TYPE))
+        return SNPE_UDO_WRONG_OPERATION;
+
+    if (def->numOfStaticParams > 0 && def->staticParams == nullptr)
+        return SNPE_UDO_WRONG_NUM_OF_PARAMS;
+    // the same checks the CPU library makes when it creates the op, including
+    // compiling the expression
+    FusedElementwiseParamTable table;
+    ExprProgram program;
+    ExprError error;
+    ActivationAccuracy accuracy;
+    const SnpeUdo_ErrorType_t status = resolveFusedElementwiseParams(def->staticParams, def->numOfStaticParams,
+                                                                     table, program, error, accuracy);
+    if (status != SNPE_UDO_NO_ERROR)
+        return status;
+
+    if (def->numOfInputs != 1 || def->numOfOutputs != 1)
+        return SNPE_UDO_WRONG_OPERATION;
+
+    if (def->inputs != nullptr && def->outputs != nullptr)
+    {
+        const SnpeUdo_TensorParam_t& input = def->inputs[0];
+        const SnpeUdo_TensorParam_t& output = def->outputs[0];
+        // the expression kernels load and store float32 only
+        if (input.dataType != SNPE_UDO_DATATYPE_FLOAT_32 || output.dataType != SNPE_UDO_DATATYPE_FLOAT_32)
+            return SNPE_UDO_UNSUPPORTED_FEATURE;
+        if (input.tensorRank != output.tensorRank ||
+            (input.tensorRank > 0 && (input.maxDimensions == nullptr || output.maxDimensions == nullptr)))
+            return SNPE_UDO_WRONG_NUM_OF_DIMENSIONS;
+        if (!std::equal(input.maxDimensions, input.maxDimensions + input.tensorRank, output.maxDimensions))
+            return SNPE_UDO_WRONG_NUM_OF_DIMENSIONS;
+    }
+
+    return SNPE_UDO_NO_ERROR;
+}
@@ -4,6 +4,7 @@
 #include <iostream>
 #include "utils/UdoUtil.hpp"
 #include "SeluUdoPackageCpuImplValidationFunctions.hpp"
+#include "SeluParams.hpp"
 
 #ifndef UDO_LIB_NAME_CPU
 #define UDO_LIB_NAME_CPU "libUdoSeluUdoPackageImplCpu.so"
@@ -33,27 +34,133 @@ SnpeUdo_initRegLibrary(void)
     */
     regLibraryInfo->addImplLib(UDO_LIB_NAME_CPU, SNPE_UDO_CORETYPE_CPU); //adding implementation libraries
 
+    // float tensors run in float32 registers, 8-bit and 16-bit TF quantized tensors through lookup tables
+    const SnpeUdo_Bitmask_t activationCpuDataTypes = SNPE_UDO_DATATYPE_FLOAT_16 | SNPE_UDO_DATATYPE_FLOAT_32 |
+                                                     SNPE_UDO_DATATYPE_FIXED_8 | SNPE_UDO_DATATYPE_UINT_8 |
+                                                     SNPE_UDO_DATATYPE_FIXED_16;
+
+    //==============================================================================
+    // Selu and the other activations of SeluPackageActivations, see SeluParams.hpp
+    //==============================================================================
+    const UdoUtil::ActivationInfo* activations = getSeluPackageActivations();
+    for (size_t idx = 0; idx < SELU_PACKAGE_NUM_ACTIVATIONS; idx++)
+    {
+        const UdoUtil::ActivationInfo& activation = activations[idx];
+        auto activationInfo = regLibraryInfo->addOperation(activation.operationType, SNPE_UDO_CORETYPE_CPU, 1, 1);
+
+        activationInfo->addCoreInfo(SNPE_UDO_CORETYPE_CPU, activationCpuDataTypes); //adding core info
+
+        // activations only have the optional scalar params of ACTIVATION_PARAM_SCHEMA,
+        // alpha only where the activation has one
+        for (size_t slot = 0; slot < UdoUtil::ACTIVATION_NUM_PARAMS; slot++)
+        {
+            if (slot != UdoUtil::ACTIVATION_PARAM_ALPHA || activation.usesAlpha)
+            {
+                const UdoUtil::UdoParamSpec& param = UdoUtil::ACTIVATION_PARAM_SCHEMA[slot];
+                activationInfo->addScalarParam(param.name, param.dataType);
+            }
+        }
+
+        //inputs and outputs need to be added as tensor params
+
+        activationInfo->addInputTensorInfo("Placeholder", {{SNPE_UDO_CORETYPE_CPU, activationCpuDataTypes},}, SNPE_UDO_LAYOUT_NHWC, 0, 0); //adding tensor info
+
+        //adding outputs
+        activationInfo->addOutputTensorInfo("Output", {{SNPE_UDO_CORETYPE_CPU, activationCpuDataTypes},}, SNPE_UDO_LAYOUT_NHWC, 0); //adding tensor info
+
+        // adding validation functions
+        UDO_VALIDATE_RETURN_STATUS(regLibraryInfo->registerValidationFunction(activation.operationType,
+                                                    SNPE_UDO_CORETYPE_CPU,
+                                                    std::unique_ptr<ActivationCpuValidationFunction>
+                                                        (new ActivationCpuValidationFunction(activation))))
+    }
+
+    //==============================================================================
+    // DenseSelu, a Dense layer with the Selu fused in, see SeluParams.hpp
+    //==============================================================================
+    auto denseSeluInfo = regLibraryInfo->addOperation(DENSE_SELU_OP_TYPE, SNPE_UDO_CORETYPE_CPU, 1, 1);
+
+    denseSeluInfo->addCoreInfo(SNPE_UDO_CORETYPE_CPU, SNPE_UDO_DATATYPE_FLOAT_32); //adding core info
+
+    for (size_t slot = 0; slot < DENSE_SELU_NUM_PARAMS; slot++)
+    {
+        const UdoUtil::UdoParamSpec& param = DENSE_SELU_PARAM_SCHEMA[slot];
+        if (param.paramType == SNPE_UDO_PARAMTYPE_TENSOR)
+        {
+            denseSeluInfo->addTensorParam(param.name, param.dataType, SNPE_UDO_LAYOUT_NHWC);
+        }
+        else
+        {
+            denseSeluInfo->addScalarParam(param.name, param.dataType);
+        }
+    }
+
+    denseSeluInfo->addInputTensorInfo("Placeholder", {{SNPE_UDO_CORETYPE_CPU, SNPE_UDO_DATATYPE_FLOAT_32},}, SNPE_UDO_LAYOUT_NHWC, 0, 0); //adding tensor info
+
+    denseSeluInfo->addOutputTensorInfo("Output", {{SNPE_UDO_CORETYPE_CPU, SNPE_UDO_DATATYPE_FLOAT_32},}, SNPE_UDO_LAYOUT_NHWC, 0); //adding tensor info
+
+    UDO_VALIDATE_RETURN_STATUS(regLibraryInfo->registerValidationFunction(DENSE_SELU_OP_TYPE,
+                                                SNPE_UDO_CORETYPE_CPU,
+                                                std::unique_ptr<DenseSeluCpuValidationFunction>
+                                                    (new DenseSeluCpuValidationFunction())))
+
     //==============================================================================
-    // Auto Generated Code for Selu
+    // Conv2dSelu, a Conv2D layer with the Selu fused in, see SeluParams.hpp
     //==============================================================================
-    auto SeluInfo = regLibraryInfo->addOperation("Selu", SNPE_UDO_CORETYPE_CPU, 1, 1);
+    auto conv2dSeluInfo = regLibraryInfo->addOperation(CONV2D_SELU_OP_TYPE, SNPE_UDO_CORETYPE_CPU, 1, 1);
+
+    conv2dSeluInfo->addCoreInfo(SNPE_UDO_CORETYPE_CPU, SNPE_UDO_DATATYPE_FLOAT_32); //adding core info
+
+    for (size_t slot = 0; slot < CONV2D_SELU_NUM_PARAMS; slot++)
+    {
+        const UdoUtil::UdoParamSpec& param = CONV2D_SELU_PARAM_SCHEMA[slot];
+        if (param.paramType == SNPE_UDO_PARAMTYPE_TENSOR)
+        {
+            conv2dSeluInfo->addTensorParam(param.name, param.dataType, SNPE_UDO_LAYOUT_NHWC);
+        }
+        else
+        {
+            conv2dSeluInfo->addScalarParam(param.name, param.dataType);
+        }
+    }
 
-    SeluInfo->addCoreInfo(SNPE_UDO_CORETYPE_CPU, SNPE_UDO_DATATYPE_FLOAT_16 | SNPE_UDO_DATATYPE_FLOAT_32); //adding core info
+    conv2dSeluInfo->addInputTensorInfo("Placeholder", {{SNPE_UDO_CORETYPE_CPU, SNPE_UDO_DATATYPE_FLOAT_32},}, SNPE_UDO_LAYOUT_NHWC, 0, 0); //adding tensor info
 
+    conv2dSeluInfo->addOutputTensorInfo("Output", {{SNPE_UDO_CORETYPE_CPU, SNPE_UDO_DATATYPE_FLOAT_32},}, SNPE_UDO_LAYOUT_NHWC, 0); //adding tensor info
+
+    UDO_VALIDATE_RETURN_STATUS(regLibraryInfo->registerValidationFunction(CONV2D_SELU_OP_TYPE,
+                                                SNPE_UDO_CORETYPE_CPU,
+                                                std::unique_ptr<Conv2dSeluCpuValidationFunction>
+                                                    (new Conv2dSeluCpuValidationFunction())))
+
+    //==============================================================================
+    // FusedElementwise, a chain of elementwise ops compiled from its expression param
+    //==============================================================================
+    auto fusedElementwiseInfo = regLibraryInfo->addOperation(FUSED_ELEMENTWISE_OP_TYPE, SNPE_UDO_CORETYPE_CPU, 1, 1);
 
+    fusedElementwiseInfo->addCoreInfo(SNPE_UDO_CORETYPE_CPU, SNPE_UDO_DATATYPE_FLOAT_32); //adding core info
 
-    //inputs and outputs need to be added as tensor params
+    for (size_t slot = 0; slot < FUSED_ELEMENTWISE_NUM_PARAMS; slot++)
+    {
+        const UdoUtil::UdoParamSpec& param = FUSED_ELEMENTWISE_PARAM_SCHEMA[slot];
+        if (param.paramType == SNPE_UDO_PARAMTYPE_STRING)
+        {
+            fusedElementwiseInfo->addStringParam(param.name);
+        }
+        else
+        {
+            fusedElementwiseInfo->addScalarParam(param.name, param.dataType);
+        }
+    }
 
-    SeluInfo->addInputTensorInfo("Placeholder", {{SNPE_UDO_CORETYPE_CPU, SNPE_UDO_DATATYPE_FLOAT_32},}, SNPE_UDO_LAYOUT_NHWC, 0, 0); //adding tensor info
+    fusedElementwiseInfo->addInputTensorInfo("Placeholder", {{SNPE_UDO_CORETYPE_CPU, SNPE_UDO_DATATYPE_FLOAT_32},}, SNPE_UDO_LAYOUT_NHWC, 0, 0); //adding tensor info
 
-    //adding outputs
-    SeluInfo->addOutputTensorInfo("Output", {{SNPE_UDO_CORETYPE_CPU, SNPE_UDO_DATATYPE_FLOAT_32},}, SNPE_UDO_LAYOUT_NHWC, 0); //adding tensor info
+    fusedElementwiseInfo->addOutputTensorInfo("Output", {{SNPE_UDO_CORETYPE_CPU, SNPE_UDO_DATATYPE_FLOAT_32},}, SNPE_UDO_LAYOUT_NHWC, 0); //adding tensor info
 
-    // adding validation functions
-    UDO_VALIDATE_RETURN_STATUS(regLibraryInfo->registerValidationFunction("Selu",
+    UDO_VALIDATE_RETURN_STATUS(regLibraryInfo->registerValidationFunction(FUSED_ELEMENTWISE_OP_TYPE,
                                                 SNPE_UDO_CORETYPE_CPU,
-                                                std::unique_ptr<SeluCpuValidationFunction>
-                                                    (new SeluCpuValidationFunction())))
+                                                std::unique_ptr<FusedElementwiseCpuValidationFunction>
+                                                    (new FusedElementwiseCpuValidationFunction())))
 
     UDO_VALIDATE_RETURN_STATUS(regLibraryInfo->createRegInfoStruct())
 
@@ -0,0 +1,662 @@
+//==============================================================================
+//
+// Copyright (c) 2020 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+// Host test of the UdoSimd.hpp backends. Every backend built into the test and
+// supported by the host CPU is run against the scalar backend:
+//  - primitives, half conversions and round/pow2 bit for bit, fmadd/fnmadd against
+//    the unfused or the correctly rounded result
+//  - the exp helpers and Selu fast/turbo over the boundaries of the range reduction,
+//    against the scalar backend and the double reference
+//  - every tail length up to three registers, on buffers that end at an unmapped page,
+//    against the full length result
+// Exits with 1 when a check fails.
+//
+// usage: simd-backend-test
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "utils/UdoCpuFeatures.hpp"
+#include "SimdBackendTest.hpp"
+
+namespace {
+
+using UdoUtil::Simd::Half;
+
+// fast Selu is documented within 2 ulp of the correctly rounded result, turbo within
+// 4.4e-4 relative, for results of at least 1e-30 in magnitude (UdoActivation.hpp)
+constexpr uint64_t SELU_FAST_MAX_ULP = 2;
+constexpr double SELU_TURBO_MAX_RELATIVE = 4.4e-4;
+constexpr double SELU_MIN_CHECKED_MAGNITUDE = 1e-30;
+
+// backends differ from the scalar one in fused multiply-adds only. The fast helpers
+// reduce with an exact two constant ln2, so that moves their results by a few ulp. The
+// turbo helpers reduce with a one constant ln2, whose product n * ln2 is rounded when
+// unfused, up to 2^-24 * 87 in r and so around 5e-6 relative in the result.
+constexpr uint64_t FAST_MAX_ULP_FROM_SCALAR = 4;
+constexpr double TURBO_MAX_RELATIVE_FROM_SCALAR = 1e-5;
+
+constexpr size_t MAX_REPORTED_FAILURES = 10;
+
+struct Rng
+{
+    uint64_t state = 0x9e3779b97f4a7c15ull;
+
+    uint32_t next()
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return static_cast<uint32_t>(state >> 32);
+    }
+
+    float uniform(float lo, float hi)
+    {
+        return lo + (hi - lo) * (next() >> 8) * (1.0f / 16777216.0f);
+    }
+};
+
+float
+fromBits(uint32_t bits)
+{
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+uint32_t
+toBits(float f)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+bool
+isHalfNaN(Half h)
+{
+    return (h & 0x7c00u) == 0x7c00u && (h & 0x3ffu) != 0;
+}
+
+// distance in representable floats, 0 between +0 and -0
+uint64_t
+ulpDistance(float a, float b)
+{
+    if (std::isnan(a) || std::isnan(b))
+    {
+        return std::isnan(a) && std::isnan(b) ? 0 : std::numeric_limits<uint64_t>::max();
+    }
+    const auto ordered = [](float f) {
+        const uint32_t bits = toBits(f);
+        return (bits & 0x80000000u) ? -static_cast<int64_t>(bits & 0x7fffffffu) : static_cast<int64_t>(bits);
+    };
+    const int64_t d = ordered(a) - ordered(b);
+    return static_cast<uint64_t>(d < 0 ? -d : d);
+}
+
+bool
+sameFloat(float a, float b)
+{
+    return toBits(a) == toBits(b) || (std::isnan(a) && std::isnan(b));
+}
+
+/**
+ * \brief Contiguous elements ending at an inaccessible page, so that a load or store
+ * past the last element faults instead of passing unnoticed.
+ */
+template <typename T>
+class GuardedBuffer
+{
+public:
+    explicit GuardedBuffer(size_t count)
+    {
+        const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        const size_t bytes = (count * sizeof(T) + page - 1) / page * page;
+        m_Size = bytes + page;
+        void* base = mmap(nullptr, m_Size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED)
+        {
+            m_Base = nullptr;
+            m_Data = nullptr;
+            return;
+        }
+        m_Base = static_cast<char*>(base);
+        mprotect(m_Base + bytes, page, PROT_NONE);
+        m_Data = reinterpret_cast<T*>(m_Base + bytes) - count;
+    }
+
+    ~GuardedBuffer()
+    {
+        if (m_Base != nullptr)
+        {
+            munmap(m_Base, m_Size);
+        }
+    }
+
+    GuardedBuffer(const GuardedBuffer&) = delete;
+    GuardedBuffer& operator=(const GuardedBuffer&) = delete;
+
+    T* data() { return m_Data; }
+    bool valid() const { return m_Base != nullptr; }
+
+private:
+    char* m_Base;
+    size_t m_Size;
+    T* m_Data;
+};
+
+class Checker
+{
+public:
+    explicit Checker(const char* backend) : m_Backend(backend) {}
+
+    void check(bool ok, const char* test, size_t index, const std::string& detail)
+    {
+        ++m_Checks;
+        if (ok)
+        {
+            return;
+        }
+        if (m_Failures++ < MAX_REPORTED_FAILURES)
+        {
+            std::printf("FAIL %s %s [%zu] %s\n", m_Backend, test, index, detail.c_str());
+        }
+    }
+
+    void checkFloat(bool ok, const char* test, size_t index, float input, float got, float want)
+    {
+        if (ok)
+        {
+            check(true, test, index, std::string());
+            return;
+        }
+        char detail[160];
+        std::snprintf(detail, sizeof(detail), "in %.9g (0x%08x) got %.9g (0x%08x) want %.9g (0x%08x)", input,
+                      toBits(input), got, toBits(got), want, toBits(want));
+        check(false, test, index, detail);
+    }
+
+    uint64_t checks() const { return m_Checks; }
+    uint64_t failures() const { return m_Failures; }
+
+private:
+    const char* m_Backend;
+    uint64_t m_Checks = 0;
+    uint64_t m_Failures = 0;
+};
+
+// finite values of every magnitude, signed zeros and denormals included
+std::vector<float>
+makeFiniteInputs(Rng& rng, size_t count)
+{
+    std::vector<float> values = {0.0f, -0.0f, 1.0f, -1.0f, 0.5f, -2.5f, 1e-45f, -1e-45f, 1.17549435e-38f,
+                                 -1.17549421e-38f, 3.40282347e38f, -3.40282347e38f, 16777216.0f, 1e-3f, -7.0f};
+    while (values.size() < count)
+    {
+        const float f = fromBits(rng.next());
+        if (std::isfinite(f))
+        {
+            values.push_back(f);
+        }
+    }
+    return values;
+}
+
+void
+checkBinary(Checker& checker, const char* test, SimdBinaryFn fn, SimdBinaryFn reference,
+            const std::vector<float>& a, const std::vector<float>& b)
+{
+    std::vector<float> got(a.size());
+    std::vector<float> want(a.size());
+    fn(a.data(), b.data(), got.data(), a.size());
+    reference(a.data(), b.data(), want.data(), a.size());
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        checker.checkFloat(sameFloat(got[i], want[i]), test, i, a[i], got[i], want[i]);
+    }
+}
+
+void
+checkArithmetic(Checker& checker, const SimdBackendOps& ops, const SimdBackendOps& scalar, Rng& rng)
+{
+    const std::vector<float> a = makeFiniteInputs(rng, 4096);
+    std::vector<float> b = makeFiniteInputs(rng, 4096);
+    // equal operands, where min, max and select must pick the second one
+    for (size_t i = 0; i < b.size(); i += 7)
+    {
+        b[i] = a[i];
+    }
+
+    checkBinary(checker, "add", ops.add, scalar.add, a, b);
+    checkBinary(checker, "sub", ops.sub, scalar.sub, a, b);
+    checkBinary(checker, "mul", ops.mul, scalar.mul, a, b);
+    checkBinary(checker, "div", ops.div, scalar.div, a, b);
+    checkBinary(checker, "min", ops.min, scalar.min, a, b);
+    checkBinary(checker, "max", ops.max, scalar.max, a, b);
+    checkBinary(checker, "cmpgt/select", ops.selectGreater, scalar.selectGreater, a, b);
+
+    // NaN operands of min and max, relied on by the clamps of the exp helpers
+    std::vector<float> x = {std::nanf(""), 1.0f, std::nanf(""), -3.0f, std::nanf(""), 0.0f, 2.0f, std::nanf("")};
+    std::vector<float> y = {1.0f, std::nanf(""), -2.0f, std::nanf(""), std::nanf(""), -0.0f, 5.0f, 4.0f};
+    if (ops.minMaxReturnsSecondOnNaN)
+    {
+        checkBinary(checker, "min NaN", ops.min, scalar.min, x, y);
+        checkBinary(checker, "max NaN", ops.max, scalar.max, x, y);
+    }
+    else
+    {
+        std::vector<float> got(x.size());
+        ops.min(x.data(), y.data(), got.data(), x.size());
+        for (size_t i = 0; i < x.size(); ++i)
+        {
+            const bool hasNaN = std::isnan(x[i]) || std::isnan(y[i]);
+            checker.checkFloat(!hasNaN || std::isnan(got[i]), "min NaN", i, x[i], got[i], std::nanf(""));
+        }
+    }
+}
+
+void
+checkMultiplyAdd(Checker& checker, const SimdBackendOps& ops, const SimdBackendOps& scalar, Rng& rng)
+{
+    const size_t count = 4096;
+    std::vector<float> a(count), b(count), c(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        a[i] = rng.uniform(-4.0f, 4.0f);
+        b[i] = rng.uniform(-4.0f, 4.0f);
+        // every eighth c cancels most of a * b
+        c[i] = (i % 8 == 0) ? -a[i] * b[i] * rng.uniform(0.999f, 1.001f) : rng.uniform(-16.0f, 16.0f);
+    }
+
+    std::vector<float> got(count), unfused(count);
+    ops.fmadd(a.data(), b.data(), c.data(), got.data(), count);
+    scalar.fmadd(a.data(), b.data(), c.data(), unfused.data(), count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float fused = static_cast<float>(double(a[i]) * b[i] + c[i]);
+        checker.checkFloat(sameFloat(got[i], unfused[i]) || sameFloat(got[i], fused), "fmadd", i, a[i], got[i],
+                           unfused[i]);
+    }
+
+    ops.fnmadd(a.data(), b.data(), c.data(), got.data(), count);
+    scalar.fnmadd(a.data(), b.data(), c.data(), unfused.data(), count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float fused = static_cast<float>(c[i] - double(a[i]) * b[i]);
+        checker.checkFloat(sameFloat(got[i], unfused[i]) || sameFloat(got[i], fused), "fnmadd", i, a[i], got[i],
+                           unfused[i]);
+    }
+}
+
+void
+checkUnaryExact(Checker& checker, const char* test, SimdUnaryFn fn, SimdUnaryFn reference,
+                const std::vector<float>& in)
+{
+    std::vector<float> got(in.size());
+    std::vector<float> want(in.size());
+    fn(in.data(), got.data(), in.size());
+    reference(in.data(), want.data(), in.size());
+    for (size_t i = 0; i < in.size(); ++i)
+    {
+        checker.checkFloat(sameFloat(got[i], want[i]), test, i, in[i], got[i], want[i]);
+    }
+}
+
+void
+checkRoundAndPow2(Checker& checker, const SimdBackendOps& ops, const SimdBackendOps& scalar, Rng& rng)
+{
+    // halfway cases round to even, everything stays below 2^22 in magnitude
+    std::vector<float> in = {0.0f, -0.0f, 0.5f, -0.5f, 1.5f, -1.5f, 2.5f, -2.5f, 4194303.5f, -4194303.5f,
+                             0.49999997f, -0.49999997f, 1e-40f};
+    for (int i = -200; i <= 200; ++i)
+    {
+        in.push_back(i * 0.25f);
+    }
+    while (in.size() < 4096)
+    {
+        in.push_back(rng.uniform(-4194304.0f, 4194304.0f));
+    }
+    // the scalar backend rounds -0.5 .. -0 to +0 and the instructions to -0, which is
+    // the same n for the range reductions
+    std::vector<float> got(in.size());
+    std::vector<float> want(in.size());
+    ops.round(in.data(), got.data(), in.size());
+    scalar.round(in.data(), want.data(), in.size());
+    for (size_t i = 0; i < in.size(); ++i)
+    {
+        checker.checkFloat(got[i] == want[i], "round", i, in[i], got[i], want[i]);
+    }
+
+    std::vector<float> exponents;
+    for (int n = -126; n <= 127; ++n)
+    {
+        exponents.push_back(static_cast<float>(n));
+    }
+    checkUnaryExact(checker, "pow2", ops.pow2, scalar.pow2, exponents);
+}
+
+void
+checkHalfConversions(Checker& checker, const SimdBackendOps& ops, const SimdBackendOps& scalar, Rng& rng)
+{
+    // every half
+    std::vector<Half> halves(65536);
+    for (size_t i = 0; i < halves.size(); ++i)
+    {
+        halves[i] = static_cast<Half>(i);
+    }
+    std::vector<float> got(halves.size());
+    std::vector<float> want(halves.size());
+    ops.loadHalf(halves.data(), got.data(), halves.size());
+    scalar.loadHalf(halves.data(), want.data(), halves.size());
+    for (size_t i = 0; i < halves.size(); ++i)
+    {
+        checker.checkFloat(sameFloat(got[i], want[i]), "loadHalf", i, fromBits(static_cast<uint32_t>(i)), got[i],
+                           want[i]);
+    }
+
+    // every half with its neighbours and midpoints, so that all rounding ties are hit,
+    // then random floats over the whole range
+    std::vector<float> in;
+    for (size_t i = 0; i < want.size(); ++i)
+    {
+        if (std::isfinite(want[i]))
+        {
+            const uint32_t bits = toBits(want[i]);
+            in.push_back(want[i]);
+            in.push_back(fromBits(bits + 0x1000u));
+            in.push_back(fromBits(bits + 0x0fffu));
+            in.push_back(fromBits(bits + 0x1001u));
+        }
+    }
+    in.push_back(std::numeric_limits<float>::infinity());
+    in.push_back(-std::numeric_limits<float>::infinity());
+    in.push_back(std::nanf(""));
+    for (size_t i = 0; i < 65536; ++i)
+    {
+        in.push_back(fromBits(rng.next()));
+    }
+
+    std::vector<Half> gotHalf(in.size());
+    std::vector<Half> wantHalf(in.size());
+    ops.storeHalf(in.data(), gotHalf.data(), in.size());
+    scalar.storeHalf(in.data(), wantHalf.data(), in.size());
+    for (size_t i = 0; i < in.size(); ++i)
+    {
+        const bool ok = gotHalf[i] == wantHalf[i] || (isHalfNaN(gotHalf[i]) && isHalfNaN(wantHalf[i]));
+        char detail[96];
+        std::snprintf(detail, sizeof(detail), "in %.9g (0x%08x) got 0x%04x want 0x%04x", in[i], toBits(in[i]),
+                      gotHalf[i], wantHalf[i]);
+        checker.check(ok, "storeHalf", i, ok ? std::string() : std::string(detail));
+    }
+}
+
+/**
+ * \brief Inputs around every point where the exp range reduction x = n * ln2 + r changes
+ * n, the clamp at -87, the subnormal and zero inputs, and a log-uniform sweep of the
+ * negative range.
+ */
+std::vector<float>
+makeRangeReductionInputs(Rng& rng)
+{
+    const double ln2 = 0.693147180559945309;
+    std::vector<float> in;
+    const auto addNeighbours = [&in](float x) {
+        float lo = x;
+        float hi = x;
+        in.push_back(x);
+        for (int i = 0; i < 3; ++i)
+        {
+            lo = std::nextafter(lo, -std::numeric_limits<float>::infinity());
+            hi = std::nextafter(hi, std::numeric_limits<float>::infinity());
+            in.push_back(lo);
+            in.push_back(hi);
+        }
+    };
+    for (int k = 0; k <= 127; ++k)
+    {
+        addNeighbours(static_cast<float>(-k * ln2));
+        addNeighbours(static_cast<float>(-(k + 0.5) * ln2));
+    }
+    addNeighbours(-87.0f);
+    addNeighbours(-87.5f);
+    addNeighbours(-88.0f);
+    addNeighbours(-103.0f);
+    addNeighbours(-1e-8f);
+    addNeighbours(1.0f);
+    const float specials[] = {0.0f, -0.0f, 1e-45f, -1e-45f, -1.17549435e-38f, -1e30f, -3.40282347e38f,
+                              3.40282347e38f, -std::numeric_limits<float>::infinity(),
+                              std::numeric_limits<float>::infinity()};
+    in.insert(in.end(), std::begin(specials), std::end(specials));
+    while (in.size() < 16384)
+    {
+        in.push_back(-std::exp(rng.uniform(-25.0f, 5.0f)));
+    }
+    return in;
+}
+
+void
+checkUlpFromScalar(Checker& checker, const char* test, SimdUnaryFn fn, SimdUnaryFn reference,
+                   const std::vector<float>& in, uint64_t maxUlp)
+{
+    std::vector<float> got(in.size());
+    std::vector<float> want(in.size());
+    fn(in.data(), got.data(), in.size());
+    reference(in.data(), want.data(), in.size());
+    for (size_t i = 0; i < in.size(); ++i)
+    {
+        checker.checkFloat(ulpDistance(got[i], want[i]) <= maxUlp, test, i, in[i], got[i], want[i]);
+    }
+}
+
+void
+checkRelativeFromScalar(Checker& checker, const char* test, SimdUnaryFn fn, SimdUnaryFn reference,
+                        const std::vector<float>& in, double maxRelative)
+{
+    std::vector<float> got(in.size());
+    std::vector<float> want(in.size());
+    fn(in.data(), got.data(), in.size());
+    reference(in.data(), want.data(), in.size());
+    for (size_t i = 0; i < in.size(); ++i)
+    {
+        const bool ok = sameFloat(got[i], want[i]) || std::fabs(double(got[i]) - want[i]) <= maxRelative * std::fabs(want[i]);
+        checker.checkFloat(ok, test, i, in[i], got[i], want[i]);
+    }
+}
+
+void
+checkSeluRangeReduction(Checker& checker, const SimdBackendOps& ops, const SimdBackendOps& scalar,
+                        const std::vector<float>& in)
+{
+    // the exp helpers take x <= 0, inf excepted
+    std::vector<float> nonPositive;
+    for (float x : in)
+    {
+        if (x <= 0.0f && std::isfinite(x))
+        {
+            nonPositive.push_back(x);
+        }
+    }
+    checkUlpFromScalar(checker, "expm1NonPositive", ops.expm1NonPositive, scalar.expm1NonPositive, nonPositive,
+                       FAST_MAX_ULP_FROM_SCALAR);
+    checkRelativeFromScalar(checker, "expm1NonPositiveTurbo", ops.expm1NonPositiveTurbo,
+                            scalar.expm1NonPositiveTurbo, nonPositive, TURBO_MAX_RELATIVE_FROM_SCALAR);
+    checkUlpFromScalar(checker, "expNonPositive", ops.expNonPositive, scalar.expNonPositive, nonPositive,
+                       FAST_MAX_ULP_FROM_SCALAR);
+    checkRelativeFromScalar(checker, "expNonPositiveTurbo", ops.expNonPositiveTurbo, scalar.expNonPositiveTurbo,
+                            nonPositive, TURBO_MAX_RELATIVE_FROM_SCALAR);
+
+    const UdoUtil::ActivationParams params = UdoUtil::SeluActivation::defaults();
+    std::vector<float> got(in.size());
+    std::vector<float> want(in.size());
+
+    ops.seluFast(params, in.data(), got.data(), in.size());
+    scalar.seluFast(params, in.data(), want.data(), in.size());
+    for (size_t i = 0; i < in.size(); ++i)
+    {
+        const float exact = static_cast<float>(UdoUtil::SeluActivation::reference(in[i], params));
+        checker.checkFloat(ulpDistance(got[i], want[i]) <= FAST_MAX_ULP_FROM_SCALAR, "selu fast", i, in[i], got[i],
+                           want[i]);
+        checker.checkFloat(std::fabs(exact) < SELU_MIN_CHECKED_MAGNITUDE || ulpDistance(got[i], exact) <= SELU_FAST_MAX_ULP,
+                           "selu fast reference", i, in[i], got[i], exact);
+    }
+
+    ops.seluTurbo(params, in.data(), got.data(), in.size());
+    scalar.seluTurbo(params, in.data(), want.data(), in.size());
+    for (size_t i = 0; i < in.size(); ++i)
+    {
+        // positive results are a single multiply, which overflows to the same inf
+        const double exact = UdoUtil::SeluActivation::reference(in[i], params);
+        const bool withinReference = std::fabs(exact) < SELU_MIN_CHECKED_MAGNITUDE ||
+                                     sameFloat(got[i], static_cast<float>(exact)) ||
+                                     std::fabs(got[i] - exact) <= SELU_TURBO_MAX_RELATIVE * std::fabs(exact);
+        const bool withinScalar = sameFloat(got[i], want[i]) ||
+                                  std::fabs(double(got[i]) - want[i]) <= TURBO_MAX_RELATIVE_FROM_SCALAR * std::fabs(want[i]);
+        checker.checkFloat(withinScalar, "selu turbo", i, in[i], got[i], want[i]);
+        checker.checkFloat(withinReference, "selu turbo reference", i, in[i], got[i], static_cast<float>(exact));
+    }
+}
+
+/**
+ * \brief Every count up to three registers, starting at every lane offset of the source
+ * so that both full and partial accesses are hit at each position. Inputs and outputs
+ * end at an unmapped page, and results must match the full length run bit for bit.
+ */
+void
+checkTails(Checker& checker, const SimdBackendOps& ops, const std::vector<float>& values)
+{
+    const UdoUtil::ActivationParams params = UdoUtil::SeluActivation::defaults();
+    const size_t maxCount = 3 * ops.width + 1;
+
+    std::vector<float> full(values.size());
+    ops.seluFast(params, values.data(), full.data(), values.size());
+    std::vector<float> sums(values.size());
+    ops.add(values.data(), full.data(), sums.data(), values.size());
+    std::vector<Half> halfValues(values.size());
+    ops.storeHalf(values.data(), halfValues.data(), values.size());
+    std::vector<Half> halfFull(values.size());
+    ops.seluFastHalf(params, halfValues.data(), halfFull.data(), values.size());
+
+    for (size_t count = 0; count <= maxCount; ++count)
+    {
+        GuardedBuffer<float> in(count);
+        GuardedBuffer<float> other(count);
+        GuardedBuffer<float> out(count);
+        GuardedBuffer<Half> halfIn(count);
+        GuardedBuffer<Half> halfOut(count);
+        if (!in.valid() || !other.valid() || !out.valid() || !halfIn.valid() || !halfOut.valid())
+        {
+            checker.check(false, "tail", count, "mmap failed");
+            return;
+        }
+        for (size_t offset = 0; offset < ops.width && offset + count <= values.size(); ++offset)
+        {
+            std::memcpy(in.data(), &values[offset], count * sizeof(float));
+            std::memcpy(other.data(), &full[offset], count * sizeof(float));
+            std::memcpy(halfIn.data(), &halfValues[offset], count * sizeof(Half));
+
+            ops.seluFast(params, in.data(), out.data(), count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                checker.checkFloat(sameFloat(out.data()[i], full[offset + i]), "tail selu", count, in.data()[i],
+                                   out.data()[i], full[offset + i]);
+            }
+
+            ops.add(in.data(), other.data(), out.data(), count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                checker.checkFloat(sameFloat(out.data()[i], sums[offset + i]), "tail add", count, in.data()[i],
+                                   out.data()[i], sums[offset + i]);
+            }
+
+            // in place, which transform() allows
+            ops.seluFast(params, in.data(), in.data(), count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                checker.checkFloat(sameFloat(in.data()[i], full[offset + i]), "tail selu in place", count,
+                                   values[offset + i], in.data()[i], full[offset + i]);
+            }
+
+            ops.seluFastHalf(params, halfIn.data(), halfOut.data(), count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                checker.check(halfOut.data()[i] == halfFull[offset + i], "tail selu half", count,
+                              halfOut.data()[i] == halfFull[offset + i] ? std::string() : "half result differs");
+            }
+        }
+    }
+}
+
+bool
+runBackend(const SimdBackendOps& ops, const SimdBackendOps& scalar)
+{
+    Checker checker(ops.name);
+    Rng rng;
+    checkArithmetic(checker, ops, scalar, rng);
+    checkMultiplyAdd(checker, ops, scalar, rng);
+    checkRoundAndPow2(checker, ops, scalar, rng);
+    checkHalfConversions(checker, ops, scalar, rng);
+    const std::vector<float> rangeInputs = makeRangeReductionInputs(rng);
+    checkSeluRangeReduction(checker, ops, scalar, rangeInputs);
+    checkTails(checker, ops, rangeInputs);
+    std::printf("%-8s width %2zu  checks %9llu  failures %llu\n", ops.name, ops.width,
+                static_cast<unsigned long long>(checker.checks()), static_cast<unsigned long long>(checker.failures()));
+    return checker.failures() == 0;
+}
+
+struct Backend
+{
+    const SimdBackendOps* ops;
+    const char* name;
+    bool supported;
+};
+
+} // namespace
+
+int
+main()
+{
+    const UdoUtil::CpuFeatures& cpu = UdoUtil::getCpuFeatures();
+    const SimdBackendOps scalar =
+        makeSimdBackendOps<UdoUtil::Simd::VecF32<UdoUtil::Simd::ScalarIsa>>("scalar", true);
+
+    // the scalar backend against itself still covers its tail handling and the references
+    bool passed = runBackend(scalar, scalar);
+
+    const Backend backends[] = {
+        {getSimdBackendOpsSse42(), "sse4.2", cpu.sse42},
+        {getSimdBackendOpsAvx2(), "avx2", cpu.avx2 && cpu.fma && cpu.f16c},
+        {getSimdBackendOpsAvx512(), "avx512", cpu.avx512f && cpu.avx2 && cpu.fma && cpu.f16c},
+        {getSimdBackendOpsNeon(), "neon", cpu.neon},
+    };
+    for (const Backend& backend : backends)
+    {
+        if (backend.ops == nullptr)
+        {
+            std::printf("%-8s skipped, not built for this target\n", backend.name);
+        }
+        else if (!backend.supported)
+        {
+            std::printf("%-8s skipped, not supported by this CPU\n", backend.name);
+        }
+        else
+        {
+            passed = runBackend(*backend.ops, scalar) && passed;
+        }
+    }
+    std::printf("%s\n", passed ? "PASSED" : "FAILED");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,262 @@
+//==============================================================================
+//
+// Copyright (c) 2020 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+#pragma once
+
+#include <cstddef>
+
+#include "utils/UdoActivation.hpp"
+#include "utils/UdoSimd.hpp"
+
+/**
+ * @brief Array wrappers around the primitives and math of one UdoSimd.hpp backend.
+ *
+ * Each ISA is instantiated in its own translation unit built with that instruction set
+ * enabled, like the SeluKernel<Isa>.cpp files, and only exchanges plain arrays with
+ * simd-backend-test. The scalar reference is built with the baseline flags in
+ * SimdBackendTest.cpp, so no inline code compiled for a wider ISA is shared with it.
+ *
+ * Every wrapper runs full registers over the first count / Width * Width elements
+ * and loadPartial/storePartial over the rest.
+ */
+using SimdUnaryFn = void (*)(const float* in, float* out, size_t count);
+using SimdBinaryFn = void (*)(const float* a, const float* b, float* out, size_t count);
+using SimdTernaryFn = void (*)(const float* a, const float* b, const float* c, float* out, size_t count);
+using SimdActivationFn = void (*)(const UdoUtil::ActivationParams& params, const float* in, float* out,
+                                  size_t count);
+using SimdHalfActivationFn = void (*)(const UdoUtil::ActivationParams& params, const UdoUtil::Simd::Half* in,
+                                      UdoUtil::Simd::Half* out, size_t count);
+using SimdLoadHalfFn = void (*)(const UdoUtil::Simd::Half* in, float* out, size_t count);
+using SimdStoreHalfFn = void (*)(const float* in, UdoUtil::Simd::Half* out, size_t count);
+
+struct SimdBackendOps
+{
+  const char* name;
+  size_t width;
+  // min and max return the second operand for NaN lanes, false on NEON
+  bool minMaxReturnsSecondOnNaN;
+  SimdBinaryFn add;
+  SimdBinaryFn sub;
+  SimdBinaryFn mul;
+  SimdBinaryFn div;
+  SimdBinaryFn min;
+  SimdBinaryFn max;
+  SimdBinaryFn selectGreater; // a > b ? a : b through cmpgt and select
+  SimdTernaryFn fmadd;
+  SimdTernaryFn fnmadd;
+  SimdUnaryFn round;
+  SimdUnaryFn pow2;
+  SimdUnaryFn expm1NonPositive;
+  SimdUnaryFn expm1NonPositiveTurbo;
+  SimdUnaryFn expNonPositive;
+  SimdUnaryFn expNonPositiveTurbo;
+  SimdLoadHalfFn loadHalf;
+  SimdStoreHalfFn storeHalf;
+  SimdActivationFn seluFast;
+  SimdActivationFn seluTurbo;
+  SimdHalfActivationFn seluFastHalf;
+};
+
+namespace SimdBackendTest {
+
+template <typename V>
+inline void
+binary(const float* a, const float* b, float* out, size_t count,
+       typename V::Reg (*fn)(typename V::Reg, typename V::Reg))
+{
+  size_t i = 0;
+  for (; i + V::Width <= count; i += V::Width)
+  {
+    V::store(out + i, fn(V::load(a + i), V::load(b + i)));
+  }
+  if (i < count)
+  {
+    V::storePartial(out + i, fn(V::loadPartial(a + i, count - i), V::loadPartial(b + i, count - i)), count - i);
+  }
+}
+
+template <typename V>
+inline void
+ternary(const float* a, const float* b, const float* c, float* out, size_t count,
+        typename V::Reg (*fn)(typename V::Reg, typename V::Reg, typename V::Reg))
+{
+  size_t i = 0;
+  for (; i + V::Width <= count; i += V::Width)
+  {
+    V::store(out + i, fn(V::load(a + i), V::load(b + i), V::load(c + i)));
+  }
+  if (i < count)
+  {
+    const size_t n = count - i;
+    V::storePartial(out + i, fn(V::loadPartial(a + i, n), V::loadPartial(b + i, n), V::loadPartial(c + i, n)), n);
+  }
+}
+
+template <typename V>
+void add(const float* a, const float* b, float* out, size_t count) { binary<V>(a, b, out, count, &V::add); }
+
+template <typename V>
+void sub(const float* a, const float* b, float* out, size_t count) { binary<V>(a, b, out, count, &V::sub); }
+
+template <typename V>
+void mul(const float* a, const float* b, float* out, size_t count) { binary<V>(a, b, out, count, &V::mul); }
+
+template <typename V>
+void div(const float* a, const float* b, float* out, size_t count) { binary<V>(a, b, out, count, &V::div); }
+
+template <typename V>
+void min(const float* a, const float* b, float* out, size_t count) { binary<V>(a, b, out, count, &V::min); }
+
+template <typename V>
+void max(const float* a, const float* b, float* out, size_t count) { binary<V>(a, b, out, count, &V::max); }
+
+template <typename V>
+typename V::Reg
+selectGreaterReg(typename V::Reg a, typename V::Reg b)
+{
+  return V::select(V::cmpgt(a, b), a, b);
+}
+
+template <typename V>
+void
+selectGreater(const float* a, const float* b, float* out, size_t count)
+{
+  binary<V>(a, b, out, count, &selectGreaterReg<V>);
+}
+
+template <typename V>
+void
+fmadd(const float* a, const float* b, const float* c, float* out, size_t count)
+{
+  ternary<V>(a, b, c, out, count, &V::fmadd);
+}
+
+template <typename V>
+void
+fnmadd(const float* a, const float* b, const float* c, float* out, size_t count)
+{
+  ternary<V>(a, b, c, out, count, &V::fnmadd);
+}
+
+template <typename V>
+void round(const float* in, float* out, size_t count) { UdoUtil::Simd::transform<V>(in, out, count, &V::round); }
+
+template <typename V>
+void pow2(const float* in, float* out, size_t count) { UdoUtil::Simd::transform<V>(in, out, count, &V::pow2); }
+
+template <typename V>
+void
+expm1NonPositive(const float* in, float* out, size_t count)
+{
+  UdoUtil::Simd::transform<V>(in, out, count, &UdoUtil::Simd::expm1NonPositive<V>);
+}
+
+template <typename V>
+void
+expm1NonPositiveTurbo(const float* in, float* out, size_t count)
+{
+  UdoUtil::Simd::transform<V>(in, out, count, &UdoUtil::Simd::expm1NonPositiveTurbo<V>);
+}
+
+template <typename V>
+void
+expNonPositive(const float* in, float* out, size_t count)
+{
+  UdoUtil::Simd::transform<V>(in, out, count, &UdoUtil::Simd::expNonPositive<V>);
+}
+
+template <typename V>
+void
+expNonPositiveTurbo(const float* in, float* out, size_t count)
+{
+  UdoUtil::Simd::transform<V>(in, out, count, &UdoUtil::Simd::expNonPositiveTurbo<V>);
+}
+
+template <typename V>
+typename V::Reg
+identity(typename V::Reg a)
+{
+  return a;
+}
+
+template <typename V>
+void
+loadHalf(const UdoUtil::Simd::Half* in, float* out, size_t count)
+{
+  UdoUtil::Simd::transform<V>(in, out, count, &identity<V>);
+}
+
+template <typename V>
+void
+storeHalf(const float* in, UdoUtil::Simd::Half* out, size_t count)
+{
+  UdoUtil::Simd::transform<V>(in, out, count, &identity<V>);
+}
+
+template <typename V, UdoUtil::ActivationAccuracy Mode, typename T>
+void
+selu(const UdoUtil::ActivationParams& params, const T* in, T* out, size_t count)
+{
+  UdoUtil::Simd::transform<V>(in, out, count, typename UdoUtil::SeluActivation::template Vec<V, Mode>(params));
+}
+
+} // namespace SimdBackendTest
+
+/**
+ * \brief The wrappers of backend V, instantiated by the SimdBackendTest<Isa>.cpp
+ * translation units.
+ */
+template <typename V>
+SimdBackendOps
+makeSimdBackendOps(const char* name, bool minMaxReturnsSecondOnNaN)
+{
+  using UdoUtil::ACTIVATION_ACCURACY_FAST;
+  using UdoUtil::ACTIVATION_ACCURACY_TURBO;
+  using UdoUtil::Simd::Half;
+  SimdBackendOps ops = {name,
+                        V::Width,
+                        minMaxReturnsSecondOnNaN,
+                        &SimdBackendTest::add<V>,
+                        &SimdBackendTest::sub<V>,
+                        &SimdBackendTest::mul<V>,
+                        &SimdBackendTest::div<V>,
+                        &SimdBackendTest::min<V>,
+                        &SimdBackendTest::max<V>,
+                        &SimdBackendTest::selectGreater<V>,
+                        &SimdBackendTest::fmadd<V>,
+                        &SimdBackendTest::fnmadd<V>,
+                        &SimdBackendTest::round<V>,
+                        &SimdBackendTest::pow2<V>,
+                        &SimdBackendTest::expm1NonPositive<V>,
+                        &SimdBackendTest::expm1NonPositiveTurbo<V>,
+                        &SimdBackendTest::expNonPositive<V>,
+                        &SimdBackendTest::expNonPositiveTurbo<V>,
+                        &SimdBackendTest::loadHalf<V>,
+                        &SimdBackendTest::storeHalf<V>,
+                        &SimdBackendTest::selu<V, ACTIVATION_ACCURACY_FAST, float>,
+                        &SimdBackendTest::selu<V, ACTIVATION_ACCURACY_TURBO, float>,
+                        &SimdBackendTest::selu<V, ACTIVATION_ACCURACY_FAST, Half>};
+  return ops;
+}
+
+/**
+ * \brief Accessors for the ISA specific backends. Each returns nullptr when its
+ * translation unit was built without the matching instruction set enabled, so the
+ * caller must also check the CPU before using the result.
+ */
+const SimdBackendOps*
+getSimdBackendOpsSse42();
+
+const SimdBackendOps*
+getSimdBackendOpsAvx2();
+
+const SimdBackendOps*
+getSimdBackendOpsAvx512();
+
+const SimdBackendOps*
+getSimdBackendOpsNeon();
@@ -0,0 +1,20 @@
+//==============================================================================
+// AVX2/FMA/F16C backend of simd-backend-test
+//
+// This file is compiled with -mavx2 -mfma -mf16c (see Makefile) and must only
+// instantiate the AVX2/FMA/F16C backend.
+//==============================================================================
+
+#include "SimdBackendTest.hpp"
+
+const SimdBackendOps*
+getSimdBackendOpsAvx2()
+{
+#if defined(__AVX2__) && defined(__FMA__) && defined(__F16C__)
+    using V = UdoUtil::Simd::VecF32<UdoUtil::Simd::Avx2Isa>;
+    static const SimdBackendOps ops = makeSimdBackendOps<V>("avx2", true);
+    return &ops;
+#else
+    return nullptr;
+#endif
+}
@@ -0,0 +1,20 @@
+//==============================================================================
+// AVX-512 backend of simd-backend-test
+//
+// This file is compiled with -mavx512f -mavx2 -mfma -mf16c (see Makefile) and must only
+// instantiate the AVX-512 backend.
+//==============================================================================
+
+#include "SimdBackendTest.hpp"
+
+const SimdBackendOps*
+getSimdBackendOpsAvx512()
+{
+#if defined(__AVX512F__)
+    using V = UdoUtil::Simd::VecF32<UdoUtil::Simd::Avx512Isa>;
+    static const SimdBackendOps ops = makeSimdBackendOps<V>("avx512", true);
+    return &ops;
+#else
+    return nullptr;
+#endif
+}
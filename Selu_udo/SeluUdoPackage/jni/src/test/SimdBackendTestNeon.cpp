@@ -0,0 +1,20 @@
+//==============================================================================
+// NEON backend of simd-backend-test
+//
+// NEON is part of the baseline of ARM targets, so this file needs no extra flags. It
+// must only instantiate the NEON backend.
+//==============================================================================
+
+#include "SimdBackendTest.hpp"
+
+const SimdBackendOps*
+getSimdBackendOpsNeon()
+{
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    using V = UdoUtil::Simd::VecF32<UdoUtil::Simd::NeonIsa>;
+    static const SimdBackendOps ops = makeSimdBackendOps<V>("neon", false);
+    return &ops;
+#else
+    return nullptr;
+#endif
+}
@@ -0,0 +1,20 @@
+//==============================================================================
+// SSE4.2 backend of simd-backend-test
+//
+// This file is compiled with -msse4.2 (see Makefile) and must only
+// instantiate the SSE4.2 backend.
+//==============================================================================
+
+#include "SimdBackendTest.hpp"
+
+const SimdBackendOps*
+getSimdBackendOpsSse42()
+{
+#if defined(__SSE4_1__)
+    using V = UdoUtil::Simd::VecF32<UdoUtil::Simd::Sse4Isa>;
+    static const SimdBackendOps ops = makeSimdBackendOps<V>("sse4.2", true);
+    return &ops;
+#else
+    return nullptr;
+#endif
+}
@@ -0,0 +1,203 @@
+//==============================================================================
+//
+// Copyright (c) 2020 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+#include "utils/UdoActivationOp.hpp"
+#include "utils/UdoMacros.hpp"
+#include <algorithm>
+
+using namespace UdoUtil;
+
+std::unique_ptr<UdoOperation>
+ActivationOpDef::createOp(void* perOpInfrastructure,
+                          uint32_t numOfInputs,
+                          SnpeUdo_TensorParam_t* inputs,
+                          uint32_t numOfOutputs,
+                          SnpeUdo_TensorParam_t* outputs,
+                          uint32_t numOfStaticParams,
+                          SnpeUdo_Param_t* params)
+{
+    ActivationParams activation;
+    ActivationAccuracy accuracy;
+    const SnpeUdo_ErrorType_t status = resolveActivationParams(m_Info, params, numOfStaticParams, activation, accuracy);
+    if (status != SNPE_UDO_NO_ERROR)
+    {
+        UDO_ERROR_MSG(status, m_Info.operationType << " static params do not match its schema, the optional params are an "
+                      << "integer " << ACTIVATION_ACCURACY_MODE_PARAM << " below " << ACTIVATION_NUM_ACCURACY_MODES
+                      << ", a finite " << ACTIVATION_SCALE_PARAM
+                      << (m_Info.usesAlpha ? " and a finite " : "") << (m_Info.usesAlpha ? ACTIVATION_ALPHA_PARAM : ""))
+        return nullptr;
+    }
+
+    std::shared_ptr<const ActivationQuantTable> quantTable;
+    const uint32_t bitWidth = (inputs != nullptr && numOfInputs > 0) ? getQuantizedBitWidth(inputs[0].dataType) : 0;
+    if (bitWidth != 0)
+    {
+        if (outputs == nullptr || numOfOutputs == 0 || getQuantizedBitWidth(outputs[0].dataType) != bitWidth)
+        {
+            UDO_ERROR_MSG(SNPE_UDO_UNSUPPORTED_FEATURE, m_Info.operationType
+                          << " needs a quantized output of the same width as its " << bitWidth << "-bit input")
+            return nullptr;
+        }
+        quantTable = getQuantTable(inputs[0], outputs[0], bitWidth, activation);
+        if (quantTable == nullptr)
+        {
+            UDO_ERROR_MSG(SNPE_UDO_INVALID_ARGUMENT,
+                          m_Info.operationType << " quantized tensors must have a non-empty TF encoding")
+            return nullptr;
+        }
+    }
+
+    std::unique_ptr<ActivationOp> op(new ActivationOp(m_Info, m_Kernels, inputs, numOfInputs, outputs, numOfOutputs,
+                                                      static_cast<SnpeUdo_CpuInfrastructure_t*>(perOpInfrastructure),
+                                                      numOfStaticParams, params, activation, accuracy,
+                                                      std::move(quantTable)));
+    if (op->preparePlan() != SNPE_UDO_NO_ERROR)
+    {
+        return nullptr;
+    }
+    return op;
+}
+
+std::shared_ptr<const ActivationQuantTable>
+ActivationOpDef::getQuantTable(const SnpeUdo_TensorParam_t& input, const SnpeUdo_TensorParam_t& output,
+                               uint32_t bitWidth, const ActivationParams& params)
+{
+    QuantEncoding inEncoding;
+    QuantEncoding outEncoding;
+    if (!getQuantEncoding(input, bitWidth, inEncoding) || !getQuantEncoding(output, bitWidth, outEncoding))
+    {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(m_QuantTablesMutex);
+    for (auto& cached : m_QuantTables)
+    {
+        std::shared_ptr<const ActivationQuantTable> table = cached.lock();
+        if (table != nullptr && table->bitWidth == bitWidth &&
+            table->input == inEncoding && table->output == outEncoding &&
+            table->params.alpha == params.alpha && table->params.scale == params.scale)
+        {
+            return table;
+        }
+    }
+
+    // the reference activation is evaluated in double, so the tables are exact up to
+    // the final rounding
+    const ActivationInfo& info = m_Info;
+    auto fn = [&info, &params](double x) { return info.reference(x, params); };
+    std::shared_ptr<ActivationQuantTable> table = std::make_shared<ActivationQuantTable>();
+    table->bitWidth = bitWidth;
+    table->input = inEncoding;
+    table->output = outEncoding;
+    table->params = params;
+    if (bitWidth == 8)
+    {
+        buildTable8(inEncoding, outEncoding, fn, table->lut8);
+    }
+    else
+    {
+        // the ELU family has its kink at 0, which the TF encoding represents exactly at
+        // zeroPoint; kinks elsewhere, such as HardSwish's at +-3, fall inside a segment
+        buildInterpTable16(inEncoding, outEncoding, inEncoding.zeroPoint, fn, table->interp16);
+    }
+
+    m_QuantTables.erase(std::remove_if(m_QuantTables.begin(), m_QuantTables.end(),
+                                       [](const std::weak_ptr<const ActivationQuantTable>& cached)
+                                       { return cached.expired(); }),
+                        m_QuantTables.end());
+    m_QuantTables.push_back(table);
+    return table;
+}
+
+SnpeUdo_ErrorType_t
+ActivationOp::prepare()
+{
+    const SnpeUdo_TensorParam_t& input = *m_Inputs[0];
+    const SnpeUdo_TensorParam_t& output = *m_Outputs[0];
+
+    // FLOAT_16 tensors are converted to float32 in registers, so mixed precision
+    // between input and output costs nothing extra
+    const ActivationFloatKernels& floatKernels = m_Kernels.modes[m_Accuracy];
+    ActivationKernelFn run = nullptr;
+    const void* table = nullptr;
+    size_t elementSize = 0;
+    if (input.dataType == SNPE_UDO_DATATYPE_FLOAT_32 && output.dataType == SNPE_UDO_DATATYPE_FLOAT_32)
+    {
+        run = floatKernels.f32;
+        elementSize = sizeof(float);
+    }
+    else if (input.dataType == SNPE_UDO_DATATYPE_FLOAT_16 && output.dataType == SNPE_UDO_DATATYPE_FLOAT_16)
+    {
+        run = floatKernels.f16;
+        elementSize = sizeof(Simd::Half);
+    }
+    else if (input.dataType == SNPE_UDO_DATATYPE_FLOAT_16 && output.dataType == SNPE_UDO_DATATYPE_FLOAT_32)
+    {
+        run = floatKernels.f16ToF32;
+        elementSize = sizeof(float);
+    }
+    else if (input.dataType == SNPE_UDO_DATATYPE_FLOAT_32 && output.dataType == SNPE_UDO_DATATYPE_FLOAT_16)
+    {
+        run = floatKernels.f32ToF16;
+        elementSize = sizeof(Simd::Half);
+    }
+    else if (m_QuantTable != nullptr && m_QuantTable->bitWidth == 8)
+    {
+        run = m_Kernels.lut8;
+        table = m_QuantTable->lut8;
+        elementSize = sizeof(uint8_t);
+    }
+    else if (m_QuantTable != nullptr && m_QuantTable->bitWidth == 16)
+    {
+        run = m_Kernels.interp16;
+        table = &m_QuantTable->interp16;
+        elementSize = sizeof(uint16_t);
+    }
+    UDO_VALIDATE_MSG(run == nullptr,
+                     SNPE_UDO_UNSUPPORTED_FEATURE,
+                     "Unsupported " << m_Info.operationType << " data types "
+                     << input.dataType << " -> " << output.dataType)
+
+    UDO_VALIDATE_MSG(input.tensorRank != output.tensorRank,
+                     SNPE_UDO_WRONG_NUM_OF_DIMENSIONS,
+                     m_Info.operationType << " input and output ranks differ")
+
+    m_Plan.elementSize = elementSize;
+    m_Plan.args.table = table;
+    m_Plan.args.params = m_Activation;
+    m_Plan.run = run;
+    return SNPE_UDO_NO_ERROR;
+}
+
+SnpeUdo_ErrorType_t
+ActivationOp::reshape()
+{
+    const SnpeUdo_TensorParam_t& input = *m_Inputs[0];
+    const SnpeUdo_TensorParam_t& output = *m_Outputs[0];
+    const size_t elementCount = getElementCount(output.currDimensions, output.tensorRank);
+    UDO_VALIDATE_MSG(getElementCount(input.currDimensions, input.tensorRank) != elementCount,
+                     SNPE_UDO_INVALID_ARGUMENT,
+                     m_Info.operationType << " input and output shapes differ")
+
+    // the activation is elementwise, so each thread gets a contiguous slice of the tensor
+    m_Plan.partition = partitionElements(elementCount, m_Plan.elementSize);
+    return SNPE_UDO_NO_ERROR;
+}
+
+void
+ActivationOp::runPlan(const void* in, void* out)
+{
+    const ActivationKernelFn run = m_Plan.run;
+    ActivationKernelArgs args = m_Plan.args;
+    args.in = in;
+    args.out = out;
+    parallelForPartition(m_Plan.partition, [run, &args](size_t begin, size_t end)
+    {
+        run(args, begin, end);
+    });
+}
@@ -0,0 +1,202 @@
+//==============================================================================
+//
+// Copyright (c) 2020 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+#include "utils/UdoAllocCheck.hpp"
+
+#ifdef UDO_CHECK_EXECUTE_ALLOCATIONS
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <unistd.h>
+
+#if !defined(__GLIBC__)
+#error "UDO_CHECK_EXECUTE_ALLOCATIONS replaces malloc through glibc's __libc_malloc family"
+#endif
+
+extern "C"
+{
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+}
+
+namespace UdoUtil {
+
+// Only the CPU library is built with the replacements, the registration library leaves
+// this file out. Initial-exec TLS is a fixed offset from the thread pointer, so reading
+// it inside malloc never allocates the thread's TLS block lazily.
+__thread int t_NoAllocDepth __attribute__((tls_model("initial-exec"))) = 0;
+bool allocChecksActive = false;
+
+}
+
+using UdoUtil::t_NoAllocDepth;
+using UdoUtil::allocChecksActive;
+
+namespace {
+
+void
+checkAllocation(const char* function, size_t size)
+{
+    allocChecksActive = true;
+    if (t_NoAllocDepth > 0)
+    {
+        // no stream or printf family call that might allocate in turn
+        t_NoAllocDepth = 0;
+        char text[160];
+        const int length = std::snprintf(text, sizeof(text),
+                                         "ERROR: %s of %zu bytes inside SnpeUdo_executeOp, aborting\n",
+                                         function, size);
+        if (length > 0)
+        {
+            const ssize_t written = write(STDERR_FILENO, text, static_cast<size_t>(length));
+            (void)written;
+        }
+        std::abort();
+    }
+}
+
+void*
+allocateChecked(const char* function, size_t size)
+{
+    checkAllocation(function, size);
+    void* ptr = __libc_malloc(size > 0 ? size : 1);
+    if (ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+// reports a library that is only opened with dlopen, whose replacements the rest of
+// the process, and the library itself, do not call
+__attribute__((constructor)) void
+checkInterposed()
+{
+    void* (*volatile allocate)(size_t) = &malloc;
+    std::free(allocate(1));
+    if (!allocChecksActive)
+    {
+        std::fprintf(stderr, "WARNING: execute allocation checks are inactive, link or LD_PRELOAD the library\n");
+    }
+}
+
+} // namespace
+
+extern "C"
+{
+
+void*
+malloc(size_t size)
+{
+    checkAllocation("malloc", size);
+    return __libc_malloc(size);
+}
+
+void*
+calloc(size_t count, size_t size)
+{
+    checkAllocation("calloc", count * size);
+    return __libc_calloc(count, size);
+}
+
+void*
+realloc(void* ptr, size_t size)
+{
+    checkAllocation("realloc", size);
+    return __libc_realloc(ptr, size);
+}
+
+void*
+memalign(size_t alignment, size_t size)
+{
+    checkAllocation("memalign", size);
+    return __libc_memalign(alignment, size);
+}
+
+void*
+aligned_alloc(size_t alignment, size_t size)
+{
+    checkAllocation("aligned_alloc", size);
+    return __libc_memalign(alignment, size);
+}
+
+int
+posix_memalign(void** ptr, size_t alignment, size_t size)
+{
+    checkAllocation("posix_memalign", size);
+    if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0)
+    {
+        return EINVAL;
+    }
+    void* block = __libc_memalign(alignment, size);
+    if (block == nullptr)
+    {
+        return ENOMEM;
+    }
+    *ptr = block;
+    return 0;
+}
+
+} // extern "C"
+
+void*
+operator new(size_t size)
+{
+    return allocateChecked("operator new", size);
+}
+
+void*
+operator new[](size_t size)
+{
+    return allocateChecked("operator new[]", size);
+}
+
+void*
+operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    checkAllocation("operator new", size);
+    return __libc_malloc(size > 0 ? size : 1);
+}
+
+void*
+operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    checkAllocation("operator new[]", size);
+    return __libc_malloc(size > 0 ? size : 1);
+}
+
+void
+operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+UdoUtil::UdoNoAllocScope::UdoNoAllocScope() {
+    t_NoAllocDepth++;
+}
+
+UdoUtil::UdoNoAllocScope::~UdoNoAllocScope() {
+    t_NoAllocDepth--;
+}
+
+bool
+UdoUtil::isNoAllocScope() {
+    return t_NoAllocDepth > 0;
+}
+
+#endif // UDO_CHECK_EXECUTE_ALLOCATIONS
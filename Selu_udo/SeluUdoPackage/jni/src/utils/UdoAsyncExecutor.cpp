@@ -0,0 +1,65 @@
+//==============================================================================
+//
+// Copyright (c) 2019 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+#include "utils/UdoAsyncExecutor.hpp"
+
+using namespace UdoUtil;
+
+UdoAsyncExecutor::UdoAsyncExecutor()
+        : m_Thread(&UdoAsyncExecutor::workerLoop, this) {
+}
+
+UdoAsyncExecutor::~UdoAsyncExecutor() {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stop = true;
+    }
+    m_Cv.notify_one();
+    m_Thread.join();
+}
+
+void
+UdoAsyncExecutor::submit(Job* job) {
+    job->next = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_Tail != nullptr)
+        {
+            m_Tail->next = job;
+        }
+        else
+        {
+            m_Head = job;
+        }
+        m_Tail = job;
+    }
+    m_Cv.notify_one();
+}
+
+void
+UdoAsyncExecutor::workerLoop() {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    for (;;)
+    {
+        m_Cv.wait(lock, [this]() { return m_Head != nullptr || m_Stop; });
+        if (m_Head == nullptr)
+        {
+            return; // stopping and drained
+        }
+        Job* job = m_Head;
+        m_Head = job->next;
+        if (m_Head == nullptr)
+        {
+            m_Tail = nullptr;
+        }
+        lock.unlock();
+        // the job may be released by its owner as soon as run() signals completion
+        job->run(job);
+        lock.lock();
+    }
+}
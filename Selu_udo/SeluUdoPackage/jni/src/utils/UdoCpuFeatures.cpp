@@ -0,0 +1,85 @@
+//==============================================================================
+//
+// Copyright (c) 2019 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+#include "utils/UdoCpuFeatures.hpp"
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+using namespace UdoUtil;
+
+namespace {
+
+#if defined(__x86_64__) || defined(__i386__)
+
+// xgetbv is encoded by hand so that the file builds without -mxsave
+uint64_t
+readXcr0()
+{
+    uint32_t eax = 0;
+    uint32_t edx = 0;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+}
+
+CpuFeatures
+detectCpuFeatures()
+{
+    CpuFeatures features;
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    {
+        return features;
+    }
+
+    const bool osxsave = (ecx & bit_OSXSAVE) != 0;
+    const uint64_t xcr0 = osxsave ? readXcr0() : 0;
+    // XMM and YMM state, plus opmask and both halves of the ZMM state for AVX-512
+    const bool ymmEnabled = (xcr0 & 0x6) == 0x6;
+    const bool zmmEnabled = (xcr0 & 0xe6) == 0xe6;
+
+    features.sse42 = (ecx & bit_SSE4_2) != 0;
+    features.avx = ymmEnabled && (ecx & bit_AVX) != 0;
+    features.fma = features.avx && (ecx & bit_FMA) != 0;
+    features.f16c = features.avx && (ecx & bit_F16C) != 0;
+
+    if (__get_cpuid_max(0, nullptr) >= 7)
+    {
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        features.avx2 = features.avx && (ebx & bit_AVX2) != 0;
+        features.avx512f = zmmEnabled && (ebx & bit_AVX512F) != 0;
+    }
+    return features;
+}
+
+#else
+
+CpuFeatures
+detectCpuFeatures()
+{
+    CpuFeatures features;
+#if defined(__aarch64__) || defined(__ARM_NEON) || defined(__ARM_NEON__)
+    features.neon = true;
+#endif
+    return features;
+}
+
+#endif
+
+} // namespace
+
+const CpuFeatures&
+UdoUtil::getCpuFeatures()
+{
+    static const CpuFeatures features = detectCpuFeatures();
+    return features;
+}
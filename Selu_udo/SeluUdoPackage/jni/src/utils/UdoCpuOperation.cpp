@@ -7,72 +7,15 @@
 //==============================================================================
 
 #include <utils/UdoCpuOperation.hpp>
+#include "utils/UdoAllocCheck.hpp"
 #include "utils/UdoMacros.hpp"
-#include <iostream>
+#include "utils/UdoStaticTensorStore.hpp"
+#include "utils/UdoUtil.hpp"
 #include <cstring>
 #include <algorithm>
-#include <numeric>
 
 using namespace UdoUtil;
 
-SnpeUdo_ErrorType_t
-copyTensorParam(const SnpeUdo_TensorParam_t &srcParam, SnpeUdo_TensorParam_t &destParam, bool copyData=false) {
-    destParam.dataType = srcParam.dataType;
-    destParam.layout = srcParam.layout;
-    destParam.quantizeParams = srcParam.quantizeParams;
-    destParam.tensorRank = srcParam.tensorRank;
-
-
-    UDO_VALIDATE_MSG(srcParam.maxDimensions == nullptr || srcParam.currDimensions == nullptr,
-                     SNPE_UDO_INVALID_ARGUMENT,
-                     "Provided dimensions are null")
-
-    auto dimSize = srcParam.tensorRank;
-    auto dimByteSize = dimSize * sizeof(uint32_t);
-    destParam.currDimensions = new uint32_t[srcParam.tensorRank];
-    destParam.maxDimensions = new uint32_t[srcParam.tensorRank];
-
-    std::memcpy(destParam.maxDimensions,
-                srcParam.maxDimensions,
-                dimByteSize);
-    std::memcpy(destParam.currDimensions,
-                srcParam.currDimensions,
-                dimByteSize);
-
-    const std::map<SnpeUdo_DataType_t, size_t> dataTypeToSize = {
-            {SNPE_UDO_DATATYPE_INT_8, 1},
-            {SNPE_UDO_DATATYPE_INT_16, 2},
-            {SNPE_UDO_DATATYPE_INT_32, 4},
-            {SNPE_UDO_DATATYPE_UINT_8, 1},
-            {SNPE_UDO_DATATYPE_UINT_16, 2},
-            {SNPE_UDO_DATATYPE_UINT_32, 4},
-            {SNPE_UDO_DATATYPE_FLOAT_16, 2},
-            {SNPE_UDO_DATATYPE_FLOAT_32, 4},
-            {SNPE_UDO_DATATYPE_FIXED_4, 1},
-            {SNPE_UDO_DATATYPE_FIXED_8, 1},
-            {SNPE_UDO_DATATYPE_FIXED_16, 2},
-            {SNPE_UDO_DATATYPE_FIXED_32, 4}
-    };
-
-    if (copyData)
-    {
-        auto dataDimSize = std::accumulate(srcParam.currDimensions,
-                                           srcParam.currDimensions + dimSize,
-                                           dataTypeToSize.find(srcParam.dataType)->second,
-                                           std::multiplies<size_t>());
-
-        // logic here is based on data being received as a uint8_t from Param Span
-        destParam.tensorData = (uint8_t*)malloc(dataDimSize);
-        std::memcpy(destParam.tensorData,
-                    reinterpret_cast<uint8_t*>(srcParam.tensorData),
-                    dataDimSize);
-    }else {
-        destParam.tensorData = srcParam.tensorData; // this is done for inputs and outputs, which cannot be copied here
-    }
-
-    return SNPE_UDO_NO_ERROR;
-}
-
 UdoCpuOperation::UdoCpuOperation(SnpeUdo_TensorParam_t* inputs,
                                  uint32_t numOfInputs,
                                  SnpeUdo_TensorParam_t* outputs,
@@ -93,51 +36,254 @@ UdoCpuOperation::UdoCpuOperation(SnpeUdo_TensorParam_t* inputs,
                    SNPE_UDO_INVALID_ARGUMENT,
                    "Infrastructure provided to function is null")
 
-    m_Inputs.resize(numOfInputs);
-    m_Outputs.resize(numOfOutputs);
+    m_PerOpFactoryInfrastructure = infrastructure;
+    m_NumOfStaticParams = numOfStaticParams;
+    m_AsyncJob.op = this;
+    if (inputs == nullptr) { numOfInputs = 0; }
+    if (outputs == nullptr) { numOfOutputs = 0; }
+    if (params == nullptr) { numOfStaticParams = 0; }
 
-    for (uint32_t idx = 0; idx < m_Inputs.size(); idx++)
+    // size everything first, so that the metadata takes a single allocation
+    m_Arena.reserve<SnpeUdo_TensorParam_t*>(numOfInputs + numOfOutputs);
+    m_Arena.reserve<SnpeUdo_TensorParam_t>(numOfInputs + numOfOutputs);
+    for (uint32_t idx = 0; idx < numOfInputs; idx++)
+    {
+        reserveTensorParam(inputs[idx], m_Arena, false);
+    }
+    for (uint32_t idx = 0; idx < numOfOutputs; idx++)
+    {
+        reserveTensorParam(outputs[idx], m_Arena, false);
+    }
+    // static tensor data goes to the library's store, shared with every op using the
+    // same tensors, only the metadata is the op's own
+    UdoStaticTensorStore* store = getImplementationStaticTensorStore();
+    reserveStaticParams(params, numOfStaticParams, m_Arena, store);
+    if (!m_Arena.commit())
     {
-        m_Inputs[idx] =  new SnpeUdo_TensorParam_t();
-        copyTensorParam(inputs[idx], *m_Inputs[idx]);
+        // leaves the op without tensors, which execute rejects
+        UDO_ERROR_MSG(SNPE_UDO_MEM_ALLOC_ERROR,
+                      "Could not allocate " << m_Arena.getCapacity() << " bytes of operation metadata")
+        return;
     }
 
-    for (std::size_t idx = 0; idx < m_Outputs.size(); idx++)
+    SnpeUdo_TensorParam_t** tensorPtrs = m_Arena.allocate<SnpeUdo_TensorParam_t*>(numOfInputs + numOfOutputs);
+    SnpeUdo_TensorParam_t* tensors = m_Arena.allocate<SnpeUdo_TensorParam_t>(numOfInputs + numOfOutputs);
+    bool tensorsValid = true;
+    for (uint32_t idx = 0; idx < numOfInputs + numOfOutputs; idx++)
     {
-        m_Outputs[idx] =  new SnpeUdo_TensorParam_t();
-        copyTensorParam(outputs[idx], *m_Outputs[idx]);
+        const SnpeUdo_TensorParam_t& src = idx < numOfInputs ? inputs[idx] : outputs[idx - numOfInputs];
+        tensorPtrs[idx] = &tensors[idx];
+        tensorsValid = copyTensorParam(src, tensors[idx], m_Arena) == SNPE_UDO_NO_ERROR && tensorsValid;
+    }
+    if (tensorsValid)
+    {
+        m_Inputs = ArenaSpan<SnpeUdo_TensorParam_t*>(tensorPtrs, numOfInputs);
+        m_Outputs = ArenaSpan<SnpeUdo_TensorParam_t*>(tensorPtrs + numOfInputs, numOfOutputs);
     }
 
-    m_PerOpFactoryInfrastructure = infrastructure;
-    m_NumOfStaticParams = numOfStaticParams;
-    if (numOfStaticParams > 0 && params != nullptr)
+    SnpeUdo_Param_t* staticParams = copyStaticParams(params, numOfStaticParams, m_Arena, store, m_StaticTensors);
+    m_Params = ArenaSpan<SnpeUdo_Param_t>(staticParams, numOfStaticParams);
+}
+
+SnpeUdo_ErrorType_t
+UdoCpuOperation::snpeUdoSetParallelism(uint32_t maxThreads, size_t grainSize) {
+    // the plan records both and is rebuilt by the next execute when they change
+    waitForCompletion();
+    m_MaxThreads = maxThreads;
+    m_GrainSize = grainSize > 0 ? grainSize : DEFAULT_GRAIN_SIZE;
+    return SNPE_UDO_NO_ERROR;
+}
+
+SnpeUdo_ErrorType_t
+UdoCpuOperation::snpeUdoExecute(bool blocking, uint32_t id, SnpeUdo_ExternalNotify_t notifyFunc) {
+    // a previous non-blocking execute may still be running on the plan
+    waitForCompletion();
+    m_Profiler.beginCall();
+    if(m_Inputs.empty() || m_Outputs.empty() || !m_PerOpFactoryInfrastructure) { return SNPE_UDO_INVALID_ARGUMENT; }
+
+    if (!isPlanCurrent())
     {
-        for (std::size_t idx = 0; idx < numOfStaticParams; idx++)
+        UDO_VALIDATE_RETURN_STATUS(preparePlan())
+    }
+    else
+    {
+        if (!isBindingCurrent())
+        {
+            // double buffering: only the data pointers change
+            rebindPlan();
+        }
+        if (!isShapeCurrent())
         {
-            std::string paramName = const_cast<char*>(params[idx].paramName);
-            m_Params[paramName] =  new SnpeUdo_Param_t();
-            m_Params[paramName]->paramType = params[idx].paramType;
-            m_Params[paramName]->paramName = params[idx].paramName;
-            switch (params[idx].paramType)
-            {
-                case SNPE_UDO_PARAMTYPE_TENSOR:
-                    copyTensorParam(params[idx].tensorParam, m_Params[paramName]->tensorParam, true);
-                    break;
-                case SNPE_UDO_PARAMTYPE_STRING:
-                    m_Params[paramName]->stringParam = params[idx].stringParam;
-                    break;
-                case SNPE_UDO_PARAMTYPE_SCALAR:
-                    m_Params[paramName]->scalarParam = params[idx].scalarParam;
-                    break;
-                default:
-                {
-                    std::cerr << "ERROR: Function: "
-                              << __FUNCTION__ << " Unknown param type for param: " << paramName
-                              << std::endl;
-                }
-            }
+            // variable batch and friends: only the shape dependent parts change
+            UDO_VALIDATE_RETURN_STATUS(reshapePlan())
         }
     }
+    if ((m_PlanState.inCount > 0 && m_PlanState.in == nullptr) ||
+        (m_PlanState.outCount > 0 && m_PlanState.out == nullptr))
+    {
+        return SNPE_UDO_INVALID_ARGUMENT;
+    }
+    m_Profiler.endSetup();
+
+    // errors are reported before returning, the background part cannot fail
+    if (!blocking)
+    {
+        return submitAsync(&UdoCpuOperation::runPlanned, id, notifyFunc);
+    }
+    return runPlanned(this);
+}
+
+SnpeUdo_ErrorType_t
+UdoCpuOperation::preparePlan() {
+    UDO_VALIDATE_MSG(m_Inputs.empty() || m_Outputs.empty() || m_PerOpFactoryInfrastructure == nullptr,
+                     SNPE_UDO_INVALID_ARGUMENT,
+                     "Operation needs an input, an output and the CPU infrastructure")
+
+    // the plan only becomes usable once its shape checks out
+    m_PlanState.ready = false;
+    UDO_VALIDATE_RETURN_STATUS(prepare())
+
+    const SnpeUdo_TensorParam_t& input = *m_Inputs[0];
+    const SnpeUdo_TensorParam_t& output = *m_Outputs[0];
+    m_PlanState.inShape.assign(input.currDimensions, input.currDimensions + input.tensorRank);
+    m_PlanState.outShape.assign(output.currDimensions, output.currDimensions + output.tensorRank);
+    m_PlanState.maxThreads = m_MaxThreads;
+    m_PlanState.grainSize = m_GrainSize;
+    rebindPlan();
+    UDO_VALIDATE_RETURN_STATUS(reshapePlan())
+    m_PlanState.ready = true;
+    return SNPE_UDO_NO_ERROR;
+}
+
+SnpeUdo_ErrorType_t
+UdoCpuOperation::reshapePlan() {
+    const SnpeUdo_TensorParam_t& input = *m_Inputs[0];
+    const SnpeUdo_TensorParam_t& output = *m_Outputs[0];
+    UDO_VALIDATE_MSG(!fitsMaxDimensions(input) || !fitsMaxDimensions(output),
+                     SNPE_UDO_INVALID_ARGUMENT,
+                     "Current shape exceeds the max shape the buffers were sized for")
+
+    UDO_VALIDATE_RETURN_STATUS(reshape())
+
+    std::copy(input.currDimensions, input.currDimensions + input.tensorRank, m_PlanState.inShape.begin());
+    std::copy(output.currDimensions, output.currDimensions + output.tensorRank, m_PlanState.outShape.begin());
+    m_PlanState.inCount = getElementCount(input.currDimensions, input.tensorRank);
+    m_PlanState.outCount = getElementCount(output.currDimensions, output.tensorRank);
+    return SNPE_UDO_NO_ERROR;
+}
+
+void
+UdoCpuOperation::rebindPlan() {
+    m_PlanState.inHandle = m_Inputs[0]->tensorData;
+    m_PlanState.outHandle = m_Outputs[0]->tensorData;
+    m_PlanState.in = m_PerOpFactoryInfrastructure->getData(m_PlanState.inHandle);
+    m_PlanState.out = m_PerOpFactoryInfrastructure->getData(m_PlanState.outHandle);
+}
+
+bool
+UdoCpuOperation::isPlanCurrent() const {
+    // setIo keeps data types and ranks, so only the parallelism settings invalidate it
+    return m_PlanState.ready &&
+           m_PlanState.maxThreads == m_MaxThreads &&
+           m_PlanState.grainSize == m_GrainSize;
+}
+
+bool
+UdoCpuOperation::isBindingCurrent() const {
+    return m_PlanState.inHandle == m_Inputs[0]->tensorData &&
+           m_PlanState.outHandle == m_Outputs[0]->tensorData;
+}
+
+bool
+UdoCpuOperation::isShapeCurrent() const {
+    // the input shape is not always implied by the output's, convolutions for one
+    return std::equal(m_PlanState.inShape.begin(), m_PlanState.inShape.end(), m_Inputs[0]->currDimensions) &&
+           std::equal(m_PlanState.outShape.begin(), m_PlanState.outShape.end(), m_Outputs[0]->currDimensions);
+}
+
+SnpeUdo_ErrorType_t
+UdoCpuOperation::runPlanned(UdoCpuOperation* op) {
+    op->m_Profiler.beginKernel();
+    op->runPlan(op->m_PlanState.in, op->m_PlanState.out);
+    op->endProfiledCall();
+    return SNPE_UDO_NO_ERROR;
+}
+
+UdoTaskScheduler*
+UdoCpuOperation::getTaskScheduler() {
+    return getImplementationTaskScheduler();
+}
+
+SnpeUdo_ErrorType_t
+UdoCpuOperation::submitAsync(AsyncFn fn, uint32_t id, SnpeUdo_ExternalNotify_t notifyFunc) {
+    UDO_VALIDATE_MSG(fn == nullptr,
+                     SNPE_UDO_INVALID_ARGUMENT,
+                     "Async function provided is null")
+
+    {
+        std::lock_guard<std::mutex> lock(m_AsyncMutex);
+        UDO_VALIDATE_MSG(m_AsyncPending.load(std::memory_order_relaxed),
+                         SNPE_UDO_INVALID_ARGUMENT,
+                         "An async execute is already in flight for this operation")
+        m_AsyncPending.store(true, std::memory_order_relaxed);
+    }
+    m_AsyncJob.run = &UdoCpuOperation::runAsyncJob;
+    m_AsyncJob.fn = fn;
+    m_AsyncJob.id = id;
+    m_AsyncJob.notifyFunc = notifyFunc;
+
+    UdoAsyncExecutor* executor = getImplementationAsyncExecutor();
+    if (executor == nullptr)
+    {
+        // no library to own a background thread, complete on the caller
+        runAsyncJob(&m_AsyncJob);
+        return SNPE_UDO_NO_ERROR;
+    }
+    executor->submit(&m_AsyncJob);
+    return SNPE_UDO_NO_ERROR;
+}
+
+void
+UdoCpuOperation::runAsyncJob(UdoAsyncExecutor::Job* job) {
+    AsyncJob* asyncJob = static_cast<AsyncJob*>(job);
+    UdoCpuOperation* op = asyncJob->op;
+    const uint32_t id = asyncJob->id;
+    const SnpeUdo_ExternalNotify_t notifyFunc = asyncJob->notifyFunc;
+
+    SnpeUdo_ErrorType_t status;
+    {
+        // the background half of a non-blocking execute, under the same contract
+        UdoNoAllocScope noAlloc;
+        status = asyncJob->fn(op);
+    }
+    UDO_ASSERT_MSG(status != SNPE_UDO_NO_ERROR,
+                   status,
+                   "Async execute " << id << " failed")
+
+    {
+        // notify under the lock: once it is released a waiter may destroy the op
+        std::lock_guard<std::mutex> lock(op->m_AsyncMutex);
+        op->m_AsyncPending.store(false, std::memory_order_release);
+        op->m_AsyncCv.notify_all();
+    }
+    // the op may be gone from here on, so the runtime can release or re-execute it
+    // from inside the callback
+    if (notifyFunc != nullptr)
+    {
+        notifyFunc(id);
+    }
+}
+
+void
+UdoCpuOperation::waitForCompletion() {
+    // every blocking execute starts here, so an op without an async execute in flight
+    // must not take the lock; the acquire pairs with the release in runAsyncJob
+    if (!m_AsyncPending.load(std::memory_order_acquire))
+    {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(m_AsyncMutex);
+    m_AsyncCv.wait(lock, [this]() { return !m_AsyncPending.load(std::memory_order_relaxed); });
 }
 
 SnpeUdo_ErrorType_t
@@ -146,57 +292,157 @@ UdoCpuOperation::snpeUdoProfile(uint32_t* executionTime) {
                      SNPE_UDO_INVALID_ARGUMENT,
                      "Execution time provided is not valid")
 
+    // report the last execute, including one still running in the background
+    waitForCompletion();
     *executionTime = m_ExecutionTime;
     return SNPE_UDO_NO_ERROR;
 }
 
+SnpeUdo_ErrorType_t
+UdoCpuOperation::snpeUdoProfileStats(UdoProfileStats_t* stats) {
+    UDO_VALIDATE_MSG(stats == nullptr,
+                     SNPE_UDO_INVALID_ARGUMENT,
+                     "Profile stats provided are not valid")
+
+    waitForCompletion();
+    m_Profiler.getStats(*stats);
+    return SNPE_UDO_NO_ERROR;
+}
+
+SnpeUdo_ErrorType_t
+UdoCpuOperation::snpeUdoResetProfileStats() {
+    waitForCompletion();
+    m_Profiler.reset();
+    m_LatencyHistogram.reset();
+    return SNPE_UDO_NO_ERROR;
+}
+
+SnpeUdo_ErrorType_t
+UdoCpuOperation::checkRebind(const SnpeUdo_TensorParam_t& srcParam, const SnpeUdo_TensorParam_t& destParam) {
+    UDO_VALIDATE_MSG(srcParam.maxDimensions == nullptr || srcParam.currDimensions == nullptr,
+                     SNPE_UDO_INVALID_ARGUMENT,
+                     "Provided dimensions are null")
+
+    UDO_VALIDATE_MSG(srcParam.dataType != destParam.dataType,
+                     SNPE_UDO_UNSUPPORTED_FEATURE,
+                     "Rebound tensor has data type " << srcParam.dataType << ", the operation was created for "
+                     << destParam.dataType)
+
+    UDO_VALIDATE_MSG(srcParam.tensorRank != destParam.tensorRank,
+                     SNPE_UDO_WRONG_NUM_OF_DIMENSIONS,
+                     "Rebound tensor has rank " << srcParam.tensorRank << ", the operation was created for "
+                     << destParam.tensorRank)
+
+    UDO_VALIDATE_MSG(!fitsMaxDimensions(srcParam),
+                     SNPE_UDO_INVALID_ARGUMENT,
+                     "Rebound tensor's current shape exceeds its max shape")
+
+    return SNPE_UDO_NO_ERROR;
+}
+
 SnpeUdo_ErrorType_t
 UdoCpuOperation::snpeUdoSetIo(SnpeUdo_TensorParam_t* inputs, SnpeUdo_TensorParam_t* outputs) {
-    //TODO: This function is never used, we should consider removing it
     UDO_VALIDATE_MSG(inputs == nullptr || m_Inputs.empty(),
                      SNPE_UDO_WRONG_NUM_OF_INPUTS,
                      "Input provided to function is null")
 
     UDO_VALIDATE_MSG(outputs == nullptr || m_Outputs.empty(),
-                     SNPE_UDO_WRONG_NUM_OF_INPUTS,
+                     SNPE_UDO_WRONG_NUM_OF_OUTPUTS,
                      "Output provided to function is null")
 
-
+    // check everything first, a rejected call leaves the op bound as it was
     for (std::size_t idx = 0; idx < m_Inputs.size(); idx++)
     {
-        m_Inputs[idx] = &inputs[idx];
+        UDO_VALIDATE_RETURN_STATUS(checkRebind(inputs[idx], *m_Inputs[idx]))
+    }
+    for (std::size_t idx = 0; idx < m_Outputs.size(); idx++)
+    {
+        UDO_VALIDATE_RETURN_STATUS(checkRebind(outputs[idx], *m_Outputs[idx]))
     }
 
+    // a non-blocking execute may still be reading the old buffers
+    waitForCompletion();
+
+    // the op keeps its own copies and only takes the handles and shapes, which fit
+    // in the arrays allocated at creation since the rank is unchanged
+    for (std::size_t idx = 0; idx < m_Inputs.size(); idx++)
+    {
+        rebindTensorParam(inputs[idx], *m_Inputs[idx]);
+    }
     for (std::size_t idx = 0; idx < m_Outputs.size(); idx++)
     {
-        m_Outputs[idx] = &outputs[idx];
+        rebindTensorParam(outputs[idx], *m_Outputs[idx]);
     }
 
     return SNPE_UDO_NO_ERROR;
 }
 
-void freeUdoTensorParam(SnpeUdo_TensorParam_t &tensorParam, bool deleteData = false) {
-    if (!tensorParam.maxDimensions || !tensorParam.currDimensions || !tensorParam.tensorData)
+void
+UdoCpuOperation::rebindTensorParam(const SnpeUdo_TensorParam_t& srcParam, SnpeUdo_TensorParam_t& destParam) {
+    const size_t dimByteSize = srcParam.tensorRank * sizeof(uint32_t);
+    std::memcpy(destParam.maxDimensions, srcParam.maxDimensions, dimByteSize);
+    std::memcpy(destParam.currDimensions, srcParam.currDimensions, dimByteSize);
+    destParam.tensorData = srcParam.tensorData;
+}
+
+bool
+UdoCpuOperation::isSameTensorType(const SnpeUdo_TensorParam_t& srcParam, const SnpeUdo_TensorParam_t& destParam) {
+    const SnpeUdo_QuantizeParams_t& srcQuant = srcParam.quantizeParams;
+    const SnpeUdo_QuantizeParams_t& destQuant = destParam.quantizeParams;
+    const bool isSameQuantization =
+        srcQuant.quantizeType == destQuant.quantizeType &&
+        (srcQuant.quantizeType != SNPE_UDO_QUANTIZATION_TF ||
+         (srcQuant.TFParams.minValue == destQuant.TFParams.minValue &&
+          srcQuant.TFParams.maxValue == destQuant.TFParams.maxValue)) &&
+        (srcQuant.quantizeType != SNPE_UDO_QUANTIZATION_QMN ||
+         srcQuant.QMNParams.numFractionalBits == destQuant.QMNParams.numFractionalBits);
+    return srcParam.dataType == destParam.dataType &&
+           srcParam.layout == destParam.layout &&
+           srcParam.tensorRank == destParam.tensorRank &&
+           isSameQuantization &&
+           srcParam.maxDimensions != nullptr && srcParam.currDimensions != nullptr &&
+           std::equal(destParam.maxDimensions, destParam.maxDimensions + destParam.tensorRank,
+                      srcParam.maxDimensions) &&
+           fitsMaxDimensions(srcParam);
+}
+
+bool
+UdoCpuOperation::isReusableFor(uint32_t numOfInputs, const SnpeUdo_TensorParam_t* inputs,
+                               uint32_t numOfOutputs, const SnpeUdo_TensorParam_t* outputs) const {
+    if (inputs == nullptr || outputs == nullptr || numOfInputs != m_Inputs.size() || numOfOutputs != m_Outputs.size())
     {
-        return;
+        return false;
     }
-    if (deleteData)
+    for (std::size_t idx = 0; idx < m_Inputs.size(); idx++)
+    {
+        if (!isSameTensorType(inputs[idx], *m_Inputs[idx])) { return false; }
+    }
+    for (std::size_t idx = 0; idx < m_Outputs.size(); idx++)
     {
-        free(reinterpret_cast<uint8_t*>(tensorParam.tensorData));
+        if (!isSameTensorType(outputs[idx], *m_Outputs[idx])) { return false; }
     }
-    delete tensorParam.maxDimensions;
-    delete tensorParam.currDimensions;
+    return true;
 }
 
-UdoCpuOperation::~UdoCpuOperation() {
-    std::for_each(m_Inputs.begin(), m_Inputs.end(), [](SnpeUdo_TensorParam_t*& param) -> void
-    { freeUdoTensorParam(*param);  delete param;});
-    std::for_each(m_Outputs.begin(), m_Outputs.end(), [](SnpeUdo_TensorParam_t*&param) -> void
-    { freeUdoTensorParam(*param); delete param;});
-
-    for (auto it = m_Params.begin(); it != m_Params.end(); it++)
+SnpeUdo_ErrorType_t
+UdoCpuOperation::reuse(SnpeUdo_TensorParam_t* inputs, SnpeUdo_TensorParam_t* outputs) {
+    UDO_VALIDATE_RETURN_STATUS(snpeUdoSetIo(inputs, outputs))
+    m_Profiler.reset();
+    // most ops are released without an execute, the buckets need no clearing then
+    if (!m_LatencyHistogram.isEmpty())
     {
-        freeUdoTensorParam(it->second->tensorParam, true);
-        delete it->second;
+        m_LatencyHistogram.reset();
     }
-}
\ No newline at end of file
+    m_ExecutionTime = 0;
+    m_MaxThreads = 0;
+    m_GrainSize = DEFAULT_GRAIN_SIZE;
+    return SNPE_UDO_NO_ERROR;
+}
+
+UdoCpuOperation::~UdoCpuOperation() {
+    // the metadata goes with m_Arena, only a background execute may still use it
+    waitForCompletion();
+    // the fast path can see the job done while runAsyncJob still holds the lock to
+    // notify, so wait for it to leave before the mutex and condition go away
+    std::lock_guard<std::mutex> lock(m_AsyncMutex);
+}
@@ -0,0 +1,670 @@
+//==============================================================================
+//
+// Copyright (c) 2020 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+#include "utils/UdoExpression.hpp"
+
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+using namespace UdoUtil;
+
+namespace {
+
+constexpr int NO_NODE = -1;
+// parentheses and unary signs nest the recursive descent, bound it for hostile params
+constexpr size_t MAX_NESTING = 32;
+
+enum NodeKind
+{
+    NODE_CONSTANT,
+    NODE_INPUT,
+    NODE_ADD,
+    NODE_SUB,
+    NODE_MUL,
+    NODE_DIV,
+    NODE_MIN,
+    NODE_MAX,
+    NODE_ABS,
+    NODE_ACTIVATION
+};
+
+struct Node
+{
+    NodeKind kind;
+    float value;            // NODE_CONSTANT
+    uint32_t activation;    // NODE_ACTIVATION
+    int children[2];
+};
+
+bool
+equalsIgnoreCase(const char* name, size_t length, const char* other)
+{
+    for (size_t idx = 0; idx < length; idx++)
+    {
+        if (other[idx] == '\0' ||
+            std::tolower(static_cast<unsigned char>(name[idx])) != std::tolower(static_cast<unsigned char>(other[idx])))
+        {
+            return false;
+        }
+    }
+    return other[length] == '\0';
+}
+
+bool
+isNameStart(char c)
+{
+    return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
+}
+
+bool
+isNameChar(char c)
+{
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+class ExprCompiler
+{
+public:
+    ExprCompiler(const char* text, const ExprVariable* variables, size_t numVariables,
+                 const ActivationInfo* activations, size_t numActivations, ExprError& error)
+        : m_Text(text)
+        , m_Variables(variables)
+        , m_NumVariables(numVariables)
+        , m_Activations(activations)
+        , m_NumActivations(numActivations)
+        , m_Error(error)
+    {
+        m_Error.position = 0;
+        m_Error.message = nullptr;
+    }
+
+    int parse()
+    {
+        const int root = parseSum();
+        skipSpaces();
+        if (root != NO_NODE && m_Text[m_Pos] != '\0')
+        {
+            return fail(m_Pos, "unexpected character");
+        }
+        return root;
+    }
+
+    bool lower(int root, ExprProgram& program)
+    {
+        program.numInstructions = 0;
+        program.numTemps = 0;
+        m_Program = &program;
+        m_FreeTemps = (1u << EXPR_MAX_TEMPS) - 1;
+        uint8_t slot = EXPR_SLOT_INPUT;
+        if (!emit(root, true, slot))
+        {
+            return false;
+        }
+        if (slot == EXPR_SLOT_INPUT)
+        {
+            // the expression is x itself
+            ExprInstruction copy = {};
+            copy.opcode = EXPR_OP_COPY;
+            copy.dst = EXPR_SLOT_OUTPUT;
+            copy.src[0] = EXPR_SLOT_INPUT;
+            return push(copy);
+        }
+        return true;
+    }
+
+private:
+    int fail(size_t position, const char* message)
+    {
+        // the innermost error is the most specific one
+        if (m_Error.message == nullptr)
+        {
+            m_Error.position = position;
+            m_Error.message = message;
+        }
+        return NO_NODE;
+    }
+
+    void skipSpaces()
+    {
+        while (std::isspace(static_cast<unsigned char>(m_Text[m_Pos])))
+        {
+            m_Pos++;
+        }
+    }
+
+    bool accept(char c)
+    {
+        skipSpaces();
+        if (m_Text[m_Pos] != c)
+        {
+            return false;
+        }
+        m_Pos++;
+        return true;
+    }
+
+    bool isConstant(int node) const { return m_Nodes[node].kind == NODE_CONSTANT; }
+
+    int addNode(const Node& node)
+    {
+        if (m_NumNodes == EXPR_MAX_NODES)
+        {
+            return fail(m_Pos, "expression has too many terms");
+        }
+        m_Nodes[m_NumNodes] = node;
+        return static_cast<int>(m_NumNodes++);
+    }
+
+    int makeConstant(float value)
+    {
+        Node node = {NODE_CONSTANT, value, 0, {NO_NODE, NO_NODE}};
+        return addNode(node);
+    }
+
+    /**
+     * \brief A node of kind over the given children, folded to a constant when they
+     * are constants. Folding rounds like the kernels, except that activations use
+     * their double reference.
+     */
+    int makeNode(NodeKind kind, int left, int right = NO_NODE, uint32_t activation = 0)
+    {
+        if (left == NO_NODE || (right == NO_NODE && kind != NODE_ABS && kind != NODE_ACTIVATION))
+        {
+            return NO_NODE;
+        }
+        if (isConstant(left) && (right == NO_NODE || isConstant(right)))
+        {
+            const float a = m_Nodes[left].value;
+            const float b = right != NO_NODE ? m_Nodes[right].value : 0.0f;
+            switch (kind)
+            {
+                case NODE_ADD: return makeConstant(a + b);
+                case NODE_SUB: return makeConstant(a - b);
+                case NODE_MUL: return makeConstant(a * b);
+                case NODE_DIV: return makeConstant(a / b);
+                // NaN operands give b, as V::min and V::max do
+                case NODE_MIN: return makeConstant(a < b ? a : b);
+                case NODE_MAX: return makeConstant(a > b ? a : b);
+                case NODE_ABS: return makeConstant(std::fabs(a));
+                case NODE_ACTIVATION:
+                {
+                    const ActivationInfo& info = m_Activations[activation];
+                    return makeConstant(static_cast<float>(info.reference(a, info.defaults)));
+                }
+                default: break;
+            }
+        }
+        Node node = {kind, 0.0f, activation, {left, right}};
+        return addNode(node);
+    }
+
+    int parseSum()
+    {
+        int node = parseProduct();
+        while (node != NO_NODE)
+        {
+            if (accept('+'))
+            {
+                node = makeNode(NODE_ADD, node, parseProduct());
+            }
+            else if (accept('-'))
+            {
+                node = makeNode(NODE_SUB, node, parseProduct());
+            }
+            else
+            {
+                break;
+            }
+        }
+        return node;
+    }
+
+    int parseProduct()
+    {
+        int node = parseUnary();
+        while (node != NO_NODE)
+        {
+            if (accept('*'))
+            {
+                node = makeNode(NODE_MUL, node, parseUnary());
+            }
+            else if (accept('/'))
+            {
+                node = makeNode(NODE_DIV, node, parseUnary());
+            }
+            else
+            {
+                break;
+            }
+        }
+        return node;
+    }
+
+    int parseUnary()
+    {
+        if (m_Nesting == MAX_NESTING)
+        {
+            return fail(m_Pos, "expression is nested too deeply");
+        }
+        m_Nesting++;
+        int node;
+        if (accept('-'))
+        {
+            // -v is v * -1, which flips the sign of zeros too
+            const int operand = parseUnary();
+            node = operand == NO_NODE ? NO_NODE : makeNode(NODE_MUL, operand, makeConstant(-1.0f));
+        }
+        else if (accept('+'))
+        {
+            node = parseUnary();
+        }
+        else
+        {
+            node = parsePrimary();
+        }
+        m_Nesting--;
+        return node;
+    }
+
+    int parsePrimary()
+    {
+        skipSpaces();
+        const size_t start = m_Pos;
+        const char c = m_Text[m_Pos];
+        if (std::isdigit(static_cast<unsigned char>(c)) || c == '.')
+        {
+            char* end = nullptr;
+            const float value = std::strtof(m_Text + start, &end);
+            if (end == m_Text + start || !std::isfinite(value))
+            {
+                return fail(start, "expected a finite number");
+            }
+            m_Pos = static_cast<size_t>(end - m_Text);
+            return makeConstant(value);
+        }
+        if (isNameStart(c))
+        {
+            while (isNameChar(m_Text[m_Pos]))
+            {
+                m_Pos++;
+            }
+            const size_t length = m_Pos - start;
+            if (accept('('))
+            {
+                return parseCall(start, length);
+            }
+            if (length == 1 && c == 'x')
+            {
+                Node node = {NODE_INPUT, 0.0f, 0, {NO_NODE, NO_NODE}};
+                return addNode(node);
+            }
+            for (size_t idx = 0; idx < m_NumVariables; idx++)
+            {
+                if (std::strlen(m_Variables[idx].name) == length &&
+                    std::strncmp(m_Variables[idx].name, m_Text + start, length) == 0)
+                {
+                    return makeConstant(m_Variables[idx].value);
+                }
+            }
+            return fail(start, "unknown name");
+        }
+        if (accept('('))
+        {
+            const int node = parseSum();
+            if (node != NO_NODE && !accept(')'))
+            {
+                return fail(m_Pos, "expected ')'");
+            }
+            return node;
+        }
+        return fail(start, "expected a number, a name or '('");
+    }
+
+    /**
+     * \brief The arguments and closing parenthesis of a call to the function named by
+     * the length characters at start.
+     */
+    int parseCall(size_t start, size_t length)
+    {
+        int args[3] = {NO_NODE, NO_NODE, NO_NODE};
+        size_t numArgs = 0;
+        if (!accept(')'))
+        {
+            do
+            {
+                if (numArgs == 3)
+                {
+                    return fail(m_Pos, "too many arguments");
+                }
+                args[numArgs] = parseSum();
+                if (args[numArgs++] == NO_NODE)
+                {
+                    return NO_NODE;
+                }
+            } while (accept(','));
+            if (!accept(')'))
+            {
+                return fail(m_Pos, "expected ',' or ')'");
+            }
+        }
+
+        const char* name = m_Text + start;
+        size_t expected = 1;
+        int node = NO_NODE;
+        if (equalsIgnoreCase(name, length, "min") || equalsIgnoreCase(name, length, "max"))
+        {
+            expected = 2;
+            if (numArgs == expected)
+            {
+                node = makeNode(equalsIgnoreCase(name, length, "min") ? NODE_MIN : NODE_MAX, args[0], args[1]);
+            }
+        }
+        else if (equalsIgnoreCase(name, length, "clamp"))
+        {
+            expected = 3;
+            if (numArgs == expected)
+            {
+                node = makeNode(NODE_MIN, makeNode(NODE_MAX, args[0], args[1]), args[2]);
+            }
+        }
+        else if (equalsIgnoreCase(name, length, "relu"))
+        {
+            if (numArgs == expected)
+            {
+                node = makeNode(NODE_MAX, args[0], makeConstant(0.0f));
+            }
+        }
+        else if (equalsIgnoreCase(name, length, "abs"))
+        {
+            if (numArgs == expected)
+            {
+                node = makeNode(NODE_ABS, args[0]);
+            }
+        }
+        else
+        {
+            uint32_t activation = 0;
+            while (activation < m_NumActivations &&
+                   !equalsIgnoreCase(name, length, m_Activations[activation].operationType))
+            {
+                activation++;
+            }
+            if (activation == m_NumActivations)
+            {
+                return fail(start, "unknown function");
+            }
+            if (numArgs == expected)
+            {
+                node = makeNode(NODE_ACTIVATION, args[0], NO_NODE, activation);
+            }
+        }
+        if (numArgs != expected)
+        {
+            return fail(start, "wrong number of arguments");
+        }
+        return node;
+    }
+
+    /**
+     * \brief Temporaries a subtree needs when the more demanding operand of every
+     * node is evaluated first, after Sethi and Ullman. Constants are immediates and x
+     * is read from the input tile, so neither needs one.
+     */
+    size_t getNeed(int node) const
+    {
+        const Node& n = m_Nodes[node];
+        switch (n.kind)
+        {
+            case NODE_CONSTANT:
+            case NODE_INPUT:
+                return 0;
+            case NODE_ABS:
+            case NODE_ACTIVATION:
+                return std::max<size_t>(1, getNeed(n.children[0]));
+            default:
+                break;
+        }
+        if (isConstant(n.children[0]) || isConstant(n.children[1]))
+        {
+            return std::max<size_t>(1, getNeed(isConstant(n.children[0]) ? n.children[1] : n.children[0]));
+        }
+        const size_t left = getNeed(n.children[0]);
+        const size_t right = getNeed(n.children[1]);
+        return std::max<size_t>(1, left == right ? left + 1 : std::max(left, right));
+    }
+
+    // node is v * c for a constant c
+    bool isScaled(int node, int& operand, float& scale) const
+    {
+        const Node& n = m_Nodes[node];
+        if (n.kind != NODE_MUL || isConstant(n.children[0]) == isConstant(n.children[1]))
+        {
+            return false;
+        }
+        const bool isLeftConstant = isConstant(n.children[0]);
+        operand = n.children[isLeftConstant ? 1 : 0];
+        scale = m_Nodes[n.children[isLeftConstant ? 0 : 1]].value;
+        return true;
+    }
+
+    /**
+     * \brief Picks the instruction of a binary node, with a constant operand as an
+     * immediate, and stores the nodes it reads in operands.
+     */
+    void selectBinary(const Node& n, ExprInstruction& ins, int operands[2]) const
+    {
+        const bool isLeftConstant = isConstant(n.children[0]);
+        const bool isRightConstant = isConstant(n.children[1]);
+        const int other = isLeftConstant ? n.children[1] : n.children[0];
+        const float constant = m_Nodes[isLeftConstant ? n.children[0] : n.children[1]].value;
+        operands[0] = other;
+        if (!isLeftConstant && !isRightConstant)
+        {
+            static const ExprOpcode opcodes[] = {EXPR_OP_ADD, EXPR_OP_SUB, EXPR_OP_MUL, EXPR_OP_DIV,
+                                                 EXPR_OP_MIN, EXPR_OP_MAX};
+            ins.opcode = opcodes[n.kind - NODE_ADD];
+            operands[0] = n.children[0];
+            operands[1] = n.children[1];
+            return;
+        }
+
+        int scaled = NO_NODE;
+        float scale = 0.0f;
+        switch (n.kind)
+        {
+            case NODE_SUB:
+                if (isLeftConstant)
+                {
+                    ins.opcode = EXPR_OP_RSUB_C;
+                    ins.constants[0] = constant;
+                    return;
+                }
+                // v - c is v + -c exactly
+                // fallthrough
+            case NODE_ADD:
+            {
+                const float addend = n.kind == NODE_SUB ? -constant : constant;
+                if (isScaled(other, scaled, scale))
+                {
+                    ins.opcode = EXPR_OP_FMA_C;
+                    ins.constants[0] = scale;
+                    ins.constants[1] = addend;
+                    operands[0] = scaled;
+                }
+                else
+                {
+                    ins.opcode = EXPR_OP_ADD_C;
+                    ins.constants[0] = addend;
+                }
+                return;
+            }
+            case NODE_MUL:
+                ins.opcode = EXPR_OP_MUL_C;
+                ins.constants[0] = constant;
+                return;
+            case NODE_DIV:
+                ins.opcode = isLeftConstant ? EXPR_OP_RDIV_C : EXPR_OP_DIV_C;
+                ins.constants[0] = constant;
+                return;
+            case NODE_MIN:
+            {
+                const Node& inner = m_Nodes[other];
+                if (inner.kind == NODE_MAX && isConstant(inner.children[0]) != isConstant(inner.children[1]))
+                {
+                    const bool isInnerLeftConstant = isConstant(inner.children[0]);
+                    ins.opcode = EXPR_OP_CLAMP_C;
+                    ins.constants[0] = m_Nodes[inner.children[isInnerLeftConstant ? 0 : 1]].value;
+                    ins.constants[1] = constant;
+                    operands[0] = inner.children[isInnerLeftConstant ? 1 : 0];
+                }
+                else
+                {
+                    ins.opcode = EXPR_OP_MIN_C;
+                    ins.constants[0] = constant;
+                }
+                return;
+            }
+            case NODE_MAX:
+                ins.opcode = EXPR_OP_MAX_C;
+                ins.constants[0] = constant;
+                return;
+            default:
+                return;
+        }
+    }
+
+    bool push(const ExprInstruction& ins)
+    {
+        if (m_Program->numInstructions == EXPR_MAX_NODES)
+        {
+            fail(0, "expression has too many terms");
+            return false;
+        }
+        m_Program->instructions[m_Program->numInstructions++] = ins;
+        return true;
+    }
+
+    void release(uint8_t slot)
+    {
+        if (slot >= EXPR_SLOT_TEMP)
+        {
+            m_FreeTemps |= 1u << (slot - EXPR_SLOT_TEMP);
+        }
+    }
+
+    bool acquire(uint8_t& slot)
+    {
+        for (size_t temp = 0; temp < EXPR_MAX_TEMPS; temp++)
+        {
+            if ((m_FreeTemps & (1u << temp)) != 0)
+            {
+                m_FreeTemps &= ~(1u << temp);
+                m_Program->numTemps = std::max(m_Program->numTemps, temp + 1);
+                slot = static_cast<uint8_t>(EXPR_SLOT_TEMP + temp);
+                return true;
+            }
+        }
+        fail(0, "expression needs too many temporaries");
+        return false;
+    }
+
+    /**
+     * \brief Emits the instructions of a subtree and returns the slot of its value.
+     * The root writes the output, every other node a temporary, possibly one its
+     * operands just freed since the instructions are elementwise.
+     */
+    bool emit(int node, bool isRoot, uint8_t& slot)
+    {
+        const Node& n = m_Nodes[node];
+        if (n.kind == NODE_INPUT)
+        {
+            slot = EXPR_SLOT_INPUT;
+            return true;
+        }
+
+        ExprInstruction ins = {};
+        int operands[2] = {NO_NODE, NO_NODE};
+        switch (n.kind)
+        {
+            case NODE_CONSTANT:
+                // constants only get here as the root, parents take them as immediates
+                ins.opcode = EXPR_OP_FILL;
+                ins.constants[0] = n.value;
+                break;
+            case NODE_ABS:
+                ins.opcode = EXPR_OP_ABS;
+                operands[0] = n.children[0];
+                break;
+            case NODE_ACTIVATION:
+                ins.opcode = EXPR_OP_ACTIVATION;
+                ins.activation = n.activation;
+                ins.params = m_Activations[n.activation].defaults;
+                operands[0] = n.children[0];
+                break;
+            default:
+                selectBinary(n, ins, operands);
+                break;
+        }
+
+        ins.src[0] = EXPR_SLOT_INPUT;
+        ins.src[1] = EXPR_SLOT_INPUT;
+        const size_t first = operands[1] != NO_NODE && getNeed(operands[1]) > getNeed(operands[0]) ? 1 : 0;
+        for (size_t idx = 0; idx < 2; idx++)
+        {
+            const size_t operand = idx == 0 ? first : 1 - first;
+            if (operands[operand] != NO_NODE && !emit(operands[operand], false, ins.src[operand]))
+            {
+                return false;
+            }
+        }
+        release(ins.src[0]);
+        release(ins.src[1]);
+        if (isRoot)
+        {
+            ins.dst = EXPR_SLOT_OUTPUT;
+        }
+        else if (!acquire(ins.dst))
+        {
+            return false;
+        }
+        slot = ins.dst;
+        return push(ins);
+    }
+
+    const char* m_Text;
+    size_t m_Pos = 0;
+    size_t m_Nesting = 0;
+    const ExprVariable* m_Variables;
+    size_t m_NumVariables;
+    const ActivationInfo* m_Activations;
+    size_t m_NumActivations;
+    ExprError& m_Error;
+    Node m_Nodes[EXPR_MAX_NODES];
+    size_t m_NumNodes = 0;
+    ExprProgram* m_Program = nullptr;
+    uint32_t m_FreeTemps = 0;
+};
+
+}
+
+SnpeUdo_ErrorType_t
+UdoUtil::compileExpression(const char* text, const ExprVariable* variables, size_t numVariables,
+                           const ActivationInfo* activations, size_t numActivations,
+                           ExprProgram& program, ExprError& error)
+{
+    ExprCompiler compiler(text != nullptr ? text : "", variables, numVariables, activations, numActivations, error);
+    const int root = compiler.parse();
+    if (root == NO_NODE || !compiler.lower(root, program))
+    {
+        program.numInstructions = 0;
+        return SNPE_UDO_INVALID_ARGUMENT;
+    }
+    return SNPE_UDO_NO_ERROR;
+}
@@ -0,0 +1,98 @@
+//==============================================================================
+//
+// Copyright (c) 2020 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+#include "utils/UdoLatencyHistogram.hpp"
+
+#include <cmath>
+
+using namespace UdoUtil;
+
+void
+UdoLatencyHistogram::merge(const UdoLatencyHistogram& other) {
+    for (uint32_t idx = 0; idx < NUM_BUCKETS; idx++)
+    {
+        const uint64_t count = other.m_Buckets[idx].load(std::memory_order_relaxed);
+        if (count != 0)
+        {
+            m_Buckets[idx].fetch_add(count, std::memory_order_relaxed);
+        }
+    }
+    m_TotalNs.fetch_add(other.m_TotalNs.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+    const uint64_t otherMin = other.m_MinNs.load(std::memory_order_relaxed);
+    uint64_t min = m_MinNs.load(std::memory_order_relaxed);
+    while (otherMin < min && !m_MinNs.compare_exchange_weak(min, otherMin, std::memory_order_relaxed)) {}
+
+    const uint64_t otherMax = other.m_MaxNs.load(std::memory_order_relaxed);
+    uint64_t max = m_MaxNs.load(std::memory_order_relaxed);
+    while (otherMax > max && !m_MaxNs.compare_exchange_weak(max, otherMax, std::memory_order_relaxed)) {}
+}
+
+uint64_t
+UdoLatencyHistogram::getCount() const {
+    uint64_t count = 0;
+    for (uint32_t idx = 0; idx < NUM_BUCKETS; idx++)
+    {
+        count += m_Buckets[idx].load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+uint64_t
+UdoLatencyHistogram::getValueAtPercentile(double percentile) const {
+    const uint64_t count = getCount();
+    if (count == 0)
+    {
+        return 0;
+    }
+    percentile = percentile < 0.0 ? 0.0 : (percentile > 100.0 ? 100.0 : percentile);
+    uint64_t rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(count)));
+    rank = rank > 0 ? rank : 1;
+
+    const uint64_t max = m_MaxNs.load(std::memory_order_relaxed);
+    uint64_t seen = 0;
+    for (uint32_t idx = 0; idx < NUM_BUCKETS; idx++)
+    {
+        seen += m_Buckets[idx].load(std::memory_order_relaxed);
+        if (seen >= rank)
+        {
+            const uint64_t value = getBucketUpperBound(idx);
+            return value < max ? value : max;
+        }
+    }
+    return max;
+}
+
+void
+UdoLatencyHistogram::getStats(UdoLatencyStats_t& stats) const {
+    stats.count = getCount();
+    if (stats.count == 0)
+    {
+        stats.minNs = stats.maxNs = stats.meanNs = 0;
+        stats.p50Ns = stats.p90Ns = stats.p99Ns = stats.p999Ns = 0;
+        return;
+    }
+    stats.minNs = m_MinNs.load(std::memory_order_relaxed);
+    stats.maxNs = m_MaxNs.load(std::memory_order_relaxed);
+    stats.meanNs = m_TotalNs.load(std::memory_order_relaxed) / stats.count;
+    stats.p50Ns = getValueAtPercentile(50.0);
+    stats.p90Ns = getValueAtPercentile(90.0);
+    stats.p99Ns = getValueAtPercentile(99.0);
+    stats.p999Ns = getValueAtPercentile(99.9);
+}
+
+void
+UdoLatencyHistogram::reset() {
+    for (uint32_t idx = 0; idx < NUM_BUCKETS; idx++)
+    {
+        m_Buckets[idx].store(0, std::memory_order_relaxed);
+    }
+    m_TotalNs.store(0, std::memory_order_relaxed);
+    m_MinNs.store(UINT64_MAX, std::memory_order_relaxed);
+    m_MaxNs.store(0, std::memory_order_relaxed);
+}
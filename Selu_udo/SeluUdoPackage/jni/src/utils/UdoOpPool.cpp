@@ -0,0 +1,97 @@
+//==============================================================================
+//
+// Copyright (c) 2020 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+#include "utils/UdoOpPool.hpp"
+#include "utils/UdoUtil.hpp"
+
+#include <algorithm>
+
+using namespace UdoUtil;
+
+UdoOpPool::UdoOpPool(uint32_t capacity)
+    : m_Capacity(capacity) {
+    m_Free.reserve(m_Capacity);
+}
+
+UdoOpPool::~UdoOpPool() {
+    close();
+}
+
+SnpeUdo_Operation_t
+UdoOpPool::take(uint32_t numOfInputs, const SnpeUdo_TensorParam_t* inputs,
+                uint32_t numOfOutputs, const SnpeUdo_TensorParam_t* outputs) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    // the most recently released op first, its memory is the most likely to be cached
+    for (size_t idx = m_Free.size(); idx > 0; idx--)
+    {
+        SnpeUdo_Operation_t operation = m_Free[idx - 1];
+        if (operation->operation->isReusableFor(numOfInputs, inputs, numOfOutputs, outputs))
+        {
+            m_Free.erase(m_Free.begin() + (idx - 1));
+            m_NumLive++;
+            m_NumReused++;
+            return operation;
+        }
+    }
+    return nullptr;
+}
+
+void
+UdoOpPool::addLive() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_NumLive++;
+    m_HighWater = std::max(m_HighWater, m_NumLive);
+}
+
+void
+UdoOpPool::dropLive() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_NumLive > 0)
+    {
+        m_NumLive--;
+    }
+}
+
+bool
+UdoOpPool::put(SnpeUdo_Operation_t operation) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_NumLive > 0)
+    {
+        m_NumLive--;
+    }
+    // ops beyond the most that were ever live at once would never be taken
+    if (m_Closed || m_Free.size() >= std::min(m_Capacity, m_HighWater))
+    {
+        return false;
+    }
+    m_Free.push_back(operation);
+    return true;
+}
+
+void
+UdoOpPool::close() {
+    std::vector<SnpeUdo_Operation_t> pooled;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Closed = true;
+        pooled.swap(m_Free);
+    }
+    for (SnpeUdo_Operation_t operation : pooled)
+    {
+        delete operation;
+    }
+}
+
+void
+UdoOpPool::getStats(UdoOpPoolStats& stats) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    stats.numLive = m_NumLive;
+    stats.highWater = m_HighWater;
+    stats.numPooled = m_Free.size();
+    stats.numReused = m_NumReused;
+}
@@ -0,0 +1,274 @@
+//==============================================================================
+//
+// Copyright (c) 2019 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+#include "utils/UdoProfiler.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace UdoUtil;
+
+namespace {
+
+constexpr uint32_t NUM_COUNTERS = 3; // cycles, instructions, cache misses
+
+bool
+countersRequested()
+{
+    static const bool requested = []()
+    {
+        const char* env = std::getenv("UDO_CPU_PERF_COUNTERS");
+        return env != nullptr && env[0] != '\0' && env[0] != '0';
+    }();
+    return requested;
+}
+
+#if defined(__linux__)
+constexpr uint32_t MAX_COUNTER_THREADS = 64;
+
+/**
+ * Counter group of the current thread, opened on first use. It has no constructor or
+ * destructor, so the thread_local needs neither a guard nor a thread exit handler,
+ * whose registration would allocate inside execute. The descriptors are closed by
+ * OpenCounterFds when the library is unloaded rather than when the thread exits.
+ */
+struct ThreadCounters
+{
+    bool opened;
+    int fds[NUM_COUNTERS];
+};
+
+thread_local ThreadCounters t_Counters = {false, {-1, -1, -1}};
+
+/**
+ * Every descriptor a thread opened, in fixed storage. Threads beyond
+ * MAX_COUNTER_THREADS count nothing.
+ */
+class OpenCounterFds
+{
+public:
+    ~OpenCounterFds()
+    {
+        const uint32_t count = std::min(m_Count.load(std::memory_order_acquire), MAX_COUNTER_THREADS);
+        for (uint32_t idx = 0; idx < count * NUM_COUNTERS; idx++)
+        {
+            const int fd = m_Fds[idx].exchange(-1, std::memory_order_relaxed);
+            if (fd >= 0)
+            {
+                ::close(fd);
+            }
+        }
+    }
+
+    bool add(const int* fds)
+    {
+        const uint32_t slot = m_Count.fetch_add(1, std::memory_order_relaxed);
+        if (slot >= MAX_COUNTER_THREADS)
+        {
+            return false;
+        }
+        for (uint32_t idx = 0; idx < NUM_COUNTERS; idx++)
+        {
+            m_Fds[slot * NUM_COUNTERS + idx].store(fds[idx], std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+private:
+    std::atomic<uint32_t> m_Count{0};
+    std::atomic<int> m_Fds[MAX_COUNTER_THREADS * NUM_COUNTERS];
+};
+
+// constructed at load, outside any execute, and destroyed at unload
+OpenCounterFds g_OpenCounterFds;
+
+void
+closeFds(int* fds)
+{
+    for (uint32_t idx = 0; idx < NUM_COUNTERS; idx++)
+    {
+        if (fds[idx] >= 0)
+        {
+            ::close(fds[idx]);
+        }
+        fds[idx] = -1;
+    }
+}
+
+/**
+ * Opens the group of the current thread. Counting is user space only, which
+ * perf_event_paranoid allows by default for a thread's own counters.
+ */
+void
+openThreadCounters(ThreadCounters& counters)
+{
+    counters.opened = true;
+    const uint64_t configs[NUM_COUNTERS] = {PERF_COUNT_HW_CPU_CYCLES,
+                                            PERF_COUNT_HW_INSTRUCTIONS,
+                                            PERF_COUNT_HW_CACHE_MISSES};
+    for (uint32_t idx = 0; idx < NUM_COUNTERS; idx++)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = configs[idx];
+        attr.read_format = PERF_FORMAT_GROUP;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        const int groupFd = idx == 0 ? -1 : counters.fds[0];
+        counters.fds[idx] = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0));
+        if (counters.fds[idx] < 0)
+        {
+            closeFds(counters.fds);
+            return;
+        }
+    }
+    if (!g_OpenCounterFds.add(counters.fds))
+    {
+        closeFds(counters.fds);
+    }
+}
+
+bool
+readThreadCounters(uint64_t* values)
+{
+    ThreadCounters& counters = t_Counters;
+    if (!counters.opened)
+    {
+        openThreadCounters(counters);
+    }
+    if (counters.fds[0] < 0)
+    {
+        return false;
+    }
+    uint64_t buffer[1 + NUM_COUNTERS];
+    if (::read(counters.fds[0], buffer, sizeof(buffer)) != static_cast<ssize_t>(sizeof(buffer)) ||
+        buffer[0] != NUM_COUNTERS)
+    {
+        return false;
+    }
+    std::memcpy(values, buffer + 1, NUM_COUNTERS * sizeof(uint64_t));
+    return true;
+}
+#else
+bool
+readThreadCounters(uint64_t*)
+{
+    return false;
+}
+#endif
+
+} // namespace
+
+constexpr size_t UdoProfiler::NUM_STATS_WORDS;
+
+UdoProfiler::UdoProfiler()
+        : m_LastChunkEndNs(0)
+        , m_StatsSeq(0) {
+    reset();
+}
+
+void
+UdoProfiler::beginKernel() {
+    m_KernelStartNs = nowNs();
+    m_LastChunkEndNs.store(0, std::memory_order_relaxed);
+    m_CountersStarted = countersRequested() && readThreadCounters(m_CountersStart);
+}
+
+uint64_t
+UdoProfiler::endCall() {
+    uint64_t countersEnd[NUM_COUNTERS];
+    const bool countersValid = m_CountersStarted && readThreadCounters(countersEnd);
+    const uint64_t endNs = nowNs();
+
+    // without chunks on other threads the kernel ends with the call
+    uint64_t kernelEndNs = m_LastChunkEndNs.load(std::memory_order_relaxed);
+    if (kernelEndNs == 0 || kernelEndNs > endNs)
+    {
+        kernelEndNs = endNs;
+    }
+    kernelEndNs = kernelEndNs < m_KernelStartNs ? m_KernelStartNs : kernelEndNs;
+
+    uint64_t phaseNs[UDO_PROFILE_NUM_PHASES];
+    phaseNs[UDO_PROFILE_PHASE_SETUP] = m_SetupEndNs - m_CallStartNs;
+    phaseNs[UDO_PROFILE_PHASE_QUEUE] = m_KernelStartNs - m_SetupEndNs;
+    phaseNs[UDO_PROFILE_PHASE_KERNEL] = kernelEndNs - m_KernelStartNs;
+    phaseNs[UDO_PROFILE_PHASE_JOIN] = endNs - kernelEndNs;
+    const uint64_t callNs = endNs - m_CallStartNs;
+
+    m_Stats.numCalls++;
+    m_Stats.lastNs = callNs;
+    m_Stats.totalNs += callNs;
+    m_Stats.minNs = m_Stats.numCalls == 1 || callNs < m_Stats.minNs ? callNs : m_Stats.minNs;
+    m_Stats.maxNs = callNs > m_Stats.maxNs ? callNs : m_Stats.maxNs;
+    for (uint32_t phase = 0; phase < UDO_PROFILE_NUM_PHASES; phase++)
+    {
+        m_Stats.lastPhaseNs[phase] = phaseNs[phase];
+        m_Stats.totalPhaseNs[phase] += phaseNs[phase];
+    }
+    if (countersValid)
+    {
+        m_Stats.hwCountersValid = 1;
+        m_Stats.cycles += countersEnd[0] - m_CountersStart[0];
+        m_Stats.instructions += countersEnd[1] - m_CountersStart[1];
+        m_Stats.cacheMisses += countersEnd[2] - m_CountersStart[2];
+    }
+    publishStats();
+    return callNs;
+}
+
+void
+UdoProfiler::publishStats() {
+    uint64_t words[NUM_STATS_WORDS];
+    std::memcpy(words, &m_Stats, sizeof(words));
+    const uint32_t seq = m_StatsSeq.load(std::memory_order_relaxed);
+    m_StatsSeq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t idx = 0; idx < NUM_STATS_WORDS; idx++)
+    {
+        m_StatsWords[idx].store(words[idx], std::memory_order_relaxed);
+    }
+    m_StatsSeq.store(seq + 2, std::memory_order_release);
+}
+
+void
+UdoProfiler::getStats(UdoProfileStats_t& stats) const {
+    uint64_t words[NUM_STATS_WORDS];
+    for (;;)
+    {
+        const uint32_t seq = m_StatsSeq.load(std::memory_order_acquire);
+        if ((seq & 1) != 0)
+        {
+            continue;
+        }
+        for (size_t idx = 0; idx < NUM_STATS_WORDS; idx++)
+        {
+            words[idx] = m_StatsWords[idx].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_StatsSeq.load(std::memory_order_relaxed) == seq)
+        {
+            break;
+        }
+    }
+    std::memcpy(&stats, words, sizeof(stats));
+}
+
+void
+UdoProfiler::reset() {
+    std::memset(&m_Stats, 0, sizeof(m_Stats));
+    publishStats();
+}
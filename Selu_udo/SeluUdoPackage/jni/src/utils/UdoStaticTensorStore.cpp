@@ -0,0 +1,475 @@
+//==============================================================================
+//
+// Copyright (c) 2020 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+#include "utils/UdoStaticTensorStore.hpp"
+#include "utils/UdoDataType.hpp"
+#include "utils/UdoMacros.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <numeric>
+
+using namespace UdoUtil;
+
+namespace {
+
+// live entries below which the maps are not swept for expired ones
+constexpr size_t MIN_PRUNE_THRESHOLD = 64;
+
+constexpr uint64_t HASH_PRIME_1 = 0x9e3779b185ebca87ull;
+constexpr uint64_t HASH_PRIME_2 = 0xc2b2ae3d27d4eb4full;
+
+uint64_t
+rotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+uint64_t
+mixLane(uint64_t lane, uint64_t word) {
+    return rotateLeft(lane + word * HASH_PRIME_2, 31) * HASH_PRIME_1;
+}
+
+uint64_t
+finalizeHash(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= HASH_PRIME_2;
+    hash ^= hash >> 29;
+    hash *= HASH_PRIME_1;
+    return hash ^ (hash >> 32);
+}
+
+// four independent lanes keep the multiplies pipelined, so hashing runs at about the
+// speed of reading the data
+uint64_t
+hashBytes(const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t lanes[4] = {HASH_PRIME_1 + HASH_PRIME_2, HASH_PRIME_2, 0, 0 - HASH_PRIME_1};
+    size_t offset = 0;
+    for (; offset + 4 * sizeof(uint64_t) <= size; offset += 4 * sizeof(uint64_t))
+    {
+        for (size_t lane = 0; lane < 4; lane++)
+        {
+            uint64_t word;
+            std::memcpy(&word, bytes + offset + lane * sizeof(uint64_t), sizeof(word));
+            lanes[lane] = mixLane(lanes[lane], word);
+        }
+    }
+    uint64_t hash = rotateLeft(lanes[0], 1) + rotateLeft(lanes[1], 7) + rotateLeft(lanes[2], 12) +
+                    rotateLeft(lanes[3], 18) + size;
+    for (; offset + sizeof(uint64_t) <= size; offset += sizeof(uint64_t))
+    {
+        uint64_t word;
+        std::memcpy(&word, bytes + offset, sizeof(word));
+        hash = mixLane(hash, word);
+    }
+    if (offset < size)
+    {
+        uint64_t word = 0;
+        std::memcpy(&word, bytes + offset, size - offset);
+        hash = mixLane(hash, word);
+    }
+    return finalizeHash(hash);
+}
+
+size_t
+getStringSize(const char* str) {
+    return str != nullptr ? std::strlen(str) + 1 : 1;
+}
+
+// null strings become empty ones
+char*
+copyString(const char* str, UdoArena& arena) {
+    const size_t size = getStringSize(str);
+    char* copy = arena.allocate<char>(size);
+    std::memcpy(copy, str != nullptr ? str : "", size);
+    return copy;
+}
+
+bool
+hasDimensions(const SnpeUdo_TensorParam_t& param) {
+    return param.maxDimensions != nullptr && param.currDimensions != nullptr;
+}
+
+}
+
+UdoStaticTensorStore::UdoStaticTensorStore()
+    : m_Mode(UDO_STATIC_TENSORS_COPY)
+    , m_PruneThreshold(MIN_PRUNE_THRESHOLD) {}
+
+std::shared_ptr<UdoStaticBlob>
+UdoStaticTensorStore::allocateBlob(size_t size) {
+    std::shared_ptr<UdoStaticBlob> blob(new (std::nothrow) UdoStaticBlob());
+    if (blob == nullptr)
+    {
+        return nullptr;
+    }
+    blob->m_Block.reset(new (std::nothrow) uint8_t[size + STATIC_TENSOR_ALIGNMENT]);
+    if (blob->m_Block == nullptr)
+    {
+        return nullptr;
+    }
+    const uintptr_t base = reinterpret_cast<uintptr_t>(blob->m_Block.get());
+    const uintptr_t aligned = (base + STATIC_TENSOR_ALIGNMENT - 1) & ~uintptr_t(STATIC_TENSOR_ALIGNMENT - 1);
+    blob->m_Data = blob->m_Block.get() + (aligned - base);
+    blob->m_Size = size;
+    return blob;
+}
+
+UdoStaticBlobRef
+UdoStaticTensorStore::findByAddress(const void* data) {
+    auto pos = m_Addresses.find(data);
+    if (pos == m_Addresses.end())
+    {
+        return nullptr;
+    }
+    UdoStaticBlobRef blob = pos->second.lock();
+    if (blob == nullptr)
+    {
+        m_Addresses.erase(pos);
+    }
+    return blob;
+}
+
+UdoStaticBlobRef
+UdoStaticTensorStore::findByContent(uint64_t hash, const void* data, size_t size) {
+    auto range = m_Contents.equal_range(hash);
+    for (auto pos = range.first; pos != range.second; ++pos)
+    {
+        UdoStaticBlobRef blob = pos->second.lock();
+        if (blob != nullptr && blob->m_Size == size && std::memcmp(blob->m_Data, data, size) == 0)
+        {
+            return blob;
+        }
+    }
+    return nullptr;
+}
+
+void
+UdoStaticTensorStore::insert(const UdoStaticBlobRef& blob) {
+    m_Addresses[blob->m_Data] = blob;
+    if (m_Contents.size() + m_Addresses.size() + m_Derived.size() > m_PruneThreshold)
+    {
+        pruneExpired();
+    }
+}
+
+void
+UdoStaticTensorStore::pruneExpired() {
+    for (auto pos = m_Contents.begin(); pos != m_Contents.end();)
+    {
+        pos = pos->second.expired() ? m_Contents.erase(pos) : std::next(pos);
+    }
+    for (auto pos = m_Addresses.begin(); pos != m_Addresses.end();)
+    {
+        pos = pos->second.expired() ? m_Addresses.erase(pos) : std::next(pos);
+    }
+    for (auto pos = m_Derived.begin(); pos != m_Derived.end();)
+    {
+        pos = pos->second.expired() ? m_Derived.erase(pos) : std::next(pos);
+    }
+    // amortized over as many inserts as there are live entries
+    m_PruneThreshold = std::max(MIN_PRUNE_THRESHOLD,
+                                2 * (m_Contents.size() + m_Addresses.size() + m_Derived.size()));
+}
+
+void
+UdoStaticTensorStore::countShared(size_t size) {
+    m_NumShared++;
+    m_BytesShared += size;
+}
+
+UdoStaticBlobRef
+UdoStaticTensorStore::acquire(const void* data, size_t size) {
+    if (data == nullptr && size > 0)
+    {
+        return nullptr;
+    }
+    {
+        // ops of one factory pass the factory's blobs, which need no hashing
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        UdoStaticBlobRef blob = findByAddress(data);
+        if (blob != nullptr && blob->m_Size == size)
+        {
+            countShared(size);
+            return blob;
+        }
+    }
+
+    const uint64_t hash = hashBytes(data, size);
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        UdoStaticBlobRef blob = findByContent(hash, data, size);
+        if (blob != nullptr)
+        {
+            countShared(size);
+            return blob;
+        }
+    }
+
+    std::shared_ptr<UdoStaticBlob> copy = allocateBlob(size);
+    if (copy == nullptr)
+    {
+        return nullptr;
+    }
+    if (size > 0)
+    {
+        std::memcpy(copy->m_Data, data, size);
+    }
+    copy->m_Hash = hash;
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    // another thread may have stored the same tensor meanwhile
+    UdoStaticBlobRef blob = findByContent(hash, data, size);
+    if (blob != nullptr)
+    {
+        countShared(size);
+        return blob;
+    }
+    m_Contents.emplace(hash, copy);
+    insert(copy);
+    return copy;
+}
+
+UdoStaticBlobRef
+UdoStaticTensorStore::acquireDerived(const UdoStaticDerivedKey& key, size_t size,
+                                     const std::function<void(void* data)>& build) {
+    UdoStaticBlobRef sources[2];
+    bool isShareable = true;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (size_t idx = 0; idx < 2; idx++)
+        {
+            if (key.sources[idx] != nullptr)
+            {
+                sources[idx] = findByAddress(key.sources[idx]);
+                isShareable = isShareable && (sources[idx] != nullptr || m_Mode == UDO_STATIC_TENSORS_BORROW);
+            }
+        }
+        auto pos = isShareable ? m_Derived.find(key) : m_Derived.end();
+        UdoStaticBlobRef blob = pos != m_Derived.end() ? pos->second.lock() : nullptr;
+        if (blob != nullptr && blob->m_Size == size)
+        {
+            countShared(size);
+            return blob;
+        }
+    }
+
+    std::shared_ptr<UdoStaticBlob> derived = allocateBlob(size);
+    if (derived == nullptr)
+    {
+        return nullptr;
+    }
+    build(derived->m_Data);
+    derived->m_Sources[0] = sources[0];
+    derived->m_Sources[1] = sources[1];
+    if (!isShareable)
+    {
+        return derived;
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    BlobWeakRef& entry = m_Derived[key];
+    UdoStaticBlobRef blob = entry.lock();
+    if (blob != nullptr && blob->m_Size == size)
+    {
+        countShared(size);
+        return blob;
+    }
+    entry = derived;
+    insert(derived);
+    return derived;
+}
+
+void
+UdoStaticTensorStore::getStats(UdoStaticTensorStats& stats) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    pruneExpired();
+    stats.numBlobs = 0;
+    stats.numBytes = 0;
+    // every live blob is known by its address
+    for (auto& entry : m_Addresses)
+    {
+        UdoStaticBlobRef blob = entry.second.lock();
+        if (blob != nullptr)
+        {
+            stats.numBlobs++;
+            stats.numBytes += blob->m_Size;
+        }
+    }
+    stats.numShared = m_NumShared;
+    stats.bytesShared = m_BytesShared;
+}
+
+size_t
+UdoStaticTensorStore::DerivedKeyHash::operator()(const UdoStaticDerivedKey& key) const {
+    uint64_t hash = HASH_PRIME_1;
+    for (size_t idx = 0; idx < 2; idx++)
+    {
+        hash = mixLane(hash, static_cast<uint64_t>(reinterpret_cast<uintptr_t>(key.sources[idx])));
+    }
+    for (size_t idx = 0; idx < 4; idx++)
+    {
+        hash = mixLane(hash, key.params[idx]);
+    }
+    return static_cast<size_t>(finalizeHash(hash));
+}
+
+bool
+UdoStaticTensorStore::DerivedKeyEqual::operator()(const UdoStaticDerivedKey& lhs,
+                                                  const UdoStaticDerivedKey& rhs) const {
+    return std::equal(lhs.sources, lhs.sources + 2, rhs.sources) &&
+           std::equal(lhs.params, lhs.params + 4, rhs.params);
+}
+
+size_t
+UdoUtil::getTensorDataSize(const SnpeUdo_TensorParam_t& param) {
+    return std::accumulate(param.currDimensions,
+                           param.currDimensions + param.tensorRank,
+                           getDataTypeSize(param.dataType),
+                           std::multiplies<size_t>());
+}
+
+void
+UdoUtil::reserveTensorParam(const SnpeUdo_TensorParam_t& srcParam, UdoArena& arena, bool copyData) {
+    arena.reserve<uint32_t>(2 * srcParam.tensorRank);
+    if (copyData && hasDimensions(srcParam))
+    {
+        arena.reserve(getTensorDataSize(srcParam), STATIC_TENSOR_ALIGNMENT);
+    }
+}
+
+SnpeUdo_ErrorType_t
+UdoUtil::copyTensorParam(const SnpeUdo_TensorParam_t &srcParam, SnpeUdo_TensorParam_t &destParam, UdoArena& arena,
+                         bool copyData) {
+    destParam.dataType = srcParam.dataType;
+    destParam.layout = srcParam.layout;
+    destParam.quantizeParams = srcParam.quantizeParams;
+    destParam.tensorRank = srcParam.tensorRank;
+
+
+    UDO_VALIDATE_MSG(!hasDimensions(srcParam),
+                     SNPE_UDO_INVALID_ARGUMENT,
+                     "Provided dimensions are null")
+
+    auto dimSize = srcParam.tensorRank;
+    auto dimByteSize = dimSize * sizeof(uint32_t);
+    destParam.maxDimensions = arena.allocate<uint32_t>(dimSize);
+    destParam.currDimensions = arena.allocate<uint32_t>(dimSize);
+    UDO_VALIDATE_MSG(dimSize > 0 && (destParam.maxDimensions == nullptr || destParam.currDimensions == nullptr),
+                     SNPE_UDO_MEM_ALLOC_ERROR,
+                     "Operation arena is too small for the tensor dimensions")
+
+    std::memcpy(destParam.maxDimensions,
+                srcParam.maxDimensions,
+                dimByteSize);
+    std::memcpy(destParam.currDimensions,
+                srcParam.currDimensions,
+                dimByteSize);
+
+    if (copyData)
+    {
+        auto dataDimSize = getTensorDataSize(srcParam);
+        UDO_VALIDATE_MSG(dataDimSize == 0 && getDataTypeSize(srcParam.dataType) == 0,
+                         SNPE_UDO_WRONG_DATATYPE,
+                         "Unknown data type " << srcParam.dataType << " of tensor param")
+
+        // logic here is based on data being received as a uint8_t from Param Span
+        destParam.tensorData = arena.allocate(dataDimSize, STATIC_TENSOR_ALIGNMENT);
+        UDO_VALIDATE_MSG(destParam.tensorData == nullptr,
+                         SNPE_UDO_MEM_ALLOC_ERROR,
+                         "Operation arena is too small for the tensor data")
+        std::memcpy(destParam.tensorData,
+                    reinterpret_cast<uint8_t*>(srcParam.tensorData),
+                    dataDimSize);
+    }else {
+        destParam.tensorData = srcParam.tensorData; // this is done for inputs and outputs, which cannot be copied here
+    }
+
+    return SNPE_UDO_NO_ERROR;
+}
+
+void
+UdoUtil::reserveStaticParams(const SnpeUdo_Param_t* params, uint32_t numOfParams, UdoArena& arena,
+                             const UdoStaticTensorStore* store) {
+    arena.reserve<SnpeUdo_Param_t>(numOfParams);
+    for (uint32_t idx = 0; idx < numOfParams; idx++)
+    {
+        arena.reserve<char>(getStringSize(params[idx].paramName));
+        if (params[idx].paramType == SNPE_UDO_PARAMTYPE_TENSOR)
+        {
+            reserveTensorParam(params[idx].tensorParam, arena, store == nullptr);
+        }
+        else if (params[idx].paramType == SNPE_UDO_PARAMTYPE_STRING)
+        {
+            arena.reserve<char>(getStringSize(params[idx].stringParam));
+        }
+    }
+}
+
+SnpeUdo_Param_t*
+UdoUtil::copyStaticParams(const SnpeUdo_Param_t* params, uint32_t numOfParams, UdoArena& arena,
+                          UdoStaticTensorStore* store, std::vector<UdoStaticBlobRef>& tensors) {
+    SnpeUdo_Param_t* staticParams = arena.allocate<SnpeUdo_Param_t>(numOfParams);
+    if (staticParams == nullptr && numOfParams > 0)
+    {
+        return nullptr;
+    }
+    const bool isBorrowing = store != nullptr && store->getMode() == UDO_STATIC_TENSORS_BORROW;
+    if (store != nullptr && !isBorrowing)
+    {
+        const size_t numTensors = std::count_if(params, params + numOfParams, [](const SnpeUdo_Param_t& param)
+        {
+            return param.paramType == SNPE_UDO_PARAMTYPE_TENSOR;
+        });
+        tensors.reserve(tensors.size() + numTensors);
+    }
+    for (std::size_t idx = 0; idx < numOfParams; idx++)
+    {
+        const char* paramName = params[idx].paramName != nullptr ? params[idx].paramName : "";
+        staticParams[idx].paramType = params[idx].paramType;
+        staticParams[idx].paramName = copyString(paramName, arena);
+        switch (params[idx].paramType)
+        {
+            case SNPE_UDO_PARAMTYPE_TENSOR:
+            {
+                const SnpeUdo_TensorParam_t& srcParam = params[idx].tensorParam;
+                SnpeUdo_TensorParam_t& destParam = staticParams[idx].tensorParam;
+                if (copyTensorParam(srcParam, destParam, arena, store == nullptr) != SNPE_UDO_NO_ERROR ||
+                    store == nullptr || isBorrowing || srcParam.tensorData == nullptr)
+                {
+                    break;
+                }
+                UdoStaticBlobRef blob = store->acquire(srcParam.tensorData, getTensorDataSize(srcParam));
+                if (blob == nullptr)
+                {
+                    // leaves the param without data, which the op rejects
+                    UDO_ERROR_MSG(SNPE_UDO_MEM_ALLOC_ERROR, "Could not store static tensor param " << paramName)
+                    destParam.tensorData = nullptr;
+                    break;
+                }
+                destParam.tensorData = const_cast<void*>(blob->getData());
+                tensors.push_back(std::move(blob));
+                break;
+            }
+            case SNPE_UDO_PARAMTYPE_STRING:
+                staticParams[idx].stringParam = copyString(params[idx].stringParam, arena);
+                break;
+            case SNPE_UDO_PARAMTYPE_SCALAR:
+                staticParams[idx].scalarParam = params[idx].scalarParam;
+                break;
+            default:
+            {
+                std::cerr << "ERROR: Function: "
+                          << __FUNCTION__ << " Unknown param type for param: " << paramName
+                          << std::endl;
+            }
+        }
+    }
+    return staticParams;
+}
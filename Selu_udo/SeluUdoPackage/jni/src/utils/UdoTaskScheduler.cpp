@@ -0,0 +1,291 @@
+//==============================================================================
+//
+// Copyright (c) 2019 Qualcomm Technologies, Inc.
+// All Rights Reserved.
+// Confidential and Proprietary - Qualcomm Technologies, Inc.
+//
+//==============================================================================
+
+#include "utils/UdoTaskScheduler.hpp"
+#include "utils/UdoAllocCheck.hpp"
+
+using namespace UdoUtil;
+
+constexpr int64_t UdoTaskScheduler::TaskDeque::CAPACITY;
+constexpr size_t UdoTaskScheduler::MAX_BATCH;
+constexpr uint32_t UdoTaskScheduler::NUM_EXTERNAL_DEQUES;
+constexpr uint32_t UdoTaskScheduler::SPINS_BEFORE_SLEEP;
+
+namespace {
+
+// deque owned by the current thread: its worker deque, or the external deque
+// borrowed by the outermost parallelFor on this thread; -1 when none
+thread_local int32_t t_DequeIdx = -1;
+thread_local uint32_t t_RandomState = 0;
+
+uint32_t
+nextRandom()
+{
+    // xorshift32, only used to spread thieves over victims
+    uint32_t x = t_RandomState != 0 ? t_RandomState : 0x9e3779b9u;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    t_RandomState = x;
+    return x;
+}
+
+} // namespace
+
+UdoTaskScheduler::TaskDeque::TaskDeque()
+        : m_Claimed(false), m_Top(0), m_Bottom(0) {
+    for (auto& slot : m_Buffer)
+    {
+        slot.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+bool
+UdoTaskScheduler::TaskDeque::push(Task* task) {
+    const int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+    const int64_t top = m_Top.load(std::memory_order_acquire);
+    if (bottom - top >= CAPACITY)
+    {
+        return false;
+    }
+    m_Buffer[bottom & (CAPACITY - 1)].store(task, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+    return true;
+}
+
+UdoTaskScheduler::Task*
+UdoTaskScheduler::TaskDeque::pop() {
+    const int64_t bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+    m_Bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = m_Top.load(std::memory_order_relaxed);
+
+    if (top > bottom)
+    {
+        m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Task* task = m_Buffer[bottom & (CAPACITY - 1)].load(std::memory_order_relaxed);
+    if (top == bottom)
+    {
+        // last element, race against thieves for it
+        if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            task = nullptr;
+        }
+        m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return task;
+}
+
+UdoTaskScheduler::Task*
+UdoTaskScheduler::TaskDeque::steal() {
+    int64_t top = m_Top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t bottom = m_Bottom.load(std::memory_order_acquire);
+    if (top >= bottom)
+    {
+        return nullptr;
+    }
+
+    Task* task = m_Buffer[top & (CAPACITY - 1)].load(std::memory_order_relaxed);
+    if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+    {
+        return nullptr;
+    }
+    return task;
+}
+
+UdoTaskScheduler::UdoTaskScheduler(uint32_t numThreads)
+        : m_QueuedTasks(0), m_Sleepers(0), m_Stop(false) {
+    const uint32_t numWorkers = numThreads > 1 ? numThreads - 1 : 0;
+    for (uint32_t idx = 0; idx < numWorkers + NUM_EXTERNAL_DEQUES; idx++)
+    {
+        m_Deques.emplace_back(new TaskDeque());
+    }
+    for (uint32_t idx = 0; idx < numWorkers; idx++)
+    {
+        m_Workers.emplace_back(&UdoTaskScheduler::workerLoop, this, idx);
+    }
+}
+
+UdoTaskScheduler::~UdoTaskScheduler() {
+    m_Stop.store(true);
+    {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+    }
+    m_SleepCv.notify_all();
+    for (auto& worker : m_Workers)
+    {
+        worker.join();
+    }
+}
+
+void
+UdoTaskScheduler::execute(Task* task) {
+    // the task lives on the submitter's stack, read it before signalling completion
+    TaskGroup* group = task->group;
+    if (group->checkAllocations)
+    {
+        UdoNoAllocScope noAlloc;
+        group->fn(group->context, task->taskIdx);
+    }
+    else
+    {
+        group->fn(group->context, task->taskIdx);
+    }
+    group->pending.fetch_sub(1, std::memory_order_release);
+}
+
+UdoTaskScheduler::Task*
+UdoTaskScheduler::findTask(uint32_t dequeIdx) {
+    Task* task = m_Deques[dequeIdx]->pop();
+    if (task == nullptr)
+    {
+        const uint32_t numDeques = static_cast<uint32_t>(m_Deques.size());
+        const uint32_t start = nextRandom() % numDeques;
+        for (uint32_t idx = 0; idx < numDeques && task == nullptr; idx++)
+        {
+            const uint32_t victim = (start + idx) % numDeques;
+            if (victim != dequeIdx)
+            {
+                task = m_Deques[victim]->steal();
+            }
+        }
+    }
+    if (task != nullptr)
+    {
+        m_QueuedTasks.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return task;
+}
+
+void
+UdoTaskScheduler::workerLoop(uint32_t dequeIdx) {
+    t_DequeIdx = static_cast<int32_t>(dequeIdx);
+    t_RandomState = dequeIdx * 0x9e3779b9u + 1;
+    uint32_t spins = 0;
+
+    while (!m_Stop.load(std::memory_order_relaxed))
+    {
+        Task* task = findTask(dequeIdx);
+        if (task != nullptr)
+        {
+            execute(task);
+            spins = 0;
+            continue;
+        }
+        if (++spins < SPINS_BEFORE_SLEEP)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_SleepMutex);
+        m_Sleepers.fetch_add(1);
+        m_SleepCv.wait(lock, [this]() { return m_Stop.load() || m_QueuedTasks.load() > 0; });
+        m_Sleepers.fetch_sub(1);
+        spins = 0;
+    }
+}
+
+void
+UdoTaskScheduler::wakeWorkers() {
+    // pairs with the predicate check in workerLoop: either the sleeper sees the
+    // queued tasks, or we see the sleeper and notify under the lock
+    if (m_Sleepers.load() > 0)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_SleepMutex);
+        }
+        m_SleepCv.notify_all();
+    }
+}
+
+int32_t
+UdoTaskScheduler::acquireDeque() {
+    const uint32_t firstExternal = static_cast<uint32_t>(m_Workers.size());
+    for (uint32_t idx = firstExternal; idx < m_Deques.size(); idx++)
+    {
+        bool expected = false;
+        if (m_Deques[idx]->m_Claimed.compare_exchange_strong(expected, true, std::memory_order_acquire))
+        {
+            return static_cast<int32_t>(idx);
+        }
+    }
+    return -1;
+}
+
+void
+UdoTaskScheduler::run(size_t numTasks, TaskFn fn, void* context) {
+    const bool ownsDeque = t_DequeIdx < 0;
+    const int32_t dequeIdx = ownsDeque && numTasks > 1 && !m_Workers.empty() ? acquireDeque() : t_DequeIdx;
+
+    if (numTasks <= 1 || dequeIdx < 0)
+    {
+        for (size_t taskIdx = 0; taskIdx < numTasks; taskIdx++)
+        {
+            fn(context, taskIdx);
+        }
+        return;
+    }
+
+    t_DequeIdx = dequeIdx;
+    TaskDeque& deque = *m_Deques[dequeIdx];
+    TaskGroup group;
+    group.fn = fn;
+    group.context = context;
+    group.checkAllocations = isNoAllocScope();
+    Task tasks[MAX_BATCH];
+
+    for (size_t batchBegin = 0; batchBegin < numTasks; batchBegin += MAX_BATCH)
+    {
+        const size_t batchSize = numTasks - batchBegin < MAX_BATCH ? numTasks - batchBegin : MAX_BATCH;
+        group.pending.store(batchSize, std::memory_order_relaxed);
+
+        // push in reverse so the owner pops the batch front to back
+        size_t queued = 0;
+        for (size_t idx = batchSize; idx-- > 0;)
+        {
+            tasks[idx].group = &group;
+            tasks[idx].taskIdx = batchBegin + idx;
+            if (deque.push(&tasks[idx]))
+            {
+                queued++;
+            }
+            else
+            {
+                execute(&tasks[idx]);
+            }
+        }
+        m_QueuedTasks.fetch_add(static_cast<int64_t>(queued));
+        wakeWorkers();
+
+        // work on our own tasks first, then help other ops until ours are done
+        while (group.pending.load(std::memory_order_acquire) > 0)
+        {
+            Task* task = findTask(static_cast<uint32_t>(dequeIdx));
+            if (task != nullptr)
+            {
+                execute(task);
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    if (ownsDeque)
+    {
+        t_DequeIdx = -1;
+        deque.m_Claimed.store(false, std::memory_order_release);
+    }
+}
@@ -8,6 +8,9 @@
 
 #include "utils/UdoUtil.hpp"
 
+#include <cstdlib>
+#include <cstring>
+
 using namespace UdoUtil;
 
 #define UDO_CHECK_POINTER(ptr) {if (ptr == nullptr) return false;}
@@ -123,6 +126,15 @@ UdoOperationInfo::addScalarParam(const char* name,
     m_Params.emplace_back(localUdoParam);
 }
 
+void
+UdoOperationInfo::addStringParam(const char* name) {
+    auto* localUdoParam = new SnpeUdo_Param_t;
+    localUdoParam->paramName = const_cast<char*>(name);
+    localUdoParam->stringParam = nullptr;
+    localUdoParam->paramType = SNPE_UDO_PARAMTYPE_STRING;
+    m_Params.emplace_back(localUdoParam);
+}
+
 void
 UdoOperationInfo::addTensorParam(const char* name,
                                  SnpeUdo_DataType_t type,
@@ -418,23 +430,163 @@ UdoImplementationLib::createOpFactory(const char* operationType,
                  SNPE_UDO_WRONG_OPERATION,
                  "Could not retrieve operation definition for op: " << operationType)
 
-    auto* factory = new _SnpeUdo_OpFactory_t();
+    std::unique_ptr<_SnpeUdo_OpFactory_t> factory(new _SnpeUdo_OpFactory_t());
+    if (staticParams == nullptr) { numOfStaticParams = 0; }
+
+    // the factory keeps its own params, their tensor data is stored once here so
+    // that its ops share it without hashing or copying
+    reserveStaticParams(staticParams, numOfStaticParams, factory->arena, &m_StaticTensorStore);
+    UDO_VALIDATE_MSG(!factory->arena.commit(),
+                     SNPE_UDO_MEM_ALLOC_ERROR,
+                     "Could not allocate the static params of op: " << operationType)
 
     factory->definition = definition;
     factory->infrastructure = perOpFactoryInfrastructure;
-    factory->staticParams = staticParams;
+    factory->staticParams = copyStaticParams(staticParams, numOfStaticParams, factory->arena, &m_StaticTensorStore,
+                                             factory->staticTensors);
     factory->numOfStaticParams = numOfStaticParams;
+    const uint32_t opPoolSize = m_OpPoolSize.load(std::memory_order_relaxed);
+    if (opPoolSize > 0)
+    {
+        factory->opPool = std::make_shared<UdoOpPool>(opPoolSize);
+    }
+
+    *opFactory = factory.release();
+
+    return SNPE_UDO_NO_ERROR;
+}
+
+SnpeUdo_ErrorType_t
+UdoImplementationLib::createOperation(SnpeUdo_OpFactory_t opFactory,
+                                      uint32_t numOfInputs,
+                                      SnpeUdo_TensorParam_t* inputs,
+                                      uint32_t numOfOutputs,
+                                      SnpeUdo_TensorParam_t* outputs,
+                                      SnpeUdo_Operation_t* operation) {
+    UDO_VALIDATE_MSG(opFactory == nullptr || operation == nullptr,
+                     SNPE_UDO_INVALID_ARGUMENT,
+                     "Operation factory or operation provided is not valid")
 
-    *opFactory = factory;
+    UdoOpPool* pool = opFactory->opPool.get();
+    if (pool != nullptr)
+    {
+        std::unique_ptr<_SnpeUdo_Operation_t> handle(pool->take(numOfInputs, inputs, numOfOutputs, outputs));
+        // a pooled op that cannot be rebound is dropped and a new one created
+        if (handle != nullptr && handle->operation->reuse(inputs, outputs) == SNPE_UDO_NO_ERROR)
+        {
+            handle->pool = opFactory->opPool;
+            *operation = handle.release();
+            return SNPE_UDO_NO_ERROR;
+        }
+        if (handle != nullptr)
+        {
+            pool->dropLive();
+        }
+    }
+
+    auto result = opFactory->definition->createOp(opFactory->infrastructure,
+                                                  numOfInputs,
+                                                  inputs,
+                                                  numOfOutputs,
+                                                  outputs,
+                                                  opFactory->numOfStaticParams,
+                                                  opFactory->staticParams);
+
+    UDO_VALIDATE_MSG(result == nullptr,
+                    SNPE_UDO_WRONG_OPERATION,
+                    "Could not create operation of type: "<<opFactory->definition->getOperationType())
+
+    std::unique_ptr<_SnpeUdo_Operation_t> handle(new _SnpeUdo_Operation_t());
+    handle->operation = std::move(result);
+    handle->operationType = opFactory->definition->getOperationType();
+    if (pool != nullptr)
+    {
+        pool->addLive();
+        handle->pool = opFactory->opPool;
+    }
+    *operation = handle.release();
 
     return SNPE_UDO_NO_ERROR;
 }
 
-UdoImplementationLib::UdoImplementationLib() {
+SnpeUdo_ErrorType_t
+UdoImplementationLib::releaseOperation(SnpeUdo_Operation_t operation) {
+    UDO_VALIDATE_MSG(operation == nullptr || !operation->operation,
+                     SNPE_UDO_INVALID_ARGUMENT,
+                     "Operation provided is not valid")
+
+    // a non-blocking execute may still be using the op's buffers and plan
+    operation->operation->waitForCompletion();
+    const UdoLatencyHistogram* histogram = operation->operation->getLatencyHistogram();
+    if (histogram != nullptr)
+    {
+        mergeImplementationLatency(operation->operationType, *histogram);
+    }
+
+    // the pooled handle must not keep its pool alive, the pool deletes it when closed
+    std::shared_ptr<UdoOpPool> pool = std::move(operation->pool);
+    if (pool == nullptr || !pool->put(operation))
+    {
+        delete operation;
+    }
+    return SNPE_UDO_NO_ERROR;
+}
+
+SnpeUdo_ErrorType_t
+UdoImplementationLib::releaseOpFactory(SnpeUdo_OpFactory_t opFactory) {
+    UDO_VALIDATE_MSG(opFactory == nullptr,
+                     SNPE_UDO_INVALID_ARGUMENT,
+                     "Operation factory provided is not valid")
+
+    if (opFactory->opPool != nullptr)
+    {
+        opFactory->opPool->close();
+    }
+    delete opFactory; // manually allocated object in createOpFactory
+    return SNPE_UDO_NO_ERROR;
+}
+
+uint32_t
+defaultNumThreads() {
+    const char* envThreads = std::getenv("UDO_CPU_NUM_THREADS");
+    if (envThreads != nullptr && std::atoi(envThreads) > 0)
+    {
+        return static_cast<uint32_t>(std::atoi(envThreads));
+    }
+    const uint32_t hwThreads = std::thread::hardware_concurrency();
+    return hwThreads > 0 ? hwThreads : 1;
+}
+
+UdoStaticTensorMode
+defaultStaticTensorMode() {
+    const char* envMode = std::getenv("UDO_CPU_STATIC_TENSORS");
+    if (envMode != nullptr && std::strcmp(envMode, "borrow") == 0)
+    {
+        return UDO_STATIC_TENSORS_BORROW;
+    }
+    return UDO_STATIC_TENSORS_COPY;
+}
+
+uint32_t
+defaultOpPoolSize() {
+    const char* envPoolSize = std::getenv("UDO_CPU_OP_POOL_SIZE");
+    if (envPoolSize != nullptr && std::atoi(envPoolSize) >= 0)
+    {
+        return static_cast<uint32_t>(std::atoi(envPoolSize));
+    }
+    return DEFAULT_OP_POOL_SIZE;
+}
+
+UdoImplementationLib::UdoImplementationLib()
+        : m_Sealed(false)
+        , m_NumThreads(defaultNumThreads())
+        , m_TaskSchedulerCreated(false)
+        , m_OpPoolSize(defaultOpPoolSize()) {
     m_ImplInfo.udoCoreType = SNPE_UDO_CORETYPE_UNDEFINED;
     m_ImplInfo.packageName = nullptr;
     m_ImplInfo.operationsString = nullptr;
     m_ImplInfo.numOfOperations = 0;
+    m_StaticTensorStore.setMode(defaultStaticTensorMode());
 }
 
 UdoImplementationLib::UdoImplementationLib(SnpeUdo_CoreType_t coreType,
@@ -456,6 +608,11 @@ UdoImplementationLib::configure(SnpeUdo_CoreType_t coreType,
 SnpeUdo_ErrorType_t
 UdoImplementationLib::registerOpDefinition(const std::string &name,
                                            std::unique_ptr<IUdoOpDefinition> &&definition) {
+    UDO_VALIDATE_MSG(m_Sealed,
+                     SNPE_UDO_UNSUPPORTED_FEATURE,
+                     "Operation definition for op: " << name <<
+                     " cannot be registered once package: " << m_PackageName << " is set")
+
     auto pos = m_Definitions.find(name);
 
     UDO_VALIDATE_MSG(pos != m_Definitions.end(),
@@ -469,6 +626,32 @@ UdoImplementationLib::registerOpDefinition(const std::string &name,
     return SNPE_UDO_NO_ERROR;
 }
 
+void
+UdoImplementationLib::seal() {
+    if (m_Sealed)
+    {
+        return;
+    }
+    std::ostringstream strm;
+    auto iter = m_Definitions.begin();
+
+    while (iter != m_Definitions.end())
+    {
+        strm << iter->second->getOperationType();
+        m_Latencies.push_back({iter->second->getOperationType(),
+                               std::unique_ptr<UdoLatencyHistogram>(new UdoLatencyHistogram())});
+        iter++;
+        if (iter != m_Definitions.end())
+        {
+            strm << ' ';
+        }
+    }
+    m_OperationsString = strm.str();
+    m_ImplInfo.operationsString = const_cast<char*>(m_OperationsString.c_str());
+    m_ImplInfo.numOfOperations = m_Definitions.size();
+    m_Sealed = true;
+}
+
 IUdoOpDefinition*
 UdoImplementationLib::resolveOperation(const char* operationType) {
     auto pos = m_Definitions.find(std::string(operationType));
@@ -487,35 +670,103 @@ UdoImplementationLib::getImplementationInfo(SnpeUdo_ImpInfo_t** info) {
                      SNPE_UDO_INVALID_ARGUMENT,
                      "The implementation info provided to the function is null")
 
-        UDO_VALIDATE_MSG(m_ImplInfo.numOfOperations > m_Definitions.size(),
-                 SNPE_UDO_WRONG_OPERATION,
-                 "The number of operations is more than the registered operation definitions."
-                 "Expected at most: " << m_Definitions.size() <<
-                 " instead got: "<<m_ImplInfo.numOfOperations)
+    UDO_VALIDATE_MSG(!m_Sealed,
+                     SNPE_UDO_UNKNOWN_ERROR,
+                     "The implementation info of package: " << m_PackageName << " is built when it is set")
 
+    *info = &m_ImplInfo;
+    return SNPE_UDO_NO_ERROR;
+}
 
-        std::ostringstream strm;
-        auto iter = m_Definitions.begin();
+SnpeUdo_ErrorType_t
+UdoImplementationLib::setNumThreads(uint32_t numThreads) {
+    // m_TaskScheduler itself is only safe to read after call_once, the flag is not
+    UDO_VALIDATE_MSG(m_TaskSchedulerCreated.load(std::memory_order_acquire),
+                     SNPE_UDO_INVALID_ARGUMENT,
+                     "Task scheduler already created, the thread count can no longer change")
 
-        while (iter != m_Definitions.end())
+    m_NumThreads.store(numThreads > 0 ? numThreads : 1, std::memory_order_relaxed);
+    return SNPE_UDO_NO_ERROR;
+}
+
+UdoTaskScheduler&
+UdoImplementationLib::getTaskScheduler() {
+    std::call_once(m_TaskSchedulerOnce, [this]() {
+        // raised before the count is read, so a later setNumThreads fails instead of
+        // storing a count the scheduler never sees
+        m_TaskSchedulerCreated.store(true, std::memory_order_release);
+        m_TaskScheduler.reset(new UdoTaskScheduler(m_NumThreads.load(std::memory_order_relaxed)));
+    });
+    return *m_TaskScheduler;
+}
+
+UdoAsyncExecutor&
+UdoImplementationLib::getAsyncExecutor() {
+    std::call_once(m_AsyncExecutorOnce, [this]() { m_AsyncExecutor.reset(new UdoAsyncExecutor()); });
+    return *m_AsyncExecutor;
+}
+
+UdoLatencyHistogram*
+UdoImplementationLib::findLatencyHistogram(const char* operationType) {
+    // a handful of types, a scan beats building a std::string key per lookup
+    for (const OperationLatency& latency : m_Latencies)
+    {
+        if (std::strcmp(latency.operationType, operationType) == 0)
         {
-            strm << iter->second->getOperationType();
-            iter++;
-            if (iter != m_Definitions.end())
-            {
-                strm << ' ';
-            }
+            return latency.histogram.get();
         }
-        m_OperationsString = strm.str();
-        m_ImplInfo.operationsString = const_cast<char*>(m_OperationsString.c_str());
-        m_ImplInfo.numOfOperations = m_Definitions.size();
+    }
+    return nullptr;
+}
 
-    *info = &m_ImplInfo;
+void
+UdoImplementationLib::mergeLatencyHistogram(const char* operationType,
+                                            const UdoLatencyHistogram& histogram) {
+    UdoLatencyHistogram* merged = findLatencyHistogram(operationType);
+    if (merged != nullptr)
+    {
+        merged->merge(histogram);
+    }
+}
+
+SnpeUdo_ErrorType_t
+UdoImplementationLib::getLatencyStats(const std::string &operationType, UdoLatencyStats_t* stats) {
+    UDO_VALIDATE_MSG(stats == nullptr,
+                     SNPE_UDO_INVALID_ARGUMENT,
+                     "The latency stats provided are null")
+
+    UdoLatencyHistogram* histogram = findLatencyHistogram(operationType.c_str());
+    if (histogram == nullptr || histogram->isEmpty())
+    {
+        return SNPE_UDO_WRONG_OPERATION;
+    }
+    histogram->getStats(*stats);
     return SNPE_UDO_NO_ERROR;
 }
 
-std::unique_ptr<UdoImplementationLib> libInstance;
-std::mutex libInstanceMutex;
+void
+UdoImplementationLib::dumpLatencyStats(std::ostream& stream) {
+    for (const OperationLatency& latency : m_Latencies)
+    {
+        if (latency.histogram->isEmpty())
+        {
+            continue;
+        }
+        UdoLatencyStats_t stats;
+        latency.histogram->getStats(stats);
+        if (stats.count == 0)
+        {
+            continue;
+        }
+        stream << "INFO: " << m_PackageName << " " << latency.operationType << " execute latency (ns):"
+               << " count=" << stats.count << " min=" << stats.minNs << " mean=" << stats.meanNs
+               << " p50=" << stats.p50Ns << " p90=" << stats.p90Ns << " p99=" << stats.p99Ns
+               << " p999=" << stats.p999Ns << " max=" << stats.maxNs << std::endl;
+    }
+}
+
+// published complete and sealed by setImplementation(), so readers need no lock
+std::atomic<UdoImplementationLib*> libInstance(nullptr);
 
 SnpeUdo_ErrorType_t
 UdoImplementationLib::getVersion(SnpeUdo_LibVersion_t** version) {
@@ -537,36 +788,93 @@ UdoImplementationLib::setVersion(uint32_t libMajor, uint32_t libMinor, uint32_t
 }
 
 SnpeUdo_ErrorType_t
-UdoUtil::setImplementation(SnpeUdo_CoreType_t coreType, const std::string &packageName)
+UdoUtil::setImplementation(std::unique_ptr<UdoImplementationLib>&& implLib)
 {
-    std::lock_guard<std::mutex> lock(libInstanceMutex);
-    UDO_VALIDATE_MSG(libInstance != nullptr,
+    UDO_VALIDATE_MSG(implLib == nullptr,
                      SNPE_UDO_INVALID_ARGUMENT,
-                     "Implementation library instance has already been set")
+                     "Implementation library instance provided is null")
 
-    libInstance.reset(new UdoImplementationLib(coreType, packageName));
+    implLib->seal();
+    UdoImplementationLib* expected = nullptr;
+    UDO_VALIDATE_MSG(!libInstance.compare_exchange_strong(expected, implLib.get(), std::memory_order_acq_rel),
+                     SNPE_UDO_INVALID_ARGUMENT,
+                     "Implementation library instance has already been set")
 
+    implLib.release();
     return SNPE_UDO_NO_ERROR;
 }
 
 UdoImplementationLib&
 UdoUtil::getImplementation()
 {
-    bool libInstanceIsNull = libInstance == nullptr;
-    UDO_ASSERT_MSG(libInstanceIsNull,
+    UdoImplementationLib* implLib = libInstance.load(std::memory_order_acquire);
+    UDO_ASSERT_MSG(implLib == nullptr,
                    SNPE_UDO_UNKNOWN_ERROR,
                    "No Implementation set in function")
 
-    return *libInstance; // #TODO: this will segfault if libInstance is null,
+    return *implLib; // #TODO: this will segfault if libInstance is null,
     // workaround needed as throwing exceptions is not allowed
 }
 
 SnpeUdo_ErrorType_t
 UdoUtil::deleteImplementationInstance()
 {
-    auto implLibptr = libInstance.release();
-    delete implLibptr;
+    delete libInstance.exchange(nullptr, std::memory_order_acq_rel);
 
     return SNPE_UDO_NO_ERROR;
 }
 
+UdoTaskScheduler*
+UdoUtil::getImplementationTaskScheduler()
+{
+    UdoImplementationLib* implLib = libInstance.load(std::memory_order_acquire);
+    if (implLib == nullptr)
+    {
+        return nullptr;
+    }
+    return &implLib->getTaskScheduler();
+}
+
+UdoAsyncExecutor*
+UdoUtil::getImplementationAsyncExecutor()
+{
+    UdoImplementationLib* implLib = libInstance.load(std::memory_order_acquire);
+    if (implLib == nullptr)
+    {
+        return nullptr;
+    }
+    return &implLib->getAsyncExecutor();
+}
+
+UdoStaticTensorStore*
+UdoUtil::getImplementationStaticTensorStore()
+{
+    UdoImplementationLib* implLib = libInstance.load(std::memory_order_acquire);
+    if (implLib == nullptr)
+    {
+        return nullptr;
+    }
+    return &implLib->getStaticTensorStore();
+}
+
+void
+UdoUtil::mergeImplementationLatency(const char* operationType, const UdoLatencyHistogram& histogram)
+{
+    UdoImplementationLib* implLib = libInstance.load(std::memory_order_acquire);
+    if (implLib == nullptr || operationType == nullptr || histogram.isEmpty())
+    {
+        return;
+    }
+    implLib->mergeLatencyHistogram(operationType, histogram);
+}
+
+void
+UdoUtil::dumpImplementationLatencyStats(std::ostream& stream)
+{
+    UdoImplementationLib* implLib = libInstance.load(std::memory_order_acquire);
+    if (implLib == nullptr)
+    {
+        return;
+    }
+    implLib->dumpLatencyStats(stream);
+}